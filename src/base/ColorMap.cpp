@@ -9,7 +9,202 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <cstring>
 
+////////////////////////////////////////////////////////////////////////////////
+// ColorMapLUT
+////////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Pack a color as 8-bit RGBA in memory order.
+///	</summary>
+static uint32_t PackPixel(
+	const RGBA & rgba
+) {
+	unsigned char cPixel[4] = {rgba.r(), rgba.g(), rgba.b(), rgba.a()};
+	uint32_t uPixel;
+	memcpy(&uPixel, cPixel, 4);
+	return uPixel;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ColorMapLUT::ColorMapLUT() :
+	m_dMinValue(0.0f),
+	m_dRange(1.0f),
+	m_dIndexScale(0.0f),
+	m_dMaxIndex(0.0f),
+	m_dFillIndex(0.0f),
+	m_fHasFillValue(false),
+	m_dFillValue(0.0f),
+	m_vecTable(1, RGBA(0, 0, 0, 0)),
+	m_vecPixelTable(1, PackPixel(RGBA(0, 0, 0, 0)))
+{ }
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ColorMapLUT::Initialize(
+	const ColorMap & colormap,
+	float dMinValue,
+	float dMaxValue,
+	float dScalingFactor
+) {
+	if (colormap.size() == 0) {
+		_EXCEPTIONT("Empty colormap");
+	}
+	if (!(dMaxValue != dMinValue)) {
+		_EXCEPTION2("Invalid colormap range [%1.5e, %1.5e]",
+			dMinValue, dMaxValue);
+	}
+	if (!(dScalingFactor > 0.0f)) {
+		_EXCEPTION1("Invalid colormap scaling factor (%1.5e)", dScalingFactor);
+	}
+
+	// Use a power of two entries per color so that the table index is
+	// exactly the index computed by ColorMap::Sample times that power
+	const size_t sColors = colormap.size();
+	size_t sEntriesPerColor = 1;
+	while (sColors * sEntriesPerColor < MinTableSize) {
+		sEntriesPerColor *= 2;
+	}
+	const size_t sTableSize = sColors * sEntriesPerColor;
+
+	// Keep the fill color across reinitialization
+	const RGBA rgbaFill = m_vecTable[m_vecTable.size()-1];
+
+	m_dMinValue = dMinValue;
+	m_dRange = dMaxValue - dMinValue;
+	m_dIndexScale = static_cast<float>(sTableSize);
+	m_dMaxIndex = static_cast<float>(sTableSize - 1);
+	m_dFillIndex = static_cast<float>(sTableSize);
+
+	m_vecTable.resize(sTableSize + 1);
+	m_vecPixelTable.resize(sTableSize + 1);
+
+	for (size_t k = 0; k < sTableSize; k++) {
+
+		// Scale the lower edge of the entry for non-unit scaling factors
+		size_t ixColor = k / sEntriesPerColor;
+		if (dScalingFactor != 1.0f) {
+			double dAlpha = std::pow(
+				static_cast<double>(k) / static_cast<double>(sTableSize),
+				static_cast<double>(dScalingFactor));
+
+			ixColor = static_cast<size_t>(dAlpha * sColors);
+			if (ixColor >= sColors) {
+				ixColor = sColors-1;
+			}
+		}
+
+		const std::vector<unsigned char> & color = colormap[ixColor];
+		_ASSERT(color.size() >= 3);
+
+		m_vecTable[k] = RGBA(color[0], color[1], color[2]);
+		m_vecPixelTable[k] = PackPixel(m_vecTable[k]);
+	}
+
+	m_vecTable[sTableSize] = rgbaFill;
+	m_vecPixelTable[sTableSize] = PackPixel(rgbaFill);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ColorMapLUT::SetFillColor(
+	const RGBA & rgbaFill
+) {
+	m_vecTable[m_vecTable.size()-1] = rgbaFill;
+	m_vecPixelTable[m_vecPixelTable.size()-1] = PackPixel(rgbaFill);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ColorMapLUT::ComputeIndices(
+	const float * dData,
+	size_t sCount,
+	int32_t * ixTable
+) const {
+	const float dMinValue = m_dMinValue;
+	const float dRange = m_dRange;
+	const float dIndexScale = m_dIndexScale;
+	const float dMaxIndex = m_dMaxIndex;
+	const float dFillIndex = m_dFillIndex;
+	const bool fHasFillValue = m_fHasFillValue;
+	const float dFillValue = m_dFillValue;
+
+#pragma omp simd
+	for (size_t s = 0; s < sCount; s++) {
+		const float dValue = dData[s];
+
+		float dIx = (dValue - dMinValue) / dRange * dIndexScale;
+		dIx = (dIx < 0.0f) ? 0.0f : dIx;
+		dIx = (dIx > dMaxIndex) ? dMaxIndex : dIx;
+
+		bool fFill = (dValue != dValue);
+		fFill = fFill || (fHasFillValue && (dValue == dFillValue));
+		dIx = fFill ? dFillIndex : dIx;
+
+		ixTable[s] = static_cast<int32_t>(dIx);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ColorMapLUT::SampleArray(
+	const float * dData,
+	size_t sCount,
+	RGBA * rgbaOut
+) const {
+	_ASSERT((sCount == 0) || ((dData != NULL) && (rgbaOut != NULL)));
+
+	const RGBA * pTable = &(m_vecTable[0]);
+
+	// Compute indices for a block of values in a vectorized pass, then
+	// gather colors from the table
+	int32_t ixTable[SampleBlockSize];
+
+	for (size_t sBegin = 0; sBegin < sCount; sBegin += SampleBlockSize) {
+		const size_t sBlock =
+			(sCount - sBegin < SampleBlockSize)
+			? (sCount - sBegin) : SampleBlockSize;
+
+		ComputeIndices(dData + sBegin, sBlock, ixTable);
+
+		RGBA * pOut = rgbaOut + sBegin;
+		for (size_t s = 0; s < sBlock; s++) {
+			pOut[s] = pTable[ixTable[s]];
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ColorMapLUT::SampleArray(
+	const float * dData,
+	size_t sCount,
+	unsigned char * cPixels
+) const {
+	_ASSERT((sCount == 0) || ((dData != NULL) && (cPixels != NULL)));
+
+	const uint32_t * pTable = &(m_vecPixelTable[0]);
+
+	int32_t ixTable[SampleBlockSize];
+
+	for (size_t sBegin = 0; sBegin < sCount; sBegin += SampleBlockSize) {
+		const size_t sBlock =
+			(sCount - sBegin < SampleBlockSize)
+			? (sCount - sBegin) : SampleBlockSize;
+
+		ComputeIndices(dData + sBegin, sBlock, ixTable);
+
+		unsigned char * pOut = cPixels + 4 * sBegin;
+		for (size_t s = 0; s < sBlock; s++) {
+			memcpy(pOut + 4 * s, &(pTable[ixTable[s]]), 4);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ColorMapLibrary
 ////////////////////////////////////////////////////////////////////////////////
 
 ColorMapLibrary::ColorMapLibrary(
@@ -9,6 +9,8 @@
 #define _COLORMAP_H_
 
 #include "Exception.h"
+#include "RGBA.h"
+
 #include <string>
 #include <vector>
 #include <cmath>
@@ -33,7 +35,7 @@ public:
 		unsigned char & cR,
 		unsigned char & cG,
 		unsigned char & cB
-	) {
+	) const {
 		int ixColor = static_cast<int>((dValue - dMinValue) / (dMaxValue - dMinValue) * size());
 
 		if (ixColor < 0) {
@@ -58,7 +60,7 @@ public:
 		unsigned char & cR,
 		unsigned char & cG,
 		unsigned char & cB
-	) {
+	) const {
 		float dAlpha = (dValue - dMinValue) / (dMaxValue - dMinValue);
 		if (dAlpha < 0.0) {
 			dAlpha = 0.0;
@@ -84,6 +86,173 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		A colormap compiled for a fixed range and power scaling factor into
+///		a flat lookup table.  Values are mapped to table entries with the
+///		same arithmetic as ColorMap::Sample, so entire fields can be sampled
+///		in one vectorizable pass.  NaN values and values equal to
+///		the fill value (if set) are mapped to the fill color.
+///	</summary>
+class ColorMapLUT {
+
+public:
+	///	<summary>
+	///		Minimum number of entries in the lookup table.
+	///	</summary>
+	static const size_t MinTableSize = 4096;
+
+	///	<summary>
+	///		Number of values processed per block in SampleArray.
+	///	</summary>
+	static const size_t SampleBlockSize = 256;
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	ColorMapLUT();
+
+	///	<summary>
+	///		Compile the lookup table from a colormap.  The table size is the
+	///		colormap size times a power of two, so scaling the normalized
+	///		value of ColorMap::Sample to a table index is exact and with unit
+	///		scaling factor the result is identical to ColorMap::Sample.  With
+	///		any other scaling factor the power is evaluated at the lower edge
+	///		of each table entry.
+	///	</summary>
+	void Initialize(
+		const ColorMap & colormap,
+		float dMinValue,
+		float dMaxValue,
+		float dScalingFactor = 1.0f
+	);
+
+	///	<summary>
+	///		Set the color used for NaN and fill values.  The default fill
+	///		color is fully transparent.
+	///	</summary>
+	void SetFillColor(
+		const RGBA & rgbaFill
+	);
+
+	///	<summary>
+	///		Set a fill value that is mapped to the fill color.
+	///	</summary>
+	void SetFillValue(
+		float dFillValue
+	) {
+		m_fHasFillValue = true;
+		m_dFillValue = dFillValue;
+	}
+
+	///	<summary>
+	///		Sample a single value.
+	///	</summary>
+	inline RGBA Sample(
+		float dValue
+	) const {
+		return m_vecTable[Index(dValue)];
+	}
+
+	///	<summary>
+	///		Sample an array of sCount values.
+	///	</summary>
+	void SampleArray(
+		const float * dData,
+		size_t sCount,
+		RGBA * rgbaOut
+	) const;
+
+	///	<summary>
+	///		Sample an array of sCount values into 8-bit RGBA pixels, as
+	///		stored in a PNGImage.
+	///	</summary>
+	void SampleArray(
+		const float * dData,
+		size_t sCount,
+		unsigned char * cPixels
+	) const;
+
+protected:
+	///	<summary>
+	///		Compute the table index of each of sCount values.
+	///	</summary>
+	void ComputeIndices(
+		const float * dData,
+		size_t sCount,
+		int32_t * ixTable
+	) const;
+
+	///	<summary>
+	///		Get the table index of the given value.  The fill color is stored
+	///		in the last entry of the table.
+	///	</summary>
+	inline size_t Index(
+		float dValue
+	) const {
+		float dIx = (dValue - m_dMinValue) / m_dRange * m_dIndexScale;
+		dIx = (dIx < 0.0f) ? 0.0f : dIx;
+		dIx = (dIx > m_dMaxIndex) ? m_dMaxIndex : dIx;
+
+		// NaN fails all comparisons and so passes through the clamp
+		bool fFill = (dValue != dValue);
+		if (m_fHasFillValue) {
+			fFill = fFill || (dValue == m_dFillValue);
+		}
+		dIx = fFill ? m_dFillIndex : dIx;
+
+		return static_cast<size_t>(static_cast<int>(dIx));
+	}
+
+private:
+	///	<summary>
+	///		Minimum value of the range.
+	///	</summary>
+	float m_dMinValue;
+
+	///	<summary>
+	///		Width of the range (maximum value less minimum value).
+	///	</summary>
+	float m_dRange;
+
+	///	<summary>
+	///		Scale from normalized values to (real) table indices.
+	///	</summary>
+	float m_dIndexScale;
+
+	///	<summary>
+	///		Largest table index for valid values.
+	///	</summary>
+	float m_dMaxIndex;
+
+	///	<summary>
+	///		Table index of the fill color.
+	///	</summary>
+	float m_dFillIndex;
+
+	///	<summary>
+	///		Flag indicating a fill value has been set.
+	///	</summary>
+	bool m_fHasFillValue;
+
+	///	<summary>
+	///		Fill value.
+	///	</summary>
+	float m_dFillValue;
+
+	///	<summary>
+	///		Color table, with the fill color as the last entry.
+	///	</summary>
+	std::vector<RGBA> m_vecTable;
+
+	///	<summary>
+	///		Color table as 8-bit RGBA quadruplets in memory order.
+	///	</summary>
+	std::vector<uint32_t> m_vecPixelTable;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class ColorMapLibrary {
 public:
 	///	<summary>
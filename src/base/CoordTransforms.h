@@ -20,6 +20,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cmath>
+#include <stdint.h>
 
 #include "Defines.h"
 #include "Exception.h"
@@ -431,6 +432,78 @@ inline void StereographicProjectionInv(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Calculate the area (in sr) on the unit sphere of the rectangle
+///		[dXs1,dXs2] x [dYs1,dYs2] in the space of the stereographic
+///		projection.  The area element of the projection is
+///		16 / (4 + x^2 + y^2)^2 dx dy, which is integrated exactly.
+///	</summary>
+inline double StereographicRectangleArea(
+	double dXs1,
+	double dYs1,
+	double dXs2,
+	double dYs2
+) {
+	// Antiderivative of the area element over [0,X] x [0,Y], up to a
+	// factor of 2
+	struct Antiderivative {
+		static double Eval(double dX, double dY) {
+			double dRX = sqrt(4.0 + dX * dX);
+			double dRY = sqrt(4.0 + dY * dY);
+			return
+				dX / dRX * atan(dY / dRX)
+				+ dY / dRY * atan(dX / dRY);
+		}
+	};
+
+	return 2.0 * fabs(
+		Antiderivative::Eval(dXs2, dYs2)
+		- Antiderivative::Eval(dXs1, dYs2)
+		- Antiderivative::Eval(dXs2, dYs1)
+		+ Antiderivative::Eval(dXs1, dYs1));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Calculate a 63-bit Morton (Z-order) key for a point in the Cartesian
+///		cube [-1,1]^3.  Points that are close on the sphere tend to have
+///		nearby keys, so sorting by this key improves locality of queries.
+///	</summary>
+inline uint64_t MortonKeyXYZ(
+	double dX,
+	double dY,
+	double dZ
+) {
+	static const double dScale = static_cast<double>((1 << 21) - 1);
+
+	uint64_t ixyz[3];
+	const double dXYZ[3] = {dX, dY, dZ};
+	for (int d = 0; d < 3; d++) {
+		double dUnit = 0.5 * (dXYZ[d] + 1.0);
+		if (dUnit < 0.0) {
+			dUnit = 0.0;
+		}
+		if (dUnit > 1.0) {
+			dUnit = 1.0;
+		}
+
+		// Spread the 21 bits of each coordinate so they occupy every
+		// third bit of the key
+		uint64_t i = static_cast<uint64_t>(dUnit * dScale);
+		i = (i | (i << 32)) & 0x1f00000000ffffULL;
+		i = (i | (i << 16)) & 0x1f0000ff0000ffULL;
+		i = (i | (i << 8))  & 0x100f00f00f00f00fULL;
+		i = (i | (i << 4))  & 0x10c30c30c30c30c3ULL;
+		i = (i | (i << 2))  & 0x1249249249249249ULL;
+		ixyz[d] = i;
+	}
+
+	return (ixyz[0] | (ixyz[1] << 1) | (ixyz[2] << 2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 
 #endif // _COORDTRANSFORMS_H_
 
@@ -15,11 +15,15 @@
 ///	</remarks>
 
 #include "FiniteElementTools.h"
-#include "PolynomialInterp.h"
 #include "GridElements.h"
 #include "GaussLobattoQuadrature.h"
 
+#include <vector>
 #include <map>
+#include <mutex>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -264,6 +268,489 @@ void ApplyInverseMap(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of (face, point) pairs solved together in each SIMD block
+///		of the batched ApplyInverseMap.
+///	</summary>
+static const int InverseMapBlockSize = 16;
+
+///	<summary>
+///		Maximum number of Newton iterations in ApplyInverseMap.
+///	</summary>
+static const int InverseMapMaxIterations = 10;
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ApplyInverseMap(
+	const FaceVector & faces,
+	const NodeVector & nodes,
+	size_t sCount,
+	const int * iFace,
+	const double * dX,
+	const double * dY,
+	const double * dZ,
+	double * dAlpha,
+	double * dBeta
+) {
+	const long lCount = static_cast<long>(sCount);
+	const long lFaces = static_cast<long>(faces.size());
+
+	// Verify face indices before entering the solver
+	long lFirstInvalid = lCount;
+
+#pragma omp parallel for reduction(min:lFirstInvalid)
+	for (long lf = 0; lf < lCount; lf++) {
+		if ((iFace[lf] < 0) || (iFace[lf] >= lFaces) ||
+		    (faces[iFace[lf]].edges.size() != 4)
+		) {
+			if (lf < lFirstInvalid) {
+				lFirstInvalid = lf;
+			}
+		}
+	}
+	if (lFirstInvalid != lCount) {
+		_EXCEPTION2("Point %li references invalid or non-quadrilateral "
+			"face %i", lFirstInvalid, iFace[lFirstInvalid]);
+	}
+
+	// Newton iteration on blocks of points, with one SIMD lane per point
+	const long lBlocks =
+		(lCount + InverseMapBlockSize - 1) / InverseMapBlockSize;
+
+	long lFirstSingular = lCount;
+
+#pragma omp parallel for reduction(min:lFirstSingular)
+	for (long lb = 0; lb < lBlocks; lb++) {
+		const long lBegin = lb * InverseMapBlockSize;
+		const int nLanes = static_cast<int>(
+			std::min<long>(InverseMapBlockSize, lCount - lBegin));
+
+		// Face corners, target point and tangent plane of each lane
+		double dX0[InverseMapBlockSize];
+		double dY0[InverseMapBlockSize];
+		double dZ0[InverseMapBlockSize];
+		double dX1[InverseMapBlockSize];
+		double dY1[InverseMapBlockSize];
+		double dZ1[InverseMapBlockSize];
+		double dX2[InverseMapBlockSize];
+		double dY2[InverseMapBlockSize];
+		double dZ2[InverseMapBlockSize];
+		double dX3[InverseMapBlockSize];
+		double dY3[InverseMapBlockSize];
+		double dZ3[InverseMapBlockSize];
+
+		double dPx[InverseMapBlockSize];
+		double dPy[InverseMapBlockSize];
+		double dPz[InverseMapBlockSize];
+
+		int iTangentPlane[InverseMapBlockSize];
+
+		double dA[InverseMapBlockSize];
+		double dB[InverseMapBlockSize];
+
+		int iActive[InverseMapBlockSize];
+		int iSingular[InverseMapBlockSize];
+
+		for (int l = 0; l < nLanes; l++) {
+			const Face & face = faces[iFace[lBegin + l]];
+
+			const Node & node0 = nodes[face[0]];
+			const Node & node1 = nodes[face[1]];
+			const Node & node2 = nodes[face[2]];
+			const Node & node3 = nodes[face[3]];
+
+			dX0[l] = node0.x;
+			dY0[l] = node0.y;
+			dZ0[l] = node0.z;
+			dX1[l] = node1.x;
+			dY1[l] = node1.y;
+			dZ1[l] = node1.z;
+			dX2[l] = node2.x;
+			dY2[l] = node2.y;
+			dZ2[l] = node2.z;
+			dX3[l] = node3.x;
+			dY3[l] = node3.y;
+			dZ3[l] = node3.z;
+
+			dPx[l] = dX[lBegin + l];
+			dPy[l] = dY[lBegin + l];
+			dPz[l] = dZ[lBegin + l];
+
+			// Fix the Cartesian components to use in iteration
+			if ((fabs(node0.x) >= fabs(node0.y)) &&
+				(fabs(node0.x) >= fabs(node0.z))
+			) {
+				iTangentPlane[l] = 0;
+
+			} else if (
+				(fabs(node0.y) >= fabs(node0.x)) &&
+				(fabs(node0.y) >= fabs(node0.z))
+			) {
+				iTangentPlane[l] = 1;
+
+			} else {
+				iTangentPlane[l] = 2;
+			}
+
+			// First guess
+			dA[l] = 0.5;
+			dB[l] = 0.5;
+
+			iActive[l] = 1;
+			iSingular[l] = 0;
+		}
+
+		for (int i = 0; i < InverseMapMaxIterations; i++) {
+
+			int nActive = 0;
+
+#pragma omp simd reduction(+:nActive)
+			for (int l = 0; l < nLanes; l++) {
+				const double dAlphaL = dA[l];
+				const double dBetaL = dB[l];
+
+				// Apply forward map
+				double dXc =
+					  dX0[l] * (1.0 - dAlphaL) * (1.0 - dBetaL)
+					+ dX1[l] *        dAlphaL  * (1.0 - dBetaL)
+					+ dX2[l] *        dAlphaL  *        dBetaL
+					+ dX3[l] * (1.0 - dAlphaL) *        dBetaL;
+
+				double dYc =
+					  dY0[l] * (1.0 - dAlphaL) * (1.0 - dBetaL)
+					+ dY1[l] *        dAlphaL  * (1.0 - dBetaL)
+					+ dY2[l] *        dAlphaL  *        dBetaL
+					+ dY3[l] * (1.0 - dAlphaL) *        dBetaL;
+
+				double dZc =
+					  dZ0[l] * (1.0 - dAlphaL) * (1.0 - dBetaL)
+					+ dZ1[l] *        dAlphaL  * (1.0 - dBetaL)
+					+ dZ2[l] *        dAlphaL  *        dBetaL
+					+ dZ3[l] * (1.0 - dAlphaL) *        dBetaL;
+
+				double dR = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
+
+				double dGx = dXc / dR;
+				double dGy = dYc / dR;
+				double dGz = dZc / dR;
+
+				double dDx1Fx =
+					(1.0 - dBetaL) * (dX1[l] - dX0[l])
+					+      dBetaL  * (dX2[l] - dX3[l]);
+				double dDx1Fy =
+					(1.0 - dBetaL) * (dY1[l] - dY0[l])
+					+      dBetaL  * (dY2[l] - dY3[l]);
+				double dDx1Fz =
+					(1.0 - dBetaL) * (dZ1[l] - dZ0[l])
+					+      dBetaL  * (dZ2[l] - dZ3[l]);
+
+				double dDx2Fx =
+					(1.0 - dAlphaL) * (dX3[l] - dX0[l])
+					+      dAlphaL  * (dX2[l] - dX1[l]);
+				double dDx2Fy =
+					(1.0 - dAlphaL) * (dY3[l] - dY0[l])
+					+      dAlphaL  * (dY2[l] - dY1[l]);
+				double dDx2Fz =
+					(1.0 - dAlphaL) * (dZ3[l] - dZ0[l])
+					+      dAlphaL  * (dZ2[l] - dZ1[l]);
+
+				double dDenomTerm = 1.0 / (dR * dR * dR);
+
+				double dDx1Gx =
+					(- dXc * (dYc * dDx1Fy + dZc * dDx1Fz)
+						+ (dYc * dYc + dZc * dZc) * dDx1Fx) * dDenomTerm;
+				double dDx1Gy =
+					(- dYc * (dXc * dDx1Fx + dZc * dDx1Fz)
+						+ (dXc * dXc + dZc * dZc) * dDx1Fy) * dDenomTerm;
+				double dDx1Gz =
+					(- dZc * (dXc * dDx1Fx + dYc * dDx1Fy)
+						+ (dXc * dXc + dYc * dYc) * dDx1Fz) * dDenomTerm;
+
+				double dDx2Gx =
+					(- dXc * (dYc * dDx2Fy + dZc * dDx2Fz)
+						+ (dYc * dYc + dZc * dZc) * dDx2Fx) * dDenomTerm;
+				double dDx2Gy =
+					(- dYc * (dXc * dDx2Fx + dZc * dDx2Fz)
+						+ (dXc * dXc + dZc * dZc) * dDx2Fy) * dDenomTerm;
+				double dDx2Gz =
+					(- dZc * (dXc * dDx2Fx + dYc * dDx2Fy)
+						+ (dXc * dXc + dYc * dYc) * dDx2Fz) * dDenomTerm;
+
+				// Pick the two Cartesian components of the tangent plane
+				const bool fFirstY = (iTangentPlane[l] == 0);
+				const bool fSecondY = (iTangentPlane[l] == 2);
+
+				double dMap00 = fFirstY ? dDx1Gy : dDx1Gx;
+				double dMap01 = fFirstY ? dDx2Gy : dDx2Gx;
+				double dMap10 = fSecondY ? dDx1Gy : dDx1Gz;
+				double dMap11 = fSecondY ? dDx2Gy : dDx2Gz;
+
+				double dF0 = fFirstY ? (dGy - dPy[l]) : (dGx - dPx[l]);
+				double dF1 = fSecondY ? (dGy - dPy[l]) : (dGz - dPz[l]);
+
+				double dDet = dMap00 * dMap11 - dMap01 * dMap10;
+
+				const bool fSingular = (fabs(dDet) < ReferenceTolerance);
+
+				// Apply Newton's method
+				double dDeltaAlpha =
+					1.0 / dDet * (  dMap11 * dF0 - dMap01 * dF1);
+
+				double dDeltaBeta =
+					1.0 / dDet * (- dMap10 * dF0 + dMap00 * dF1);
+
+				const bool fUpdate = (iActive[l] != 0) && !fSingular;
+
+				dA[l] = fUpdate ? (dAlphaL - dDeltaAlpha) : dAlphaL;
+				dB[l] = fUpdate ? (dBetaL - dDeltaBeta) : dBetaL;
+
+				double dDeltaNorm = fabs(dDeltaAlpha) + fabs(dDeltaBeta);
+
+				iSingular[l] |= ((iActive[l] != 0) && fSingular) ? 1 : 0;
+				iActive[l] =
+					(fUpdate && !(dDeltaNorm < InverseMapTolerance)) ? 1 : 0;
+
+				nActive += iActive[l];
+			}
+
+			// Stop once all lanes have converged
+			if (nActive == 0) {
+				break;
+			}
+		}
+
+		for (int l = 0; l < nLanes; l++) {
+			dAlpha[lBegin + l] = dA[l];
+			dBeta[lBegin + l] = dB[l];
+
+			if (iSingular[l] && (lBegin + l < lFirstSingular)) {
+				lFirstSingular = lBegin + l;
+			}
+		}
+	}
+
+	if (lFirstSingular != lCount) {
+		_EXCEPTION1("Zero determinant in map inverse of point %li",
+			lFirstSingular);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Location of a GLL node within a quadrilateral element, used to
+///		identify nodes shared between elements by topology.
+///	</summary>
+enum GLLSlotType {
+	GLLSlotType_Interior = 0,
+	GLLSlotType_Corner = 1,
+	GLLSlotType_Edge = 2
+};
+
+///	<summary>
+///		Classify GLL node (i,j) of an element.  Corners return the local
+///		node index in iLocal.  Edge nodes return the local edge index in
+///		iLocal and the position t along the edge (measured from node iLocal).
+///	</summary>
+static GLLSlotType ClassifyGLLSlot(
+	int nP,
+	int i,
+	int j,
+	int & iLocal,
+	int & t
+) {
+	if (j == 0) {
+		if (i == 0) {
+			iLocal = 0;
+			return GLLSlotType_Corner;
+		} else if (i == nP-1) {
+			iLocal = 1;
+			return GLLSlotType_Corner;
+		}
+		iLocal = 0;
+		t = i;
+		return GLLSlotType_Edge;
+	}
+	if (j == nP-1) {
+		if (i == nP-1) {
+			iLocal = 2;
+			return GLLSlotType_Corner;
+		} else if (i == 0) {
+			iLocal = 3;
+			return GLLSlotType_Corner;
+		}
+		iLocal = 2;
+		t = nP-1-i;
+		return GLLSlotType_Edge;
+	}
+	if (i == nP-1) {
+		iLocal = 1;
+		t = j;
+		return GLLSlotType_Edge;
+	}
+	if (i == 0) {
+		iLocal = 3;
+		t = nP-1-j;
+		return GLLSlotType_Edge;
+	}
+	return GLLSlotType_Interior;
+}
+
+///	<summary>
+///		Inverse of ClassifyGLLSlot for edge nodes.
+///	</summary>
+static void GetGLLEdgeSlot(
+	int nP,
+	int iEdge,
+	int t,
+	int & i,
+	int & j
+) {
+	if (iEdge == 0) {
+		i = t;
+		j = 0;
+	} else if (iEdge == 1) {
+		i = nP-1;
+		j = t;
+	} else if (iEdge == 2) {
+		i = nP-1-t;
+		j = nP-1;
+	} else {
+		i = 0;
+		j = nP-1-t;
+	}
+}
+
+///	<summary>
+///		Classify GLL node (i,j) of a Face as in ClassifyGLLSlot.  A
+///		degenerate edge (whose endpoints are the same node) has no edge
+///		map entry and all of its GLL nodes coincide with that node, so
+///		they are classified as the corner at the start of the edge.
+///	</summary>
+static GLLSlotType ClassifyGLLFaceSlot(
+	const Face & face,
+	int nP,
+	int i,
+	int j,
+	int & iLocal,
+	int & t
+) {
+	GLLSlotType eType = ClassifyGLLSlot(nP, i, j, iLocal, t);
+
+	if ((eType == GLLSlotType_Edge) &&
+	    (face[iLocal] == face[(iLocal + 1) % 4])
+	) {
+		return GLLSlotType_Corner;
+	}
+	return eType;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute the GLL-weighted Jacobian at all nP x nP nodes of a
+///		quadrilateral element.  This is the same calculation as
+///		ApplyLocalMap followed by a cross product, arranged so the loop over
+///		nodes vectorizes.  dAlpha, dBeta and dWeight hold the reference
+///		coordinates and product of GLL weights of each node (index j*nP+i).
+///	</summary>
+static void CalculateGLLJacobian(
+	const Face & face,
+	const NodeVector & nodes,
+	int nP,
+	const double * dAlpha,
+	const double * dBeta,
+	const double * dWeight,
+	double * dJacobian
+) {
+	const double dX0 = nodes[face[0]].x;
+	const double dY0 = nodes[face[0]].y;
+	const double dZ0 = nodes[face[0]].z;
+	const double dX1 = nodes[face[1]].x;
+	const double dY1 = nodes[face[1]].y;
+	const double dZ1 = nodes[face[1]].z;
+	const double dX2 = nodes[face[2]].x;
+	const double dY2 = nodes[face[2]].y;
+	const double dZ2 = nodes[face[2]].z;
+	const double dX3 = nodes[face[3]].x;
+	const double dY3 = nodes[face[3]].y;
+	const double dZ3 = nodes[face[3]].z;
+
+	const int nPoints = nP * nP;
+
+#pragma omp simd
+	for (int s = 0; s < nPoints; s++) {
+		const double dA = dAlpha[s];
+		const double dB = dBeta[s];
+
+		// Nodal locations on the plane
+		double dXc =
+			  dX0 * (1.0 - dA) * (1.0 - dB)
+			+ dX1 *        dA  * (1.0 - dB)
+			+ dX2 *        dA  *        dB
+			+ dX3 * (1.0 - dA) *        dB;
+
+		double dYc =
+			  dY0 * (1.0 - dA) * (1.0 - dB)
+			+ dY1 *        dA  * (1.0 - dB)
+			+ dY2 *        dA  *        dB
+			+ dY3 * (1.0 - dA) *        dB;
+
+		double dZc =
+			  dZ0 * (1.0 - dA) * (1.0 - dB)
+			+ dZ1 *        dA  * (1.0 - dB)
+			+ dZ2 *        dA  *        dB
+			+ dZ3 * (1.0 - dA) *        dB;
+
+		double dR = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
+
+		// Pointwise basis vectors in Cartesian geometry
+		double dDx1Fx = (1.0 - dB) * (dX1 - dX0) + dB * (dX2 - dX3);
+		double dDx1Fy = (1.0 - dB) * (dY1 - dY0) + dB * (dY2 - dY3);
+		double dDx1Fz = (1.0 - dB) * (dZ1 - dZ0) + dB * (dZ2 - dZ3);
+
+		double dDx2Fx = (1.0 - dA) * (dX3 - dX0) + dA * (dX2 - dX1);
+		double dDx2Fy = (1.0 - dA) * (dY3 - dY0) + dA * (dY2 - dY1);
+		double dDx2Fz = (1.0 - dA) * (dZ3 - dZ0) + dA * (dZ2 - dZ1);
+
+		// Pointwise basis vectors in spherical geometry
+		double dDenomTerm = 1.0 / (dR * dR * dR);
+
+		double dDx1Gx =
+			(- dXc * (dYc * dDx1Fy + dZc * dDx1Fz)
+				+ (dYc * dYc + dZc * dZc) * dDx1Fx) * dDenomTerm;
+		double dDx1Gy =
+			(- dYc * (dXc * dDx1Fx + dZc * dDx1Fz)
+				+ (dXc * dXc + dZc * dZc) * dDx1Fy) * dDenomTerm;
+		double dDx1Gz =
+			(- dZc * (dXc * dDx1Fx + dYc * dDx1Fy)
+				+ (dXc * dXc + dYc * dYc) * dDx1Fz) * dDenomTerm;
+
+		double dDx2Gx =
+			(- dXc * (dYc * dDx2Fy + dZc * dDx2Fz)
+				+ (dYc * dYc + dZc * dZc) * dDx2Fx) * dDenomTerm;
+		double dDx2Gy =
+			(- dYc * (dXc * dDx2Fx + dZc * dDx2Fz)
+				+ (dXc * dXc + dZc * dZc) * dDx2Fy) * dDenomTerm;
+		double dDx2Gz =
+			(- dZc * (dXc * dDx2Fx + dYc * dDx2Fy)
+				+ (dXc * dXc + dYc * dYc) * dDx2Fz) * dDenomTerm;
+
+		// Cross product gives local Jacobian
+		double dCrossX = dDx1Gy * dDx2Gz - dDx1Gz * dDx2Gy;
+		double dCrossY = dDx1Gz * dDx2Gx - dDx1Gx * dDx2Gz;
+		double dCrossZ = dDx1Gx * dDx2Gy - dDx1Gy * dDx2Gx;
+
+		// Element area weighted by local GLL weights
+		dJacobian[s] = sqrt(
+			  dCrossX * dCrossX
+			+ dCrossY * dCrossY
+			+ dCrossZ * dCrossZ) * dWeight[s];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 double GenerateMetaData(
 	const Mesh & mesh,
 	int nP,
@@ -275,210 +762,369 @@ double GenerateMetaData(
 	// Number of Faces
 	int nElements = static_cast<int>(mesh.faces.size());
 
+	if (nP < 2) {
+		_EXCEPTION1("Invalid number of GLL nodes (%i)", nP);
+	}
+	if (mesh.edgemap.size() == 0) {
+		_EXCEPTIONT("Mesh::ConstructEdgeMap() must be called prior "
+			"to GenerateMetaData()");
+	}
+
+	// Verify face areas are available
+	if (fBubble) {
+		if (mesh.vecFaceArea.GetRows() != static_cast<size_t>(nElements)) {
+			_EXCEPTIONT("Face area information unavailable or incorrect");
+		}
+	}
+
 	// Initialize data structures
 	dataGLLnodes.Allocate(nP, nP, nElements);
 	dataGLLJacobian.Allocate(nP, nP, nElements);
 
-	NodeTree nt;
-
 	// GLL Quadrature nodes
 	DataArray1D<double> dG;
 	DataArray1D<double> dW;
 	GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
 
-	// Accumulated Jacobian
-	double dAccumulatedJacobian = 0.0;
+	const int nPoints = nP * nP;
 
-	// Growing array of Jacobian values
-	std::vector<double> vecGLLJacobian;
+	std::vector<double> dAlphaPoints(nPoints);
+	std::vector<double> dBetaPoints(nPoints);
+	std::vector<double> dWeightPoints(nPoints);
 
-	// Verify face areas are available
-	if (fBubble) {
-		if (mesh.vecFaceArea.GetRows() != nElements) {
-			_EXCEPTIONT("Face area information unavailable or incorrect");
-		}
+	for (int j = 0; j < nP; j++) {
+	for (int i = 0; i < nP; i++) {
+		dAlphaPoints[j * nP + i] = dG[i];
+		dBetaPoints[j * nP + i] = dG[j];
+		dWeightPoints[j * nP + i] = dW[i] * dW[j];
+	}
 	}
 
-	// Write metadata
-	for (int k = 0; k < nElements; k++) {
-		const Face & face = mesh.faces[k];
-		const NodeVector & nodevec = mesh.nodes;
+	// Index of each Face edge in the edge map
+	const long lNoElement = static_cast<long>(nElements);
+
+	long lFirstNonQuad = lNoElement;
+	long lFirstMissingEdge = lNoElement;
+
+	std::vector<int> vecFaceEdgeIx(4 * static_cast<size_t>(nElements));
+
+#pragma omp parallel for reduction(min:lFirstNonQuad,lFirstMissingEdge)
+	for (long lf = 0; lf < lNoElement; lf++) {
+		const Face & face = mesh.faces[lf];
 
 		if (face.edges.size() != 4) {
-			_EXCEPTIONT("Mesh must only contain quadrilateral elements");
+			if (lf < lFirstNonQuad) {
+				lFirstNonQuad = lf;
+			}
+			continue;
 		}
 
-		double dFaceNumericalArea = 0.0;
+		for (int e = 0; e < 4; e++) {
+			if (face[e] == face[(e + 1) % 4]) {
+				vecFaceEdgeIx[4 * lf + e] = InvalidNode;
+				continue;
+			}
 
-		for (int j = 0; j < nP; j++) {
-		for (int i = 0; i < nP; i++) {
-/*
-			double dXc =
-				  nodevec[face[0]].x * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].x *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].x *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].x * (1.0 - dG[i]) *        dG[j];
-
-			double dYc =
-				  nodevec[face[0]].y * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].y *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].y *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].y * (1.0 - dG[i]) *        dG[j];
-
-			double dZc =
-				  nodevec[face[0]].z * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].z *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].z *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].z * (1.0 - dG[i]) *        dG[j];
-
-			double dR = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
-
-			// Check if this Node exists in the NodeMap
-			Node nodeGLL;
-			nodeGLL.x = dXc / dR;
-			nodeGLL.y = dYc / dR;
-			nodeGLL.z = dZc / dR;
-
-			// Calculate Jacobian
-
-			// Pointwise basis vectors in Cartesian geometry
-			Node dDx1F(
-				(1.0 - dG[j]) * (nodevec[face[1]].x - nodevec[face[0]].x)
-				+      dG[j]  * (nodevec[face[2]].x - nodevec[face[3]].x),
-				(1.0 - dG[j]) * (nodevec[face[1]].y - nodevec[face[0]].y)
-				+      dG[j]  * (nodevec[face[2]].y - nodevec[face[3]].y),
-				(1.0 - dG[j]) * (nodevec[face[1]].z - nodevec[face[0]].z)
-				+      dG[j]  * (nodevec[face[2]].z - nodevec[face[3]].z));
-
-			Node dDx2F(
-				(1.0 - dG[i]) * (nodevec[face[3]].x - nodevec[face[0]].x)
-				+      dG[i]  * (nodevec[face[2]].x - nodevec[face[1]].x),
-				(1.0 - dG[i]) * (nodevec[face[3]].y - nodevec[face[0]].y)
-				+      dG[i]  * (nodevec[face[2]].y - nodevec[face[1]].y),
-				(1.0 - dG[i]) * (nodevec[face[3]].z - nodevec[face[0]].z)
-				+      dG[i]  * (nodevec[face[2]].z - nodevec[face[1]].z));
-
-			// Pointwise basis vectors in spherical geometry
-			double dDenomTerm = 1.0 / (dR * dR * dR);
-
-			Node dDx1G(
-				- dXc * (dYc * dDx1F.y + dZc * dDx1F.z)
-					+ (dYc * dYc + dZc * dZc) * dDx1F.x,
-				- dYc * (dXc * dDx1F.x + dZc * dDx1F.z)
-					+ (dXc * dXc + dZc * dZc) * dDx1F.y,
-				- dZc * (dXc * dDx1F.x + dYc * dDx1F.y)
-					+ (dXc * dXc + dYc * dYc) * dDx1F.z);
-
-			Node dDx2G(
-				- dXc * (dYc * dDx2F.y + dZc * dDx2F.z)
-					+ (dYc * dYc + dZc * dZc) * dDx2F.x,
-				- dYc * (dXc * dDx2F.x + dZc * dDx2F.z)
-					+ (dXc * dXc + dZc * dZc) * dDx2F.y,
-				- dZc * (dXc * dDx2F.x + dYc * dDx2F.y)
-					+ (dXc * dXc + dYc * dYc) * dDx2F.z);
-
-			dDx1G.x *= dDenomTerm;
-			dDx1G.y *= dDenomTerm;
-			dDx1G.z *= dDenomTerm;
-
-			dDx2G.x *= dDenomTerm;
-			dDx2G.y *= dDenomTerm;
-			dDx2G.z *= dDenomTerm;
-*/
-			// Get local map vectors
-			Node nodeGLL;
-			Node dDx1G;
-			Node dDx2G;
-
-			ApplyLocalMap(
-				face,
-				nodevec,
-				dG[i],
-				dG[j],
-				nodeGLL,
-				dDx1G,
-				dDx2G);
-
-			// Determine if this is a unique Node
-			dataGLLnodes[j][i][k] = nt.find_or_insert(nodeGLL, nt.size()+1);
-
-			// Cross product gives local Jacobian
-			Node nodeCross = CrossProduct(dDx1G, dDx2G);
-
-			double dJacobian = sqrt(
-				  nodeCross.x * nodeCross.x
-				+ nodeCross.y * nodeCross.y
-				+ nodeCross.z * nodeCross.z);
-
-			// Element area weighted by local GLL weights
-			dJacobian *= dW[i] * dW[j];
-
-			if (dJacobian <= 0.0) {
-				_EXCEPTIONT("Nonpositive Jacobian detected");
+			EdgeMapConstIterator iter = mesh.edgemap.find(face.edges[e]);
+			if (iter == mesh.edgemap.end()) {
+				if (lf < lFirstMissingEdge) {
+					lFirstMissingEdge = lf;
+				}
+				vecFaceEdgeIx[4 * lf + e] = InvalidNode;
+			} else {
+				vecFaceEdgeIx[4 * lf + e] =
+					static_cast<int>(iter - mesh.edgemap.begin());
 			}
+		}
+	}
+
+	if (lFirstNonQuad != lNoElement) {
+		_EXCEPTIONT("Mesh must only contain quadrilateral elements");
+	}
+	if (lFirstMissingEdge != lNoElement) {
+		_EXCEPTION1("Edge of face %li not found in edge map; "
+			"Mesh::ConstructEdgeMap() must be called after the last "
+			"change to the mesh", lFirstMissingEdge);
+	}
+
+	// Each shared GLL node is owned by the first element that references
+	// it, which numbers unique nodes in order of first appearance
+	std::vector<long> vecNodeOwnerSlot(mesh.nodes.size(), -1);
+	std::vector<long> vecEdgeOwner(mesh.edgemap.size(), -1);
 
-			dFaceNumericalArea += dJacobian;
+	for (long lf = 0; lf < lNoElement; lf++) {
+		const Face & face = mesh.faces[lf];
+		const long lSlotBase = lf * nPoints;
 
-			dataGLLJacobian[j][i][k] = dJacobian;
+		if (vecNodeOwnerSlot[face[0]] == -1) {
+			vecNodeOwnerSlot[face[0]] = lSlotBase;
 		}
+		if (vecNodeOwnerSlot[face[1]] == -1) {
+			vecNodeOwnerSlot[face[1]] = lSlotBase + nP - 1;
+		}
+		if (vecNodeOwnerSlot[face[3]] == -1) {
+			vecNodeOwnerSlot[face[3]] = lSlotBase + (nP - 1) * nP;
+		}
+		if (vecNodeOwnerSlot[face[2]] == -1) {
+			vecNodeOwnerSlot[face[2]] = lSlotBase + nPoints - 1;
+		}
+
+		for (int e = 0; e < 4; e++) {
+			int ixEdge = vecFaceEdgeIx[4 * lf + e];
+			if (ixEdge == InvalidNode) {
+				continue;
+			}
+			if (vecEdgeOwner[ixEdge] == -1) {
+				vecEdgeOwner[ixEdge] = 4 * lf + e;
+			}
+		}
+	}
+
+	// Jacobian and number of owned GLL nodes in each element
+	std::vector<double> vecFaceNumericalArea(nElements);
+	std::vector<int> vecOwnedCount(nElements);
+
+	long lFirstNonpositive = lNoElement;
+	long lFirstBubbleFailure = lNoElement;
+
+#pragma omp parallel reduction(min:lFirstNonpositive,lFirstBubbleFailure)
+	{
+		std::vector<double> dJacobian(nPoints);
+
+#pragma omp for
+	for (long lf = 0; lf < lNoElement; lf++) {
+		const Face & face = mesh.faces[lf];
+
+		CalculateGLLJacobian(
+			face,
+			mesh.nodes,
+			nP,
+			&(dAlphaPoints[0]),
+			&(dBetaPoints[0]),
+			&(dWeightPoints[0]),
+			&(dJacobian[0]));
+
+		double dFaceNumericalArea = 0.0;
+
+		// The Jacobian vanishes along degenerate edges
+		bool fNonpositive = false;
+		for (int s = 0; s < nPoints; s++) {
+			if (dJacobian[s] <= 0.0) {
+				int iLocal;
+				int t;
+				GLLSlotType eType = ClassifyGLLSlot(nP, s % nP, s / nP, iLocal, t);
+
+				bool fDegenerate = false;
+				if (eType == GLLSlotType_Edge) {
+					fDegenerate = (face[iLocal] == face[(iLocal + 1) % 4]);
+				} else if (eType == GLLSlotType_Corner) {
+					fDegenerate =
+						(face[iLocal] == face[(iLocal + 1) % 4]) ||
+						(face[iLocal] == face[(iLocal + 3) % 4]);
+				}
+				if ((dJacobian[s] < 0.0) || !fDegenerate) {
+					fNonpositive = true;
+					break;
+				}
+			}
+			dFaceNumericalArea += dJacobian[s];
+		}
+		if (fNonpositive) {
+			if (lf < lFirstNonpositive) {
+				lFirstNonpositive = lf;
+			}
+			continue;
 		}
 
 		// Apply bubble adjustment to area
-		if (fBubble && (dFaceNumericalArea != mesh.vecFaceArea[k])) {
+		if (fBubble && (dFaceNumericalArea != mesh.vecFaceArea[lf])) {
+
+			double dMassDifference = mesh.vecFaceArea[lf] - dFaceNumericalArea;
 
 			// Use uniform bubble for linear elements
 			if (nP < 3) {
-				double dMassDifference = mesh.vecFaceArea[k] - dFaceNumericalArea;
 				for (int j = 0; j < nP; j++) {
 				for (int i = 0; i < nP; i++) {
-					dataGLLJacobian[j][i][k] +=
-						dMassDifference * dW[i] * dW[j];
- 				}
+					dJacobian[j * nP + i] += dMassDifference * dW[i] * dW[j];
+				}
 				}
-
-				dFaceNumericalArea += dMassDifference;
 
 			// Use HOMME bubble for higher order elements
 			} else {
-			    double dMassDifference = mesh.vecFaceArea[k] - dFaceNumericalArea;
-
-			    double dInteriorMassSum = 0;
+				double dInteriorMassSum = 0;
 				for (int i = 1; i < nP-1; i++) {
 				for (int j = 1; j < nP-1; j++) {
-						dInteriorMassSum += dataGLLJacobian[i][j][k];
+					dInteriorMassSum += dJacobian[i * nP + j];
 				}
 				}
 
 				// Check that dInteriorMassSum is not too small
 				if (std::abs(dInteriorMassSum) < 1e-15) {
-					_EXCEPTIONT("--bubble correction cannot be performed, "
-						"sum of inner weights is too small");
+					if (lf < lFirstBubbleFailure) {
+						lFirstBubbleFailure = lf;
+					}
+					continue;
 				}
 
 				dInteriorMassSum = dMassDifference / dInteriorMassSum;
 				for (int j = 1; j < nP-1; j++) {
 				for (int i = 1; i < nP-1; i++) {
-					dataGLLJacobian[j][i][k] *= 1.0 + dInteriorMassSum;
+					dJacobian[j * nP + i] *= 1.0 + dInteriorMassSum;
 				}
 				}
-/*
-				double dNewMassSum = 0;
-				for (int j = 0; j < nP; j++) {
-				for (int i = 0; i < nP; i++) {
-					dNewMassSum += dataGLLJacobian[j][i][k];
+			}
+
+			dFaceNumericalArea += dMassDifference;
+		}
+
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			dataGLLJacobian[j][i][lf] = dJacobian[j * nP + i];
+		}
+		}
+
+		vecFaceNumericalArea[lf] = dFaceNumericalArea;
+
+		// Count GLL nodes owned by this element
+		int nOwned = (nP - 2) * (nP - 2);
+		const long lSlotBase = lf * nPoints;
+
+		if (vecNodeOwnerSlot[face[0]] == lSlotBase) {
+			nOwned++;
+		}
+		if (vecNodeOwnerSlot[face[1]] == lSlotBase + nP - 1) {
+			nOwned++;
+		}
+		if (vecNodeOwnerSlot[face[3]] == lSlotBase + (nP - 1) * nP) {
+			nOwned++;
+		}
+		if (vecNodeOwnerSlot[face[2]] == lSlotBase + nPoints - 1) {
+			nOwned++;
+		}
+		for (int e = 0; e < 4; e++) {
+			int ixEdge = vecFaceEdgeIx[4 * lf + e];
+			if ((ixEdge != InvalidNode) && (vecEdgeOwner[ixEdge] == 4 * lf + e)) {
+				nOwned += nP - 2;
+			}
+		}
+		vecOwnedCount[lf] = nOwned;
+	}
+	}
+
+	if ((lFirstNonpositive != lNoElement) &&
+	    (lFirstNonpositive <= lFirstBubbleFailure)
+	) {
+		_EXCEPTION1("Nonpositive Jacobian detected in face %li",
+			lFirstNonpositive);
+	}
+	if (lFirstBubbleFailure != lNoElement) {
+		_EXCEPTIONT("--bubble correction cannot be performed, "
+			"sum of inner weights is too small");
+	}
+
+	// Offset of the first unique GLL node owned by each element
+	std::vector<int> vecOwnedOffset(nElements);
+	{
+		long lOffset = 0;
+		for (int k = 0; k < nElements; k++) {
+			vecOwnedOffset[k] = static_cast<int>(lOffset);
+			lOffset += vecOwnedCount[k];
+		}
+		if (lOffset > static_cast<long>(std::numeric_limits<int>::max())) {
+			_EXCEPTION1("Too many unique GLL nodes (%li)", lOffset);
+		}
+	}
+
+	// Number owned GLL nodes in order of appearance within each element
+#pragma omp parallel for
+	for (long lf = 0; lf < lNoElement; lf++) {
+		const Face & face = mesh.faces[lf];
+		const long lSlotBase = lf * nPoints;
+
+		int ixNext = vecOwnedOffset[lf] + 1;
+
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			int iLocal;
+			int t;
+			GLLSlotType eType = ClassifyGLLFaceSlot(face, nP, i, j, iLocal, t);
+
+			bool fOwned = true;
+			if (eType == GLLSlotType_Corner) {
+				fOwned = (vecNodeOwnerSlot[face[iLocal]]
+					== lSlotBase + j * nP + i);
+			} else if (eType == GLLSlotType_Edge) {
+				fOwned = (vecEdgeOwner[vecFaceEdgeIx[4 * lf + iLocal]]
+					== 4 * lf + iLocal);
+			}
+
+			if (fOwned) {
+				dataGLLnodes[j][i][lf] = ixNext;
+				ixNext++;
+			}
+		}
+		}
+	}
+
+	// Copy indices of shared GLL nodes from their owners
+#pragma omp parallel for
+	for (long lf = 0; lf < lNoElement; lf++) {
+		const Face & face = mesh.faces[lf];
+		const long lSlotBase = lf * nPoints;
+
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			int iLocal;
+			int t;
+			GLLSlotType eType = ClassifyGLLFaceSlot(face, nP, i, j, iLocal, t);
+
+			if (eType == GLLSlotType_Corner) {
+				long lOwnerSlot = vecNodeOwnerSlot[face[iLocal]];
+				if (lOwnerSlot == lSlotBase + j * nP + i) {
+					continue;
+				}
+				long lOwnerFace = lOwnerSlot / nPoints;
+				int iOwner = static_cast<int>(lOwnerSlot % nPoints) % nP;
+				int jOwner = static_cast<int>(lOwnerSlot % nPoints) / nP;
+
+				dataGLLnodes[j][i][lf] =
+					dataGLLnodes[jOwner][iOwner][lOwnerFace];
+
+			} else if (eType == GLLSlotType_Edge) {
+				long lOwner = vecEdgeOwner[vecFaceEdgeIx[4 * lf + iLocal]];
+				if (lOwner == 4 * lf + iLocal) {
+					continue;
 				}
+				long lOwnerFace = lOwner / 4;
+				int iOwnerEdge = static_cast<int>(lOwner % 4);
+
+				// Position along the edge measured from its smaller node
+				int tCanonical = t;
+				if (face[iLocal] > face[(iLocal + 1) % 4]) {
+					tCanonical = nP - 1 - t;
 				}
 
-				std::cout << "New mass  -  true mass " << dNewMassSum - mesh.vecFaceArea[k] << "\n";
+				const Face & faceOwner = mesh.faces[lOwnerFace];
+				int tOwner = tCanonical;
+				if (faceOwner[iOwnerEdge] > faceOwner[(iOwnerEdge + 1) % 4]) {
+					tOwner = nP - 1 - tCanonical;
+				}
 
-				std::cout << "New mass = " << dNewMassSum << ", true mass = " << mesh.vecFaceArea[k] << "\n";
-*/
-				dFaceNumericalArea += dMassDifference;
+				int iOwner;
+				int jOwner;
+				GetGLLEdgeSlot(nP, iOwnerEdge, tOwner, iOwner, jOwner);
+
+				dataGLLnodes[j][i][lf] =
+					dataGLLnodes[jOwner][iOwner][lOwnerFace];
 			}
 		}
+		}
+	}
 
-		// Accumulate area from element
-		dAccumulatedJacobian += dFaceNumericalArea;
+	// Accumulate area from elements
+	double dAccumulatedJacobian = 0.0;
+	for (int k = 0; k < nElements; k++) {
+		dAccumulatedJacobian += vecFaceNumericalArea[k];
 	}
 
 	return dAccumulatedJacobian;
@@ -554,124 +1200,250 @@ void GenerateDiscontinuousJacobian(
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		Global coefficient arrays (kept global to minimize reallocation)
+///		GLL nodes and barycentric weights on [0,1], computed once per
+///		order and shared between threads.
 ///	</summary>
-DataArray1D<double> g_dCoeffAlpha;
-DataArray1D<double> g_dCoeffBeta;
+class GLLBarycentricWeights {
+
+public:
+	///	<summary>
+	///		Orders that are computed together on first use.  Higher orders
+	///		are computed on demand and memoized.
+	///	</summary>
+	static const int TabulatedMaxOrder = 16;
+
+public:
+	///	<summary>
+	///		Get the weights for the given order.  The returned reference
+	///		remains valid for the lifetime of the program.
+	///	</summary>
+	static const GLLBarycentricWeights & Get(
+		int nP
+	) {
+		if (nP < 1) {
+			_EXCEPTION1("Invalid finite element order (%i)", nP);
+		}
 
-void SampleGLLFiniteElement(
+		if (nP <= TabulatedMaxOrder) {
+			static const std::vector<GLLBarycentricWeights> s_vecTable =
+				BuildTable();
+
+			return s_vecTable[nP-1];
+		}
+
+		static std::mutex s_mutex;
+		static std::map<int, GLLBarycentricWeights> s_mapWeights;
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		std::map<int, GLLBarycentricWeights>::iterator iter =
+			s_mapWeights.find(nP);
+
+		if (iter == s_mapWeights.end()) {
+			iter = s_mapWeights.insert(
+				std::pair<int, GLLBarycentricWeights>(
+					nP, GLLBarycentricWeights(nP))).first;
+		}
+		return iter->second;
+	}
+
+private:
+	///	<summary>
+	///		Build the table of weights for orders 1 through
+	///		TabulatedMaxOrder.
+	///	</summary>
+	static std::vector<GLLBarycentricWeights> BuildTable() {
+		std::vector<GLLBarycentricWeights> vecTable;
+		vecTable.reserve(TabulatedMaxOrder);
+
+		for (int n = 1; n <= TabulatedMaxOrder; n++) {
+			vecTable.push_back(GLLBarycentricWeights(n));
+		}
+
+		return vecTable;
+	}
+
+	///	<summary>
+	///		Compute the nodes and weights for the given order.
+	///	</summary>
+	explicit GLLBarycentricWeights(
+		int n
+	) :
+		m_nP(n),
+		m_dG(n),
+		m_dW(n)
+	{
+		if (n == 1) {
+			m_dG[0] = 0.5;
+			m_dW[0] = 1.0;
+			return;
+		}
+
+		DataArray1D<double> dG;
+		GetDefaultNodalLocations(n, dG);
+
+		// Barycentric weights.  Node differences are scaled by 4 (the
+		// inverse capacity of [0,1]) so that products neither underflow
+		// nor overflow at high order, and the weights are then normalized
+		// by their maximum; both factors cancel in evaluation.
+		double dMaxW = 0.0;
+		for (int i = 0; i < n; i++) {
+			m_dG[i] = dG[i];
+
+			double dProd = 1.0;
+			for (int k = 0; k < n; k++) {
+				if (k != i) {
+					dProd *= 4.0 * (dG[i] - dG[k]);
+				}
+			}
+			m_dW[i] = 1.0 / dProd;
+
+			if (fabs(m_dW[i]) > dMaxW) {
+				dMaxW = fabs(m_dW[i]);
+			}
+		}
+		for (int i = 0; i < n; i++) {
+			m_dW[i] /= dMaxW;
+		}
+	}
+
+public:
+	///	<summary>
+	///		Number of nodes.
+	///	</summary>
+	int m_nP;
+
+	///	<summary>
+	///		GLL nodes on [0,1].
+	///	</summary>
+	std::vector<double> m_dG;
+
+	///	<summary>
+	///		Barycentric weights associated with each node.
+	///	</summary>
+	std::vector<double> m_dW;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that SampleGLLFiniteElement supports the given monotone type
+///		and order, so that the per-point kernel never needs to throw.
+///	</summary>
+static void ValidateGLLSampleType(
+	int nMonotoneType,
+	int nP
+) {
+	if ((nMonotoneType < 0) || (nMonotoneType > 3)) {
+		_EXCEPTIONT("Invalid monotone type");
+	}
+	if (nMonotoneType == 0) {
+		if ((nP < 2) || (nP > 4)) {
+			GLLBarycentricWeights::Get(nP);
+		}
+	} else if ((nP < 2) || (nP > 4)) {
+		_EXCEPTIONT("Not implemented");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute the one-dimensional sampling coefficients at dX in [0,1].
+///		The tensor product of the coefficients in each direction gives the
+///		coefficients of the two-dimensional element.  The order and
+///		monotone type must already have been validated and dCoeff must
+///		have room for nP values.
+///	</summary>
+static void SampleGLLFiniteElement1D(
 	int nMonotoneType,
 	int nP,
-	double dAlpha,
-	double dBeta,
-	DataArray2D<double> & dCoeff
+	double dX,
+	double * dCoeff
 ) {
-	// Interpolation coefficients
-	g_dCoeffAlpha.Allocate(nP);
-	g_dCoeffBeta.Allocate(nP);
+	for (int i = 0; i < nP; i++) {
+		dCoeff[i] = 0.0;
+	}
 
-	// Non-monotone interpolation
-	if (nMonotoneType == 0) {
+	// Non-monotone interpolation at arbitrary order via the barycentric
+	// form of the Lagrange polynomials
+	if ((nMonotoneType == 0) && ((nP < 2) || (nP > 4))) {
+		const GLLBarycentricWeights & bary = GLLBarycentricWeights::Get(nP);
 
-		if (nP > 4) {
-			// GLL Quadrature nodes on [0,1]
-			DataArray1D<double> dG;
-			GetDefaultNodalLocations(nP, dG);
-			//DataArray1D<double> dW;
-			//GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
+		// Sample point coincides with a node
+		for (int i = 0; i < nP; i++) {
+			if (dX == bary.m_dG[i]) {
+				dCoeff[i] = 1.0;
+				return;
+			}
+		}
 
-			// Get interpolation coefficients in each direction
-			PolynomialInterp::LagrangianPolynomialCoeffs(
-				nP, dG, g_dCoeffAlpha, dAlpha);
+		double dSum = 0.0;
+#pragma omp simd reduction(+:dSum)
+		for (int i = 0; i < nP; i++) {
+			dCoeff[i] = bary.m_dW[i] / (dX - bary.m_dG[i]);
+			dSum += dCoeff[i];
+		}
 
-			PolynomialInterp::LagrangianPolynomialCoeffs(
-				nP, dG, g_dCoeffBeta, dBeta);
+		const double dInvSum = 1.0 / dSum;
+#pragma omp simd
+		for (int i = 0; i < nP; i++) {
+			dCoeff[i] *= dInvSum;
 		}
+		return;
+	}
 
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
+	// Map dX to [-1,1]
+	dX = 2.0 * dX - 1.0;
 
-		// Second order monotone interpolation
-		if (nP == 2) {
-			g_dCoeffAlpha[0] = 0.5 * (1.0 - dAlpha);
-			g_dCoeffAlpha[1] = 0.5 * (1.0 + dAlpha);
+	// Non-monotone interpolation
+	if (nMonotoneType == 0) {
 
-			g_dCoeffBeta[0] = 0.5 * (1.0 - dBeta);
-			g_dCoeffBeta[1] = 0.5 * (1.0 + dBeta);
+		// Second order interpolation
+		if (nP == 2) {
+			dCoeff[0] = 0.5 * (1.0 - dX);
+			dCoeff[1] = 0.5 * (1.0 + dX);
 
 		// Third order interpolation
 		} else if (nP == 3) {
-			g_dCoeffAlpha[0] = 0.5 * (dAlpha * dAlpha - dAlpha);
-			g_dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
-			g_dCoeffAlpha[2] = 0.5 * (dAlpha * dAlpha + dAlpha);
-
-			g_dCoeffBeta[0] = 0.5 * (dBeta * dBeta - dBeta);
-			g_dCoeffBeta[1] = 1.0 - dBeta * dBeta;
-			g_dCoeffBeta[2] = 0.5 * (dBeta * dBeta + dBeta);
+			dCoeff[0] = 0.5 * (dX * dX - dX);
+			dCoeff[1] = 1.0 - dX * dX;
+			dCoeff[2] = 0.5 * (dX * dX + dX);
 
 		// Fourth order interpolation
-		} else if (nP == 4) {
-			g_dCoeffAlpha[0] = -1.0/8.0
-				* (dAlpha - 1.0) * (5.0 * dAlpha * dAlpha - 1.0);
-			g_dCoeffAlpha[1] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) - 5.0 * dAlpha)
-				* (dAlpha * dAlpha - 1.0);
-			g_dCoeffAlpha[2] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) + 5.0 * dAlpha)
-				* (dAlpha * dAlpha - 1.0);
-			g_dCoeffAlpha[3] =  1.0/8.0
-				* (dAlpha + 1.0) * (5.0 * dAlpha * dAlpha - 1.0);
-
-			g_dCoeffBeta[0] = -1.0/8.0
-				* (dBeta - 1.0) * (5.0 * dBeta * dBeta - 1.0);
-			g_dCoeffBeta[1] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) - 5.0 * dBeta)
-				* (dBeta * dBeta - 1.0);
-			g_dCoeffBeta[2] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) + 5.0 * dBeta)
-				* (dBeta * dBeta - 1.0);
-			g_dCoeffBeta[3] =  1.0/8.0
-				* (dBeta + 1.0) * (5.0 * dBeta * dBeta - 1.0);
+		} else {
+			dCoeff[0] = -1.0/8.0
+				* (dX - 1.0) * (5.0 * dX * dX - 1.0);
+			dCoeff[1] = - sqrt(5.0)/8.0
+				* (sqrt(5.0) - 5.0 * dX)
+				* (dX * dX - 1.0);
+			dCoeff[2] = - sqrt(5.0)/8.0
+				* (sqrt(5.0) + 5.0 * dX)
+				* (dX * dX - 1.0);
+			dCoeff[3] =  1.0/8.0
+				* (dX + 1.0) * (5.0 * dX * dX - 1.0);
 		}
 
 	// Standard monotone interpolation
 	} else if (nMonotoneType == 1) {
 
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
-
 		// Second order monotone interpolation
 		if (nP == 2) {
-
-			g_dCoeffAlpha[0] = 0.5 * (1.0 - dAlpha);
-			g_dCoeffAlpha[1] = 0.5 * (1.0 + dAlpha);
-
-			g_dCoeffBeta[0] = 0.5 * (1.0 - dBeta);
-			g_dCoeffBeta[1] = 0.5 * (1.0 + dBeta);
+			dCoeff[0] = 0.5 * (1.0 - dX);
+			dCoeff[1] = 0.5 * (1.0 + dX);
 
 		// Third order monotone interpolation
 		} else if (nP == 3) {
-
-			if (dAlpha < 0.0) {
-				g_dCoeffAlpha[0] = dAlpha * dAlpha;
-				g_dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
+			if (dX < 0.0) {
+				dCoeff[0] = dX * dX;
+				dCoeff[1] = 1.0 - dX * dX;
 			} else {
-				g_dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
-				g_dCoeffAlpha[2] = dAlpha * dAlpha;
-			}
-			if (dBeta < 0.0) {
-				g_dCoeffBeta[0] = dBeta * dBeta;
-				g_dCoeffBeta[1] = 1.0 - dBeta * dBeta;
-			} else {
-				g_dCoeffBeta[1] = 1.0 - dBeta * dBeta;
-				g_dCoeffBeta[2] = dBeta * dBeta;
+				dCoeff[1] = 1.0 - dX * dX;
+				dCoeff[2] = dX * dX;
 			}
 
 		// Fourth order monotone interpolation
-		} else if (nP == 4) {
-
+		} else {
 			const double dGLL1 = 1.0/sqrt(5.0);
 
 			const double dA0 = (1.0 + sqrt(5.0)) / 16.0;
@@ -684,208 +1456,116 @@ void SampleGLLFiniteElement(
 			const double dC1 = 0.0;
 			const double dD1 = (5.0 / 4.0) * sqrt(5.0);
 
-			if ((dAlpha >= -dGLL1) && (dAlpha <= dGLL1)) {
-				g_dCoeffAlpha[1] =
-					dA1 + dAlpha * (dB1 + dAlpha * (dC1 + dAlpha * dD1));
-				g_dCoeffAlpha[2] =
-					1.0 - g_dCoeffAlpha[1];
-			} else if (dAlpha < -dGLL1) {
-				g_dCoeffAlpha[0] =
-					dA0 + dAlpha * (dB0 + dAlpha * (dC0 + dAlpha * dD0));
-				g_dCoeffAlpha[1] =
-					1.0 - g_dCoeffAlpha[0];
-			} else {
-				g_dCoeffAlpha[3] =
-					dA0 - dAlpha * (dB0 - dAlpha * (dC0 - dAlpha * dD0));
-				g_dCoeffAlpha[2] =
-					1.0 - g_dCoeffAlpha[3];
-			}
-
-			if ((dBeta >= -dGLL1) && (dBeta <= dGLL1)) {
-				g_dCoeffBeta[1] =
-					dA1 + dBeta * (dB1 + dBeta * (dC1 + dBeta * dD1));
-				g_dCoeffBeta[2] =
-					1.0 - g_dCoeffBeta[1];
-			} else if (dBeta < -dGLL1) {
-				g_dCoeffBeta[0] =
-					dA0 + dBeta * (dB0 + dBeta * (dC0 + dBeta * dD0));
-				g_dCoeffBeta[1] =
-					1.0 - g_dCoeffBeta[0];
+			if ((dX >= -dGLL1) && (dX <= dGLL1)) {
+				dCoeff[1] = dA1 + dX * (dB1 + dX * (dC1 + dX * dD1));
+				dCoeff[2] = 1.0 - dCoeff[1];
+			} else if (dX < -dGLL1) {
+				dCoeff[0] = dA0 + dX * (dB0 + dX * (dC0 + dX * dD0));
+				dCoeff[1] = 1.0 - dCoeff[0];
 			} else {
-				g_dCoeffBeta[3] =
-					dA0 - dBeta * (dB0 - dBeta * (dC0 - dBeta * dD0));
-				g_dCoeffBeta[2] =
-					1.0 - g_dCoeffBeta[3];
+				dCoeff[3] = dA0 - dX * (dB0 - dX * (dC0 - dX * dD0));
+				dCoeff[2] = 1.0 - dCoeff[3];
 			}
-
-		} else {
-			_EXCEPTIONT("Not implemented");
 		}
 
 	// Piecewise constant monotone interpolation
 	} else if (nMonotoneType == 2) {
 
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
-
 		// Second order monotone interpolation
 		if (nP == 2) {
-
-			g_dCoeffAlpha.Zero();
-			g_dCoeffBeta.Zero();
-
-			if (dAlpha < 0.0) {
-				g_dCoeffAlpha[0] = 1.0;
+			if (dX < 0.0) {
+				dCoeff[0] = 1.0;
 			} else {
-				g_dCoeffAlpha[1] = 1.0;
-			}
-			if (dBeta < 0.0) {
-				g_dCoeffBeta[0] = 1.0;
-			} else {
-				g_dCoeffBeta[1] = 1.0;
+				dCoeff[1] = 1.0;
 			}
 
 		// Third order monotone interpolation
 		} else if (nP == 3) {
-
-			g_dCoeffAlpha.Zero();
-			g_dCoeffBeta.Zero();
-
-			if (dAlpha < -2.0/3.0) {
-				g_dCoeffAlpha[0] = 1.0;
-			} else if (dAlpha <= 2.0/3.0) {
-				g_dCoeffAlpha[1] = 1.0;
-			} else {
-				g_dCoeffAlpha[2] = 1.0;
-			}
-			if (dBeta < -2.0/3.0) {
-				g_dCoeffBeta[0] = 1.0;
-			} else if (dBeta <= 2.0/3.0) {
-				g_dCoeffBeta[1] = 1.0;
+			if (dX < -2.0/3.0) {
+				dCoeff[0] = 1.0;
+			} else if (dX <= 2.0/3.0) {
+				dCoeff[1] = 1.0;
 			} else {
-				g_dCoeffBeta[2] = 1.0;
+				dCoeff[2] = 1.0;
 			}
 
 		// Fourth order monotone interpolation
-		} else if (nP == 4) {
-
-			g_dCoeffAlpha.Zero();
-			g_dCoeffBeta.Zero();
-
-			if (dAlpha < -5.0/6.0) {
-				g_dCoeffAlpha[0] = 1.0;
-			} else if (dAlpha <= 0.0) {
-				g_dCoeffAlpha[1] = 1.0;
-			} else if (dAlpha <= 5.0/6.0) {
-				g_dCoeffAlpha[2] = 1.0;
-			} else {
-				g_dCoeffAlpha[3] = 1.0;
-			}
-
-			if (dBeta < -5.0/6.0) {
-				g_dCoeffBeta[0] = 1.0;
-			} else if (dBeta <= 0.0) {
-				g_dCoeffBeta[1] = 1.0;
-			} else if (dBeta <= 5.0/6.0) {
-				g_dCoeffBeta[2] = 1.0;
+		} else {
+			if (dX < -5.0/6.0) {
+				dCoeff[0] = 1.0;
+			} else if (dX <= 0.0) {
+				dCoeff[1] = 1.0;
+			} else if (dX <= 5.0/6.0) {
+				dCoeff[2] = 1.0;
 			} else {
-				g_dCoeffBeta[3] = 1.0;
+				dCoeff[3] = 1.0;
 			}
-
-		} else {
-			_EXCEPTIONT("Not implemented");
 		}
 
 	// Piecewise linear monotone interpolation
-	} else if (nMonotoneType == 3) {
-
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
+	} else {
 
 		// Second order monotone interpolation
 		if (nP == 2) {
-
-			g_dCoeffAlpha[0] = 0.5 * (1.0 - dAlpha);
-			g_dCoeffAlpha[1] = 0.5 * (1.0 + dAlpha);
-
-			g_dCoeffBeta[0] = 0.5 * (1.0 - dBeta);
-			g_dCoeffBeta[1] = 0.5 * (1.0 + dBeta);
+			dCoeff[0] = 0.5 * (1.0 - dX);
+			dCoeff[1] = 0.5 * (1.0 + dX);
 
 		// Third order monotone interpolation
 		} else if (nP == 3) {
-
-			if (dAlpha < 0.0) {
-				g_dCoeffAlpha[0] = - dAlpha;
-				g_dCoeffAlpha[1] = 1.0 + dAlpha;
-			} else {
-				g_dCoeffAlpha[1] = 1.0 - dAlpha;
-				g_dCoeffAlpha[2] = dAlpha;
-			}
-			if (dBeta < 0.0) {
-				g_dCoeffBeta[0] = - dBeta;
-				g_dCoeffBeta[1] = 1.0 + dBeta;
+			if (dX < 0.0) {
+				dCoeff[0] = - dX;
+				dCoeff[1] = 1.0 + dX;
 			} else {
-				g_dCoeffBeta[1] = 1.0 - dBeta;
-				g_dCoeffBeta[2] = dBeta;
+				dCoeff[1] = 1.0 - dX;
+				dCoeff[2] = dX;
 			}
 
 		// Fourth order monotone interpolation
-		} else if (nP == 4) {
-
+		} else {
 			const double dGLL1 = 1.0/sqrt(5.0);
 
 			const double dA = 5.0 + sqrt(5.0);
 
-			if (dAlpha < -dGLL1) {
-				g_dCoeffAlpha[0] =
-					-1.0 / 20.0 * dA * (5.0 * dAlpha + sqrt(5.0));
-				g_dCoeffAlpha[1] =
-					1.0 / 4.0 * dA * (dAlpha + 1.0);
+			if (dX < -dGLL1) {
+				dCoeff[0] = -1.0 / 20.0 * dA * (5.0 * dX + sqrt(5.0));
+				dCoeff[1] = 1.0 / 4.0 * dA * (dX + 1.0);
 
-			} else if (dAlpha < dGLL1) {
-				g_dCoeffAlpha[1] = 0.5 * (1.0 - sqrt(5.0) * dAlpha);
-				g_dCoeffAlpha[2] = 0.5 * (1.0 + sqrt(5.0) * dAlpha);
+			} else if (dX < dGLL1) {
+				dCoeff[1] = 0.5 * (1.0 - sqrt(5.0) * dX);
+				dCoeff[2] = 0.5 * (1.0 + sqrt(5.0) * dX);
 
 			} else {
-				g_dCoeffAlpha[2] =
-					- 1.0 / 4.0 * dA * (dAlpha - 1.0);
-				g_dCoeffAlpha[3] =
-					- 1.0 / 20.0 * dA * (-5.0 * dAlpha + sqrt(5.0));
+				dCoeff[2] = - 1.0 / 4.0 * dA * (dX - 1.0);
+				dCoeff[3] = - 1.0 / 20.0 * dA * (-5.0 * dX + sqrt(5.0));
 			}
+		}
+	}
+}
 
-			if (dBeta < -dGLL1) {
-				g_dCoeffBeta[0] =
-					-1.0 / 20.0 * dA * (5.0 * dBeta + sqrt(5.0));
-				g_dCoeffBeta[1] =
-					1.0 / 4.0 * dA * (dBeta + 1.0);
-
-			} else if (dBeta < dGLL1) {
-				g_dCoeffBeta[1] = 0.5 * (1.0 - sqrt(5.0) * dBeta);
-				g_dCoeffBeta[2] = 0.5 * (1.0 + sqrt(5.0) * dBeta);
+///////////////////////////////////////////////////////////////////////////////
 
-			} else {
-				g_dCoeffBeta[2] =
-					- 1.0 / 4.0 * dA * (dBeta - 1.0);
-				g_dCoeffBeta[3] =
-					- 1.0 / 20.0 * dA * (-5.0 * dBeta + sqrt(5.0));
-			}
+void SampleGLLFiniteElement(
+	int nMonotoneType,
+	int nP,
+	double dAlpha,
+	double dBeta,
+	DataArray2D<double> & dCoeff
+) {
+	ValidateGLLSampleType(nMonotoneType, nP);
 
-		} else {
-			_EXCEPTIONT("Not implemented");
-		}
+	// Interpolation coefficients in each direction
+	std::vector<double> dCoeffAlpha(nP);
+	std::vector<double> dCoeffBeta(nP);
 
-	} else {
-		_EXCEPTIONT("Invalid monotone type");
-	}
+	SampleGLLFiniteElement1D(nMonotoneType, nP, dAlpha, &(dCoeffAlpha[0]));
+	SampleGLLFiniteElement1D(nMonotoneType, nP, dBeta, &(dCoeffBeta[0]));
 
 	// Combine coefficients
 	dCoeff.Allocate(nP, nP);
 
 	for (int i = 0; i < nP; i++) {
 	for (int j = 0; j < nP; j++) {
-		dCoeff[j][i] = g_dCoeffAlpha[i] * g_dCoeffBeta[j];
+		dCoeff[j][i] = dCoeffAlpha[i] * dCoeffBeta[j];
 	}
 	}
 /*
@@ -962,3 +1642,99 @@ void SampleGLLFiniteElement(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SampleGLLFiniteElement(
+	int nMonotoneType,
+	int nP,
+	size_t sCount,
+	const double * dAlpha,
+	const double * dBeta,
+	double * dCoeff
+) {
+	ValidateGLLSampleType(nMonotoneType, nP);
+
+	const size_t sBlockSize = static_cast<size_t>(nP) * nP;
+
+#pragma omp parallel
+	{
+		// Interpolation coefficients in each direction, allocated once
+		// per thread
+		std::vector<double> vecCoeffAlpha(nP);
+		std::vector<double> vecCoeffBeta(nP);
+
+		double * const dCoeffAlpha = &(vecCoeffAlpha[0]);
+		double * const dCoeffBeta = &(vecCoeffBeta[0]);
+
+#pragma omp for
+		for (long lf = 0; lf < static_cast<long>(sCount); lf++) {
+			SampleGLLFiniteElement1D(
+				nMonotoneType, nP, dAlpha[lf], dCoeffAlpha);
+			SampleGLLFiniteElement1D(
+				nMonotoneType, nP, dBeta[lf], dCoeffBeta);
+
+			double * dCoeffPoint = dCoeff + lf * sBlockSize;
+			for (int j = 0; j < nP; j++) {
+#pragma omp simd
+			for (int i = 0; i < nP; i++) {
+				dCoeffPoint[j * nP + i] = dCoeffAlpha[i] * dCoeffBeta[j];
+			}
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ApplyGLLFiniteElementSamples(
+	int nP,
+	const DataArray3D<int> & dataGLLnodes,
+	size_t sCount,
+	const int * iElement,
+	const double * dCoeff,
+	const double * dDataGLL,
+	double * dDataOut
+) {
+	const long lElements = static_cast<long>(dataGLLnodes.GetSubColumns());
+
+	if ((dataGLLnodes.GetRows() != static_cast<size_t>(nP)) ||
+	    (dataGLLnodes.GetColumns() != static_cast<size_t>(nP))
+	) {
+		_EXCEPTION2("GLL node array dimensions (%lu) do not match order (%i)",
+			dataGLLnodes.GetRows(), nP);
+	}
+
+	// Find the first sample referencing an invalid element
+	long lFirstInvalid = static_cast<long>(sCount);
+
+#pragma omp parallel for reduction(min:lFirstInvalid)
+	for (long lf = 0; lf < static_cast<long>(sCount); lf++) {
+		if ((iElement[lf] < 0) || (iElement[lf] >= lElements)) {
+			if (lf < lFirstInvalid) {
+				lFirstInvalid = lf;
+			}
+		}
+	}
+	if (lFirstInvalid != static_cast<long>(sCount)) {
+		_EXCEPTION3("Sample %li references element %i out of range [0,%li)",
+			lFirstInvalid, iElement[lFirstInvalid], lElements);
+	}
+
+	const size_t sBlockSize = static_cast<size_t>(nP) * nP;
+
+#pragma omp parallel for
+	for (long lf = 0; lf < static_cast<long>(sCount); lf++) {
+		const int k = iElement[lf];
+		const double * dCoeffPoint = dCoeff + lf * sBlockSize;
+
+		double dValue = 0.0;
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			dValue += dCoeffPoint[j * nP + i]
+				* dDataGLL[dataGLLnodes[j][i][k] - 1];
+		}
+		}
+		dDataOut[lf] = dValue;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -81,7 +81,32 @@ void ApplyInverseMap(
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		Generate Mesh meta data for a spectral element grid.
+///		Apply inverse map using Newton's method to sCount points, where
+///		point s with Cartesian coordinates (dX[s], dY[s], dZ[s]) is located
+///		in quadrilateral face iFace[s].  Points are solved in blocks of SIMD
+///		lanes that stop once every lane has converged, and blocks are
+///		distributed across threads.  Results are identical to the
+///		single-point version, which is retained for verification.
+///	</summary>
+void ApplyInverseMap(
+	const FaceVector & faces,
+	const NodeVector & nodes,
+	size_t sCount,
+	const int * iFace,
+	const double * dX,
+	const double * dY,
+	const double * dZ,
+	double * dAlpha,
+	double * dBeta
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate Mesh meta data for a spectral element grid.  GLL nodes
+///		shared between elements are identified by mesh topology, so the
+///		edge map must have been constructed.  GLL nodes on a degenerate
+///		edge (with a repeated node) are identified with that node.
 ///	</summary>
 double GenerateMetaData(
 	const Mesh & mesh,
@@ -128,3 +153,40 @@ void SampleGLLFiniteElement(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Get the coefficients for sampling a 2D finite element at sCount
+///		points.  The caller provides dCoeff with room for sCount * nP * nP
+///		values; the coefficients of point s are stored at
+///		dCoeff[s * nP * nP + j * nP + i], matching dCoeff[j][i] of the
+///		single-point version.  Points are processed in parallel and no
+///		memory is allocated per point.
+///	</summary>
+void SampleGLLFiniteElement(
+	int nMonotoneType,
+	int nP,
+	size_t sCount,
+	const double * dAlpha,
+	const double * dBeta,
+	double * dCoeff
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Evaluate a field stored on unique GLL nodes at sCount sample points,
+///		using the coefficients from the batched SampleGLLFiniteElement and
+///		the (0-indexed) element containing each point.  Coefficients can be
+///		reused across fields and time slices.
+///	</summary>
+void ApplyGLLFiniteElementSamples(
+	int nP,
+	const DataArray3D<int> & dataGLLnodes,
+	size_t sCount,
+	const int * iElement,
+	const double * dCoeff,
+	const double * dDataGLL,
+	double * dDataOut
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,558 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    FramePipeline.cpp
+///	\author  Paul Ullrich
+///	\version October 18, 2026
+///
+///	<remarks>
+///		Copyright 2026 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "FramePipeline.h"
+#include "GridRasterizer.h"
+#include "ColorMap.h"
+#include "Exception.h"
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdio>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Queues and bookkeeping shared by the threads of a FramePipeline.
+///		All members are guarded by mutex.
+///	</summary>
+struct FramePipelineQueues {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FramePipelineQueues(
+		size_t a_sFrameCount,
+		size_t a_sCapacity,
+		size_t a_sMaxInFlight
+	) :
+		sFrameCount(a_sFrameCount),
+		sCapacity(a_sCapacity),
+		sMaxInFlight(a_sMaxInFlight),
+		sInFlight(0),
+		sRendering(0),
+		sNextWrite(0),
+		fReadDone(false),
+		fWriting(false),
+		fAbort(false),
+		sErrorFrame(0)
+	{ }
+
+	///	<summary>
+	///		Record an error for the given frame and stop the pipeline.  The
+	///		error for the lowest frame index is kept.
+	///	</summary>
+	void Fail(
+		size_t sFrame,
+		const Exception & e
+	) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (vecError.size() == 0) {
+				vecError.push_back(e);
+				sErrorFrame = sFrame;
+			} else if (sFrame < sErrorFrame) {
+				vecError[0] = e;
+				sErrorFrame = sFrame;
+			}
+			fAbort = true;
+		}
+		cond.notify_all();
+	}
+
+	std::mutex mutex;
+	std::condition_variable cond;
+
+	///	<summary>
+	///		Frames that have been read and are waiting to be rendered.
+	///	</summary>
+	std::deque<FramePipelineFrame> dequeRender;
+
+	///	<summary>
+	///		Frames that have been rendered and are waiting to be encoded.
+	///	</summary>
+	std::deque<FramePipelineFrame> dequeEncode;
+
+	///	<summary>
+	///		Encoded frames waiting for all earlier frames to be written.
+	///	</summary>
+	std::map<size_t, std::vector<unsigned char> > mapEncoded;
+
+	size_t sFrameCount;
+	size_t sCapacity;
+	size_t sMaxInFlight;
+
+	///	<summary>
+	///		Number of frames read but not yet written.
+	///	</summary>
+	size_t sInFlight;
+
+	///	<summary>
+	///		Number of frames being rendered, each of which holds a slot in
+	///		the encode queue.
+	///	</summary>
+	size_t sRendering;
+
+	///	<summary>
+	///		Index of the next frame to write.
+	///	</summary>
+	size_t sNextWrite;
+
+	bool fReadDone;
+	bool fWriting;
+	bool fAbort;
+
+	size_t sErrorFrame;
+	std::vector<Exception> vecError;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FramePipeline
+///////////////////////////////////////////////////////////////////////////////
+
+FramePipeline::FramePipeline(
+	const GridRasterizer & rasterizer,
+	const ColorMapLUT & lut
+) :
+	m_rasterizer(rasterizer),
+	m_lut(lut),
+	m_dFontSize(0.0),
+	m_nLabelX(0),
+	m_nLabelY(0),
+	m_eLabelAlign(SchriftText::TextAlignment_Left),
+	m_rgbaLabel(0, 0, 0),
+	m_sQueueCapacity(DefaultQueueCapacity),
+	m_pvarreg(NULL),
+	m_varix(InvalidVariableIndex),
+	m_pvecFiles(NULL),
+	m_pgrid(NULL),
+	m_pvecTimes(NULL)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::SetLabel(
+	const std::string & strFontFile,
+	double dFontSize,
+	int nX,
+	int nY,
+	SchriftText::TextAlignment eAlign,
+	RGBA rgba
+) {
+	if (dFontSize <= 0.0) {
+		_EXCEPTION1("Invalid font size (%1.5f)", dFontSize);
+	}
+
+	// Load the font now so that a bad font file is reported immediately
+	SchriftText font(strFontFile, dFontSize, 1);
+
+	m_strFontFile = strFontFile;
+	m_dFontSize = dFontSize;
+	m_nLabelX = nX;
+	m_nLabelY = nY;
+	m_eLabelAlign = eAlign;
+	m_rgbaLabel = rgba;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::SetOverlay(
+	const PNGImage & imgOverlay
+) {
+	if ((imgOverlay.width() != m_rasterizer.width()) ||
+	    (imgOverlay.height() != m_rasterizer.height())
+	) {
+		_EXCEPTION4("Overlay size (%u x %u) does not match rasterizer size (%u x %u)",
+			imgOverlay.width(), imgOverlay.height(),
+			m_rasterizer.width(), m_rasterizer.height());
+	}
+	m_imgOverlay = imgOverlay;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::SetQueueCapacity(
+	size_t sQueueCapacity
+) {
+	if (sQueueCapacity == 0) {
+		_EXCEPTIONT("Queue capacity must be positive");
+	}
+	m_sQueueCapacity = sQueueCapacity;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string FramePipeline::FrameFilename(
+	const std::string & strOutputPrefix,
+	size_t sFrame
+) {
+	char szIndex[32];
+	snprintf(szIndex, sizeof(szIndex), "%06lu.png",
+		static_cast<unsigned long>(sFrame));
+	return strOutputPrefix + szIndex;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::Run(
+	VariableRegistry & varreg,
+	VariableIndex varix,
+	NcFileVector & vecFiles,
+	const SimpleGrid & grid,
+	const std::vector<Time> & vecTimes,
+	const std::string & strOutputPrefix
+) {
+	m_pvarreg = &varreg;
+	m_varix = varix;
+	m_pvecFiles = &vecFiles;
+	m_pgrid = &grid;
+	m_pvecTimes = &vecTimes;
+
+	try {
+		Process(vecTimes.size(), strOutputPrefix);
+
+	} catch(...) {
+		m_pvarreg = NULL;
+		m_pvecFiles = NULL;
+		m_pgrid = NULL;
+		m_pvecTimes = NULL;
+		throw;
+	}
+
+	m_pvarreg = NULL;
+	m_pvecFiles = NULL;
+	m_pgrid = NULL;
+	m_pvecTimes = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::Process(
+	size_t sFrameCount,
+	const std::string & strOutputPrefix
+) {
+	if (sFrameCount == 0) {
+		return;
+	}
+
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+
+	bool fSerial = (nThreads < 2);
+
+	if (!fSerial) {
+
+		// Frames in flight are bounded by the two queues, the frames held
+		// by the workers and the encoded frames waiting to be written
+		FramePipelineQueues queues(
+			sFrameCount,
+			m_sQueueCapacity,
+			2 * m_sQueueCapacity + static_cast<size_t>(nThreads));
+
+#pragma omp parallel num_threads(nThreads)
+		{
+			int iThread = 0;
+			int nTeam = 1;
+#ifdef _OPENMP
+			iThread = omp_get_thread_num();
+			nTeam = omp_get_num_threads();
+#endif
+			if (nTeam == 1) {
+				fSerial = true;
+			} else if (iThread == 0) {
+				ReaderLoop(queues);
+			} else {
+				WorkerLoop(queues, strOutputPrefix);
+			}
+		}
+
+		if (queues.vecError.size() != 0) {
+			throw queues.vecError[0];
+		}
+	}
+
+	// Without a second thread process each frame in turn, leaving the
+	// rasterizer and encoder free to use all threads
+	if (fSerial) {
+		SchriftText * pfont = CreateFont();
+		try {
+			for (size_t f = 0; f < sFrameCount; f++) {
+				FramePipelineFrame frame;
+				frame.sFrame = f;
+				ReadFrame(frame);
+				RenderFrame(frame, pfont);
+				EncodeFrame(frame);
+				WriteFrame(strOutputPrefix, f, frame.vecPNG);
+			}
+
+		} catch(...) {
+			delete pfont;
+			throw;
+		}
+		delete pfont;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::ReadFrame(
+	FramePipelineFrame & frame
+) {
+	_ASSERT(m_pvarreg != NULL);
+	_ASSERT(m_pvecFiles != NULL);
+	_ASSERT(m_pgrid != NULL);
+	_ASSERT(m_pvecTimes != NULL);
+	_ASSERT(frame.sFrame < m_pvecTimes->size());
+
+	const Time & time = (*m_pvecTimes)[frame.sFrame];
+
+	m_pvecFiles->SetTime(time);
+
+	Variable & var = m_pvarreg->Get(m_varix);
+	var.LoadGridData(*m_pvarreg, *m_pvecFiles, *m_pgrid);
+
+	const DataArray1D<float> & data = var.GetData();
+	const float * pData = data;
+	frame.vecData.assign(pData, pData + data.GetRows());
+
+	frame.strLabel = time.ToString();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::RenderFrame(
+	FramePipelineFrame & frame,
+	SchriftText * pfont
+) const {
+	frame.img = PNGImage(m_rasterizer.width(), m_rasterizer.height());
+
+	m_rasterizer.Render(
+		(frame.vecData.size() == 0)?(NULL):(&(frame.vecData[0])),
+		frame.vecData.size(),
+		m_lut,
+		frame.img);
+
+	std::vector<float>().swap(frame.vecData);
+
+	if (m_imgOverlay.size() != 0) {
+		frame.img.overlay(m_imgOverlay);
+	}
+
+	if ((pfont != NULL) && (frame.strLabel.length() != 0)) {
+		pfont->DrawString(
+			frame.strLabel,
+			m_nLabelX,
+			m_nLabelY,
+			m_eLabelAlign,
+			frame.img.width(),
+			frame.img.height(),
+			&(frame.img[0]),
+			m_rgbaLabel);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::EncodeFrame(
+	FramePipelineFrame & frame
+) const {
+	frame.img.encode(frame.vecPNG, m_settings);
+
+	PNGImage().swap(frame.img);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::WriteFrame(
+	const std::string & strOutputPrefix,
+	size_t sFrame,
+	const std::vector<unsigned char> & vecPNG
+) const {
+	std::string strFilename = FrameFilename(strOutputPrefix, sFrame);
+
+	unsigned error =
+		lodepng_save_file(&(vecPNG[0]), vecPNG.size(), strFilename.c_str());
+	if (error) {
+		_EXCEPTION2("Unable to write \"%s\": %s",
+			strFilename.c_str(), lodepng_error_text(error));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::ReaderLoop(
+	FramePipelineQueues & queues
+) {
+	size_t f = 0;
+	try {
+		for (; f < queues.sFrameCount; f++) {
+			{
+				std::unique_lock<std::mutex> lock(queues.mutex);
+				while (!queues.fAbort && (
+				       (queues.dequeRender.size() >= queues.sCapacity) ||
+				       (queues.sInFlight >= queues.sMaxInFlight))
+				) {
+					queues.cond.wait(lock);
+				}
+				if (queues.fAbort) {
+					break;
+				}
+			}
+
+			FramePipelineFrame frame;
+			frame.sFrame = f;
+			ReadFrame(frame);
+
+			{
+				std::lock_guard<std::mutex> lock(queues.mutex);
+				queues.dequeRender.push_back(std::move(frame));
+				queues.sInFlight++;
+			}
+			queues.cond.notify_all();
+		}
+
+	} catch(Exception & e) {
+		queues.Fail(f, e);
+
+	} catch(std::exception & e) {
+		queues.Fail(f, Exception(__FILE__, __LINE__, "%s", e.what()));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queues.mutex);
+		queues.fReadDone = true;
+	}
+	queues.cond.notify_all();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FramePipeline::WorkerLoop(
+	FramePipelineQueues & queues,
+	const std::string & strOutputPrefix
+) {
+	SchriftText * pfont = NULL;
+
+	size_t f = 0;
+	try {
+		pfont = CreateFont();
+
+		std::unique_lock<std::mutex> lock(queues.mutex);
+		for (;;) {
+			if (queues.fAbort) {
+				break;
+			}
+
+			// Encode
+			if (queues.dequeEncode.size() != 0) {
+				FramePipelineFrame frame(std::move(queues.dequeEncode.front()));
+				queues.dequeEncode.pop_front();
+				f = frame.sFrame;
+				lock.unlock();
+				queues.cond.notify_all();
+
+				EncodeFrame(frame);
+
+				lock.lock();
+				queues.mapEncoded[f].swap(frame.vecPNG);
+
+				// Write all consecutive encoded frames, with only one
+				// thread writing at a time to preserve frame order
+				if (queues.fWriting) {
+					continue;
+				}
+				queues.fWriting = true;
+				for (;;) {
+					std::map<size_t, std::vector<unsigned char> >::iterator iter =
+						queues.mapEncoded.find(queues.sNextWrite);
+					if (iter == queues.mapEncoded.end()) {
+						break;
+					}
+
+					std::vector<unsigned char> vecPNG;
+					vecPNG.swap(iter->second);
+					queues.mapEncoded.erase(iter);
+					f = queues.sNextWrite;
+					lock.unlock();
+
+					WriteFrame(strOutputPrefix, f, vecPNG);
+
+					lock.lock();
+					queues.sNextWrite++;
+					queues.sInFlight--;
+					queues.cond.notify_all();
+				}
+				queues.fWriting = false;
+				continue;
+			}
+
+			// Render, reserving a slot in the encode queue
+			if ((queues.dequeRender.size() != 0) &&
+			    (queues.dequeEncode.size() + queues.sRendering < queues.sCapacity)
+			) {
+				FramePipelineFrame frame(std::move(queues.dequeRender.front()));
+				queues.dequeRender.pop_front();
+				queues.sRendering++;
+				f = frame.sFrame;
+				lock.unlock();
+				queues.cond.notify_all();
+
+				RenderFrame(frame, pfont);
+
+				lock.lock();
+				queues.sRendering--;
+				queues.dequeEncode.push_back(std::move(frame));
+				queues.cond.notify_all();
+				continue;
+			}
+
+			if (queues.fReadDone && (queues.sInFlight == 0)) {
+				break;
+			}
+
+			queues.cond.wait(lock);
+		}
+
+	} catch(Exception & e) {
+		queues.Fail(f, e);
+
+	} catch(std::exception & e) {
+		queues.Fail(f, Exception(__FILE__, __LINE__, "%s", e.what()));
+	}
+
+	delete pfont;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SchriftText * FramePipeline::CreateFont() const {
+	if (m_strFontFile.length() == 0) {
+		return NULL;
+	}
+	return new SchriftText(m_strFontFile, m_dFontSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,293 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    FramePipeline.h
+///	\author  Paul Ullrich
+///	\version October 18, 2026
+///
+///	<remarks>
+///		Copyright 2026 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _FRAMEPIPELINE_H_
+#define _FRAMEPIPELINE_H_
+
+#include "Variable.h"
+#include "TimeObj.h"
+#include "PNGImage.h"
+#include "SchriftText.h"
+#include "RGBA.h"
+
+#include <vector>
+#include <string>
+
+class GridRasterizer;
+class ColorMapLUT;
+struct FramePipelineQueues;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A single frame as it passes through the FramePipeline.
+///	</summary>
+struct FramePipelineFrame {
+
+	///	<summary>
+	///		Index of the frame.
+	///	</summary>
+	size_t sFrame;
+
+	///	<summary>
+	///		Field values on the grid.
+	///	</summary>
+	std::vector<float> vecData;
+
+	///	<summary>
+	///		Label drawn on the frame.
+	///	</summary>
+	std::string strLabel;
+
+	///	<summary>
+	///		Rendered image.
+	///	</summary>
+	PNGImage img;
+
+	///	<summary>
+	///		Encoded PNG.
+	///	</summary>
+	std::vector<unsigned char> vecPNG;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A pipeline for rendering a sequence of time slices of a variable to
+///		PNG files.  A reader stage on the calling thread loads each field
+///		from the NcFileVector, while the remaining threads color map the
+///		field, apply the overlay and label and encode the PNG.  The stages
+///		are connected by bounded queues so that at most a fixed number of
+///		frames are held in memory.  Frame i is always written to the file
+///		FrameFilename(strOutputPrefix, i) and files are written in frame
+///		order, so the output does not depend on the number of threads.
+///	</summary>
+class FramePipeline {
+
+public:
+	///	<summary>
+	///		Default number of frames in each queue.
+	///	</summary>
+	static const size_t DefaultQueueCapacity = 4;
+
+public:
+	///	<summary>
+	///		Constructor.  The rasterizer and compiled colormap must remain
+	///		valid for the lifetime of the pipeline.
+	///	</summary>
+	FramePipeline(
+		const GridRasterizer & rasterizer,
+		const ColorMapLUT & lut
+	);
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	virtual ~FramePipeline() { }
+
+	///	<summary>
+	///		Draw the time of each frame on the image in the given font.  The
+	///		coordinate (x,y) indicates the top-left corner of the label.
+	///	</summary>
+	void SetLabel(
+		const std::string & strFontFile,
+		double dFontSize,
+		int nX,
+		int nY,
+		SchriftText::TextAlignment eAlign = SchriftText::TextAlignment_Left,
+		RGBA rgba = RGBA(0, 0, 0)
+	);
+
+	///	<summary>
+	///		Apply an overlay to each frame (such as coastlines).  The overlay
+	///		must have the same size as the rasterizer.
+	///	</summary>
+	void SetOverlay(
+		const PNGImage & imgOverlay
+	);
+
+	///	<summary>
+	///		Set the PNG encoder settings.
+	///	</summary>
+	void SetEncoderSettings(
+		const PNGEncoderSettings & settings
+	) {
+		m_settings = settings;
+	}
+
+	///	<summary>
+	///		Set the number of frames in each queue.
+	///	</summary>
+	void SetQueueCapacity(
+		size_t sQueueCapacity
+	);
+
+	///	<summary>
+	///		Get the name of the output file for the given frame.
+	///	</summary>
+	static std::string FrameFilename(
+		const std::string & strOutputPrefix,
+		size_t sFrame
+	);
+
+	///	<summary>
+	///		Render the variable at each of the given times to PNG files.
+	///		The NcFileVector is left at the last time that was read.  If any
+	///		frame fails the pipeline is stopped and the error for the first
+	///		failed frame is rethrown.
+	///	</summary>
+	void Run(
+		VariableRegistry & varreg,
+		VariableIndex varix,
+		NcFileVector & vecFiles,
+		const SimpleGrid & grid,
+		const std::vector<Time> & vecTimes,
+		const std::string & strOutputPrefix
+	);
+
+protected:
+	///	<summary>
+	///		Render sFrameCount frames to PNG files.
+	///	</summary>
+	void Process(
+		size_t sFrameCount,
+		const std::string & strOutputPrefix
+	);
+
+	///	<summary>
+	///		Reader stage: load the field and label for frame.sFrame.  Only
+	///		called from a single thread.
+	///	</summary>
+	virtual void ReadFrame(
+		FramePipelineFrame & frame
+	);
+
+	///	<summary>
+	///		Render stage: color map the field and draw the overlay and label.
+	///		Each thread provides its own font, which may be NULL.
+	///	</summary>
+	void RenderFrame(
+		FramePipelineFrame & frame,
+		SchriftText * pfont
+	) const;
+
+	///	<summary>
+	///		Encode stage: encode the rendered image and release it.
+	///	</summary>
+	void EncodeFrame(
+		FramePipelineFrame & frame
+	) const;
+
+	///	<summary>
+	///		Write an encoded frame to its output file.
+	///	</summary>
+	void WriteFrame(
+		const std::string & strOutputPrefix,
+		size_t sFrame,
+		const std::vector<unsigned char> & vecPNG
+	) const;
+
+	///	<summary>
+	///		Reader loop, feeding the render queue.
+	///	</summary>
+	void ReaderLoop(
+		FramePipelineQueues & queues
+	);
+
+	///	<summary>
+	///		Worker loop, draining the encode queue in preference to the
+	///		render queue and writing encoded frames in order.
+	///	</summary>
+	void WorkerLoop(
+		FramePipelineQueues & queues,
+		const std::string & strOutputPrefix
+	);
+
+	///	<summary>
+	///		Create the font for one thread, or NULL if there is no label.
+	///	</summary>
+	SchriftText * CreateFont() const;
+
+private:
+	///	<summary>
+	///		Rasterizer mapping the grid to the image.
+	///	</summary>
+	const GridRasterizer & m_rasterizer;
+
+	///	<summary>
+	///		Compiled colormap.
+	///	</summary>
+	const ColorMapLUT & m_lut;
+
+	///	<summary>
+	///		Font file for the label, or empty if there is no label.
+	///	</summary>
+	std::string m_strFontFile;
+
+	///	<summary>
+	///		Font size for the label.
+	///	</summary>
+	double m_dFontSize;
+
+	///	<summary>
+	///		X coordinate of the label.
+	///	</summary>
+	int m_nLabelX;
+
+	///	<summary>
+	///		Y coordinate of the label.
+	///	</summary>
+	int m_nLabelY;
+
+	///	<summary>
+	///		Alignment of the label.
+	///	</summary>
+	SchriftText::TextAlignment m_eLabelAlign;
+
+	///	<summary>
+	///		Color of the label.
+	///	</summary>
+	RGBA m_rgbaLabel;
+
+	///	<summary>
+	///		Overlay applied to each frame, or empty if there is no overlay.
+	///	</summary>
+	PNGImage m_imgOverlay;
+
+	///	<summary>
+	///		PNG encoder settings.
+	///	</summary>
+	PNGEncoderSettings m_settings;
+
+	///	<summary>
+	///		Number of frames in each queue.
+	///	</summary>
+	size_t m_sQueueCapacity;
+
+	///	<summary>
+	///		Inputs to the reader stage during Run.
+	///	</summary>
+	VariableRegistry * m_pvarreg;
+	VariableIndex m_varix;
+	NcFileVector * m_pvecFiles;
+	const SimpleGrid * m_pgrid;
+	const std::vector<Time> * m_pvecTimes;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _FRAMEPIPELINE_H_
+
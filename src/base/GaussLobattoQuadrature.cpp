@@ -20,185 +20,234 @@
 
 #include "Exception.h"
 
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
 ///////////////////////////////////////////////////////////////////////////////
 
-void GaussLobattoQuadrature::GetPoints(
+///	<summary>
+///		Largest number of points with tabulated nodes and weights.
+///	</summary>
+static const int GaussLobattoTableMaxCount = 16;
+
+///	<summary>
+///		Tabulated quadrature nodes on [-1,1], stored consecutively by
+///		number of points.
+///	</summary>
+static const double GaussLobattoTableNodes[] = {
+	// 2 points
+	-1.0, +1.0,
+	// 3 points
+	-1.0, 0.0, +1.0,
+	// 4 points
+	-1.0, -0.4472135954999579, +0.4472135954999579, +1.0,
+	// 5 points
+	-1.0, -0.6546536707079772, 0.0, +0.6546536707079772, +1.0,
+	// 6 points
+	-1.0, -0.7650553239294647, -0.2852315164806451, +0.2852315164806451,
+	+0.7650553239294647, +1.0,
+	// 7 points
+	-1.0, -0.830223896278567, -0.46884879347071423, 0.0,
+	+0.46884879347071423, +0.830223896278567, +1.0,
+	// 8 points
+	-1.0, -0.8717401485096066, -0.5917001814331423, -0.20929921790247888,
+	+0.20929921790247888, +0.5917001814331423, +0.8717401485096066, +1.0,
+	// 9 points
+	-1.0, -0.8997579954114602, -0.6771862795107377, -0.36311746382617816,
+	0.0, +0.36311746382617816, +0.6771862795107377, +0.8997579954114602,
+	+1.0,
+	// 10 points
+	-1.0, -0.9195339081664589, -0.738773865105505, -0.4779249498104445,
+	-0.16527895766638703, +0.16527895766638703, +0.4779249498104445,
+	+0.738773865105505, +0.9195339081664589, +1.0,
+	// 11 points
+	-1.0, -0.9340014304080592, -0.7844834736631444, -0.565235326996205,
+	-0.2957581355869394, 0.0, +0.2957581355869394, +0.565235326996205,
+	+0.7844834736631444, +0.9340014304080592, +1.0,
+	// 12 points
+	-1.0, -0.9448992722228822, -0.8192793216440066, -0.6328761530318607,
+	-0.3995309409653489, -0.13655293285492756, +0.13655293285492756,
+	+0.3995309409653489, +0.6328761530318607, +0.8192793216440066,
+	+0.9448992722228822, +1.0,
+	// 13 points
+	-1.0, -0.9533098466421639, -0.8463475646518723, -0.6861884690817575,
+	-0.4829098210913362, -0.24928693010623998, 0.0, +0.24928693010623998,
+	+0.4829098210913362, +0.6861884690817575, +0.8463475646518723,
+	+0.9533098466421639, +1.0,
+	// 14 points
+	-1.0, -0.9599350452672609, -0.8678010538303472, -0.7288685990913262,
+	-0.5506394029286471, -0.34272401334271285, -0.11633186888370387,
+	+0.11633186888370387, +0.34272401334271285, +0.5506394029286471,
+	+0.7288685990913262, +0.8678010538303472, +0.9599350452672609, +1.0,
+	// 15 points
+	-1.0, -0.9652459265038386, -0.8850820442229763, -0.7635196899518152,
+	-0.6062532054698457, -0.4206380547136725, -0.21535395536379423, 0.0,
+	+0.21535395536379423, +0.4206380547136725, +0.6062532054698457,
+	+0.7635196899518152, +0.8850820442229763, +0.9652459265038386, +1.0,
+	// 16 points
+	-1.0, -0.969568046270218, -0.8992005330934721, -0.7920082918618151,
+	-0.6523887028824931, -0.48605942188713763, -0.2998304689007632,
+	-0.10132627352194945, +0.10132627352194945, +0.2998304689007632,
+	+0.48605942188713763, +0.6523887028824931, +0.7920082918618151,
+	+0.8992005330934721, +0.969568046270218, +1.0
+};
+
+///	<summary>
+///		Tabulated quadrature weights on [-1,1], stored consecutively by
+///		number of points.
+///	</summary>
+static const double GaussLobattoTableWeights[] = {
+	// 2 points
+	+1.0, +1.0,
+	// 3 points
+	+0.3333333333333333, +1.3333333333333333, +0.3333333333333333,
+	// 4 points
+	+0.16666666666666666, +0.8333333333333334, +0.8333333333333334,
+	+0.16666666666666666,
+	// 5 points
+	+0.1, +0.5444444444444444, +0.7111111111111111, +0.5444444444444444,
+	+0.1,
+	// 6 points
+	+0.06666666666666667, +0.378474956297847, +0.5548583770354863,
+	+0.5548583770354863, +0.378474956297847, +0.06666666666666667,
+	// 7 points
+	+0.047619047619047616, +0.27682604736156596, +0.4317453812098626,
+	+0.4876190476190476, +0.4317453812098626, +0.27682604736156596,
+	+0.047619047619047616,
+	// 8 points
+	+0.03571428571428571, +0.21070422714350603, +0.34112269248350435,
+	+0.4124587946587039, +0.4124587946587039, +0.34112269248350435,
+	+0.21070422714350603, +0.03571428571428571,
+	// 9 points
+	+0.027777777777777776, +0.16549536156080552, +0.2745387125001617,
+	+0.34642851097304633, +0.37151927437641724, +0.34642851097304633,
+	+0.2745387125001617, +0.16549536156080552, +0.027777777777777776,
+	// 10 points
+	+0.022222222222222223, +0.13330599085107012, +0.22488934206312644,
+	+0.2920426836796838, +0.32753976118389744, +0.32753976118389744,
+	+0.2920426836796838, +0.22488934206312644, +0.13330599085107012,
+	+0.022222222222222223,
+	// 11 points
+	+0.01818181818181818, +0.10961227326699487, +0.1871698817803052,
+	+0.24804810426402832, +0.28687912477900807, +0.3002175954556907,
+	+0.28687912477900807, +0.24804810426402832, +0.1871698817803052,
+	+0.10961227326699487, +0.01818181818181818,
+	// 12 points
+	+0.015151515151515152, +0.09168451741319614, +0.15797470556437013,
+	+0.21250841776102114, +0.2512756031992013, +0.2714052409106962,
+	+0.2714052409106962, +0.2512756031992013, +0.21250841776102114,
+	+0.15797470556437013, +0.09168451741319614, +0.015151515151515152,
+	// 13 points
+	+0.01282051282051282, +0.07780168674681892, +0.13498192668960834,
+	+0.18364686520355009, +0.2207677935661101, +0.24401579030667636,
+	+0.2519308493334467, +0.24401579030667636, +0.2207677935661101,
+	+0.18364686520355009, +0.13498192668960834, +0.07780168674681892,
+	+0.01282051282051282,
+	// 14 points
+	+0.01098901098901099, +0.06683728449768128, +0.11658665589871166,
+	+0.16002185176295214, +0.1948261493734161, +0.21912625300977076,
+	+0.23161279446845706, +0.23161279446845706, +0.21912625300977076,
+	+0.1948261493734161, +0.16002185176295214, +0.11658665589871166,
+	+0.06683728449768128, +0.01098901098901099,
+	// 15 points
+	+0.009523809523809525, +0.05802989302860125, +0.10166007032571807,
+	+0.1405116998024281, +0.17278964725360094, +0.19698723596461334,
+	+0.21197358592682092, +0.21704811634881566, +0.21197358592682092,
+	+0.19698723596461334, +0.17278964725360094, +0.1405116998024281,
+	+0.10166007032571807, +0.05802989302860125, +0.009523809523809525,
+	// 16 points
+	+0.008333333333333333, +0.05085036100591991, +0.0893936973259308,
+	+0.1242553821325141, +0.1540269808071643, +0.17749191339170411,
+	+0.1936900238252036, +0.20195830817822988, +0.20195830817822988,
+	+0.1936900238252036, +0.17749191339170411, +0.1540269808071643,
+	+0.1242553821325141, +0.0893936973259308, +0.05085036100591991,
+	+0.008333333333333333
+};
+
+static_assert(
+	sizeof(GaussLobattoTableNodes) == 135 * sizeof(double),
+	"Incorrect size of GaussLobattoTableNodes");
+
+static_assert(
+	sizeof(GaussLobattoTableWeights) == 135 * sizeof(double),
+	"Incorrect size of GaussLobattoTableWeights");
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GaussLobattoQuadrature::GetCachedPoints(
 	int nCount,
-	DataArray1D<double> & dG,
-	DataArray1D<double> & dW
+	const double *& dG,
+	const double *& dW
 ) {
 	// Check for valid range
 	if (nCount < 2) {
 		_EXCEPTION1("Invalid count (%i): Minimum count 2", nCount);
 	}
 
-	// Initialize the arrays
-	dG.Allocate(nCount);
-	dW.Allocate(nCount);
+	// Tabulated points
+	if (nCount <= GaussLobattoTableMaxCount) {
+		const int ixBegin = nCount * (nCount - 1) / 2 - 1;
+		dG = GaussLobattoTableNodes + ixBegin;
+		dW = GaussLobattoTableWeights + ixBegin;
+		return;
+	}
+
+	// Higher degrees are computed once and memoized, with nodes followed
+	// by weights in each entry
+	static std::mutex s_mutex;
+	static std::map< int, std::vector<double> > s_mapPoints;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
 
-	// Degree 2
-	if (nCount == 2) {
-		dG[0] = -1.0;
-		dG[1] = +1.0;
-
-		dW[0] = +1.0;
-		dW[1] = +1.0;
-
-	// Degree 3
-	} else if (nCount == 3) {
-		dG[0] = -1.0;
-		dG[1] =  0.0;
-		dG[2] = +1.0;
-
-		dW[0] = +0.333333333333333;
-		dW[1] = +1.333333333333334;
-		dW[2] = +0.333333333333333;
-
-	// Degree 4
-	} else if (nCount == 4) {
-		dG[0] = -1.0;
-		dG[1] = -0.447213595499958;
-		dG[2] = +0.447213595499958;
-		dG[3] = +1.0;
-
-		dW[0] = 0.166666666666667;
-		dW[1] = 0.833333333333333;
-		dW[2] = 0.833333333333333;
-		dW[3] = 0.166666666666667;
-
-	// Degree 5
-	} else if (nCount == 5) {
-		dG[0] = -1.0;
-		dG[1] = -0.654653670707977;
-		dG[2] =  0.0;
-		dG[3] = +0.654653670707977;
-		dG[4] = +1.0;
-
-		dW[0] = 0.100000000000000;
-		dW[1] = 0.544444444444445;
-		dW[2] = 0.711111111111110;
-		dW[3] = 0.544444444444445;
-		dW[4] = 0.100000000000000;
-
-	// Degree 6
-	} else if (nCount == 6) {
-		dG[0] = -1.0;
-		dG[1] = -0.765055323929465;
-		dG[2] = -0.285231516480645;
-		dG[3] = +0.285231516480645;
-		dG[4] = +0.765055323929465;
-		dG[5] = +1.0;
-
-		dW[0] = 0.066666666666667;
-		dW[1] = 0.378474956297847;
-		dW[2] = 0.554858377035486;
-		dW[3] = 0.554858377035486;
-		dW[4] = 0.378474956297847;
-		dW[5] = 0.066666666666667;
-
-	// Degree 7
-	} else if (nCount == 7) {
-		dG[0] = -1.0;
-		dG[1] = -0.830223896278567;
-		dG[2] = -0.468848793470714;
-		dG[3] =  0.0;
-		dG[4] = +0.468848793470714;
-		dG[5] = +0.830223896278567;
-		dG[6] = +1.0;
-
-		dW[0] = 0.047619047619048;
-		dW[1] = 0.276826047361566;
-		dW[2] = 0.431745381209862;
-		dW[3] = 0.487619047619048;
-		dW[4] = 0.431745381209862;
-		dW[5] = 0.276826047361566;
-		dW[6] = 0.047619047619048;
-
-	// Degree 8
-	} else if (nCount == 8) {
-		dG[0] = -1.0;
-		dG[1] = -0.871740148509607;
-		dG[2] = -0.591700181433142;
-		dG[3] = -0.209299217902479;
-		dG[4] = +0.209299217902479;
-		dG[5] = +0.591700181433142;
-		dG[6] = +0.871740148509607;
-		dG[7] = +1.0;
-
-		dW[0] = 0.035714285714286;
-		dW[1] = 0.210704227143506;
-		dW[2] = 0.341122692483505;
-		dW[3] = 0.412458794658703;
-		dW[4] = 0.412458794658703;
-		dW[5] = 0.341122692483505;
-		dW[6] = 0.210704227143506;
-		dW[7] = 0.035714285714286;
-
-	// Degree 9
-	} else if (nCount == 9) {
-		dG[0] = -1.0;
-		dG[1] = -0.899757995411460;
-		dG[2] = -0.677186279510738;
-		dG[3] = -0.363117463826178;
-		dG[4] =  0.0;
-		dG[5] = +0.363117463826178;
-		dG[6] = +0.677186279510738;
-		dG[7] = +0.899757995411460;
-		dG[8] = +1.0;
-
-		dW[0] = 0.027777777777778;
-		dW[1] = 0.165495361560806;
-		dW[2] = 0.274538712500162;
-		dW[3] = 0.346428510973046;
-		dW[4] = 0.371519274376417;
-		dW[5] = 0.346428510973046;
-		dW[6] = 0.274538712500162;
-		dW[7] = 0.165495361560806;
-		dW[8] = 0.027777777777778;
-
-	// Degree 10
-	} else if (nCount == 10) {
-		dG[0] = -1.0;
-		dG[1] = -0.919533908166459;
-		dG[2] = -0.738773865105505;
-		dG[3] = -0.477924949810444;
-		dG[4] = -0.165278957666387;
-		dG[5] = +0.165278957666387;
-		dG[6] = +0.477924949810444;
-		dG[7] = +0.738773865105505;
-		dG[8] = +0.919533908166459;
-		dG[9] = +1.0;
-
-		dW[0] = 0.022222222222222;
-		dW[1] = 0.133305990851070;
-		dW[2] = 0.224889342063126;
-		dW[3] = 0.292042683679684;
-		dW[4] = 0.327539761183897;
-		dW[5] = 0.327539761183897;
-		dW[6] = 0.292042683679684;
-		dW[7] = 0.224889342063126;
-		dW[8] = 0.133305990851070;
-		dW[9] = 0.022222222222222;
-
-	// Higher degrees
-	} else {
-		DataArray1D<double> dRoots(nCount);
-		
-		LegendrePolynomial::AllDerivativeRoots(nCount-1, dRoots);
-
-		dG[0] = -1.0;
-		memcpy(dG+1, dRoots, (nCount-2) * sizeof(double));
-		dG[nCount-1] = +1.0;
+	std::vector<double> & vecPoints = s_mapPoints[nCount];
+
+	if (vecPoints.size() == 0) {
+		std::vector<double> vecComputed(2 * nCount);
+
+		double * dCompG = &(vecComputed[0]);
+		double * dCompW = &(vecComputed[nCount]);
+
+		dCompG[0] = -1.0;
+		LegendrePolynomial::AllDerivativeRoots(nCount-1, dCompG+1);
+		dCompG[nCount-1] = +1.0;
 
 		for (int k = 0; k < nCount; k++) {
 			double dValue =
-				LegendrePolynomial::Evaluate(nCount-1, dG[k]);
+				LegendrePolynomial::Evaluate(nCount-1, dCompG[k]);
 
 			double dDegree = static_cast<double>(nCount);
 
-			dW[k] = 2.0 / (dDegree * (dDegree - 1.0) * dValue * dValue);
+			dCompW[k] =
+				2.0 / (dDegree * (dDegree - 1.0) * dValue * dValue);
 		}
+
+		vecPoints.swap(vecComputed);
 	}
+
+	dG = &(vecPoints[0]);
+	dW = &(vecPoints[nCount]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GaussLobattoQuadrature::GetPoints(
+	int nCount,
+	DataArray1D<double> & dG,
+	DataArray1D<double> & dW
+) {
+	const double * dCachedG;
+	const double * dCachedW;
+
+	GetCachedPoints(nCount, dCachedG, dCachedW);
+
+	// Initialize the arrays
+	dG.Allocate(nCount);
+	dW.Allocate(nCount);
+
+	memcpy(dG, dCachedG, nCount * sizeof(double));
+	memcpy(dW, dCachedW, nCount * sizeof(double));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -27,6 +27,20 @@
 class GaussLobattoQuadrature {
 
 public:
+	///	<summary>
+	///		Get pointers to the Gauss-Lobatto quadrature points and weights on
+	///		[-1,1] for the given number of points.  Points for up to 16 nodes
+	///		are tabulated to full double precision.  Points for more nodes are
+	///		computed in double precision, accurate to a few units in the last
+	///		place, once and memoized.  The returned arrays remain valid for
+	///		the life of the program and this function is thread-safe.
+	///	</summary>
+	static void GetCachedPoints(
+		int nCount,
+		const double *& dG,
+		const double *& dW
+	);
+
 	///	<summary>
 	///		Return the Gauss-Lobatto quadrature points and their corresponding
 	///		weights for the given number of points.
@@ -18,183 +18,242 @@
 #include "LegendrePolynomial.h"
 #include "Exception.h"
 
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
 ///////////////////////////////////////////////////////////////////////////////
 
-void GaussQuadrature::GetPoints(
+///	<summary>
+///		Largest number of points with tabulated nodes and weights.
+///	</summary>
+static const int GaussTableMaxCount = 16;
+
+///	<summary>
+///		Tabulated quadrature nodes on [-1,1], stored consecutively by
+///		number of points.
+///	</summary>
+static const double GaussTableNodes[] = {
+	// 1 point
+	0.0,
+	// 2 points
+	-0.5773502691896257, +0.5773502691896257,
+	// 3 points
+	-0.7745966692414834, 0.0, +0.7745966692414834,
+	// 4 points
+	-0.8611363115940526, -0.33998104358485626, +0.33998104358485626,
+	+0.8611363115940526,
+	// 5 points
+	-0.906179845938664, -0.5384693101056831, 0.0, +0.5384693101056831,
+	+0.906179845938664,
+	// 6 points
+	-0.932469514203152, -0.6612093864662645, -0.2386191860831969,
+	+0.2386191860831969, +0.6612093864662645, +0.932469514203152,
+	// 7 points
+	-0.9491079123427585, -0.7415311855993945, -0.4058451513773972, 0.0,
+	+0.4058451513773972, +0.7415311855993945, +0.9491079123427585,
+	// 8 points
+	-0.9602898564975363, -0.7966664774136267, -0.525532409916329,
+	-0.1834346424956498, +0.1834346424956498, +0.525532409916329,
+	+0.7966664774136267, +0.9602898564975363,
+	// 9 points
+	-0.9681602395076261, -0.8360311073266358, -0.6133714327005904,
+	-0.3242534234038089, 0.0, +0.3242534234038089, +0.6133714327005904,
+	+0.8360311073266358, +0.9681602395076261,
+	// 10 points
+	-0.9739065285171717, -0.8650633666889845, -0.6794095682990244,
+	-0.4333953941292472, -0.14887433898163122, +0.14887433898163122,
+	+0.4333953941292472, +0.6794095682990244, +0.8650633666889845,
+	+0.9739065285171717,
+	// 11 points
+	-0.978228658146057, -0.8870625997680953, -0.7301520055740494,
+	-0.5190961292068118, -0.26954315595234496, 0.0, +0.26954315595234496,
+	+0.5190961292068118, +0.7301520055740494, +0.8870625997680953,
+	+0.978228658146057,
+	// 12 points
+	-0.9815606342467192, -0.9041172563704749, -0.7699026741943047,
+	-0.5873179542866175, -0.3678314989981802, -0.1252334085114689,
+	+0.1252334085114689, +0.3678314989981802, +0.5873179542866175,
+	+0.7699026741943047, +0.9041172563704749, +0.9815606342467192,
+	// 13 points
+	-0.9841830547185881, -0.9175983992229779, -0.8015780907333099,
+	-0.6423493394403402, -0.44849275103644687, -0.2304583159551348, 0.0,
+	+0.2304583159551348, +0.44849275103644687, +0.6423493394403402,
+	+0.8015780907333099, +0.9175983992229779, +0.9841830547185881,
+	// 14 points
+	-0.9862838086968123, -0.9284348836635735, -0.827201315069765,
+	-0.6872929048116855, -0.5152486363581541, -0.31911236892788974,
+	-0.10805494870734367, +0.10805494870734367, +0.31911236892788974,
+	+0.5152486363581541, +0.6872929048116855, +0.827201315069765,
+	+0.9284348836635735, +0.9862838086968123,
+	// 15 points
+	-0.9879925180204854, -0.937273392400706, -0.8482065834104272,
+	-0.7244177313601701, -0.5709721726085388, -0.3941513470775634,
+	-0.20119409399743451, 0.0, +0.20119409399743451, +0.3941513470775634,
+	+0.5709721726085388, +0.7244177313601701, +0.8482065834104272,
+	+0.937273392400706, +0.9879925180204854,
+	// 16 points
+	-0.9894009349916499, -0.9445750230732326, -0.8656312023878318,
+	-0.755404408355003, -0.6178762444026438, -0.45801677765722737,
+	-0.2816035507792589, -0.09501250983763744, +0.09501250983763744,
+	+0.2816035507792589, +0.45801677765722737, +0.6178762444026438,
+	+0.755404408355003, +0.8656312023878318, +0.9445750230732326,
+	+0.9894009349916499
+};
+
+///	<summary>
+///		Tabulated quadrature weights on [-1,1], stored consecutively by
+///		number of points.
+///	</summary>
+static const double GaussTableWeights[] = {
+	// 1 point
+	+2.0,
+	// 2 points
+	+1.0, +1.0,
+	// 3 points
+	+0.5555555555555556, +0.8888888888888888, +0.5555555555555556,
+	// 4 points
+	+0.34785484513745385, +0.6521451548625461, +0.6521451548625461,
+	+0.34785484513745385,
+	// 5 points
+	+0.23692688505618908, +0.47862867049936647, +0.5688888888888889,
+	+0.47862867049936647, +0.23692688505618908,
+	// 6 points
+	+0.17132449237917036, +0.3607615730481386, +0.46791393457269104,
+	+0.46791393457269104, +0.3607615730481386, +0.17132449237917036,
+	// 7 points
+	+0.1294849661688697, +0.27970539148927664, +0.3818300505051189,
+	+0.4179591836734694, +0.3818300505051189, +0.27970539148927664,
+	+0.1294849661688697,
+	// 8 points
+	+0.10122853629037626, +0.22238103445337448, +0.31370664587788727,
+	+0.362683783378362, +0.362683783378362, +0.31370664587788727,
+	+0.22238103445337448, +0.10122853629037626,
+	// 9 points
+	+0.08127438836157441, +0.1806481606948574, +0.26061069640293544,
+	+0.31234707704000286, +0.3302393550012598, +0.31234707704000286,
+	+0.26061069640293544, +0.1806481606948574, +0.08127438836157441,
+	// 10 points
+	+0.06667134430868814, +0.1494513491505806, +0.21908636251598204,
+	+0.26926671930999635, +0.29552422471475287, +0.29552422471475287,
+	+0.26926671930999635, +0.21908636251598204, +0.1494513491505806,
+	+0.06667134430868814,
+	// 11 points
+	+0.05566856711617366, +0.1255803694649046, +0.18629021092773426,
+	+0.23319376459199048, +0.26280454451024665, +0.2729250867779006,
+	+0.26280454451024665, +0.23319376459199048, +0.18629021092773426,
+	+0.1255803694649046, +0.05566856711617366,
+	// 12 points
+	+0.04717533638651183, +0.10693932599531843, +0.16007832854334622,
+	+0.20316742672306592, +0.2334925365383548, +0.24914704581340277,
+	+0.24914704581340277, +0.2334925365383548, +0.20316742672306592,
+	+0.16007832854334622, +0.10693932599531843, +0.04717533638651183,
+	// 13 points
+	+0.04048400476531588, +0.09212149983772845, +0.13887351021978725,
+	+0.17814598076194574, +0.2078160475368885, +0.22628318026289723,
+	+0.2325515532308739, +0.22628318026289723, +0.2078160475368885,
+	+0.17814598076194574, +0.13887351021978725, +0.09212149983772845,
+	+0.04048400476531588,
+	// 14 points
+	+0.03511946033175186, +0.08015808715976021, +0.12151857068790319,
+	+0.15720316715819355, +0.18553839747793782, +0.2051984637212956,
+	+0.2152638534631578, +0.2152638534631578, +0.2051984637212956,
+	+0.18553839747793782, +0.15720316715819355, +0.12151857068790319,
+	+0.08015808715976021, +0.03511946033175186,
+	// 15 points
+	+0.03075324199611727, +0.07036604748810812, +0.10715922046717194,
+	+0.13957067792615432, +0.16626920581699392, +0.1861610000155622,
+	+0.19843148532711158, +0.2025782419255613, +0.19843148532711158,
+	+0.1861610000155622, +0.16626920581699392, +0.13957067792615432,
+	+0.10715922046717194, +0.07036604748810812, +0.03075324199611727,
+	// 16 points
+	+0.027152459411754096, +0.062253523938647894, +0.09515851168249279,
+	+0.12462897125553388, +0.14959598881657674, +0.16915651939500254,
+	+0.18260341504492358, +0.1894506104550685, +0.1894506104550685,
+	+0.18260341504492358, +0.16915651939500254, +0.14959598881657674,
+	+0.12462897125553388, +0.09515851168249279, +0.062253523938647894,
+	+0.027152459411754096
+};
+
+static_assert(
+	sizeof(GaussTableNodes) == 136 * sizeof(double),
+	"Incorrect size of GaussTableNodes");
+
+static_assert(
+	sizeof(GaussTableWeights) == 136 * sizeof(double),
+	"Incorrect size of GaussTableWeights");
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GaussQuadrature::GetCachedPoints(
 	int nCount,
-	DataArray1D<double> & dG,
-	DataArray1D<double> & dW
+	const double *& dG,
+	const double *& dW
 ) {
 	// Check for valid range
 	if (nCount < 1) {
 		_EXCEPTION1("Invalid count (%i): Minimum count 1", nCount);
 	}
 
-	// Initialize the arrays
-	dG.Allocate(nCount);
-	dW.Allocate(nCount);
+	// Tabulated points
+	if (nCount <= GaussTableMaxCount) {
+		const int ixBegin = nCount * (nCount - 1) / 2;
+		dG = GaussTableNodes + ixBegin;
+		dW = GaussTableWeights + ixBegin;
+		return;
+	}
+
+	// Higher degrees are computed once and memoized, with nodes followed
+	// by weights in each entry
+	static std::mutex s_mutex;
+	static std::map< int, std::vector<double> > s_mapPoints;
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	std::vector<double> & vecPoints = s_mapPoints[nCount];
+
+	if (vecPoints.size() == 0) {
+		std::vector<double> vecComputed(2 * nCount);
+
+		double * dCompG = &(vecComputed[0]);
+		double * dCompW = &(vecComputed[nCount]);
 
-	// Degree 1
-	if (nCount == 1) {
-		dG[0] =  0.0;
-		dW[0] = +2.0;
-
-	// Degree 2
-	} else if (nCount == 2) {
-		dG[0] = -0.5773502691896257;
-		dG[1] = +0.5773502691896257;
-
-		dW[0] = +1.0;
-		dW[1] = +1.0;
-
-	// Degree 3
-	} else if (nCount == 3) {
-		dG[0] = -0.7745966692414834;
-		dG[1] =  0.0;
-		dG[2] = +0.7745966692414834;
-
-		dW[0] = +0.5555555555555556;
-		dW[1] = +0.8888888888888888;
-		dW[2] = +0.5555555555555556;
-
-	// Degree 4
-	} else if (nCount == 4) {
-		dG[0] = -0.8611363115940526;
-		dG[1] = -0.3399810435848563;
-		dG[2] = +0.3399810435848563;
-		dG[3] = +0.8611363115940526;
-
-		dW[0] = 0.3478548451374538;
-		dW[1] = 0.6521451548625461;
-		dW[2] = 0.6521451548625461;
-		dW[3] = 0.3478548451374538;
-
-	// Degree 5
-	} else if (nCount == 5) {
-		dG[0] = -0.9061798459386640;
-		dG[1] = -0.5384693101056831;
-		dG[2] =  0.0;
-		dG[3] = +0.5384693101056831;
-		dG[4] = +0.9061798459386640;
-
-		dW[0] = 0.2369268850561891;
-		dW[1] = 0.4786286704993665;
-		dW[2] = 0.5688888888888889;
-		dW[3] = 0.4786286704993665;
-		dW[4] = 0.2369268850561891;
-
-	// Degree 6
-	} else if (nCount == 6) {
-		dG[0] = -0.9324695142031521;
-		dG[1] = -0.6612093864662645;
-		dG[2] = -0.2386191860831969;
-		dG[3] = +0.2386191860831969;
-		dG[4] = +0.6612093864662645;
-		dG[5] = +0.9324695142031521;
-
-		dW[0] = 0.1713244923791704;
-		dW[1] = 0.3607615730481386;
-		dW[2] = 0.4679139345726910;
-		dW[3] = 0.4679139345726910;
-		dW[4] = 0.3607615730481386;
-		dW[5] = 0.1713244923791704;
-
-	// Degree 7
-	} else if (nCount == 7) {
-		dG[0] = -0.9491079123427585;
-		dG[1] = -0.7415311855993945;
-		dG[2] = -0.4058451513773972;
-		dG[3] =  0.0;
-		dG[4] = +0.4058451513773972;
-		dG[5] = +0.7415311855993945;
-		dG[6] = +0.9491079123427585;
-
-		dW[0] = 0.1294849661688697;
-		dW[1] = 0.2797053914892766;
-		dW[2] = 0.3818300505051189;
-		dW[3] = 0.4179591836734694;
-		dW[4] = 0.3818300505051189;
-		dW[5] = 0.2797053914892766;
-		dW[6] = 0.1294849661688697;
-
-	// Degree 8
-	} else if (nCount == 8) {
-		dG[0] = -0.9602898564975363;
-		dG[1] = -0.7966664774136267;
-		dG[2] = -0.5255324099163290;
-		dG[3] = -0.1834346424956498;
-		dG[4] = +0.1834346424956498;
-		dG[5] = +0.5255324099163290;
-		dG[6] = +0.7966664774136267;
-		dG[7] = +0.9602898564975363;
-
-		dW[0] = 0.1012285362903763;
-		dW[1] = 0.2223810344533745;
-		dW[2] = 0.3137066458778873;
-		dW[3] = 0.3626837833783620;
-		dW[4] = 0.3626837833783620;
-		dW[5] = 0.3137066458778873;
-		dW[6] = 0.2223810344533745;
-		dW[7] = 0.1012285362903763;
-
-	// Degree 9
-	} else if (nCount == 9) {
-		dG[0] = -1.0;
-		dG[1] = -0.899757995411460;
-		dG[2] = -0.677186279510738;
-		dG[3] = -0.363117463826178;
-		dG[4] =  0.0;
-		dG[5] = +0.363117463826178;
-		dG[6] = +0.677186279510738;
-		dG[7] = +0.899757995411460;
-		dG[8] = +1.0;
-
-		dW[0] = 0.0812743883615744;
-		dW[1] = 0.1806481606948574;
-		dW[2] = 0.2606106964029354;
-		dW[3] = 0.3123470770400029;
-		dW[4] = 0.3302393550012598;
-		dW[5] = 0.3123470770400029;
-		dW[6] = 0.2606106964029354;
-		dW[7] = 0.1806481606948574;
-		dW[8] = 0.0812743883615744;
-
-	// Degree 10
-	} else if (nCount == 10) {
-		dG[0] = -0.9739065285171717;
-		dG[1] = -0.8650633666889845;
-		dG[2] = -0.6794095682990244;
-		dG[3] = -0.4333953941292472;
-		dG[4] = -0.1488743389816312;
-		dG[5] = +0.1488743389816312;
-		dG[6] = +0.4333953941292472;
-		dG[7] = +0.6794095682990244;
-		dG[8] = +0.8650633666889845;
-		dG[9] = +0.9739065285171717;
-
-		dW[0] = 0.0666713443086881;
-		dW[1] = 0.1494513491505806;
-		dW[2] = 0.2190863625159820;
-		dW[3] = 0.2692667193099963;
-		dW[4] = 0.2955242247147529;
-		dW[5] = 0.2955242247147529;
-		dW[6] = 0.2692667193099963;
-		dW[7] = 0.2190863625159820;
-		dW[8] = 0.1494513491505806;
-		dW[9] = 0.0666713443086881;
-
-	// Higher degrees
-	} else {
-		LegendrePolynomial::AllRoots(nCount, dG);
+		LegendrePolynomial::AllRoots(nCount, dCompG);
 
 		for (int k = 0; k < nCount; k++) {
 			double dDeriv =
-				LegendrePolynomial::EvaluateDerivative(nCount, dG[k]);
+				LegendrePolynomial::EvaluateDerivative(nCount, dCompG[k]);
 
-			dW[k] = 2.0 / ((1.0 - dG[k] * dG[k]) * dDeriv * dDeriv);
+			dCompW[k] =
+				2.0 / ((1.0 - dCompG[k] * dCompG[k]) * dDeriv * dDeriv);
 		}
 
+		vecPoints.swap(vecComputed);
 	}
+
+	dG = &(vecPoints[0]);
+	dW = &(vecPoints[nCount]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GaussQuadrature::GetPoints(
+	int nCount,
+	DataArray1D<double> & dG,
+	DataArray1D<double> & dW
+) {
+	const double * dCachedG;
+	const double * dCachedW;
+
+	GetCachedPoints(nCount, dCachedG, dCachedW);
+
+	// Initialize the arrays
+	dG.Allocate(nCount);
+	dW.Allocate(nCount);
+
+	memcpy(dG, dCachedG, nCount * sizeof(double));
+	memcpy(dW, dCachedW, nCount * sizeof(double));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
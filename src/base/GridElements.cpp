@@ -23,6 +23,7 @@
 #include "GaussQuadrature.h"
 #include "STLStringHelper.h"
 #include "MeshUtilitiesFuzzy.h"
+#include "RadixSort.h"
 
 #include <ctime>
 #include <cmath>
@@ -130,63 +131,878 @@ void Face::RemoveZeroEdges() {
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// EdgeMap
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Comparator between an EdgePair and an Edge used for lookups in the
+///		EdgeMap table.
+///	</summary>
+struct EdgePairLessThanEdge {
+	bool operator()(const EdgePair & edgepr, const Edge & edge) const {
+		return (edgepr.first < edge);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+EdgeMap::iterator EdgeMap::find(
+	const Edge & edge
+) {
+	iterator iter =
+		std::lower_bound(m_vecEdges.begin(), m_vecEdges.end(), edge,
+			EdgePairLessThanEdge());
+
+	if ((iter == m_vecEdges.end()) || (edge < iter->first)) {
+		return m_vecEdges.end();
+	}
+	return iter;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+EdgeMap::const_iterator EdgeMap::find(
+	const Edge & edge
+) const {
+	const_iterator iter =
+		std::lower_bound(m_vecEdges.begin(), m_vecEdges.end(), edge,
+			EdgePairLessThanEdge());
+
+	if ((iter == m_vecEdges.end()) || (edge < iter->first)) {
+		return m_vecEdges.end();
+	}
+	return iter;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::pair<EdgeMap::iterator, bool> EdgeMap::insert(
+	const value_type & value
+) {
+	iterator iter =
+		std::lower_bound(m_vecEdges.begin(), m_vecEdges.end(), value.first,
+			EdgePairLessThanEdge());
+
+	if ((iter != m_vecEdges.end()) && !(value.first < iter->first)) {
+		return std::pair<iterator, bool>(iter, false);
+	}
+
+	iter = m_vecEdges.insert(iter, value);
+	return std::pair<iterator, bool>(iter, true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void EdgeMap::assign(
+	EdgeMapVector & vecEdges
+) {
+	m_vecEdges.swap(vecEdges);
+	vecEdges.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// CompactFaceVector
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactFaceVector::AddFace(
+	int nNodes,
+	const int * ixNodes,
+	const int * iEdgeTypes
+) {
+	_ASSERT(nNodes >= 0);
+
+	// Only store Edge types if a non-default type is present
+	if ((iEdgeTypes != NULL) && (vecEdgeTypes.size() == 0)) {
+		for (int k = 0; k < nNodes; k++) {
+			if (iEdgeTypes[k] != static_cast<int>(Edge::Type_Default)) {
+				AllocateEdgeTypes();
+				break;
+			}
+		}
+	}
+
+	vecFaceNodes.insert(vecFaceNodes.end(), ixNodes, ixNodes + nNodes);
+	vecFaceOffsets.push_back(vecFaceNodes.size());
+
+	if (vecEdgeTypes.size() != 0) {
+		for (int k = 0; k < nNodes; k++) {
+			if (iEdgeTypes == NULL) {
+				vecEdgeTypes.push_back(
+					static_cast<unsigned char>(Edge::Type_Default));
+			} else {
+				vecEdgeTypes.push_back(
+					static_cast<unsigned char>(iEdgeTypes[k]));
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Face CompactFaceVector::GetFace(
+	size_t f
+) const {
+	_ASSERT(f < size());
+
+	const int nNodes = GetNodeCount(f);
+	const int * ixNodes = GetNodes(f);
+
+	Face face(nNodes);
+	for (int k = 0; k < nNodes; k++) {
+		face.SetNode(k, ixNodes[k]);
+	}
+	if (vecEdgeTypes.size() != 0) {
+		for (int k = 0; k < nNodes; k++) {
+			face.edges[k].type = GetEdgeType(f, k);
+		}
+	}
+	return face;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactFaceVector::FromFaces(
+	const FaceVector & faces
+) {
+	const long lFaces = static_cast<long>(faces.size());
+
+	// Offsets and detection of non-default Edge types
+	bool fHasEdgeTypes = false;
+
+	vecFaceOffsets.resize(faces.size() + 1);
+	vecFaceOffsets[0] = 0;
+	for (size_t f = 0; f < faces.size(); f++) {
+		const EdgeVector & edges = faces[f].edges;
+		vecFaceOffsets[f+1] = vecFaceOffsets[f] + edges.size();
+
+		if (!fHasEdgeTypes) {
+			for (size_t k = 0; k < edges.size(); k++) {
+				if (edges[k].type != Edge::Type_Default) {
+					fHasEdgeTypes = true;
+					break;
+				}
+			}
+		}
+	}
+
+	vecFaceNodes.resize(vecFaceOffsets[faces.size()]);
+	vecEdgeTypes.clear();
+	if (fHasEdgeTypes) {
+		vecEdgeTypes.resize(vecFaceNodes.size());
+	}
+
+	// Copy nodes and Edge types
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < lFaces; lf++) {
+		const Face & face = faces[lf];
+		const size_t sOffset = vecFaceOffsets[lf];
+		for (size_t k = 0; k < face.edges.size(); k++) {
+			vecFaceNodes[sOffset + k] = face[k];
+		}
+		if (fHasEdgeTypes) {
+			for (size_t k = 0; k < face.edges.size(); k++) {
+				vecEdgeTypes[sOffset + k] =
+					static_cast<unsigned char>(face.edges[k].type);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactFaceVector::ToFaces(
+	FaceVector & faces
+) const {
+	const long lFaces = static_cast<long>(size());
+
+	faces.clear();
+	faces.resize(size());
+
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < lFaces; lf++) {
+		faces[lf] = GetFace(lf);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// ReverseNodeArray
+///////////////////////////////////////////////////////////////////////////////
+
+struct ReverseNodeArrayFaceVectorAccessor {
+	ReverseNodeArrayFaceVectorAccessor(
+		const FaceVector & _faces
+	) :
+		faces(_faces)
+	{ }
+
+	size_t GetNodeCount(size_t f) const {
+		return faces[f].edges.size();
+	}
+
+	int GetNode(size_t f, size_t k) const {
+		return faces[f].edges[k][0];
+	}
+
+	const FaceVector & faces;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <class FaceAccessor>
+void ReverseNodeArray::ConstructFromAccessor(
+	size_t sNodes,
+	size_t sFaces,
+	const FaceAccessor & accessor
+) {
+	const long lFaces = static_cast<long>(sFaces);
+	const long lNodes = static_cast<long>(sNodes);
+
+	// Count the number of distinct Faces associated with each node
+	m_vecOffsets.assign(sNodes + 1, 0);
+
+	bool fInvalidNode = false;
+
+#pragma omp parallel for schedule(static) reduction(||:fInvalidNode)
+	for (long lf = 0; lf < lFaces; lf++) {
+		const size_t sNodeCount = accessor.GetNodeCount(lf);
+		for (size_t k = 0; k < sNodeCount; k++) {
+			const int ixNode = accessor.GetNode(lf, k);
+			if ((ixNode < 0) || (ixNode >= lNodes)) {
+				fInvalidNode = true;
+				continue;
+			}
+
+			// Faces with repeated nodes are only associated once
+			size_t kPrev = 0;
+			for (; kPrev < k; kPrev++) {
+				if (accessor.GetNode(lf, kPrev) == ixNode) {
+					break;
+				}
+			}
+			if (kPrev != k) {
+				continue;
+			}
+
+#pragma omp atomic
+			m_vecOffsets[ixNode + 1]++;
+		}
+	}
+
+	if (fInvalidNode) {
+		_EXCEPTION1("Face node index out of range [0,%lu)", sNodes);
+	}
+
+	for (size_t s = 0; s < sNodes; s++) {
+		m_vecOffsets[s + 1] += m_vecOffsets[s];
+	}
+
+	// Scatter Face indices into each node's slot
+	m_vecFaces.resize(m_vecOffsets[sNodes]);
+
+	std::vector<size_t> vecNextSlot(
+		m_vecOffsets.begin(), m_vecOffsets.end() - 1);
+
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < lFaces; lf++) {
+		const size_t sNodeCount = accessor.GetNodeCount(lf);
+		for (size_t k = 0; k < sNodeCount; k++) {
+			const int ixNode = accessor.GetNode(lf, k);
+
+			size_t kPrev = 0;
+			for (; kPrev < k; kPrev++) {
+				if (accessor.GetNode(lf, kPrev) == ixNode) {
+					break;
+				}
+			}
+			if (kPrev != k) {
+				continue;
+			}
+
+			size_t sSlot;
+#pragma omp atomic capture
+			sSlot = vecNextSlot[ixNode]++;
+
+			m_vecFaces[sSlot] = static_cast<int>(lf);
+		}
+	}
+
+	// Scatter order depends on thread scheduling; sort each node's Faces
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (long ln = 0; ln < lNodes; ln++) {
+		std::sort(
+			m_vecFaces.begin() + m_vecOffsets[ln],
+			m_vecFaces.begin() + m_vecOffsets[ln + 1]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ReverseNodeArray::Construct(
+	size_t sNodes,
+	const FaceVector & faces
+) {
+	ConstructFromAccessor(
+		sNodes,
+		faces.size(),
+		ReverseNodeArrayFaceVectorAccessor(faces));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ReverseNodeArray::Construct(
+	size_t sNodes,
+	const CompactFaceVector & compactfaces
+) {
+	ConstructFromAccessor(
+		sNodes,
+		compactfaces.size(),
+		compactfaces);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// FaceCapTree
+///////////////////////////////////////////////////////////////////////////////
+
+const Real FaceCapTree::CapPadding = 1.0e-8;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Comparator for sorting Face indices by the coordinate of the center
+///		of their cap along one axis.
+///	</summary>
+struct FaceCapTreeCenterLessThan {
+	FaceCapTreeCenterLessThan(
+		const std::vector<Real> & _vecCenters,
+		int _iAxis
+	) :
+		vecCenters(_vecCenters),
+		iAxis(_iAxis)
+	{ }
+
+	bool operator()(int ix1, int ix2) const {
+		Real d1 = vecCenters[3 * ix1 + iAxis];
+		Real d2 = vecCenters[3 * ix2 + iAxis];
+		if (d1 != d2) {
+			return (d1 < d2);
+		}
+		return (ix1 < ix2);
+	}
+
+	const std::vector<Real> & vecCenters;
+	int iAxis;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceCapTree::SetCosRadius(
+	Cap & cap
+) {
+	if (cap.dRadius + CapPadding >= M_PI) {
+		cap.dCosRadius = -2.0;
+	} else {
+		cap.dCosRadius = cos(cap.dRadius + CapPadding);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FaceCapTree::Cap FaceCapTree::MergeCaps(
+	const Cap & cap1,
+	const Cap & cap2
+) {
+	Node node1(cap1.x, cap1.y, cap1.z);
+	Node node2(cap2.x, cap2.y, cap2.z);
+
+	// Angle between cap centers
+	Node nodeCross = CrossProduct(node1, node2);
+	Real dTheta = atan2(nodeCross.Magnitude(), DotProduct(node1, node2));
+
+	// One cap contains the other
+	if (cap1.dRadius >= dTheta + cap2.dRadius) {
+		return cap1;
+	}
+	if (cap2.dRadius >= dTheta + cap1.dRadius) {
+		return cap2;
+	}
+
+	Cap cap;
+	cap.ixLeft = (-1);
+	cap.ixRight = (-1);
+	cap.ixBegin = 0;
+	cap.ixEnd = 0;
+	cap.dRadius = 0.5 * (dTheta + cap1.dRadius + cap2.dRadius);
+
+	if (cap.dRadius >= M_PI) {
+		cap.x = cap1.x;
+		cap.y = cap1.y;
+		cap.z = cap1.z;
+		cap.dRadius = M_PI;
+
+	} else {
+		// Rotate the center of the first cap towards the second
+		Node nodeTangent = node2 - node1 * DotProduct(node1, node2);
+		Real dTangentMag = nodeTangent.Magnitude();
+
+		Node nodeCenter = node1;
+		if (dTangentMag > 0.0) {
+			Real dAlpha = cap.dRadius - cap1.dRadius;
+			nodeCenter =
+				node1 * cos(dAlpha)
+				+ nodeTangent * (sin(dAlpha) / dTangentMag);
+			nodeCenter = nodeCenter.Normalized();
+		}
+
+		cap.x = nodeCenter.x;
+		cap.y = nodeCenter.y;
+		cap.z = nodeCenter.z;
+	}
+
+	SetCosRadius(cap);
+
+	return cap;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int FaceCapTree::BuildRecursive(
+	const std::vector<Cap> & vecFaceCaps,
+	const std::vector<Real> & vecCenters,
+	int ixBegin,
+	int ixEnd
+) {
+	int ixCap = static_cast<int>(m_vecCaps.size());
+	m_vecCaps.push_back(Cap());
+
+	// Leaf
+	if (ixEnd - ixBegin <= MaxLeafFaces) {
+		Cap cap = vecFaceCaps[m_vecFaces[ixBegin]];
+		for (int i = ixBegin + 1; i < ixEnd; i++) {
+			cap = MergeCaps(cap, vecFaceCaps[m_vecFaces[i]]);
+		}
+		cap.ixLeft = (-1);
+		cap.ixRight = (-1);
+		cap.ixBegin = ixBegin;
+		cap.ixEnd = ixEnd;
+
+		m_vecCaps[ixCap] = cap;
+		return ixCap;
+	}
+
+	// Split at the median along the axis of greatest extent of cap centers
+	Real dMin[3] = { vecFaceCaps[m_vecFaces[ixBegin]].x,
+	                 vecFaceCaps[m_vecFaces[ixBegin]].y,
+	                 vecFaceCaps[m_vecFaces[ixBegin]].z };
+	Real dMax[3] = { dMin[0], dMin[1], dMin[2] };
+
+	for (int i = ixBegin + 1; i < ixEnd; i++) {
+		const Cap & capFace = vecFaceCaps[m_vecFaces[i]];
+		dMin[0] = std::min(dMin[0], capFace.x);
+		dMin[1] = std::min(dMin[1], capFace.y);
+		dMin[2] = std::min(dMin[2], capFace.z);
+		dMax[0] = std::max(dMax[0], capFace.x);
+		dMax[1] = std::max(dMax[1], capFace.y);
+		dMax[2] = std::max(dMax[2], capFace.z);
+	}
+
+	int iAxis = 0;
+	if (dMax[1] - dMin[1] > dMax[iAxis] - dMin[iAxis]) {
+		iAxis = 1;
+	}
+	if (dMax[2] - dMin[2] > dMax[iAxis] - dMin[iAxis]) {
+		iAxis = 2;
+	}
+
+	int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+
+	std::nth_element(
+		m_vecFaces.begin() + ixBegin,
+		m_vecFaces.begin() + ixMid,
+		m_vecFaces.begin() + ixEnd,
+		FaceCapTreeCenterLessThan(vecCenters, iAxis));
+
+	int ixLeft = BuildRecursive(vecFaceCaps, vecCenters, ixBegin, ixMid);
+	int ixRight = BuildRecursive(vecFaceCaps, vecCenters, ixMid, ixEnd);
+
+	Cap cap = MergeCaps(m_vecCaps[ixLeft], m_vecCaps[ixRight]);
+	cap.ixLeft = ixLeft;
+	cap.ixRight = ixRight;
+	cap.ixBegin = 0;
+	cap.ixEnd = 0;
+
+	m_vecCaps[ixCap] = cap;
+	return ixCap;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceCapTree::Construct(
+	const NodeVector & nodes,
+	const FaceVector & faces
+) {
+	static const int ConstantLatitudeSamples = 16;
+
+	clear();
+
+	if (faces.size() == 0) {
+		return;
+	}
+
+	const int nFaces = static_cast<int>(faces.size());
+
+	// Bounding cap of each Face
+	std::vector<Cap> vecFaceCaps(faces.size());
+
+	bool fInvalidNode = false;
+
+#pragma omp parallel for schedule(static) reduction(||:fInvalidNode)
+	for (int f = 0; f < nFaces; f++) {
+		const Face & face = faces[f];
+		const int nEdges = static_cast<int>(face.edges.size());
+
+		Cap & cap = vecFaceCaps[f];
+		cap.ixLeft = (-1);
+		cap.ixRight = (-1);
+		cap.ixBegin = 0;
+		cap.ixEnd = 0;
+
+		Node nodeCenter;
+		for (int i = 0; i < nEdges; i++) {
+			if ((face[i] < 0) || (face[i] >= static_cast<int>(nodes.size()))) {
+				fInvalidNode = true;
+				break;
+			}
+			nodeCenter += nodes[face[i]].Normalized();
+		}
+		if (fInvalidNode) {
+			continue;
+		}
+
+		Real dCenterMag = nodeCenter.Magnitude();
+		if ((nEdges == 0) || (dCenterMag == 0.0)) {
+			cap.x = 1.0;
+			cap.y = 0.0;
+			cap.z = 0.0;
+			cap.dRadius = M_PI;
+			SetCosRadius(cap);
+			continue;
+		}
+		nodeCenter /= dCenterMag;
+
+		// Great circle arcs lie within the cap of their endpoints as long
+		// as the cap is no larger than a hemisphere
+		Real dRadius = 0.0;
+		for (int i = 0; i < nEdges; i++) {
+			Node nodeVertex = nodes[face[i]].Normalized();
+			Node nodeCross = CrossProduct(nodeCenter, nodeVertex);
+			dRadius = std::max(dRadius,
+				atan2(nodeCross.Magnitude(), DotProduct(nodeCenter, nodeVertex)));
+
+			// Lines of constant latitude bulge poleward of the great circle
+			// arc; sample along them and pad by the sampling error
+			if (face.edges[i].type == Edge::Type_ConstantLatitude) {
+				const Node & node0 = nodes[face.edges[i][0]];
+				const Node & node1 = nodes[face.edges[i][1]];
+
+				Real dLon0 = atan2(node0.y, node0.x);
+				Real dLon1 = atan2(node1.y, node1.x);
+				Real dDeltaLon = dLon1 - dLon0;
+				if (dDeltaLon > M_PI) {
+					dDeltaLon -= 2.0 * M_PI;
+				}
+				if (dDeltaLon < -M_PI) {
+					dDeltaLon += 2.0 * M_PI;
+				}
+
+				Node node0n = node0.Normalized();
+				Real dZ = node0n.z;
+				Real dR = sqrt(std::max(0.0, 1.0 - dZ * dZ));
+
+				Real dSpacing = fabs(dDeltaLon) / ConstantLatitudeSamples;
+				for (int k = 1; k < ConstantLatitudeSamples; k++) {
+					Real dLon = dLon0 + dDeltaLon * static_cast<Real>(k)
+						/ static_cast<Real>(ConstantLatitudeSamples);
+					Node nodeSample(dR * cos(dLon), dR * sin(dLon), dZ);
+					Node nodeSampleCross = CrossProduct(nodeCenter, nodeSample);
+					dRadius = std::max(dRadius,
+						atan2(nodeSampleCross.Magnitude(),
+							DotProduct(nodeCenter, nodeSample))
+						+ dSpacing * dSpacing);
+				}
+			}
+		}
+
+		if (dRadius > 0.5 * M_PI) {
+			dRadius = M_PI;
+		}
+
+		cap.x = nodeCenter.x;
+		cap.y = nodeCenter.y;
+		cap.z = nodeCenter.z;
+		cap.dRadius = dRadius;
+		SetCosRadius(cap);
+	}
+
+	if (fInvalidNode) {
+		_EXCEPTIONT("Face node index out of range");
+	}
+
+	// Build the hierarchy
+	std::vector<Real> vecCenters(3 * faces.size());
+	for (int f = 0; f < nFaces; f++) {
+		vecCenters[3*f+0] = vecFaceCaps[f].x;
+		vecCenters[3*f+1] = vecFaceCaps[f].y;
+		vecCenters[3*f+2] = vecFaceCaps[f].z;
+	}
+
+	m_vecFaces.resize(faces.size());
+	for (int f = 0; f < nFaces; f++) {
+		m_vecFaces[f] = f;
+	}
+
+	m_vecCaps.reserve(2 * (faces.size() / MaxLeafFaces + 1));
+
+	BuildRecursive(vecFaceCaps, vecCenters, 0, nFaces);
+
+	m_sFaces = faces.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceCapTree::FindCandidateFaces(
+	const Node & node,
+	std::vector<int> & vecFaces
+) const {
+	vecFaces.clear();
+
+	if (m_vecCaps.size() == 0) {
+		return;
+	}
+
+	Real dMag = node.Magnitude();
+	if (dMag == 0.0) {
+		vecFaces = m_vecFaces;
+		std::sort(vecFaces.begin(), vecFaces.end());
+		return;
+	}
+
+	Node nodeUnit = node / dMag;
+
+	std::vector<int> vecStack;
+	vecStack.push_back(0);
+
+	while (vecStack.size() != 0) {
+		const Cap & cap = m_vecCaps[vecStack.back()];
+		vecStack.pop_back();
+
+		Real dDot =
+			cap.x * nodeUnit.x
+			+ cap.y * nodeUnit.y
+			+ cap.z * nodeUnit.z;
+
+		if (dDot < cap.dCosRadius) {
+			continue;
+		}
+
+		if (cap.ixLeft < 0) {
+			for (int i = cap.ixBegin; i < cap.ixEnd; i++) {
+				vecFaces.push_back(m_vecFaces[i]);
+			}
+
+		} else {
+			vecStack.push_back(cap.ixRight);
+			vecStack.push_back(cap.ixLeft);
+		}
+	}
+
+	std::sort(vecFaces.begin(), vecFaces.end());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Mesh
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Clear() {
-	nodes.clear();
-	faces.clear();
-	edgemap.clear();
-	revnodearray.clear();
-}
+void Mesh::Clear() {
+	nodes.clear();
+	faces.clear();
+	compactfaces.clear();
+	edgemap.clear();
+	revnodearray.clear();
+	facetree.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ConstructCompactFaces() {
+	compactfaces.FromFaces(faces);
+	FaceVector().swap(faces);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ConstructFacesFromCompact() {
+	compactfaces.ToFaces(faces);
+	compactfaces = CompactFaceVector();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::DiscardStaleCompactFaces() {
+	if ((faces.size() != 0) && (compactfaces.size() != 0)) {
+		compactfaces = CompactFaceVector();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ConstructEdgeMap() {
+
+	DiscardStaleCompactFaces();
+
+	edgemap.clear();
+
+	// Faces are taken from compactfaces if the FaceVector is empty
+	const bool fUseCompact = (faces.size() == 0);
+	const long lFaces = static_cast<long>(GetFaceCount());
+
+	// Count the non-zero Edges of each Face
+	std::vector<size_t> vecEdgeOffsets(lFaces + 1);
+	vecEdgeOffsets[0] = 0;
+
+	int ixMinNode = 0;
+	int ixMaxNode = 0;
+
+#pragma omp parallel for schedule(static) reduction(min:ixMinNode) reduction(max:ixMaxNode)
+	for (long lf = 0; lf < lFaces; lf++) {
+		const int nEdges =
+			(fUseCompact)?(compactfaces.GetNodeCount(lf)):(faces[lf].edges.size());
+
+		size_t sNonZeroEdges = 0;
+		for (int k = 0; k < nEdges; k++) {
+			int ixNode0;
+			int ixNode1;
+			if (fUseCompact) {
+				ixNode0 = compactfaces.GetNode(lf, k);
+				ixNode1 = compactfaces.GetNode(lf, (k+1)%nEdges);
+			} else {
+				ixNode0 = faces[lf][k];
+				ixNode1 = faces[lf][(k+1)%nEdges];
+			}
+			if (ixNode0 < ixMinNode) {
+				ixMinNode = ixNode0;
+			}
+			if (ixNode0 > ixMaxNode) {
+				ixMaxNode = ixNode0;
+			}
+			if (ixNode0 != ixNode1) {
+				sNonZeroEdges++;
+			}
+		}
+		vecEdgeOffsets[lf+1] = sNonZeroEdges;
+	}
+
+	if (ixMinNode < 0) {
+		_EXCEPTION1("Invalid node index (%i) in Face", ixMinNode);
+	}
 
-///////////////////////////////////////////////////////////////////////////////
+	for (long lf = 0; lf < lFaces; lf++) {
+		vecEdgeOffsets[lf+1] += vecEdgeOffsets[lf];
+	}
 
-void Mesh::ConstructEdgeMap() {
+	// Emit one (min node, max node, face) record per non-zero Edge.  The
+	// value stores the Face index and whether the Edge is reversed.
+	const int nNodeBits = RadixSortBitCount(static_cast<uint64_t>(ixMaxNode));
 
-	// Construct the edge map
-	edgemap.clear();
-	for (int i = 0; i < faces.size(); i++) {
-		const Face & face = faces[i];
+	std::vector<uint64_t> vecKeys(vecEdgeOffsets[lFaces]);
+	std::vector<uint64_t> vecValues(vecEdgeOffsets[lFaces]);
 
-		int nEdges = face.edges.size();
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < lFaces; lf++) {
+		const int nEdges =
+			(fUseCompact)?(compactfaces.GetNodeCount(lf)):(faces[lf].edges.size());
 
+		size_t s = vecEdgeOffsets[lf];
 		for (int k = 0; k < nEdges; k++) {
-			if (faces[i][k] == face[(k+1)%nEdges]) {
+			int ixNode0;
+			int ixNode1;
+			if (fUseCompact) {
+				ixNode0 = compactfaces.GetNode(lf, k);
+				ixNode1 = compactfaces.GetNode(lf, (k+1)%nEdges);
+			} else {
+				ixNode0 = faces[lf][k];
+				ixNode1 = faces[lf][(k+1)%nEdges];
+			}
+			if (ixNode0 == ixNode1) {
 				continue;
 			}
 
-			Edge edge(face[k], face[(k+1)%nEdges]);
-			FacePair facepair;
+			uint64_t ulReversed = 0;
+			if (ixNode0 > ixNode1) {
+				std::swap(ixNode0, ixNode1);
+				ulReversed = 1;
+			}
+
+			vecKeys[s] =
+				(static_cast<uint64_t>(ixNode0) << nNodeBits)
+				| static_cast<uint64_t>(ixNode1);
+			vecValues[s] = (static_cast<uint64_t>(lf) << 1) | ulReversed;
+			s++;
+		}
+	}
+
+	// Sort records by Edge.  The sort is stable, so records of each Edge
+	// remain in order of Face index.
+	RadixSortKeyValue(vecKeys, vecValues, 2 * nNodeBits);
+
+	// Build the flat edge table
+	const uint64_t ulNodeMask = (static_cast<uint64_t>(1) << nNodeBits) - 1;
+
+	size_t sUniqueEdges = 0;
+	for (size_t s = 0; s < vecKeys.size(); s++) {
+		if ((s == 0) || (vecKeys[s] != vecKeys[s-1])) {
+			sUniqueEdges++;
+		}
+	}
+
+	EdgeMapVector vecEdges;
+	vecEdges.reserve(sUniqueEdges);
 
-			EdgeMapIterator iter =
-				edgemap.insert(EdgeMapPair(edge, facepair)).first;
+	for (size_t s = 0; s < vecKeys.size(); s++) {
+		if ((s == 0) || (vecKeys[s] != vecKeys[s-1])) {
+			int ixNode0 = static_cast<int>(vecKeys[s] >> nNodeBits);
+			int ixNode1 = static_cast<int>(vecKeys[s] & ulNodeMask);
 
-			iter->second.AddFace(i);
+			// Edge orientation is taken from the first Face
+			if (vecValues[s] & 1) {
+				std::swap(ixNode0, ixNode1);
+			}
+			vecEdges.push_back(EdgePair(Edge(ixNode0, ixNode1), FacePair()));
 		}
+		vecEdges.back().second.AddFace(static_cast<int>(vecValues[s] >> 1));
 	}
 
+	edgemap.assign(vecEdges);
+
 	Announce("Mesh size: Edges [%i]", edgemap.size());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Mesh::ConstructReverseNodeArray() {
+	DiscardStaleCompactFaces();
 
-	// Initialize the object
-	revnodearray.resize(nodes.size());
-	for (int i = 0; i < revnodearray.size(); i++) {
-		revnodearray[i].clear();
+	if ((faces.size() == 0) && (compactfaces.size() != 0)) {
+		revnodearray.Construct(nodes.size(), compactfaces);
+	} else {
+		revnodearray.Construct(nodes.size(), faces);
 	}
+}
 
-	// Build set for each node
-	for (int i = 0; i < faces.size(); i++) {
-		for (int k = 0; k < faces[i].edges.size(); k++) {
-			int ixNode = faces[i].edges[k][0];
-			revnodearray[ixNode].insert(i);
-		}
-	}
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ConstructFaceTree() {
+	facetree.Construct(nodes, faces);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -201,25 +1017,50 @@ Real Mesh::CalculateFaceAreas(
 		return 0.0;
 	}
 
-	// Calculate the area of each Face
+	// Calculate the area of each Face; each area is independent of the
+	// thread count so the accumulated sum below is reproducible
+	const long lFaces = static_cast<long>(faces.size());
+
 	if (fContainsConcaveFaces) {
 
-		for (int i = 0; i < faces.size(); i++) {
-			vecFaceArea[i] = CalculateFaceArea_Concave(faces[i], nodes);
-			if (vecFaceArea[i] < 1.0e-13) {
+		// Concave Faces may throw during subdivision; defer the exception
+		// from the lowest Face index until after the parallel region
+		long lFirstError = lFaces;
+		Exception excFirst(__FILE__, __LINE__);
+
+#pragma omp parallel for schedule(dynamic,256) reduction(+:nCount)
+		for (long lf = 0; lf < lFaces; lf++) {
+			try {
+				vecFaceArea[lf] = CalculateFaceArea_Concave(faces[lf], nodes);
+			} catch(Exception & e) {
+#pragma omp critical
+				{
+					if (lf < lFirstError) {
+						lFirstError = lf;
+						excFirst = e;
+					}
+				}
+				continue;
+			}
+			if (vecFaceArea[lf] < 1.0e-13) {
 				nCount++;
 			}
 		}
 
+		if (lFirstError != lFaces) {
+			throw excFirst;
+		}
+
 		if (nCount != 0) {
 			Announce("WARNING: %i small elements found", nCount);
 		}
 
 	} else {
 
-		for (int i = 0; i < faces.size(); i++) {
-			vecFaceArea[i] = CalculateFaceArea(faces[i], nodes);
-			if (vecFaceArea[i] < 1.0e-13) {
+#pragma omp parallel for schedule(static) reduction(+:nCount)
+		for (long lf = 0; lf < lFaces; lf++) {
+			vecFaceArea[lf] = CalculateFaceArea(faces[lf], nodes);
+			if (vecFaceArea[lf] < 1.0e-13) {
 				nCount++;
 			}
 		}
@@ -253,125 +1094,903 @@ Real Mesh::CalculateFaceAreas(
 		vecFaceAreaBak.resize((vecFaceAreaBak.size()-1) / Jump + 1);
 	}
 
-	return vecFaceAreaBak[0];
-}
+	return vecFaceAreaBak[0];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Real Mesh::CalculateFaceAreasFromOverlap(
+	const Mesh & meshOverlap
+) {
+	if (meshOverlap.vecFaceArea.GetRows() == 0) {
+		_EXCEPTIONT("MeshOverlap Face Areas have not been calculated");
+	}
+
+	// Set all Face areas to zero
+	vecFaceArea.Allocate(faces.size());
+
+	// Loop over all Faces in meshOverlap
+	double dTotalArea = 0.0;
+
+	for (int i = 0; i < meshOverlap.faces.size(); i++) {
+		int ixFirstFace = meshOverlap.vecSourceFaceIx[i];
+
+		if (ixFirstFace >= vecFaceArea.GetRows()) {
+			_EXCEPTIONT("Overlap Mesh FirstFaceIx contains invalid "
+				"Face index");
+		}
+
+		vecFaceArea[ixFirstFace] += meshOverlap.vecFaceArea[i];
+		dTotalArea += meshOverlap.vecFaceArea[i];
+	}
+	return dTotalArea;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ExchangeFirstAndSecondMesh() {
+
+	// Verify all vectors are the same size
+	if ((faces.size() != vecSourceFaceIx.size()) ||
+		(faces.size() != vecTargetFaceIx.size())
+	) {
+		_EXCEPTIONT("");
+	}
+
+	// Reorder vectors
+	FaceVector facesOld = faces;
+
+	std::vector<int> vecSourceFaceIxOld = vecSourceFaceIx;
+
+	// Reordering map
+	std::multimap<int,int> multimapReorder;
+	for (int i = 0; i < vecTargetFaceIx.size(); i++) {
+		multimapReorder.insert(std::pair<int,int>(vecTargetFaceIx[i], i));
+	}
+
+	// Apply reordering
+	faces.clear();
+	vecSourceFaceIx.clear();
+	vecTargetFaceIx.clear();
+
+	std::multimap<int,int>::const_iterator iterReorder
+		= multimapReorder.begin();
+
+	for (; iterReorder != multimapReorder.end(); iterReorder++) {
+		faces.push_back(facesOld[iterReorder->second]);
+		vecSourceFaceIx.push_back(iterReorder->first);
+		vecTargetFaceIx.push_back(vecSourceFaceIxOld[iterReorder->second]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A uniform spatial hash over a NodeVector (or a subset of its nodes)
+///		with cell size equal to twice the coincident node tolerance, so that
+///		the neighbors of a node lie in the 2x2x2 cells nearest to it.  Node
+///		indices are radix sorted by the hash
+///		of their cell, so that the nodes of each cell are stored contiguously
+///		in increasing index order, and a directory on the leading bits of the
+///		hash locates the run for a given cell.
+///	</summary>
+class CoincidentNodeSpatialHash {
+
+public:
+	///	<summary>
+	///		Build the spatial hash over all nodes, or over the given subset of
+	///		node indices in increasing order.  Returns false if the tolerance
+	///		is not positive or cell coordinates cannot be represented.
+	///	</summary>
+	bool Build(
+		const NodeVector & nodes,
+		double dTolerance,
+		const std::vector<int> * pvecSubset = NULL
+	) {
+		static const double MaxCellCoord = 4.0e18;
+
+		m_dTolerance = dTolerance;
+		m_dCellSize = 2.0 * dTolerance;
+		if (!(dTolerance > 0.0)) {
+			return false;
+		}
+
+		const size_t sCount =
+			(pvecSubset == NULL)?(nodes.size()):(pvecSubset->size());
+		const long lCount = static_cast<long>(sCount);
+
+		m_vecKeys.resize(sCount);
+		m_vecNodes.resize(sCount);
+
+		bool fInvalidCell = false;
+
+#pragma omp parallel for schedule(static) reduction(||:fInvalidCell)
+		for (long l = 0; l < lCount; l++) {
+			const size_t ixNode =
+				(pvecSubset == NULL)?(l):((*pvecSubset)[l]);
+			const Node & node = nodes[ixNode];
+			if (!(fabs(node.x / m_dCellSize) < MaxCellCoord) ||
+			    !(fabs(node.y / m_dCellSize) < MaxCellCoord) ||
+			    !(fabs(node.z / m_dCellSize) < MaxCellCoord)
+			) {
+				fInvalidCell = true;
+				continue;
+			}
+
+			int64_t iCell[3];
+			GetCell(node, iCell);
+
+			m_vecKeys[l] = Hash(iCell);
+			m_vecNodes[l] = static_cast<uint64_t>(ixNode);
+		}
+
+		if (fInvalidCell) {
+			return false;
+		}
+
+		RadixSortKeyValue(m_vecKeys, m_vecNodes);
+
+		// Directory on the leading bits of the hash
+		m_nDirectoryBits = RadixSortBitCount(sCount);
+		if (m_nDirectoryBits < 6 - OccupancyExtraBits) {
+			m_nDirectoryBits = 6 - OccupancyExtraBits;
+		}
+		const size_t sDirectorySize = static_cast<size_t>(1) << m_nDirectoryBits;
+
+		m_vecDirectory.resize(sDirectorySize + 1);
+
+		const size_t sOccupancyWords =
+			static_cast<size_t>(1) << (m_nDirectoryBits + OccupancyExtraBits - 6);
+
+		m_vecOccupancy.assign(sOccupancyWords, 0);
+
+#pragma omp parallel for schedule(static)
+		for (long l = 0; l <= lCount; l++) {
+			size_t sPrev = (l == 0)?(0):(Bucket(m_vecKeys[l-1]) + 1);
+			size_t sNext = (l == lCount)?(sDirectorySize):(Bucket(m_vecKeys[l]));
+			for (size_t b = sPrev; b <= sNext; b++) {
+				m_vecDirectory[b] = static_cast<size_t>(l);
+			}
+
+			if (l != lCount) {
+				const uint64_t ulBit = OccupancyBit(m_vecKeys[l]);
+#pragma omp atomic
+				m_vecOccupancy[ulBit >> 6] |= (static_cast<uint64_t>(1) << (ulBit & 63));
+			}
+		}
+
+		return true;
+	}
+
+	///	<summary>
+	///		Get the cell containing the given node.
+	///	</summary>
+	void GetCell(
+		const Node & node,
+		int64_t iCell[3]
+	) const {
+		iCell[0] = static_cast<int64_t>(floor(node.x / m_dCellSize));
+		iCell[1] = static_cast<int64_t>(floor(node.y / m_dCellSize));
+		iCell[2] = static_cast<int64_t>(floor(node.z / m_dCellSize));
+	}
+
+	///	<summary>
+	///		Get the range of cells [iBegin, iEnd] in one coordinate direction
+	///		that may contain nodes within the tolerance of the given
+	///		coordinate.  The margin absorbs rounding in the cell computation.
+	///	</summary>
+	void GetCellRange(
+		double dX,
+		int64_t & iBegin,
+		int64_t & iEnd
+	) const {
+		const double dCell = dX / m_dCellSize;
+		const double dFloor = floor(dCell);
+		const double dFrac = dCell - dFloor;
+		const double dMargin = 1.0e-3 + 1.0e-15 * fabs(dCell);
+
+		iBegin = static_cast<int64_t>(dFloor);
+		iEnd = iBegin;
+		if (dFrac < 0.5 + dMargin) {
+			iBegin--;
+		}
+		if (dFrac >= 0.5 - dMargin) {
+			iEnd++;
+		}
+	}
+
+	///	<summary>
+	///		Hash of a cell.
+	///	</summary>
+	static uint64_t Hash(
+		const int64_t iCell[3]
+	) {
+		uint64_t h = static_cast<uint64_t>(iCell[0]) * 0x9E3779B97F4A7C15ULL;
+		h ^= static_cast<uint64_t>(iCell[1]) * 0xC2B2AE3D27D4EB4FULL;
+		h ^= static_cast<uint64_t>(iCell[2]) * 0x165667B19E3779F9ULL;
+
+		h ^= (h >> 31);
+		h *= 0xBF58476D1CE4E5B9ULL;
+		h ^= (h >> 27);
+		h *= 0x94D049BB133111EBULL;
+		h ^= (h >> 31);
+		return h;
+	}
+
+	///	<summary>
+	///		Find the run of sorted entries [sBegin, sEnd) with the given hash.
+	///	</summary>
+	void FindRun(
+		uint64_t ulKey,
+		size_t & sBegin,
+		size_t & sEnd
+	) const {
+		const uint64_t ulBit = OccupancyBit(ulKey);
+		if ((m_vecOccupancy[ulBit >> 6] & (static_cast<uint64_t>(1) << (ulBit & 63))) == 0) {
+			sBegin = 0;
+			sEnd = 0;
+			return;
+		}
+
+		const size_t b = Bucket(ulKey);
+		std::pair<
+			std::vector<uint64_t>::const_iterator,
+			std::vector<uint64_t>::const_iterator> range =
+				std::equal_range(
+					m_vecKeys.begin() + m_vecDirectory[b],
+					m_vecKeys.begin() + m_vecDirectory[b+1],
+					ulKey);
+
+		sBegin = static_cast<size_t>(range.first - m_vecKeys.begin());
+		sEnd = static_cast<size_t>(range.second - m_vecKeys.begin());
+	}
+
+	///	<summary>
+	///		Node index of the given sorted entry.
+	///	</summary>
+	int GetNode(size_t s) const {
+		return static_cast<int>(m_vecNodes[s]);
+	}
+
+	///	<summary>
+	///		Call fn(j) for nodes j within the tolerance of node ixNode, visiting
+	///		the nodes of each cell in increasing order.  Only nodes with index
+	///		below fn.ixBound are visited, which the functor may lower during
+	///		the search.  The functor returns false to stop the search.  Returns
+	///		false if more than sMaxScanned entries were examined, in which case
+	///		the search is incomplete.
+	///	</summary>
+	template <class Functor>
+	bool ForEachEarlierNeighbor(
+		const NodeVector & nodes,
+		int ixNode,
+		Functor & fn,
+		size_t sMaxScanned = static_cast<size_t>(-1)
+	) const {
+		const Node & node = nodes[ixNode];
+		const double dTolerance2 = m_dTolerance * m_dTolerance;
+
+		size_t sScanned = 0;
+
+		int64_t iBegin[3];
+		int64_t iEnd[3];
+		GetCellRange(node.x, iBegin[0], iEnd[0]);
+		GetCellRange(node.y, iBegin[1], iEnd[1]);
+		GetCellRange(node.z, iBegin[2], iEnd[2]);
+
+		for (int64_t i = iBegin[0]; i <= iEnd[0]; i++) {
+		for (int64_t j = iBegin[1]; j <= iEnd[1]; j++) {
+		for (int64_t k = iBegin[2]; k <= iEnd[2]; k++) {
+			int64_t iNbrCell[3];
+			iNbrCell[0] = i;
+			iNbrCell[1] = j;
+			iNbrCell[2] = k;
+
+			size_t sBegin;
+			size_t sEnd;
+			FindRun(Hash(iNbrCell), sBegin, sEnd);
+
+			for (size_t s = sBegin; s < sEnd; s++) {
+				const int ixOther = GetNode(s);
+				if (ixOther >= fn.ixBound) {
+					break;
+				}
+				if (sScanned == sMaxScanned) {
+					return false;
+				}
+				sScanned++;
+
+				// Skip hash collisions from other cells
+				int64_t iOtherCell[3];
+				GetCell(nodes[ixOther], iOtherCell);
+				if ((iOtherCell[0] != iNbrCell[0]) ||
+				    (iOtherCell[1] != iNbrCell[1]) ||
+				    (iOtherCell[2] != iNbrCell[2])
+				) {
+					continue;
+				}
+
+				// Same distance test as kd_nearest_range3()
+				const Node & nodeOther = nodes[ixOther];
+				double dDist2 =
+					(nodeOther.x - node.x) * (nodeOther.x - node.x)
+					+ (nodeOther.y - node.y) * (nodeOther.y - node.y)
+					+ (nodeOther.z - node.z) * (nodeOther.z - node.z);
+
+				if (dDist2 <= dTolerance2) {
+					if (!fn(ixOther)) {
+						return true;
+					}
+				}
+			}
+		}
+		}
+		}
+		return true;
+	}
+
+protected:
+	///	<summary>
+	///		Directory bucket of the given hash.
+	///	</summary>
+	size_t Bucket(uint64_t ulKey) const {
+		return static_cast<size_t>(ulKey >> (64 - m_nDirectoryBits));
+	}
+
+	///	<summary>
+	///		Bit in the occupancy bitmap of the given hash.
+	///	</summary>
+	uint64_t OccupancyBit(uint64_t ulKey) const {
+		return (ulKey >> (64 - m_nDirectoryBits - OccupancyExtraBits));
+	}
+
+	///	<summary>
+	///		Number of additional leading hash bits used by the occupancy
+	///		bitmap, which rejects most empty cells without accessing the
+	///		directory.
+	///	</summary>
+	static const int OccupancyExtraBits = 4;
+
+private:
+	///	<summary>
+	///		Coincident node tolerance.
+	///	</summary>
+	double m_dTolerance;
+
+	///	<summary>
+	///		Cell size.
+	///	</summary>
+	double m_dCellSize;
+
+	///	<summary>
+	///		Sorted cell hashes and associated node indices.
+	///	</summary>
+	std::vector<uint64_t> m_vecKeys;
+	std::vector<uint64_t> m_vecNodes;
+
+	///	<summary>
+	///		Number of leading hash bits used by the directory.
+	///	</summary>
+	int m_nDirectoryBits;
+
+	///	<summary>
+	///		First sorted entry of each directory bucket.
+	///	</summary>
+	std::vector<size_t> m_vecDirectory;
+
+	///	<summary>
+	///		Bitmap of occupied hash prefixes.
+	///	</summary>
+	std::vector<uint64_t> m_vecOccupancy;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Functor that records whether any earlier neighbor exists.
+///	</summary>
+struct CoincidentNodeAnyFunctor {
+	CoincidentNodeAnyFunctor(
+		int ixNode
+	) :
+		ixBound(ixNode),
+		fFound(false)
+	{ }
+
+	bool operator()(int) {
+		fFound = true;
+		return false;
+	}
+
+	int ixBound;
+	bool fFound;
+};
+
+///	<summary>
+///		Functor that records the lowest neighbor.
+///	</summary>
+struct CoincidentNodeLowestFunctor {
+	CoincidentNodeLowestFunctor(
+		int ixNode
+	) :
+		ixBound(ixNode),
+		ixLowest(InvalidNode)
+	{ }
+
+	bool operator()(int ixOther) {
+		ixLowest = ixOther;
+		ixBound = ixOther;
+		return true;
+	}
+
+	int ixBound;
+	int ixLowest;
+};
+
+///	<summary>
+///		Functor that counts and optionally stores all neighbors, stopping
+///		once more than nMaxNeighbors have been found.
+///	</summary>
+struct CoincidentNodeCollectFunctor {
+	CoincidentNodeCollectFunctor(
+		int ixNode,
+		int _nMaxNeighbors,
+		int * _pNeighbors
+	) :
+		ixBound(ixNode),
+		nMaxNeighbors(_nMaxNeighbors),
+		pNeighbors(_pNeighbors),
+		nNeighbors(0)
+	{ }
+
+	bool operator()(int ixOther) {
+		if (nNeighbors == nMaxNeighbors) {
+			nNeighbors++;
+			return false;
+		}
+		if (pNeighbors != NULL) {
+			pNeighbors[nNeighbors] = ixOther;
+		}
+		nNeighbors++;
+		return true;
+	}
+
+	int ixBound;
+	int nMaxNeighbors;
+	int * pNeighbors;
+	int nNeighbors;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::RemoveCoincidentNodes() {
+	DiscardStaleCompactFaces();
+
+	const int nNodes = static_cast<int>(nodes.size());
+
+	// Index of the unique node that each node is merged into.  A node is
+	// merged into the lowest indexed unique node within the tolerance,
+	// where nodes are processed in index order.
+	std::vector<int> vecMergeNode(nodes.size());
+
+	// Maximum number of spatial hash entries examined per search, which
+	// bounds the cost of searches in cells containing many distinct nodes
+	static const size_t MaxScannedEntries = 256;
+
+	// Identify nodes with any earlier node within the tolerance; all
+	// other nodes are necessarily unique
+	std::vector<char> vecHasEarlier(nodes.size(), 0);
+
+	bool fSpatialHash;
+	{
+		CoincidentNodeSpatialHash hashAll;
+		fSpatialHash = hashAll.Build(nodes, coincident_node_tolerance);
+
+		if (fSpatialHash) {
+#pragma omp parallel for schedule(dynamic, 4096)
+			for (int i = 0; i < nNodes; i++) {
+				CoincidentNodeAnyFunctor fnAny(i);
+				bool fComplete =
+					hashAll.ForEachEarlierNeighbor(
+						nodes, i, fnAny, MaxScannedEntries);
+
+				// Incomplete searches are conservatively treated as having
+				// an earlier neighbor and resolved below
+				vecHasEarlier[i] = (fnAny.fFound || !fComplete)?(1):(0);
+				vecMergeNode[i] = i;
+			}
+		}
+	}
+
+	if (fSpatialHash) {
+		std::vector<int> vecKnownUniqueNodes;
+		std::vector<int> vecCandidateNodes;
+		for (int i = 0; i < nNodes; i++) {
+			if (vecHasEarlier[i]) {
+				vecCandidateNodes.push_back(i);
+			} else {
+				vecKnownUniqueNodes.push_back(i);
+			}
+		}
+
+		// Known unique nodes are separated by more than the tolerance, so
+		// each cell contains only a few of them.  Find the lowest known
+		// unique neighbor of each remaining candidate node.
+		const int nCandidateNodes = static_cast<int>(vecCandidateNodes.size());
+
+		std::vector<int> vecKnownUnique(vecCandidateNodes.size());
+		{
+			CoincidentNodeSpatialHash hashKnownUnique;
+			hashKnownUnique.Build(
+				nodes, coincident_node_tolerance, &vecKnownUniqueNodes);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+			for (int c = 0; c < nCandidateNodes; c++) {
+				CoincidentNodeLowestFunctor fnLowest(vecCandidateNodes[c]);
+				hashKnownUnique.ForEachEarlierNeighbor(
+					nodes, vecCandidateNodes[c], fnLowest);
+				vecKnownUnique[c] = fnLowest.ixLowest;
+			}
+		}
+
+		// Candidate nodes below the lowest known unique neighbor may also be
+		// unique; collect them in two passes.  Nodes with many such
+		// neighbors, or in cells with many distinct nodes, are instead
+		// resolved below using a NodeTree.
+		static const int MaxCandidateNeighbors = 64;
+
+		CoincidentNodeSpatialHash hashCandidate;
+		hashCandidate.Build(
+			nodes, coincident_node_tolerance, &vecCandidateNodes);
+
+		std::vector<size_t> vecNeighborOffsets(vecCandidateNodes.size() + 1, 0);
+		std::vector<char> vecOverflow(vecCandidateNodes.size(), 0);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+		for (int c = 0; c < nCandidateNodes; c++) {
+			CoincidentNodeCollectFunctor fnCount(
+				(vecKnownUnique[c] == InvalidNode)
+					?(vecCandidateNodes[c]):(vecKnownUnique[c]),
+				MaxCandidateNeighbors,
+				NULL);
+			bool fComplete =
+				hashCandidate.ForEachEarlierNeighbor(
+					nodes, vecCandidateNodes[c], fnCount, MaxScannedEntries);
+
+			if (!fComplete || (fnCount.nNeighbors > MaxCandidateNeighbors)) {
+				vecOverflow[c] = 1;
+			} else {
+				vecNeighborOffsets[c+1] = fnCount.nNeighbors;
+			}
+		}
+
+		for (int c = 0; c < nCandidateNodes; c++) {
+			vecNeighborOffsets[c+1] += vecNeighborOffsets[c];
+		}
+
+		std::vector<int> vecNeighbors(vecNeighborOffsets[nCandidateNodes]);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+		for (int c = 0; c < nCandidateNodes; c++) {
+			if (vecNeighborOffsets[c+1] == vecNeighborOffsets[c]) {
+				continue;
+			}
+			CoincidentNodeCollectFunctor fnFill(
+				(vecKnownUnique[c] == InvalidNode)
+					?(vecCandidateNodes[c]):(vecKnownUnique[c]),
+				MaxCandidateNeighbors,
+				&(vecNeighbors[vecNeighborOffsets[c]]));
+			hashCandidate.ForEachEarlierNeighbor(
+				nodes, vecCandidateNodes[c], fnFill);
+			std::sort(
+				vecNeighbors.begin() + vecNeighborOffsets[c],
+				vecNeighbors.begin() + vecNeighborOffsets[c+1]);
+		}
+
+		// Resolve in index order, since whether a candidate node is unique
+		// depends on all lower indexed nodes
+		NodeTree ntCandidateUniques(coincident_node_tolerance);
+
+		for (int c = 0; c < nCandidateNodes; c++) {
+			const int i = vecCandidateNodes[c];
+
+			int ixMerge = vecKnownUnique[c];
+			if (vecOverflow[c]) {
+				if (ntCandidateUniques.size() != 0) {
+					size_t sFound = ntCandidateUniques.find(nodes[i]);
+					if ((sFound != (size_t)(InvalidNode)) &&
+					    ((ixMerge == InvalidNode) || (sFound < (size_t)(ixMerge)))
+					) {
+						ixMerge = static_cast<int>(sFound);
+					}
+				}
+
+			} else {
+				for (size_t s = vecNeighborOffsets[c]; s < vecNeighborOffsets[c+1]; s++) {
+					const int j = vecNeighbors[s];
+					if (vecMergeNode[j] == j) {
+						ixMerge = j;
+						break;
+					}
+				}
+			}
+
+			if (ixMerge != InvalidNode) {
+				vecMergeNode[i] = ixMerge;
+			} else {
+				ntCandidateUniques.find_or_insert(nodes[i], i);
+			}
+		}
+
+	// Fall back to the NodeTree
+	} else {
+		NodeTree nt(coincident_node_tolerance);
+
+		for (size_t i = 0; i < nodes.size(); i++) {
+			vecMergeNode[i] = static_cast<int>(nt.find_or_insert(nodes[i], i));
+		}
+	}
+
+	// Renumber unique nodes
+	std::vector<int> vecNodeIndex(nodes.size());
+	std::vector<int> vecUniques;
+
+	for (int i = 0; i < nNodes; i++) {
+		if (vecMergeNode[i] == i) {
+			vecNodeIndex[i] = static_cast<int>(vecUniques.size());
+			vecUniques.push_back(i);
+		} else {
+			vecNodeIndex[i] = vecNodeIndex[vecMergeNode[i]];
+		}
+	}
+
+	if (nodes.size() - vecUniques.size() != 0) {
+		Announce("%i duplicate nodes detected", nodes.size() - vecUniques.size());
+	}
+
+	if (vecUniques.size() == nodes.size()) {
+		return;
+	}
+
+	// Remove duplicates
+	const int nUniques = static_cast<int>(vecUniques.size());
+
+	NodeVector nodesOld;
+	nodesOld.swap(nodes);
 
-///////////////////////////////////////////////////////////////////////////////
+	nodes.resize(vecUniques.size());
 
-Real Mesh::CalculateFaceAreasFromOverlap(
-	const Mesh & meshOverlap
-) {
-	if (meshOverlap.vecFaceArea.GetRows() == 0) {
-		_EXCEPTIONT("MeshOverlap Face Areas have not been calculated");
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nUniques; i++) {
+		nodes[i] = nodesOld[vecUniques[i]];
 	}
 
-	// Set all Face areas to zero
-	vecFaceArea.Allocate(faces.size());
-
-	// Loop over all Faces in meshOverlap
-	double dTotalArea = 0.0;
+	// Adjust node indices in Faces
+	const long lFaces = static_cast<long>(faces.size());
+
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < lFaces; lf++) {
+	for (size_t j = 0; j < faces[lf].edges.size(); j++) {
+		faces[lf].edges[j].node[0] =
+			vecNodeIndex[faces[lf].edges[j].node[0]];
+		faces[lf].edges[j].node[1] =
+			vecNodeIndex[faces[lf].edges[j].node[1]];
+	}
+	}
 
-	for (int i = 0; i < meshOverlap.faces.size(); i++) {
-		int ixFirstFace = meshOverlap.vecSourceFaceIx[i];
+	// Adjust node indices in compact Faces
+	if (faces.size() == 0) {
+		const long lFaceNodes = static_cast<long>(compactfaces.vecFaceNodes.size());
 
-		if (ixFirstFace >= vecFaceArea.GetRows()) {
-			_EXCEPTIONT("Overlap Mesh FirstFaceIx contains invalid "
-				"Face index");
+#pragma omp parallel for schedule(static)
+		for (long l = 0; l < lFaceNodes; l++) {
+			compactfaces.vecFaceNodes[l] =
+				vecNodeIndex[compactfaces.vecFaceNodes[l]];
 		}
-
-		vecFaceArea[ixFirstFace] += meshOverlap.vecFaceArea[i];
-		dTotalArea += meshOverlap.vecFaceArea[i];
 	}
-	return dTotalArea;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::ExchangeFirstAndSecondMesh() {
+///	<summary>
+///		Number of Faces or Nodes gathered and written to file at a time by
+///		Mesh::Write and Mesh::WriteScrip.
+///	</summary>
+static const long MeshWriteChunkSize = 65536;
 
-	// Verify all vectors are the same size
-	if ((faces.size() != vecSourceFaceIx.size()) ||
-		(faces.size() != vecTargetFaceIx.size())
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Enable chunked storage and compression of a variable in a netCDF-4
+///		file.  Chunk sizes are clamped to the extent of each dimension.
+///		This has no effect on classic format files, on variables with an
+///		empty or unlimited dimension, or if nDeflateLevel is not positive.
+///	</summary>
+static void DefineMeshVarCompression(
+	NcFile & ncOut,
+	NcVar * var,
+	NcFile::FileFormat eFileFormat,
+	int nDeflateLevel,
+	const size_t * sChunkSizes
+) {
+	if ((eFileFormat != NcFile::Netcdf4) &&
+	    (eFileFormat != NcFile::Netcdf4Classic)
 	) {
-		_EXCEPTIONT("");
+		return;
+	}
+	if (nDeflateLevel <= 0) {
+		return;
+	}
+	if (nDeflateLevel > 9) {
+		_EXCEPTION1("Invalid deflate level (%i): Expected value in [0,9]",
+			nDeflateLevel);
 	}
 
-	// Reorder vectors
-	FaceVector facesOld = faces;
-
-	std::vector<int> vecSourceFaceIxOld = vecSourceFaceIx;
+	const int nDims = var->num_dims();
 
-	// Reordering map
-	std::multimap<int,int> multimapReorder;
-	for (int i = 0; i < vecTargetFaceIx.size(); i++) {
-		multimapReorder.insert(std::pair<int,int>(vecTargetFaceIx[i], i));
+	std::vector<size_t> vecChunkSizes(nDims);
+	for (int d = 0; d < nDims; d++) {
+		NcDim * dim = var->get_dim(d);
+		if (dim->is_unlimited() || (dim->size() == 0)) {
+			return;
+		}
+		const size_t sDimSize = static_cast<size_t>(dim->size());
+		vecChunkSizes[d] = std::max<size_t>(1, sChunkSizes[d]);
+		if (vecChunkSizes[d] > sDimSize) {
+			vecChunkSizes[d] = sDimSize;
+		}
 	}
 
-	// Apply reordering
-	faces.clear();
-	vecSourceFaceIx.clear();
-	vecTargetFaceIx.clear();
+	int iErr = nc_def_var_chunking(
+		ncOut.id(), var->id(), NC_CHUNKED, &(vecChunkSizes[0]));
 
-	std::multimap<int,int>::const_iterator iterReorder
-		= multimapReorder.begin();
+	if (iErr != NC_NOERR) {
+		_EXCEPTION2("Error setting chunking of variable \"%s\": %s",
+			var->name(), nc_strerror(iErr));
+	}
 
-	for (; iterReorder != multimapReorder.end(); iterReorder++) {
-		faces.push_back(facesOld[iterReorder->second]);
-		vecSourceFaceIx.push_back(iterReorder->first);
-		vecTargetFaceIx.push_back(vecSourceFaceIxOld[iterReorder->second]);
+	iErr = nc_def_var_deflate(
+		ncOut.id(), var->id(), 1, 1, nDeflateLevel);
+
+	if (iErr != NC_NOERR) {
+		_EXCEPTION2("Error setting compression of variable \"%s\": %s",
+			var->name(), nc_strerror(iErr));
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::RemoveCoincidentNodes() {
-	std::vector<int> vecNodeIndex;
-	std::vector<int> vecUniques;
+///	<summary>
+///		Read-only view of the Faces of a Mesh used by Mesh::Write and
+///		Mesh::WriteScrip.  Faces are read from the FaceVector if it is
+///		populated and from the CompactFaceVector otherwise, so that
+///		neither needs to be converted before writing.
+///	</summary>
+class MeshFaceView {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	MeshFaceView(
+		const FaceVector & faces,
+		const CompactFaceVector & compactfaces
+	) :
+		m_faces(faces),
+		m_compactfaces(compactfaces),
+		m_fCompact(faces.size() == 0)
+	{ }
+
+	///	<summary>
+	///		Number of Faces.
+	///	</summary>
+	size_t size() const {
+		return (m_fCompact)?(m_compactfaces.size()):(m_faces.size());
+	}
 
-	vecNodeIndex.reserve(nodes.size());
-	vecUniques.reserve(nodes.size());
+	///	<summary>
+	///		Number of nodes (and Edges) of the given Face.
+	///	</summary>
+	inline int GetNodeCount(size_t f) const {
+		if (m_fCompact) {
+			return m_compactfaces.GetNodeCount(f);
+		}
+		return static_cast<int>(m_faces[f].edges.size());
+	}
 
-	// Identify duplicate nodes
-	NodeTree nt(coincident_node_tolerance);
+	///	<summary>
+	///		Node k of the given Face.
+	///	</summary>
+	inline int GetNode(size_t f, int k) const {
+		if (m_fCompact) {
+			return m_compactfaces.GetNode(f, k);
+		}
+		return m_faces[f][k];
+	}
 
-	for (size_t i = 0; i < nodes.size(); i++) {
-		size_t s = nt.find_or_insert(nodes[i], i);
-		if (s == i) {
-			vecUniques.push_back(i);
-			vecNodeIndex.push_back(i);
-		} else {
-			vecNodeIndex.push_back(s);
+	///	<summary>
+	///		Type of Edge k of the given Face.
+	///	</summary>
+	inline Edge::Type GetEdgeType(size_t f, int k) const {
+		if (m_fCompact) {
+			return m_compactfaces.GetEdgeType(f, k);
 		}
+		return m_faces[f].edges[k].type;
 	}
 
-	if (nodes.size() - vecUniques.size() != 0) {
-		Announce("%i duplicate nodes detected", nodes.size() - vecUniques.size());
+	///	<summary>
+	///		Area of the given Face.
+	///	</summary>
+	Real CalculateArea(size_t f, const NodeVector & nodes) const {
+		if (m_fCompact) {
+			return CalculateFaceArea(m_compactfaces.GetFace(f), nodes);
+		}
+		return CalculateFaceArea(m_faces[f], nodes);
 	}
 
-	// Remove duplicates
-	NodeVector nodesOld = nodes;
+private:
+	///	<summary>
+	///		Faces of the Mesh.
+	///	</summary>
+	const FaceVector & m_faces;
 
-	nodes.resize(vecUniques.size());
-	for (int i = 0; i < vecUniques.size(); i++) {
-		nodes[i] = nodesOld[vecUniques[i]];
+	///	<summary>
+	///		Compact Faces of the Mesh.
+	///	</summary>
+	const CompactFaceVector & m_compactfaces;
+
+	///	<summary>
+	///		True if Faces are read from the CompactFaceVector.
+	///	</summary>
+	bool m_fCompact;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine the distinct number of nodes per Face of a Mesh, in
+///		increasing order, and the number of Faces with each count.
+///	</summary>
+static void CalculateMeshBlockSizes(
+	const MeshFaceView & cfaces,
+	std::vector<int> & vecBlockSizes,
+	std::vector<int> & vecBlockSizeFaces
+) {
+	const long lFaces = static_cast<long>(cfaces.size());
+
+	int nMaxNodeCount = 0;
+	for (long lf = 0; lf < lFaces; lf++) {
+		nMaxNodeCount = std::max(nMaxNodeCount, cfaces.GetNodeCount(lf));
 	}
 
-	// Adjust node indices in Faces
-	for (int i = 0; i < faces.size(); i++) {
-	for (int j = 0; j < faces[i].edges.size(); j++) {
-		faces[i].edges[j].node[0] =
-			vecNodeIndex[faces[i].edges[j].node[0]];
-		faces[i].edges[j].node[1] =
-			vecNodeIndex[faces[i].edges[j].node[1]];
+	std::vector<int> vecNodeCountFaces(nMaxNodeCount + 1, 0);
+	for (long lf = 0; lf < lFaces; lf++) {
+		vecNodeCountFaces[cfaces.GetNodeCount(lf)]++;
 	}
+
+	vecBlockSizes.clear();
+	vecBlockSizeFaces.clear();
+	for (int n = 0; n <= nMaxNodeCount; n++) {
+		if (vecNodeCountFaces[n] != 0) {
+			vecBlockSizes.push_back(n);
+			vecBlockSizeFaces.push_back(vecNodeCountFaces[n]);
+		}
+	}
+
+	AnnounceStartBlock("Nodes per element");
+	for (int n = 0; n < vecBlockSizes.size(); n++) {
+		Announce("Block %i (%i nodes): %i",
+			n+1, vecBlockSizes[n], vecBlockSizeFaces[n]);
 	}
+	AnnounceEndBlock(NULL);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Mesh::Write(
 	const std::string & strFile,
-	NcFile::FileFormat eFileFormat
+	NcFile::FileFormat eFileFormat,
+	int nDeflateLevel
 ) const {
 	const int ParamFour = 4;
 	const int ParamLenString = 33;
@@ -379,43 +1998,13 @@ void Mesh::Write(
 	// Temporarily change error reporting
 	NcError error_temp(NcError::verbose_fatal);
 
+	// View of the Faces of this mesh
+	const MeshFaceView cfaces(faces, compactfaces);
+
 	// Determine block sizes
 	std::vector<int> vecBlockSizes;
 	std::vector<int> vecBlockSizeFaces;
-	{
-		std::map<int, int> mapBlockSizes;
-		std::map<int, int>::iterator iterBlockSize;
-		int iBlock;
-		char szBuffer[ParamLenString];
-
-		for (int i = 0; i < faces.size(); i++) {
-			iterBlockSize = mapBlockSizes.find(faces[i].edges.size());
-
-			if (iterBlockSize == mapBlockSizes.end()) {
-				mapBlockSizes.insert(
-					std::pair<int,int>(faces[i].edges.size(), 1));
-			} else {
-				(iterBlockSize->second)++;
-			}
-		}
-
-		vecBlockSizes.resize(mapBlockSizes.size());
-		vecBlockSizeFaces.resize(mapBlockSizes.size());
-
-		AnnounceStartBlock("Nodes per element");
-		iterBlockSize = mapBlockSizes.begin();
-		iBlock = 1;
-		for (; iterBlockSize != mapBlockSizes.end(); iterBlockSize++) {
-			vecBlockSizes[iBlock-1] = iterBlockSize->first;
-			vecBlockSizeFaces[iBlock-1] = iterBlockSize->second;
-
-			Announce("Block %i (%i nodes): %i",
-				iBlock, vecBlockSizes[iBlock-1], vecBlockSizeFaces[iBlock-1]);
-
-			iBlock++;
-		}
-		AnnounceEndBlock(NULL);
-	}
+	CalculateMeshBlockSizes(cfaces, vecBlockSizes, vecBlockSizeFaces);
 
 	// Output to a NetCDF Exodus file
 	NcFile ncOut(strFile.c_str(), NcFile::Replace, NULL, 0, eFileFormat);
@@ -436,7 +2025,7 @@ void Mesh::Write(
 	NcDim * dimNodes = ncOut.add_dim("num_nodes", nNodeCount);
 
 	// Number of elements
-	int nElementCount = faces.size();
+	int nElementCount = cfaces.size();
 	NcDim * dimElements = ncOut.add_dim("num_elem", nElementCount);
 
 	// Other dimensions
@@ -591,13 +2180,10 @@ void Mesh::Write(
 
 	// Attributes
 	{
-		for (int n = 0; n < vecBlockSizes.size(); n++) {
-			std::vector<double> dAttrib;
-			dAttrib.resize(vecBlockSizeFaces[n]);
-			for (int i = 0; i < vecBlockSizeFaces[n]; i++) {
-				dAttrib[i] = 1.0;
-			}
+		std::vector<double> dAttrib(
+			std::min<long>(MeshWriteChunkSize, nElementCount), 1.0);
 
+		for (int n = 0; n < vecBlockSizes.size(); n++) {
 			char szAttribName[ParamLenString];
 			snprintf(szAttribName, ParamLenString, "attrib%i", n+1);
 
@@ -611,8 +2197,17 @@ void Mesh::Write(
 				_EXCEPTION1("Error creating variable \"%s\"", szAttribName);
 			}
 
-			varAttrib->set_cur((long)0);
-			varAttrib->put(&(dAttrib[0]), vecBlockSizeFaces[n]);
+			const size_t sChunkSizes[2] = {MeshWriteChunkSize, 1};
+			DefineMeshVarCompression(
+				ncOut, varAttrib, eFileFormat, nDeflateLevel, sChunkSizes);
+
+			for (long lBegin = 0; lBegin < vecBlockSizeFaces[n]; lBegin += MeshWriteChunkSize) {
+				long lCount =
+					std::min(MeshWriteChunkSize, vecBlockSizeFaces[n] - lBegin);
+
+				varAttrib->set_cur(lBegin, 0);
+				varAttrib->put(&(dAttrib[0]), lCount, 1);
+			}
 		}
 	}
 
@@ -622,47 +2217,28 @@ void Mesh::Write(
 		std::vector<NcVar*> vecConnectVar;
 		vecConnectVar.resize(vecBlockSizes.size());
 
-		std::vector< DataArray2D<int> > vecConnect;
-		vecConnect.resize(vecBlockSizes.size());
-
-		// Number of elements added to each connectivity array
-		std::vector<int> vecConnectCount;
-		vecConnectCount.resize(vecBlockSizes.size());
-
 		// Global ids
 		std::vector<NcVar*> vecGlobalIdVar;
 		vecGlobalIdVar.resize(vecBlockSizes.size());
 
-		std::vector< DataArray1D<int> > vecGlobalId;
-		vecGlobalId.resize(vecBlockSizes.size());
-
 		// Edge types
 		std::vector<NcVar*> vecEdgeTypeVar;
 		vecEdgeTypeVar.resize(vecBlockSizes.size());
 
-		std::vector< DataArray2D<int> > vecEdgeType;
-		vecEdgeType.resize(vecBlockSizes.size());
-
 		// Parent on source mesh
 		std::vector<NcVar*> vecFaceParentAVar;
 		vecFaceParentAVar.resize(vecBlockSizes.size());
 
-		std::vector< DataArray1D<int> > vecFaceParentA;
-		vecFaceParentA.resize(vecBlockSizes.size());
-
 		// Parent on target mesh
 		std::vector<NcVar*> vecFaceParentBVar;
 		vecFaceParentBVar.resize(vecBlockSizes.size());
 
-		std::vector< DataArray1D<int> > vecFaceParentB;
-		vecFaceParentB.resize(vecBlockSizes.size());
-
-		// Initialize block-local storage arrays and create output variables
+		// Create output variables
 		for (int n = 0; n < vecBlockSizes.size(); n++) {
-			vecConnect[n].Allocate(vecBlockSizeFaces[n], vecBlockSizes[n]);
-			vecGlobalId[n].Allocate(vecBlockSizeFaces[n]);
-			vecEdgeType[n].Allocate(vecBlockSizeFaces[n], vecBlockSizes[n]);
-	
+			const size_t sChunkSizes[2] = {
+				MeshWriteChunkSize,
+				static_cast<size_t>(vecBlockSizes[n])};
+
 			char szConnectVarName[ParamLenString];
 			snprintf(szConnectVarName, ParamLenString, "connect%i", n+1);
 			vecConnectVar[n] =
@@ -676,6 +2252,9 @@ void Mesh::Write(
 					szConnectVarName);
 			}
 
+			DefineMeshVarCompression(
+				ncOut, vecConnectVar[n], eFileFormat, nDeflateLevel, sChunkSizes);
+
 			char szConnectAttrib[ParamLenString];
 			snprintf(szConnectAttrib, ParamLenString, "SHELL%i", vecBlockSizes[n]);
 			vecConnectVar[n]->add_att("elem_type", szConnectAttrib);
@@ -692,6 +2271,9 @@ void Mesh::Write(
 					szGlobalIdVarName);
 			}
 
+			DefineMeshVarCompression(
+				ncOut, vecGlobalIdVar[n], eFileFormat, nDeflateLevel, sChunkSizes);
+
 			char szEdgeTypeVarName[ParamLenString];
 			snprintf(szEdgeTypeVarName, ParamLenString, "edge_type%i", n+1);
 			vecEdgeTypeVar[n] =
@@ -705,9 +2287,10 @@ void Mesh::Write(
 					szEdgeTypeVarName);
 			}
 
-			if (vecSourceFaceIx.size() != 0) {
-				vecFaceParentA[n].Allocate(vecBlockSizeFaces[n]);
+			DefineMeshVarCompression(
+				ncOut, vecEdgeTypeVar[n], eFileFormat, nDeflateLevel, sChunkSizes);
 
+			if (vecSourceFaceIx.size() != 0) {
 				char szParentAVarName[ParamLenString];
 				snprintf(szParentAVarName, ParamLenString, "el_parent_a%i", n+1);
 				vecFaceParentAVar[n] =
@@ -719,11 +2302,12 @@ void Mesh::Write(
 					_EXCEPTION1("Error creating variable \"%s\"",
 						szParentAVarName);
 				}
+
+				DefineMeshVarCompression(
+					ncOut, vecFaceParentAVar[n], eFileFormat, nDeflateLevel, sChunkSizes);
 			}
 
 			if (vecTargetFaceIx.size() != 0) {
-				vecFaceParentB[n].Allocate(vecBlockSizeFaces[n]);
-
 				char szParentBVarName[ParamLenString];
 				snprintf(szParentBVarName, ParamLenString, "el_parent_b%i", n+1);
 				vecFaceParentBVar[n] =
@@ -735,72 +2319,101 @@ void Mesh::Write(
 					_EXCEPTION1("Error creating variable \"%s\"",
 						szParentBVarName);
 				}
-			}
-		}
 
-		// Rebuild global data structures in local block arrays
-		for (int i = 0; i < nElementCount; i++) {
-			int iBlock = 0;
-			for (; iBlock < vecBlockSizes.size(); iBlock++) {
-				if (vecBlockSizes[iBlock] == faces[i].edges.size()) {
-					break;
-				}
-			}
-			if (iBlock == vecBlockSizes.size()) {
-				_EXCEPTIONT("Logic error");
+				DefineMeshVarCompression(
+					ncOut, vecFaceParentBVar[n], eFileFormat, nDeflateLevel, sChunkSizes);
 			}
+		}
 
-			int iLocal = vecConnectCount[iBlock];
-			for (int k = 0; k < faces[i].edges.size(); k++) {
-				vecConnect[iBlock][iLocal][k] = faces[i][k] + 1;
+		// Global indices of the Faces in each block, in increasing order
+		std::vector<int> vecBlockFaceBegin(vecBlockSizes.size() + 1, 0);
+		for (int n = 0; n < vecBlockSizes.size(); n++) {
+			vecBlockFaceBegin[n+1] = vecBlockFaceBegin[n] + vecBlockSizeFaces[n];
+		}
 
-				vecEdgeType[iBlock][iLocal][k] =
-					static_cast<int>(faces[i].edges[k].type);
+		std::vector<int> vecBlockFaces(nElementCount);
+		{
+			std::vector<int> vecNodeCountBlock(
+				(vecBlockSizes.size() == 0)?(0):(vecBlockSizes.back() + 1), -1);
+			for (int n = 0; n < vecBlockSizes.size(); n++) {
+				vecNodeCountBlock[vecBlockSizes[n]] = n;
 			}
 
-			vecGlobalId[iBlock][iLocal] = i + 1;
+			std::vector<int> vecBlockNext(
+				vecBlockFaceBegin.begin(), vecBlockFaceBegin.end() - 1);
 
-			if (vecSourceFaceIx.size() != 0) {
-				vecFaceParentA[iBlock][iLocal] = vecSourceFaceIx[i] + 1;
-			}
-			if (vecTargetFaceIx.size() != 0) {
-				vecFaceParentB[iBlock][iLocal] = vecTargetFaceIx[i] + 1;
+			for (int i = 0; i < nElementCount; i++) {
+				int iBlock = vecNodeCountBlock[cfaces.GetNodeCount(i)];
+				vecBlockFaces[vecBlockNext[iBlock]++] = i;
 			}
-
-			vecConnectCount[iBlock]++;
 		}
 
-		// Write data to NetCDF file
+		// Gather and write each block in chunks of bounded size
+		std::vector<int> vecConnect;
+		std::vector<int> vecGlobalId;
+		std::vector<int> vecEdgeType;
+		std::vector<int> vecFaceParentA;
+		std::vector<int> vecFaceParentB;
+
 		for (int n = 0; n < vecBlockSizes.size(); n++) {
-			vecConnectVar[n]->set_cur(0, 0);
-			vecConnectVar[n]->put(
-				&(vecConnect[n][0][0]),
-				vecBlockSizeFaces[n],
-				vecBlockSizes[n]);
-
-			vecGlobalIdVar[n]->set_cur((long)0);
-			vecGlobalIdVar[n]->put(
-				&(vecGlobalId[n][0]),
-				vecBlockSizeFaces[n]);
-
-			vecEdgeTypeVar[n]->set_cur(0, 0);
-			vecEdgeTypeVar[n]->put(
-				&(vecEdgeType[n][0][0]),
-				vecBlockSizeFaces[n],
-				vecBlockSizes[n]);
+			const int nBlockSize = vecBlockSizes[n];
+			const int * const pBlockFaces =
+				&(vecBlockFaces[0]) + vecBlockFaceBegin[n];
 
-			if (vecSourceFaceIx.size() != 0) {
-				vecFaceParentAVar[n]->set_cur((long)0);
-				vecFaceParentAVar[n]->put(
-					&(vecFaceParentA[n][0]),
-					vecBlockSizeFaces[n]);
-			}
+			for (long lBegin = 0; lBegin < vecBlockSizeFaces[n]; lBegin += MeshWriteChunkSize) {
+				const long lCount =
+					std::min(MeshWriteChunkSize, vecBlockSizeFaces[n] - lBegin);
 
-			if (vecTargetFaceIx.size() != 0) {
-				vecFaceParentBVar[n]->set_cur((long)0);
-				vecFaceParentBVar[n]->put(
-					&(vecFaceParentB[n][0]),
-					vecBlockSizeFaces[n]);
+				vecConnect.resize(lCount * nBlockSize);
+				vecEdgeType.resize(lCount * nBlockSize);
+				vecGlobalId.resize(lCount);
+				if (vecSourceFaceIx.size() != 0) {
+					vecFaceParentA.resize(lCount);
+				}
+				if (vecTargetFaceIx.size() != 0) {
+					vecFaceParentB.resize(lCount);
+				}
+
+#pragma omp parallel for schedule(static)
+				for (long l = 0; l < lCount; l++) {
+					const int i = pBlockFaces[lBegin + l];
+
+					for (int k = 0; k < nBlockSize; k++) {
+						vecConnect[l * nBlockSize + k] = cfaces.GetNode(i, k) + 1;
+
+						vecEdgeType[l * nBlockSize + k] =
+							static_cast<int>(cfaces.GetEdgeType(i, k));
+					}
+
+					vecGlobalId[l] = i + 1;
+
+					if (vecSourceFaceIx.size() != 0) {
+						vecFaceParentA[l] = vecSourceFaceIx[i] + 1;
+					}
+					if (vecTargetFaceIx.size() != 0) {
+						vecFaceParentB[l] = vecTargetFaceIx[i] + 1;
+					}
+				}
+
+				// Write data to NetCDF file
+				vecConnectVar[n]->set_cur(lBegin, 0);
+				vecConnectVar[n]->put(&(vecConnect[0]), lCount, nBlockSize);
+
+				vecGlobalIdVar[n]->set_cur(lBegin);
+				vecGlobalIdVar[n]->put(&(vecGlobalId[0]), lCount);
+
+				vecEdgeTypeVar[n]->set_cur(lBegin, 0);
+				vecEdgeTypeVar[n]->put(&(vecEdgeType[0]), lCount, nBlockSize);
+
+				if (vecSourceFaceIx.size() != 0) {
+					vecFaceParentAVar[n]->set_cur(lBegin);
+					vecFaceParentAVar[n]->put(&(vecFaceParentA[0]), lCount);
+				}
+
+				if (vecTargetFaceIx.size() != 0) {
+					vecFaceParentBVar[n]->set_cur(lBegin);
+					vecFaceParentBVar[n]->put(&(vecFaceParentB[0]), lCount);
+				}
 			}
 		}
 	}
@@ -814,23 +2427,33 @@ void Mesh::Write(
 			_EXCEPTIONT("Error creating variable \"coord\"");
 		}
 
-		DataArray1D<double> dCoord(nNodeCount);
+		const size_t sChunkSizes[2] = {1, MeshWriteChunkSize};
+		DefineMeshVarCompression(
+			ncOut, varNodes, eFileFormat, nDeflateLevel, sChunkSizes);
+
+		DataArray1D<double> dCoord(
+			std::min<long>(MeshWriteChunkSize, nNodeCount));
+
+		for (int d = 0; d < 3; d++) {
+			for (long lBegin = 0; lBegin < nNodeCount; lBegin += MeshWriteChunkSize) {
+				const long lCount =
+					std::min(MeshWriteChunkSize, nNodeCount - lBegin);
+
+				for (long l = 0; l < lCount; l++) {
+					const Node & node = nodes[lBegin + l];
+					if (d == 0) {
+						dCoord[l] = static_cast<double>(node.x);
+					} else if (d == 1) {
+						dCoord[l] = static_cast<double>(node.y);
+					} else {
+						dCoord[l] = static_cast<double>(node.z);
+					}
+				}
 
-		for (int i = 0; i < nNodeCount; i++) {
-			dCoord[i] = static_cast<double>(nodes[i].x);
-		}
-		varNodes->set_cur(0, 0);
-		varNodes->put(dCoord, 1, nNodeCount);
-		for (int i = 0; i < nNodeCount; i++) {
-			dCoord[i] = static_cast<double>(nodes[i].y);
-		}
-		varNodes->set_cur(1, 0);
-		varNodes->put(dCoord, 1, nNodeCount);
-		for (int i = 0; i < nNodeCount; i++) {
-			dCoord[i] = static_cast<double>(nodes[i].z);
+				varNodes->set_cur(d, lBegin);
+				varNodes->put(dCoord, 1, lCount);
+			}
 		}
-		varNodes->set_cur(2, 0);
-		varNodes->put(dCoord, 1, nNodeCount);
 	}
 }
 
@@ -838,51 +2461,22 @@ void Mesh::Write(
 
 void Mesh::WriteScrip(
 	const std::string & strFile,
-	NcFile::FileFormat eFileFormat
+	NcFile::FileFormat eFileFormat,
+	int nDeflateLevel
 ) const {
-	const int ParamLenString = 33;
 
 	// Temporarily change error reporting
 	NcError error_temp(NcError::verbose_fatal);
 
+	// View of the Faces of this mesh
+	const MeshFaceView cfaces(faces, compactfaces);
+
 	//---------------------------------------------------------------------------
 	// Determine block sizes
 	std::vector<int> vecBlockSizes;
 	std::vector<int> vecBlockSizeFaces;
-	{
-		std::map<int, int> mapBlockSizes;
-		std::map<int, int>::iterator iterBlockSize;
-		int iBlock;
-		char szBuffer[ParamLenString];
-
-		for (int i = 0; i < faces.size(); i++) {
-			iterBlockSize = mapBlockSizes.find(faces[i].edges.size());
-
-			if (iterBlockSize == mapBlockSizes.end()) {
-				mapBlockSizes.insert(
-					std::pair<int,int>(faces[i].edges.size(), 1));
-			} else {
-				(iterBlockSize->second)++;
-			}
-		}
+	CalculateMeshBlockSizes(cfaces, vecBlockSizes, vecBlockSizeFaces);
 
-		vecBlockSizes.resize(mapBlockSizes.size());
-		vecBlockSizeFaces.resize(mapBlockSizes.size());
-
-		AnnounceStartBlock("Nodes per element");
-		iterBlockSize = mapBlockSizes.begin();
-		iBlock = 1;
-		for (; iterBlockSize != mapBlockSizes.end(); iterBlockSize++) {
-			vecBlockSizes[iBlock-1] = iterBlockSize->first;
-			vecBlockSizeFaces[iBlock-1] = iterBlockSize->second;
-
-			Announce("Block %i (%i nodes): %i",
-				iBlock, vecBlockSizes[iBlock-1], vecBlockSizeFaces[iBlock-1]);
-
-			iBlock++;
-		}
-		AnnounceEndBlock(NULL);
-	}
 	//---------------------------------------------------------------------------
 	// Output to a NetCDF SCRIP file
 	NcFile ncOut(strFile.c_str(), NcFile::Replace, NULL, 0, eFileFormat);
@@ -891,10 +2485,10 @@ void Mesh::WriteScrip(
 			strFile.c_str());
 	}
 	// Find max number of corners oer all faces
-	int nElementCount = faces.size();
+	int nElementCount = cfaces.size();
 	int nCornersMax = 0;
-	for (int i=0; i<nElementCount; i++) {
-		nCornersMax = std::max( nCornersMax, (int)(faces[i].edges.size()) );
+	if (vecBlockSizes.size() != 0) {
+		nCornersMax = vecBlockSizes.back();
 	}
 	// SCRIP dimensions
 	NcDim * dimGridSize   = ncOut.add_dim("grid_size",    nElementCount);
@@ -906,128 +2500,156 @@ void Mesh::WriteScrip(
 	ncOut.add_att("floating_point_word_size", 8);
 	ncOut.add_att("file_size", 0);
 	//---------------------------------------------------------------------------
-	// Grid Area
-	{
-		NcVar * varArea = ncOut.add_var("grid_area", ncDouble, dimGridSize);
-		if (varArea == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_area\"");
-		}
-		DataArray1D<double> area(nElementCount);
-		for (int i=0; i<nElementCount; i++) {
-			area[i] = static_cast<double>( CalculateFaceArea(faces[i], nodes) );
-		}
-		varArea->set_cur((long)0);
-		varArea->put(area, nElementCount);
-		varArea->add_att("units", "radians^2");
+	// Define variables
+	const size_t sChunkSizes[2] = {
+		MeshWriteChunkSize,
+		static_cast<size_t>(nCornersMax)};
+
+	NcVar * varArea = ncOut.add_var("grid_area", ncDouble, dimGridSize);
+	if (varArea == NULL) {
+		_EXCEPTIONT("Error creating variable \"grid_area\"");
+	}
+	DefineMeshVarCompression(
+		ncOut, varArea, eFileFormat, nDeflateLevel, sChunkSizes);
+	varArea->add_att("units", "radians^2");
+
+	NcVar * varCenterLat = ncOut.add_var("grid_center_lat", ncDouble, dimGridSize);
+	NcVar * varCenterLon = ncOut.add_var("grid_center_lon", ncDouble, dimGridSize);
+	NcVar * varCornerLat = ncOut.add_var("grid_corner_lat", ncDouble, dimGridSize, dimGridCorner);
+	NcVar * varCornerLon = ncOut.add_var("grid_corner_lon", ncDouble, dimGridSize, dimGridCorner);
+	if (varCenterLat == NULL) {
+		_EXCEPTIONT("Error creating variable \"grid_center_lat\"");
+	}
+	if (varCenterLon == NULL) {
+		_EXCEPTIONT("Error creating variable \"grid_center_lon\"");
+	}
+	if (varCornerLat == NULL) {
+		_EXCEPTIONT("Error creating variable \"grid_corner_lat\"");
+	}
+	if (varCornerLon == NULL) {
+		_EXCEPTIONT("Error creating variable \"grid_corner_lon\"");
+	}
+	DefineMeshVarCompression(
+		ncOut, varCenterLat, eFileFormat, nDeflateLevel, sChunkSizes);
+	DefineMeshVarCompression(
+		ncOut, varCenterLon, eFileFormat, nDeflateLevel, sChunkSizes);
+	DefineMeshVarCompression(
+		ncOut, varCornerLat, eFileFormat, nDeflateLevel, sChunkSizes);
+	DefineMeshVarCompression(
+		ncOut, varCornerLon, eFileFormat, nDeflateLevel, sChunkSizes);
+
+	varCenterLat->add_att("units", "degrees");
+	varCenterLat->add_att("_FillValue", 9.96920996838687e+36 );
+	varCenterLon->add_att("units", "degrees");
+	varCenterLon->add_att("_FillValue", 9.96920996838687e+36 );
+	varCornerLat->add_att("units", "degrees");
+	varCornerLon->add_att("units", "degrees");
+	varCornerLat->add_att("_FillValue", 9.96920996838687e+36 );
+	varCornerLon->add_att("_FillValue", 9.96920996838687e+36 );
+
+	NcVar * varMask = ncOut.add_var("grid_imask", ncDouble, dimGridSize);
+	if (varMask == NULL) {
+		_EXCEPTIONT("Error creating variable \"grid_imask\"");
+	}
+	DefineMeshVarCompression(
+		ncOut, varMask, eFileFormat, nDeflateLevel, sChunkSizes);
+	varMask->add_att("_FillValue", 9.96920996838687e+36 );
+
+	NcVar * varDims = ncOut.add_var("grid_dims", ncInt, dimGridRank);
+	if (varDims == NULL) {
+		_EXCEPTIONT("Error creating variable \"grid_dims\"");
 	}
 	//---------------------------------------------------------------------------
-	// Grid center and corner coordinates
+	// Grid area, center and corner coordinates and mask, gathered and
+	// written in chunks of bounded size
 	{
-		NcVar * varCenterLat = ncOut.add_var("grid_center_lat", ncDouble, dimGridSize);
-		NcVar * varCenterLon = ncOut.add_var("grid_center_lon", ncDouble, dimGridSize);
-		NcVar * varCornerLat = ncOut.add_var("grid_corner_lat", ncDouble, dimGridSize, dimGridCorner);
-		NcVar * varCornerLon = ncOut.add_var("grid_corner_lon", ncDouble, dimGridSize, dimGridCorner);
-		if (varCenterLat == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_center_lat\"");
-		}
-		if (varCenterLon == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_center_lon\"");
-		}
-		if (varCornerLat == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_corner_lat\"");
-		}
-		if (varCornerLon == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_corner_lon\"");
-		}
-
-		DataArray1D<double> centerLat(nElementCount);
-		DataArray1D<double> centerLon(nElementCount);
-		DataArray2D<double> cornerLat(nElementCount, nCornersMax);
-		DataArray2D<double> cornerLon(nElementCount, nCornersMax);
-		Node corner(0,0,0);
-		for (int i=0; i<nElementCount; i++) {
-			Node center(0,0,0);
-			// int nCorners = faces[i].edges.size()+1;
-			int nCorners = faces[i].edges.size();
-			for (int j=0; j<nCorners; ++j) {
-				corner = nodes[ faces[i][j] ];
-				XYZtoRLL_Deg(
-					corner.x, corner.y, corner.z,
-					cornerLon[i][j],
-					cornerLat[i][j]);
-				center = center + corner;
-			}
-			center = center / nCorners;
-			double dMag = sqrt(center.x * center.x + 
-							   center.y * center.y + 
-							   center.z * center.z);
-			center.x /= dMag;
-			center.y /= dMag;
-			center.z /= dMag;
-			XYZtoRLL_Deg(
-				center.x, center.y, center.z,
-				centerLon[i],
-				centerLat[i]);
-			// Adjust corner logitudes
-			double lonDiff;
-			for (int j=0; j<nCorners; ++j) {
-				// First check for polar point
-				if (cornerLat[i][j]==90. || cornerLat[i][j]==-90.) {
-					cornerLon[i][j] = centerLon[i];
+		const long lChunkCapacity =
+			std::min<long>(MeshWriteChunkSize, nElementCount);
+
+		DataArray1D<double> area(lChunkCapacity);
+		DataArray1D<double> centerLat(lChunkCapacity);
+		DataArray1D<double> centerLon(lChunkCapacity);
+		DataArray2D<double> cornerLat(lChunkCapacity, nCornersMax);
+		DataArray2D<double> cornerLon(lChunkCapacity, nCornersMax);
+		DataArray1D<double> mask(lChunkCapacity);
+
+		for (long lBegin = 0; lBegin < nElementCount; lBegin += MeshWriteChunkSize) {
+			const long lCount =
+				std::min(MeshWriteChunkSize, nElementCount - lBegin);
+
+#pragma omp parallel for schedule(static)
+			for (long l = 0; l < lCount; l++) {
+				const int i = static_cast<int>(lBegin + l);
+
+				area[l] = static_cast<double>( cfaces.CalculateArea(i, nodes) );
+				mask[l] = static_cast<double>( 1 );
+
+				Node center(0,0,0);
+				Node corner(0,0,0);
+				int nCorners = cfaces.GetNodeCount(i);
+				for (int j=0; j<nCorners; ++j) {
+					corner = nodes[ cfaces.GetNode(i, j) ];
+					XYZtoRLL_Deg(
+						corner.x, corner.y, corner.z,
+						cornerLon[l][j],
+						cornerLat[l][j]);
+					center = center + corner;
 				}
-				// Next check for corners that wrap around prime meridian
-				lonDiff = centerLon[i] - cornerLon[i][j];
-				if (lonDiff>180) {
-					cornerLon[i][j] = cornerLon[i][j] + (double)360.0;
+				for (int j=nCorners; j<nCornersMax; ++j) {
+					cornerLon[l][j] = 0.0;
+					cornerLat[l][j] = 0.0;
 				}
-				if (lonDiff<-180) {
-					cornerLon[i][j] = cornerLon[i][j] - (double)360.0;
+				center = center / nCorners;
+				double dMag = sqrt(center.x * center.x + 
+								   center.y * center.y + 
+								   center.z * center.z);
+				center.x /= dMag;
+				center.y /= dMag;
+				center.z /= dMag;
+				XYZtoRLL_Deg(
+					center.x, center.y, center.z,
+					centerLon[l],
+					centerLat[l]);
+				// Adjust corner logitudes
+				double lonDiff;
+				for (int j=0; j<nCorners; ++j) {
+					// First check for polar point
+					if (cornerLat[l][j]==90. || cornerLat[l][j]==-90.) {
+						cornerLon[l][j] = centerLon[l];
+					}
+					// Next check for corners that wrap around prime meridian
+					lonDiff = centerLon[l] - cornerLon[l][j];
+					if (lonDiff>180) {
+						cornerLon[l][j] = cornerLon[l][j] + (double)360.0;
+					}
+					if (lonDiff<-180) {
+						cornerLon[l][j] = cornerLon[l][j] - (double)360.0;
+					}
 				}
 			}
-		}
-		varCenterLat->set_cur((long)0);
-		varCenterLat->put(centerLat, nElementCount);
-		varCenterLat->add_att("units", "degrees");
-		varCenterLat->add_att("_FillValue", 9.96920996838687e+36 );
 
-		varCenterLon->set_cur((long)0);
-		varCenterLon->put(centerLon, nElementCount);
-		varCenterLon->add_att("units", "degrees");
-		varCenterLon->add_att("_FillValue", 9.96920996838687e+36 );
+			varArea->set_cur(lBegin);
+			varArea->put(area, lCount);
 
-		for (int i=0; i<nElementCount; i++) {
-			varCornerLat->set_cur(i,0);
-			varCornerLat->put(cornerLat[i], 1, nCornersMax);
-			varCornerLon->set_cur(i,0);
-			varCornerLon->put(cornerLon[i], 1, nCornersMax);
-		}
-		varCornerLat->add_att("units", "degrees");
-		varCornerLon->add_att("units", "degrees");
-		varCornerLat->add_att("_FillValue", 9.96920996838687e+36 );
-		varCornerLon->add_att("_FillValue", 9.96920996838687e+36 );
-	}
-	//---------------------------------------------------------------------------
-	// Grid mask
-	{
-		NcVar * varMask = ncOut.add_var("grid_imask", ncDouble, dimGridSize);
-		if (varMask == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_imask\"");
-		}
-		DataArray1D<double> mask(nElementCount);
-		for (int i = 0; i < nElementCount; i++) {
-			mask[i] = static_cast<double>( 1 );
+			varCenterLat->set_cur(lBegin);
+			varCenterLat->put(centerLat, lCount);
+
+			varCenterLon->set_cur(lBegin);
+			varCenterLon->put(centerLon, lCount);
+
+			varCornerLat->set_cur(lBegin, 0);
+			varCornerLat->put(&(cornerLat[0][0]), lCount, nCornersMax);
+
+			varCornerLon->set_cur(lBegin, 0);
+			varCornerLon->put(&(cornerLon[0][0]), lCount, nCornersMax);
+
+			varMask->set_cur(lBegin);
+			varMask->put(mask, lCount);
 		}
-		varMask->set_cur((long)0);
-		varMask->put(mask, nElementCount);
-		varMask->add_att("_FillValue", 9.96920996838687e+36 );
 	}
 	//---------------------------------------------------------------------------
 	// Grid dims
 	{
-		NcVar * varDims = ncOut.add_var("grid_dims", ncInt, dimGridRank);
-		if (varDims == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_dims\"");
-		}
 		DataArray1D<int> rank(1);
 		rank(0) = 1;
 		varDims->set_cur((long)0);
@@ -1038,14 +2660,72 @@ void Mesh::WriteScrip(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Read(const std::string & strFile) {
+///	<summary>
+///		Number of Faces or Nodes read from file at a time by Mesh::Read.
+///	</summary>
+static const long MeshReadChunkSize = 65536;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read one Cartesian coordinate of all Nodes in chunks of bounded size
+///		directly into a NodeVector.  If iRow is negative the variable is
+///		one-dimensional, otherwise coordinates are read from row iRow of a
+///		two-dimensional variable.  iCoord selects the x (0), y (1) or z (2)
+///		coordinate.
+///	</summary>
+static void ReadMeshNodeCoordinate(
+	NcVar * var,
+	int iRow,
+	int iCoord,
+	NodeVector & nodes
+) {
+	const long lNodes = static_cast<long>(nodes.size());
+
+	DataArray1D<double> dBuffer(std::min(MeshReadChunkSize, lNodes));
+
+	for (long lBegin = 0; lBegin < lNodes; lBegin += MeshReadChunkSize) {
+		const long lCount = std::min(MeshReadChunkSize, lNodes - lBegin);
+
+		if (iRow < 0) {
+			var->set_cur(lBegin);
+			var->get(&(dBuffer[0]), lCount);
+		} else {
+			var->set_cur(iRow, lBegin);
+			var->get(&(dBuffer[0]), 1, lCount);
+		}
+
+		Node * const pNodes = &(nodes[lBegin]);
+
+#pragma omp parallel for schedule(static)
+		for (long l = 0; l < lCount; l++) {
+			if (iCoord == 0) {
+				pNodes[l].x = static_cast<Real>(dBuffer[l]);
+			} else if (iCoord == 1) {
+				pNodes[l].y = static_cast<Real>(dBuffer[l]);
+			} else {
+				pNodes[l].z = static_cast<Real>(dBuffer[l]);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+void Mesh::Read(
+	const std::string & strFile,
+	bool fConstructFaces
+) {
 	const int ParamFour = 4;
 	const int ParamLenString = 33;
 
 	// Store the file name
 	strFileName = strFile;
 
+	// Faces are read into compactfaces
+	faces.clear();
+	compactfaces.clear();
+
 	// Open the NetCDF file
 	if (strFile == "") {
 		_EXCEPTIONT("No grid file specified for reading");
@@ -1074,8 +2754,6 @@ void Mesh::Read(const std::string & strFile) {
 
 			nodes.resize(dimVertex->size());
 
-			DataArray1D<double> dNodeBuffer(dimVertex->size());
-
 			// Load in x coordinates of vertices
 			NcVar * varICONX = ncFile.get_var("cartesian_x_vertices");
 			if (varICONX == NULL) {
@@ -1090,11 +2768,7 @@ void Mesh::Read(const std::string & strFile) {
 				_EXCEPTION1("ICON grid file \"%s\" variable \"cartesian_x_vertices\" dimension 0 must have name \"vertex\"",
 					strFile.c_str());
 			}
-			varICONX->set_cur((long)0);
-			varICONX->get(&(dNodeBuffer[0]), dimVertex->size());
-			for (long i = 0; i < dimVertex->size(); i++) {
-				nodes[i].x = dNodeBuffer[i];
-			}
+			ReadMeshNodeCoordinate(varICONX, -1, 0, nodes);
 
 			// Load in y coordinates of vertices
 			NcVar * varICONY = ncFile.get_var("cartesian_y_vertices");
@@ -1110,11 +2784,7 @@ void Mesh::Read(const std::string & strFile) {
 				_EXCEPTION1("ICON grid file \"%s\" variable \"cartesian_y_vertices\" dimension 0 must have name \"vertex\"",
 					strFile.c_str());
 			}
-			varICONY->set_cur((long)0);
-			varICONY->get(&(dNodeBuffer[0]), dimVertex->size());
-			for (long i = 0; i < dimVertex->size(); i++) {
-				nodes[i].y = dNodeBuffer[i];
-			}
+			ReadMeshNodeCoordinate(varICONY, -1, 1, nodes);
 
 			// Load in z coordinates of vertices
 			NcVar * varICONZ = ncFile.get_var("cartesian_z_vertices");
@@ -1130,13 +2800,7 @@ void Mesh::Read(const std::string & strFile) {
 				_EXCEPTION1("ICON grid file \"%s\" variable \"cartesian_z_vertices\" dimension 0 must have name \"vertex\"",
 					strFile.c_str());
 			}
-			varICONZ->set_cur((long)0);
-			varICONZ->get(&(dNodeBuffer[0]), dimVertex->size());
-			for (long i = 0; i < dimVertex->size(); i++) {
-				nodes[i].z = dNodeBuffer[i];
-			}
-
-			dNodeBuffer.Detach();
+			ReadMeshNodeCoordinate(varICONZ, -1, 2, nodes);
 
 			// Load in face vertex indices
 			NcVar * varVertexOfCell = ncFile.get_var("vertex_of_cell");
@@ -1154,26 +2818,62 @@ void Mesh::Read(const std::string & strFile) {
 			}
 
 			long lVerticesPerCell = varVertexOfCell->get_dim(0)->size();
+			long lCells = dimCell->size();
+
+			compactfaces.vecFaceOffsets.resize(lCells + 1);
+			compactfaces.vecFaceNodes.resize(lCells * lVerticesPerCell);
+			for (long i = 0; i <= lCells; i++) {
+				compactfaces.vecFaceOffsets[i] = i * lVerticesPerCell;
+			}
 
-			faces.resize(dimCell->size(), Face(lVerticesPerCell));
+			// Read connectivity in chunks of cells; out-of-range indices
+			// are reported for the lowest offending entry
+			const long lNodes = static_cast<long>(nodes.size());
 
 			DataArray2D<int> dVertexOfCellBuf(
 				lVerticesPerCell,
-				dimCell->size());
-			varVertexOfCell->get(
-				&(dVertexOfCellBuf(0,0)), 
-				lVerticesPerCell,
-				dimCell->size());
-
-			for (long i = 0; i < dimCell->size(); i++) {
-				for (long j = 0; j < lVerticesPerCell; j++) {
-					if ((dVertexOfCellBuf(j,i) < 1) || (dVertexOfCellBuf(j,i) > nodes.size())) {
-						_EXCEPTION4("ICON grid file \"%s\" vertex %li cell %li out of range (%li)",
-							strFile.c_str(), j, i, dVertexOfCellBuf(j,i));
+				std::min(MeshReadChunkSize, lCells));
+
+			for (long lBegin = 0; lBegin < lCells; lBegin += MeshReadChunkSize) {
+				const long lCount = std::min(MeshReadChunkSize, lCells - lBegin);
+
+				varVertexOfCell->set_cur(0, lBegin);
+				varVertexOfCell->get(
+					&(dVertexOfCellBuf(0,0)),
+					lVerticesPerCell,
+					lCount);
+
+				const int * const pBuf = &(dVertexOfCellBuf(0,0));
+
+				long lFirstError = lCount * lVerticesPerCell;
+
+#pragma omp parallel for schedule(static) reduction(min:lFirstError)
+				for (long l = 0; l < lCount; l++) {
+					for (long j = 0; j < lVerticesPerCell; j++) {
+						const int iVertex = pBuf[j * lCount + l];
+						if ((iVertex < 1) || (iVertex > lNodes)) {
+							if (l * lVerticesPerCell + j < lFirstError) {
+								lFirstError = l * lVerticesPerCell + j;
+							}
+							continue;
+						}
+						compactfaces.vecFaceNodes[(lBegin + l) * lVerticesPerCell + j] =
+							iVertex - 1;
 					}
-					faces[i].SetNode(j, dVertexOfCellBuf(j,i)-1);
+				}
+
+				if (lFirstError != lCount * lVerticesPerCell) {
+					const long i = lFirstError / lVerticesPerCell;
+					const long j = lFirstError % lVerticesPerCell;
+					_EXCEPTION4("ICON grid file \"%s\" vertex %li cell %li out of range (%li)",
+						strFile.c_str(), j, lBegin + i,
+						static_cast<long>(pBuf[j * lCount + i]));
 				}
 			}
+
+			if (fConstructFaces) {
+				ConstructFacesFromCompact();
+			}
 			return;
 		}
 	}
@@ -1220,16 +2920,8 @@ void Mesh::Read(const std::string & strFile) {
 		int nGridSize = static_cast<int>(dimGridSize->size());
 		int nGridCorners = static_cast<int>(dimGridCorners->size());
 
-		DataArray2D<double> dCornerLat(nGridSize, nGridCorners);
-		DataArray2D<double> dCornerLon(nGridSize, nGridCorners);
-
-		varGridCornerLat->set_cur(0, 0);
-		varGridCornerLat->get(&(dCornerLat[0][0]), nGridSize, nGridCorners);
-
-		varGridCornerLon->set_cur(0, 0);
-		varGridCornerLon->get(&(dCornerLon[0][0]), nGridSize, nGridCorners);
-
-		faces.resize(nGridSize);
+		compactfaces.vecFaceOffsets.resize(nGridSize + 1);
+		compactfaces.vecFaceNodes.resize(nGridSize * nGridCorners);
 		nodes.resize(nGridSize * nGridCorners);
 
 		// Check for units attribute; if "degrees" then convert to radians
@@ -1275,52 +2967,73 @@ void Mesh::Read(const std::string & strFile) {
 			varMask->get(&(vecMask[0]), nGridSize);
 		}
 
-		// Current global node index
-		int ixNode = 0;
+		// Read corners in chunks of Faces and convert directly into the
+		// node table; each Face owns nGridCorners consecutive nodes
+		DataArray2D<double> dCornerLat(
+			std::min<long>(MeshReadChunkSize, nGridSize), nGridCorners);
+		DataArray2D<double> dCornerLon(
+			std::min<long>(MeshReadChunkSize, nGridSize), nGridCorners);
 
-		for (int i = 0; i < nGridSize; i++) {
+		for (long lBegin = 0; lBegin < nGridSize; lBegin += MeshReadChunkSize) {
+			const long lCount = std::min<long>(MeshReadChunkSize, nGridSize - lBegin);
 
-			// Create a new Face
-			Face faceNew(nGridCorners);
-			for (int j = 0; j < nGridCorners; j++) {
-				faceNew.SetNode(j, ixNode + j);
-			}
-			faces[i] = faceNew;
+			varGridCornerLat->set_cur(lBegin, 0);
+			varGridCornerLat->get(&(dCornerLat[0][0]), lCount, nGridCorners);
 
-			// Insert Face corners into node table
-			for (int j = 0; j < nGridCorners; j++) {
-				double dLon = dCornerLon[i][j];
-				double dLat = dCornerLat[i][j];
+			varGridCornerLon->set_cur(lBegin, 0);
+			varGridCornerLon->get(&(dCornerLon[0][0]), lCount, nGridCorners);
 
-				if (fConvertLonToRadians) {
-					dLon = dLon / 180.0 * M_PI;
-				}
-				if (fConvertLatToRadians) {
-					dLat = dLat / 180.0 * M_PI;
-				}
+#pragma omp parallel for schedule(static)
+			for (long l = 0; l < lCount; l++) {
+				const int i = static_cast<int>(lBegin + l);
+				const int ixFirstNode = i * nGridCorners;
 
-				if (dLat > 0.5 * M_PI) {
-					dLat = 0.5 * M_PI;
-				}
-				if (dLat < -0.5 * M_PI) {
-					dLat = -0.5 * M_PI;
+				// Create a new Face
+				compactfaces.vecFaceOffsets[i] = ixFirstNode;
+				for (int j = 0; j < nGridCorners; j++) {
+					compactfaces.vecFaceNodes[ixFirstNode + j] = ixFirstNode + j;
 				}
 
-				nodes[ixNode].x = cos(dLon) * cos(dLat);
-				nodes[ixNode].y = sin(dLon) * cos(dLat);
-				nodes[ixNode].z = sin(dLat);
+				// Insert Face corners into node table
+				for (int j = 0; j < nGridCorners; j++) {
+					double dLon = dCornerLon[l][j];
+					double dLat = dCornerLat[l][j];
+
+					if (fConvertLonToRadians) {
+						dLon = dLon / 180.0 * M_PI;
+					}
+					if (fConvertLatToRadians) {
+						dLat = dLat / 180.0 * M_PI;
+					}
+
+					if (dLat > 0.5 * M_PI) {
+						dLat = 0.5 * M_PI;
+					}
+					if (dLat < -0.5 * M_PI) {
+						dLat = -0.5 * M_PI;
+					}
 
-				ixNode++;
+					Node & node = nodes[ixFirstNode + j];
+					node.x = cos(dLon) * cos(dLat);
+					node.y = sin(dLon) * cos(dLat);
+					node.z = sin(dLat);
+				}
 			}
 		}
 
+		compactfaces.vecFaceOffsets[nGridSize] = nGridSize * nGridCorners;
+
 		// SCRIP does not reference a node table, so we must remove
 		// coincident nodes.
 		RemoveCoincidentNodes();
 
+		if (fConstructFaces) {
+			ConstructFacesFromCompact();
+		}
+
 		// Output size
 		Announce("Mesh size: Nodes [%i] Elements [%i]",
-			nodes.size(), faces.size());
+			nodes.size(), GetFaceCount());
 
 	// Input from a NetCDF Exodus file
 	} else {
@@ -1364,10 +3077,17 @@ void Mesh::Read(const std::string & strFile) {
 		Announce("Mesh size: Nodes [%i] Elements [%i]",
 			nNodeCount, nTotalElementCount);
 
-		// Allocate faces
-		faces.resize(nTotalElementCount);
+		// Number of nodes per element, number of elements and global ids
+		// of each block
+		std::vector<int> vecBlockNodesPerElement(nElementBlocks);
+		std::vector<int> vecBlockElementCount(nElementBlocks);
+		std::vector< DataArray1D<int> > vecBlockGlobalId(nElementBlocks);
+
+		// Block and block-local index of the last entry listing each face;
+		// a face listed more than once takes its data from this entry
+		std::vector<int> vecFaceBlock(nTotalElementCount, -1);
+		std::vector<int> vecFaceBlockIndex(nTotalElementCount, -1);
 
-		// Loop over all blocks
 		for (int n = 0; n < nElementBlocks; n++) {
 
 			// Determine number of nodes per element in this block
@@ -1379,6 +3099,7 @@ void Mesh::Read(const std::string & strFile) {
 					"\"%s\"", strFile.c_str(), szNodesPerElement);
 			}
 			int nNodesPerElement = dimNodesPerElement->size();
+			vecBlockNodesPerElement[n] = nNodesPerElement;
 
 			// Number of elements in block
 			char szElementsInBlock[ParamLenString];
@@ -1390,30 +3111,10 @@ void Mesh::Read(const std::string & strFile) {
 						"\"%s\"", strFile.c_str(), szElementsInBlock);
 			}
 			int nElementCount = dimBlockElements->size();
+			vecBlockElementCount[n] = nElementCount;
 
-			// Variables for each face
-			DataArray2D<int> iConnect(nElementCount, nNodesPerElement);
-			DataArray1D<int> iGlobalId(nElementCount);
-			DataArray2D<int> iEdgeType(nElementCount, nNodesPerElement);
-
-			DataArray1D<int> iParentA(nElementCount);
-			DataArray1D<int> iParentB(nElementCount);
-
-			// Load in nodes for all elements in this block
-			char szConnect[ParamLenString];
-			snprintf(szConnect, ParamLenString, "connect%i", n+1);
-
-			NcVar * varConnect = ncFile.get_var(szConnect);
-			if (varConnect == NULL) {
-				_EXCEPTION2("Exodus Grid file \"%s\" is missing variable "
-						"\"%s\"", strFile.c_str(), szConnect);
-			}
-
-			varConnect->set_cur(0, 0);
-			varConnect->get(
-				&(iConnect[0][0]),
-				nElementCount,
-				nNodesPerElement);
+			DataArray1D<int> & iGlobalId = vecBlockGlobalId[n];
+			iGlobalId.Allocate(nElementCount);
 
 			// Earlier version didn't have global_id
 			if (flVersion == 4.98f) {
@@ -1432,10 +3133,55 @@ void Mesh::Read(const std::string & strFile) {
 							"\"%s\"", strFile.c_str(), szGlobalId);
 				}
 
-				varGlobalId->set_cur((long)0);
-				varGlobalId->get(
-					&(iGlobalId[0]),
-					nElementCount);
+				for (long lBegin = 0; lBegin < nElementCount; lBegin += MeshReadChunkSize) {
+					const long lCount =
+						std::min<long>(MeshReadChunkSize, nElementCount - lBegin);
+
+					varGlobalId->set_cur(lBegin);
+					varGlobalId->get(&(iGlobalId[lBegin]), lCount);
+				}
+			}
+
+			for (int i = 0; i < nElementCount; i++) {
+				if ((iGlobalId[i] < 1) || (iGlobalId[i] > nTotalElementCount)) {
+					_EXCEPTION2("global_id %i out of range [1,%i]",
+						iGlobalId[i], nTotalElementCount);
+				}
+				vecFaceBlock[iGlobalId[i]-1] = n;
+				vecFaceBlockIndex[iGlobalId[i]-1] = i;
+			}
+		}
+
+		// Allocate faces
+		compactfaces.vecFaceOffsets.resize(nTotalElementCount + 1);
+		compactfaces.vecFaceOffsets[0] = 0;
+		for (int i = 0; i < nTotalElementCount; i++) {
+			int nFaceNodeCount = 0;
+			if (vecFaceBlock[i] != (-1)) {
+				nFaceNodeCount = vecBlockNodesPerElement[vecFaceBlock[i]];
+			}
+			compactfaces.vecFaceOffsets[i+1] =
+				compactfaces.vecFaceOffsets[i] + nFaceNodeCount;
+		}
+		compactfaces.vecFaceNodes.resize(
+			compactfaces.vecFaceOffsets[nTotalElementCount]);
+
+		// Loop over all blocks
+		for (int n = 0; n < nElementBlocks; n++) {
+
+			int nNodesPerElement = vecBlockNodesPerElement[n];
+			int nElementCount = vecBlockElementCount[n];
+
+			const DataArray1D<int> & iGlobalId = vecBlockGlobalId[n];
+
+			// Load in nodes for all elements in this block
+			char szConnect[ParamLenString];
+			snprintf(szConnect, ParamLenString, "connect%i", n+1);
+
+			NcVar * varConnect = ncFile.get_var(szConnect);
+			if (varConnect == NULL) {
+				_EXCEPTION2("Exodus Grid file \"%s\" is missing variable "
+						"\"%s\"", strFile.c_str(), szConnect);
 			}
 
 			// Load in edge type for all elements in this block
@@ -1447,13 +3193,6 @@ void Mesh::Read(const std::string & strFile) {
 			}
 
 			NcVar * varEdgeType = ncFile.get_var(szEdgeType);
-			if (varEdgeType != NULL) {
-				varEdgeType->set_cur(0, 0);
-				varEdgeType->get(
-					&(iEdgeType[0][0]),
-					nElementCount,
-					nNodesPerElement);
-			}
 
 			// Load in parent from A grid for all elements in this block
 			char szParentA[ParamLenString];
@@ -1472,11 +3211,6 @@ void Mesh::Read(const std::string & strFile) {
 				if (vecSourceFaceIx.size() == 0) {
 					vecSourceFaceIx.resize(nTotalElementCount);
 				}
-
-				varParentA->set_cur((long)0);
-				varParentA->get(
-					&(iParentA[0]),
-					nElementCount);
 			}
 
 			// Load in parent from A grid for all elements in this block
@@ -1496,32 +3230,100 @@ void Mesh::Read(const std::string & strFile) {
 				if (vecTargetFaceIx.size() == 0) {
 					vecTargetFaceIx.resize(nTotalElementCount);
 				}
+			}
+
+			// Variables for each chunk of faces
+			const long lChunkCapacity =
+				std::min<long>(MeshReadChunkSize, nElementCount);
 
-				varParentB->set_cur((long)0);
-				varParentB->get(
-					&(iParentB[0]),
-					nElementCount);
+			DataArray2D<int> iConnect(lChunkCapacity, nNodesPerElement);
+			DataArray2D<int> iEdgeType;
+			if (varEdgeType != NULL) {
+				iEdgeType.Allocate(lChunkCapacity, nNodesPerElement);
 			}
 
-			// Put local data into global structures
-			for (int i = 0; i < nElementCount; i++) {
-				if (iGlobalId[i] - 1 >= nTotalElementCount) {
-					_EXCEPTION2("global_id %i out of range [1,%i]",
-						iGlobalId[i], nTotalElementCount);
+			DataArray1D<int> iParentA(lChunkCapacity);
+			DataArray1D<int> iParentB(lChunkCapacity);
+
+			for (long lBegin = 0; lBegin < nElementCount; lBegin += MeshReadChunkSize) {
+				const long lCount =
+					std::min<long>(MeshReadChunkSize, nElementCount - lBegin);
+
+				varConnect->set_cur(lBegin, 0);
+				varConnect->get(
+					&(iConnect[0][0]),
+					lCount,
+					nNodesPerElement);
+
+				if (varEdgeType != NULL) {
+					varEdgeType->set_cur(lBegin, 0);
+					varEdgeType->get(
+						&(iEdgeType[0][0]),
+						lCount,
+						nNodesPerElement);
+
+					// Only store edge types if a non-default type is present
+					if (!compactfaces.HasEdgeTypes()) {
+						bool fNonDefaultEdgeType = false;
+
+#pragma omp parallel for schedule(static) reduction(||:fNonDefaultEdgeType)
+						for (long l = 0; l < lCount; l++) {
+						for (int k = 0; k < nNodesPerElement; k++) {
+							if (iEdgeType[l][k] != static_cast<int>(Edge::Type_Default)) {
+								fNonDefaultEdgeType = true;
+							}
+						}
+						}
+
+						if (fNonDefaultEdgeType) {
+							compactfaces.AllocateEdgeTypes();
+						}
+					}
 				}
-				faces[iGlobalId[i]-1] = Face(nNodesPerElement);
-				for (int k = 0; k < nNodesPerElement; k++) {
-					faces[iGlobalId[i] - 1].SetNode(k, iConnect[i][k] - 1);
-					faces[iGlobalId[i] - 1].edges[k].type = 
-						static_cast<Edge::Type>(iEdgeType[i][k]);
+
+				if (varParentA != NULL) {
+					varParentA->set_cur(lBegin);
+					varParentA->get(&(iParentA[0]), lCount);
 				}
 
-				if (vecSourceFaceIx.size() != 0) {
-					vecSourceFaceIx[iGlobalId[i] - 1] = iParentA[i] - 1;
+				if (varParentB != NULL) {
+					varParentB->set_cur(lBegin);
+					varParentB->get(&(iParentB[0]), lCount);
 				}
 
-				if (vecTargetFaceIx.size() != 0) {
-					vecTargetFaceIx[iGlobalId[i] - 1] = iParentB[i] - 1;
+				// Put local data into global structures
+				const bool fHasEdgeTypes =
+					(varEdgeType != NULL) && compactfaces.HasEdgeTypes();
+
+#pragma omp parallel for schedule(static)
+				for (long l = 0; l < lCount; l++) {
+					const int i = static_cast<int>(lBegin + l);
+					const int ixFace = iGlobalId[i] - 1;
+
+					if ((vecFaceBlock[ixFace] != n) ||
+					    (vecFaceBlockIndex[ixFace] != i)
+					) {
+						continue;
+					}
+
+					const size_t sOffset = compactfaces.vecFaceOffsets[ixFace];
+					for (int k = 0; k < nNodesPerElement; k++) {
+						compactfaces.vecFaceNodes[sOffset + k] = iConnect[l][k] - 1;
+					}
+					if (fHasEdgeTypes) {
+						for (int k = 0; k < nNodesPerElement; k++) {
+							compactfaces.vecEdgeTypes[sOffset + k] =
+								static_cast<unsigned char>(iEdgeType[l][k]);
+						}
+					}
+
+					if (vecSourceFaceIx.size() != 0) {
+						vecSourceFaceIx[ixFace] = iParentA[l] - 1;
+					}
+
+					if (vecTargetFaceIx.size() != 0) {
+						vecTargetFaceIx[ixFace] = iParentB[l] - 1;
+					}
 				}
 			}
 		}
@@ -1550,21 +3352,17 @@ void Mesh::Read(const std::string & strFile) {
 						"\"coord\"", strFile.c_str());
 			}
 
-			DataArray2D<double> dNodeCoords(3, nNodeCount);
-
-			// Load in node array
-			varNodes->set_cur(0, 0);
-			varNodes->get(&(dNodeCoords[0][0]), 3, nNodeCount);
-
-			for (int i = 0; i < nNodeCount; i++) {
-				nodes[i].x = static_cast<Real>(dNodeCoords[0][i]);
-				nodes[i].y = static_cast<Real>(dNodeCoords[1][i]);
-				nodes[i].z = static_cast<Real>(dNodeCoords[2][i]);
-			}
+			ReadMeshNodeCoordinate(varNodes, 0, 0, nodes);
+			ReadMeshNodeCoordinate(varNodes, 1, 1, nodes);
+			ReadMeshNodeCoordinate(varNodes, 2, 2, nodes);
 		}
 
 		// Remove coincident nodes.
 		RemoveCoincidentNodes();
+
+		if (fConstructFaces) {
+			ConstructFacesFromCompact();
+		}
 	}
 }
 
@@ -1572,6 +3370,8 @@ void Mesh::Read(const std::string & strFile) {
 
 void Mesh::RemoveZeroEdges() {
 
+	DiscardStaleCompactFaces();
+
 	// Remove zero edges from all Faces
 	for (int i = 0; i < faces.size(); i++) {
 		faces[i].RemoveZeroEdges();
@@ -1580,118 +3380,112 @@ void Mesh::RemoveZeroEdges() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Validate() const {
-
-	// Valid that Nodes have magnitude 1
-	for (int i = 0; i < nodes.size(); i++) {
-		double dMag = nodes[i].Magnitude();
-
-		if (fabs(dMag - 1.0) > ReferenceTolerance) {
-			_EXCEPTION5("Mesh validation failed: "
-				"Node[%i] of non-unit magnitude detected (%1.10e, %1.10e, %1.10e) = %1.10e",
-				i, nodes[i].x, nodes[i].y, nodes[i].z, dMag);
-
-		}
-	}
-
-	// Validate that edges are oriented counter-clockwise
-	for (int i = 0; i < faces.size(); i++) {
-		const Face & face = faces[i];
-
-		const int nEdges = face.edges.size();
+///	<summary>
+///		Validate that Face i is oriented counter-clockwise, throwing an
+///		exception on failure.  Diagnostics are printed only if fVerbose
+///		is set.
+///	</summary>
+static void ValidateFaceOrientation(
+	const NodeVector & nodes,
+	const Face & face,
+	int i,
+	bool fVerbose
+) {
+	const int nEdges = face.edges.size();
 
-		for (int j = 0; j < nEdges; j++) {
+	for (int j = 0; j < nEdges; j++) {
 
-			// Check for zero edges
-			for(;;) {
-				if (face.edges[j][0] == face.edges[j][1]) {
-					j++;
-				} else {
-					break;
-				}
-				if (j == nEdges) {
-					break;
-				}
+		// Check for zero edges
+		for(;;) {
+			if (face.edges[j][0] == face.edges[j][1]) {
+				j++;
+			} else {
+				break;
 			}
-
 			if (j == nEdges) {
 				break;
 			}
+		}
 
-			// Find the next non-zero edge
-			int jNext = (j + 1) % nEdges;
+		if (j == nEdges) {
+			break;
+		}
 
-			for(;;) {
-				if (face.edges[jNext][0] == face.edges[jNext][1]) {
-					jNext++;
-				} else {
-					break;
-				}
-				if (jNext == nEdges) {
-					jNext = 0;
-				}
-				if (jNext == ((j + 1) % nEdges)) {
-					_EXCEPTIONT("Mesh validation failed: "
-						"No edge information on Face");
-				}
+		// Find the next non-zero edge
+		int jNext = (j + 1) % nEdges;
+
+		for(;;) {
+			if (face.edges[jNext][0] == face.edges[jNext][1]) {
+				jNext++;
+			} else {
+				break;
 			}
+			if (jNext == nEdges) {
+				jNext = 0;
+			}
+			if (jNext == ((j + 1) % nEdges)) {
+				_EXCEPTIONT("Mesh validation failed: "
+					"No edge information on Face");
+			}
+		}
 
-			// Get edges
-			const Edge & edge0 = face.edges[j];
-			const Edge & edge1 = face.edges[(j + 1) % nEdges];
+		// Get edges
+		const Edge & edge0 = face.edges[j];
+		const Edge & edge1 = face.edges[(j + 1) % nEdges];
 
-			if (edge0[1] != edge1[0]) {
-				_EXCEPTIONT("Mesh validation failed: Edge cyclicity error");
-			}
+		if (edge0[1] != edge1[0]) {
+			_EXCEPTIONT("Mesh validation failed: Edge cyclicity error");
+		}
 
-			const Node & node0 = nodes[edge0[0]];
-			const Node & node1 = nodes[edge0[1]];
-			const Node & node2 = nodes[edge1[1]];
+		const Node & node0 = nodes[edge0[0]];
+		const Node & node1 = nodes[edge0[1]];
+		const Node & node2 = nodes[edge1[1]];
 
-			// Vectors along edges
-			Node nodeD1 = node0 - node1;
-			Node nodeD2 = node2 - node1;
+		// Vectors along edges
+		Node nodeD1 = node0 - node1;
+		Node nodeD2 = node2 - node1;
 
-			// Compute cross-product
-			Node nodeCross(CrossProduct(nodeD1, nodeD2));
+		// Compute cross-product
+		Node nodeCross(CrossProduct(nodeD1, nodeD2));
 
-			// Dot cross product with radial vector
-			Real dDot = DotProduct(node1, nodeCross);
+		// Dot cross product with radial vector
+		Real dDot = DotProduct(node1, nodeCross);
 /*
 #ifdef USE_EXACT_ARITHMETIC
-			FixedPoint dDotX = DotProductX(node1, nodeCross);
-
-			printf("%1.15e : ", nodeCross.x); nodeCross.fx.Print(); printf("\n");
-
-			if (fabs(nodeCross.x - nodeCross.fx.ToReal()) > ReferenceTolerance) {
-				printf("X0: %1.15e : ", node0.x); node0.fx.Print(); printf("\n");
-				printf("Y0: %1.15e : ", node0.y); node0.fy.Print(); printf("\n");
-				printf("Z0: %1.15e : ", node0.z); node0.fz.Print(); printf("\n");
-				printf("X1: %1.15e : ", node1.x); node1.fx.Print(); printf("\n");
-				printf("Y1: %1.15e : ", node1.y); node1.fy.Print(); printf("\n");
-				printf("Z1: %1.15e : ", node1.z); node1.fz.Print(); printf("\n");
-				printf("X2: %1.15e : ", node2.x); node2.fx.Print(); printf("\n");
-				printf("Y2: %1.15e : ", node2.y); node2.fy.Print(); printf("\n");
-				printf("Z2: %1.15e : ", node2.z); node2.fz.Print(); printf("\n");
-
-				printf("X1: %1.15e : ", nodeD1.x); nodeD1.fx.Print(); printf("\n");
-				printf("Y1: %1.15e : ", nodeD1.y); nodeD1.fy.Print(); printf("\n");
-				printf("Z1: %1.15e : ", nodeD1.z); nodeD1.fz.Print(); printf("\n");
-				printf("X2: %1.15e : ", nodeD2.x); nodeD2.fx.Print(); printf("\n");
-				printf("Y2: %1.15e : ", nodeD2.y); nodeD2.fy.Print(); printf("\n");
-				printf("Z2: %1.15e : ", nodeD2.z); nodeD2.fz.Print(); printf("\n");
-				_EXCEPTIONT("FixedPoint mismatch (X)");
-			}
-			if (fabs(nodeCross.y - nodeCross.fy.ToReal()) > ReferenceTolerance) {
-				_EXCEPTIONT("FixedPoint mismatch (Y)");
-			}
-			if (fabs(nodeCross.z - nodeCross.fz.ToReal()) > ReferenceTolerance) {
-				_EXCEPTIONT("FixedPoint mismatch (Z)");
-			}
+		FixedPoint dDotX = DotProductX(node1, nodeCross);
+
+		printf("%1.15e : ", nodeCross.x); nodeCross.fx.Print(); printf("\n");
+
+		if (fabs(nodeCross.x - nodeCross.fx.ToReal()) > ReferenceTolerance) {
+			printf("X0: %1.15e : ", node0.x); node0.fx.Print(); printf("\n");
+			printf("Y0: %1.15e : ", node0.y); node0.fy.Print(); printf("\n");
+			printf("Z0: %1.15e : ", node0.z); node0.fz.Print(); printf("\n");
+			printf("X1: %1.15e : ", node1.x); node1.fx.Print(); printf("\n");
+			printf("Y1: %1.15e : ", node1.y); node1.fy.Print(); printf("\n");
+			printf("Z1: %1.15e : ", node1.z); node1.fz.Print(); printf("\n");
+			printf("X2: %1.15e : ", node2.x); node2.fx.Print(); printf("\n");
+			printf("Y2: %1.15e : ", node2.y); node2.fy.Print(); printf("\n");
+			printf("Z2: %1.15e : ", node2.z); node2.fz.Print(); printf("\n");
+
+			printf("X1: %1.15e : ", nodeD1.x); nodeD1.fx.Print(); printf("\n");
+			printf("Y1: %1.15e : ", nodeD1.y); nodeD1.fy.Print(); printf("\n");
+			printf("Z1: %1.15e : ", nodeD1.z); nodeD1.fz.Print(); printf("\n");
+			printf("X2: %1.15e : ", nodeD2.x); nodeD2.fx.Print(); printf("\n");
+			printf("Y2: %1.15e : ", nodeD2.y); nodeD2.fy.Print(); printf("\n");
+			printf("Z2: %1.15e : ", nodeD2.z); nodeD2.fz.Print(); printf("\n");
+			_EXCEPTIONT("FixedPoint mismatch (X)");
+		}
+		if (fabs(nodeCross.y - nodeCross.fy.ToReal()) > ReferenceTolerance) {
+			_EXCEPTIONT("FixedPoint mismatch (Y)");
+		}
+		if (fabs(nodeCross.z - nodeCross.fz.ToReal()) > ReferenceTolerance) {
+			_EXCEPTIONT("FixedPoint mismatch (Z)");
+		}
 
 #endif
 */
-			if (dDot > 0.0) {
+		if (dDot > 0.0) {
+			if (fVerbose) {
 				printf("\nError detected (orientation):\n");
 				printf("  Face %i, Edge %i, Orientation %1.5e\n",
 					i, j, dDot);
@@ -1724,12 +3518,73 @@ void Mesh::Validate() const {
 				printf("  X-Product:\n");
 				printf("    %1.5e %1.5e %1.5e\n",
 					nodeCross.x, nodeCross.y, nodeCross.z);
+			}
+
+			_EXCEPTIONT(
+				"Mesh validation failed: Clockwise or concave face detected");
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::Validate() const {
+
+	// Valid that Nodes have magnitude 1; the lowest offending index is
+	// reported so the result does not depend on the number of threads
+	const long lNodes = static_cast<long>(nodes.size());
+
+	long lFirstNode = lNodes;
+
+#pragma omp parallel for schedule(static) reduction(min:lFirstNode)
+	for (long lf = 0; lf < lNodes; lf++) {
+		double dMag = nodes[lf].Magnitude();
+
+		if (fabs(dMag - 1.0) > ReferenceTolerance) {
+			if (lf < lFirstNode) {
+				lFirstNode = lf;
+			}
+		}
+	}
+
+	if (lFirstNode != lNodes) {
+		const int i = static_cast<int>(lFirstNode);
+		double dMag = nodes[i].Magnitude();
+
+		_EXCEPTION5("Mesh validation failed: "
+			"Node[%i] of non-unit magnitude detected (%1.10e, %1.10e, %1.10e) = %1.10e",
+			i, nodes[i].x, nodes[i].y, nodes[i].z, dMag);
+	}
 
-				_EXCEPTIONT(
-					"Mesh validation failed: Clockwise or concave face detected");
+	// Validate that edges are oriented counter-clockwise; Faces are checked
+	// quietly in parallel and the lowest failing Face is then re-checked
+	// with diagnostics to report the error
+	const long lFaces = static_cast<long>(faces.size());
+
+	long lFirstFace = lFaces;
+
+#pragma omp parallel for schedule(dynamic,1024) reduction(min:lFirstFace)
+	for (long lf = 0; lf < lFaces; lf++) {
+		try {
+			ValidateFaceOrientation(
+				nodes, faces[lf], static_cast<int>(lf), false);
+
+		} catch(Exception & e) {
+			if (lf < lFirstFace) {
+				lFirstFace = lf;
 			}
 		}
 	}
+
+	if (lFirstFace != lFaces) {
+		ValidateFaceOrientation(
+			nodes,
+			faces[lFirstFace],
+			static_cast<int>(lFirstFace),
+			true);
+
+		_EXCEPTIONT("Mesh validation failed");
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1954,17 +3809,82 @@ int BuildCoincidentNodeVector(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Tensor-product Gaussian quadrature on the unit square used to
+///		integrate the area of each sub-triangle of a Face.  The nodes and
+///		weights are computed once and shared by all threads.
+///	</summary>
+class FaceAreaQuadrature {
+
+public:
+	///	<summary>
+	///		Order of the one-dimensional quadrature rule.
+	///	</summary>
+	static const int Order = 6;
+
+	///	<summary>
+	///		Number of points in the tensor-product rule.
+	///	</summary>
+	static const int Points = Order * Order;
+
+public:
+	///	<summary>
+	///		Get the shared instance of the quadrature table.
+	///	</summary>
+	static const FaceAreaQuadrature & Get() {
+		static const FaceAreaQuadrature s_quadrature;
+		return s_quadrature;
+	}
+
+protected:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FaceAreaQuadrature() {
+		DataArray1D<double> dG;
+		DataArray1D<double> dW;
+		GaussQuadrature::GetPoints(Order, 0.0, 1.0, dG, dW);
+
+		for (int p = 0; p < Order; p++) {
+		for (int q = 0; q < Order; q++) {
+			m_dA[p * Order + q] = dG[p];
+			m_dB[p * Order + q] = dG[q];
+			m_dW[p * Order + q] = dW[p] * dW[q];
+		}
+		}
+	}
+
+public:
+	///	<summary>
+	///		First coordinate of each quadrature point.
+	///	</summary>
+	double m_dA[Points];
+
+	///	<summary>
+	///		Second coordinate of each quadrature point.
+	///	</summary>
+	double m_dB[Points];
+
+	///	<summary>
+	///		Product of one-dimensional weights at each quadrature point.
+	///	</summary>
+	double m_dW[Points];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 Real CalculateFaceAreaQuadratureMethod(
 	const Face & face,
 	const NodeVector & nodes
 ) {
 	int nTriangles = face.edges.size() - 2;
 
-	const int nOrder = 6;
+	const FaceAreaQuadrature & quad = FaceAreaQuadrature::Get();
+
+	const double * const dA = quad.m_dA;
+	const double * const dB = quad.m_dB;
 
-	DataArray1D<double> dG;
-	DataArray1D<double> dW;
-	GaussQuadrature::GetPoints(nOrder, 0.0, 1.0, dG, dW);
+	double dJacobian[FaceAreaQuadrature::Points];
 
 	double dFaceArea = 0.0;
 
@@ -1972,85 +3892,72 @@ Real CalculateFaceAreaQuadratureMethod(
 	for (int j = 0; j < nTriangles; j++) {
 
 		// Calculate the area of the modified Face
-		Node node1 = nodes[face[0]];
-		Node node2 = nodes[face[j+1]];
-		Node node3 = nodes[face[j+2]];
-
-		// Calculate area at quadrature node
-		for (int p = 0; p < dW.GetRows(); p++) {
-		for (int q = 0; q < dW.GetRows(); q++) {
-
-			double dA = dG[p];
-			double dB = dG[q];
-
-			Node dF(
-				(1.0 - dB) * ((1.0 - dA) * node1.x + dA * node2.x) + dB * node3.x,
-				(1.0 - dB) * ((1.0 - dA) * node1.y + dA * node2.y) + dB * node3.y,
-				(1.0 - dB) * ((1.0 - dA) * node1.z + dA * node2.z) + dB * node3.z);
-
-			Node dDaF(
-				(1.0 - dB) * (node2.x - node1.x),
-				(1.0 - dB) * (node2.y - node1.y),
-				(1.0 - dB) * (node2.z - node1.z));
-
-			Node dDbF(
-				- (1.0 - dA) * node1.x - dA * node2.x + node3.x,
-				- (1.0 - dA) * node1.y - dA * node2.y + node3.y,
-				- (1.0 - dA) * node1.z - dA * node2.z + node3.z);
-
-			double dR = sqrt(dF.x * dF.x + dF.y * dF.y + dF.z * dF.z);
-
-			Node dDaG(
-				dDaF.x * (dF.y * dF.y + dF.z * dF.z)
-					- dF.x * (dDaF.y * dF.y + dDaF.z * dF.z),
-				dDaF.y * (dF.x * dF.x + dF.z * dF.z)
-					- dF.y * (dDaF.x * dF.x + dDaF.z * dF.z),
-				dDaF.z * (dF.x * dF.x + dF.y * dF.y)
-					- dF.z * (dDaF.x * dF.x + dDaF.y * dF.y));
-
-			Node dDbG(
-				dDbF.x * (dF.y * dF.y + dF.z * dF.z)
-					- dF.x * (dDbF.y * dF.y + dDbF.z * dF.z),
-				dDbF.y * (dF.x * dF.x + dF.z * dF.z)
-					- dF.y * (dDbF.x * dF.x + dDbF.z * dF.z),
-				dDbF.z * (dF.x * dF.x + dF.y * dF.y)
-					- dF.z * (dDbF.x * dF.x + dDbF.y * dF.y));
-
-			double dDenomTerm = 1.0 / (dR * dR * dR);
-
-			dDaG.x *= dDenomTerm;
-			dDaG.y *= dDenomTerm;
-			dDaG.z *= dDenomTerm;
-
-			dDbG.x *= dDenomTerm;
-			dDbG.y *= dDenomTerm;
-			dDbG.z *= dDenomTerm;
-/*
-			Node node;
-			Node dDx1G;
-			Node dDx2G;
-
-			ApplyLocalMap(
-				faceQuad,
-				nodes,
-				dG[p],
-				dG[q],
-				node,
-				dDx1G,
-				dDx2G);
-*/
-			// Cross product gives local Jacobian
-			Node nodeCross = CrossProduct(dDaG, dDbG);
-
-			double dJacobian = sqrt(
-				  nodeCross.x * nodeCross.x
-				+ nodeCross.y * nodeCross.y
-				+ nodeCross.z * nodeCross.z);
+		const Node & node1 = nodes[face[0]];
+		const Node & node2 = nodes[face[j+1]];
+		const Node & node3 = nodes[face[j+2]];
+
+		const double x1 = node1.x;
+		const double y1 = node1.y;
+		const double z1 = node1.z;
+
+		const double x2 = node2.x;
+		const double y2 = node2.y;
+		const double z2 = node2.z;
+
+		const double x3 = node3.x;
+		const double y3 = node3.y;
+		const double z3 = node3.z;
+
+		// Calculate the local Jacobian at all quadrature points; the
+		// arithmetic is identical to the pointwise formulation so that
+		// areas do not depend on vectorization
+#pragma omp simd
+		for (int k = 0; k < FaceAreaQuadrature::Points; k++) {
+
+			const double dFx = (1.0 - dB[k]) * ((1.0 - dA[k]) * x1 + dA[k] * x2) + dB[k] * x3;
+			const double dFy = (1.0 - dB[k]) * ((1.0 - dA[k]) * y1 + dA[k] * y2) + dB[k] * y3;
+			const double dFz = (1.0 - dB[k]) * ((1.0 - dA[k]) * z1 + dA[k] * z2) + dB[k] * z3;
+
+			const double dDaFx = (1.0 - dB[k]) * (x2 - x1);
+			const double dDaFy = (1.0 - dB[k]) * (y2 - y1);
+			const double dDaFz = (1.0 - dB[k]) * (z2 - z1);
+
+			const double dDbFx = - (1.0 - dA[k]) * x1 - dA[k] * x2 + x3;
+			const double dDbFy = - (1.0 - dA[k]) * y1 - dA[k] * y2 + y3;
+			const double dDbFz = - (1.0 - dA[k]) * z1 - dA[k] * z2 + z3;
+
+			const double dR = sqrt(dFx * dFx + dFy * dFy + dFz * dFz);
+
+			const double dDenomTerm = 1.0 / (dR * dR * dR);
+
+			const double dDaGx = (dDaFx * (dFy * dFy + dFz * dFz)
+				- dFx * (dDaFy * dFy + dDaFz * dFz)) * dDenomTerm;
+			const double dDaGy = (dDaFy * (dFx * dFx + dFz * dFz)
+				- dFy * (dDaFx * dFx + dDaFz * dFz)) * dDenomTerm;
+			const double dDaGz = (dDaFz * (dFx * dFx + dFy * dFy)
+				- dFz * (dDaFx * dFx + dDaFy * dFy)) * dDenomTerm;
+
+			const double dDbGx = (dDbFx * (dFy * dFy + dFz * dFz)
+				- dFx * (dDbFy * dFy + dDbFz * dFz)) * dDenomTerm;
+			const double dDbGy = (dDbFy * (dFx * dFx + dFz * dFz)
+				- dFy * (dDbFx * dFx + dDbFz * dFz)) * dDenomTerm;
+			const double dDbGz = (dDbFz * (dFx * dFx + dFy * dFy)
+				- dFz * (dDbFx * dFx + dDbFy * dFy)) * dDenomTerm;
 
-			//dFaceArea += 2.0 * dW[p] * dW[q] * (1.0 - dG[q]) * dJacobian;
-			
-			dFaceArea += dW[p] * dW[q] * dJacobian;
+			// Cross product gives local Jacobian
+			const double dCrossX = dDaGy * dDbGz - dDaGz * dDbGy;
+			const double dCrossY = dDaGz * dDbGx - dDaGx * dDbGz;
+			const double dCrossZ = dDaGx * dDbGy - dDaGy * dDbGx;
+
+			dJacobian[k] = sqrt(
+				  dCrossX * dCrossX
+				+ dCrossY * dCrossY
+				+ dCrossZ * dCrossZ);
 		}
+
+		// Accumulate in a fixed order so the result is reproducible
+		for (int k = 0; k < FaceAreaQuadrature::Points; k++) {
+			dFaceArea += quad.m_dW[k] * dJacobian[k];
 		}
 	}
 
@@ -2630,31 +4537,193 @@ bool ConvexifyFaceBayazit(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void ConvexifyMesh(
-	Mesh & mesh,
+///	<summary>
+///		Subdivide all concave Faces of a Mesh.  Each concave Face is copied
+///		into a standalone Mesh whose first nodes are the nodes of the Face,
+///		in order, and is then divided independently of all other Faces.
+///		On return vecConcaveFaces contains the indices of subdivided Faces
+///		in increasing order and vecFaceMeshes the corresponding output.
+///	</summary>
+static void ConvexifyMeshFaces(
+	const Mesh & mesh,
+	std::vector<int> & vecConcaveFaces,
+	std::vector<Mesh> & vecFaceMeshes,
 	bool fVerbose
 ) {
-	char szBuffer[256];
+	const long lFaces = static_cast<long>(mesh.faces.size());
 
-	// Loop through all Faces in the Mesh
-	int nFaces = mesh.faces.size();
-	for (int f = 0; f < nFaces; f++) {
-		if (fVerbose) {
-			snprintf(szBuffer, 256, "Face %i", f);
-			AnnounceStartBlock(szBuffer);
+	// Identify concave Faces
+	std::vector<char> vecIsConcave(lFaces);
+
+#pragma omp parallel for schedule(dynamic,1024)
+	for (long lf = 0; lf < lFaces; lf++) {
+		vecIsConcave[lf] =
+			IsFaceConcave(mesh.faces[lf], mesh.nodes) ? 1 : 0;
+	}
+
+	std::vector<int> vecCandidateFaces;
+	for (long lf = 0; lf < lFaces; lf++) {
+		if (vecIsConcave[lf]) {
+			vecCandidateFaces.push_back(static_cast<int>(lf));
+		}
+	}
+
+	// Subdivide each concave Face into its own Mesh; output is serialized
+	// when verbose so that announcements are not interleaved
+	const long lCandidates = static_cast<long>(vecCandidateFaces.size());
+
+	std::vector<Mesh> vecCandidateMeshes(lCandidates);
+	std::vector<char> vecSubdivided(lCandidates, 0);
+
+	long lFirstError = lCandidates;
+	Exception excFirst(__FILE__, __LINE__);
+
+#pragma omp parallel for schedule(dynamic,1) if(!fVerbose)
+	for (long lc = 0; lc < lCandidates; lc++) {
+		const int iFace = vecCandidateFaces[lc];
+		const Face & face = mesh.faces[iFace];
+		const int nEdges = face.edges.size();
+
+		try {
+			if (fVerbose) {
+				char szBuffer[256];
+				snprintf(szBuffer, 256, "Face %i", iFace);
+				AnnounceStartBlock(szBuffer);
+			}
+
+			Mesh meshFace;
+			meshFace.nodes.resize(nEdges);
+
+			Face faceLocal(nEdges);
+			for (int j = 0; j < nEdges; j++) {
+				meshFace.nodes[j] = mesh.nodes[face[j]];
+				faceLocal.SetNode(j, j);
+			}
+			meshFace.faces.push_back(faceLocal);
+
+			Mesh & meshLocal = vecCandidateMeshes[lc];
+			meshLocal.nodes = meshFace.nodes;
+
+			if (ConvexifyFace(meshFace, meshLocal, 0, false, fVerbose)) {
+				vecSubdivided[lc] = 1;
+			}
+
+			if (fVerbose) {
+				AnnounceEndBlock("Done");
+			}
+
+		} catch(Exception & e) {
+#pragma omp critical
+			{
+				if (lc < lFirstError) {
+					lFirstError = lc;
+					excFirst = e;
+				}
+			}
 		}
+	}
+
+	if (lFirstError != lCandidates) {
+		throw excFirst;
+	}
+
+	// Gather subdivided Faces in order
+	vecConcaveFaces.clear();
+	vecFaceMeshes.clear();
 
-		// Adjust current Face index
-		bool fConcaveFace = ConvexifyFace(mesh, mesh, f, true, fVerbose);
-		if (fConcaveFace) {
-			f--;
-			nFaces--;
+	for (long lc = 0; lc < lCandidates; lc++) {
+		if (vecSubdivided[lc]) {
+			vecConcaveFaces.push_back(vecCandidateFaces[lc]);
+			vecFaceMeshes.push_back(Mesh());
+			vecFaceMeshes.back().nodes.swap(vecCandidateMeshes[lc].nodes);
+			vecFaceMeshes.back().faces.swap(vecCandidateMeshes[lc].faces);
 		}
+	}
+}
 
-		if (fVerbose) {
-			AnnounceEndBlock("Done");
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append the subdivision of Face face, stored in meshFace by
+///		ConvexifyMeshFaces, to the given node and Face arrays.
+///	</summary>
+static void AppendConvexifiedFace(
+	const Face & face,
+	const Mesh & meshFace,
+	NodeVector & nodes,
+	FaceVector & faces
+) {
+	const int nEdges = face.edges.size();
+	const int nLocalNodes = static_cast<int>(meshFace.nodes.size());
+	const int ixFirstNewNode = static_cast<int>(nodes.size()) - nEdges;
+
+	for (int i = nEdges; i < nLocalNodes; i++) {
+		nodes.push_back(meshFace.nodes[i]);
+	}
+
+	for (size_t i = 0; i < meshFace.faces.size(); i++) {
+		const Face & faceLocal = meshFace.faces[i];
+		const int nLocalEdges = static_cast<int>(faceLocal.edges.size());
+
+		Face faceNew(nLocalEdges);
+		for (int j = 0; j < nLocalEdges; j++) {
+			const int ixLocal = faceLocal[j];
+			if ((ixLocal < 0) || (ixLocal >= nLocalNodes)) {
+				_EXCEPTIONT("Logic error");
+			}
+			if (ixLocal < nEdges) {
+				faceNew.SetNode(j, face[ixLocal]);
+			} else {
+				faceNew.SetNode(j, ixFirstNewNode + ixLocal);
+			}
+		}
+		faces.push_back(faceNew);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConvexifyMesh(
+	Mesh & mesh,
+	bool fVerbose
+) {
+	std::vector<int> vecConcaveFaces;
+	std::vector<Mesh> vecFaceMeshes;
+
+	ConvexifyMeshFaces(mesh, vecConcaveFaces, vecFaceMeshes, fVerbose);
+
+	if (vecConcaveFaces.size() == 0) {
+		return;
+	}
+
+	// Remaining Faces keep their order and subdivided Faces are appended
+	// in order of the original Face index
+	FaceVector facesNew;
+	facesNew.reserve(mesh.faces.size());
+
+	const int nFaces = static_cast<int>(mesh.faces.size());
+	const int nConcaveFaces = static_cast<int>(vecConcaveFaces.size());
+
+	int iNextConcave = 0;
+	for (int f = 0; f < nFaces; f++) {
+		if ((iNextConcave < nConcaveFaces) &&
+		    (vecConcaveFaces[iNextConcave] == f)
+		) {
+			iNextConcave++;
+			continue;
 		}
+		facesNew.push_back(mesh.faces[f]);
 	}
+
+	for (int i = 0; i < nConcaveFaces; i++) {
+		AppendConvexifiedFace(
+			mesh.faces[vecConcaveFaces[i]],
+			vecFaceMeshes[i],
+			mesh.nodes,
+			facesNew);
+	}
+
+	mesh.faces.swap(facesNew);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2664,44 +4733,49 @@ void ConvexifyMesh(
 	Mesh & meshout,
 	bool fVerbose
 ) {
-	char szBuffer[256];
+	std::vector<int> vecConcaveFaces;
+	std::vector<Mesh> vecFaceMeshes;
+
+	ConvexifyMeshFaces(mesh, vecConcaveFaces, vecFaceMeshes, fVerbose);
 
 	// Copy all nodes to output mesh
-	meshout.nodes.clear();
+	meshout.nodes = mesh.nodes;
 
 	// Remove all Faces from output mesh
 	meshout.faces.clear();
+	meshout.faces.reserve(mesh.faces.size());
 
 	// Clear the MultiFaceMap
 	meshout.vecMultiFaceMap.clear();
 
 	// Loop through all Faces in the input Mesh
-	int nFaces = mesh.faces.size();
-	for (int f = 0; f < nFaces; f++) {
-		if (fVerbose) {
-			snprintf(szBuffer, 256, "Face %i", f);
-			AnnounceStartBlock(szBuffer);
-		}
+	const int nFaces = static_cast<int>(mesh.faces.size());
+	const int nConcaveFaces = static_cast<int>(vecConcaveFaces.size());
 
-		// Adjust current Face index
-		int nMeshSize = meshout.faces.size();
+	int iNextConcave = 0;
+	for (int f = 0; f < nFaces; f++) {
+		if ((iNextConcave < nConcaveFaces) &&
+		    (vecConcaveFaces[iNextConcave] == f)
+		) {
+			int nMeshSize = meshout.faces.size();
 
-		bool fConcaveFace = ConvexifyFace(mesh, meshout, f, false, fVerbose);
+			AppendConvexifiedFace(
+				mesh.faces[f],
+				vecFaceMeshes[iNextConcave],
+				meshout.nodes,
+				meshout.faces);
 
-		if (fConcaveFace) {
 			int nAddedFaces = meshout.faces.size() - nMeshSize;
 			for (int i = 0; i < nAddedFaces; i++) {
 				meshout.vecMultiFaceMap.push_back(f);
 			}
 
+			iNextConcave++;
+
 		} else {
 			meshout.faces.push_back(mesh.faces[f]);
 			meshout.vecMultiFaceMap.push_back(f);
 		}
-
-		if (fVerbose) {
-			AnnounceEndBlock("Done");
-		}
 	}
 
 	if (meshout.vecMultiFaceMap.size() != meshout.faces.size()) {
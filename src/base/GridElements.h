@@ -629,7 +629,91 @@ public:
 
 typedef std::vector<Edge> EdgeVector;
 
-typedef std::map<Edge, FacePair> EdgeMap;
+typedef std::pair<Edge, FacePair> EdgePair;
+
+typedef std::vector<EdgePair> EdgeMapVector;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A map between Edges and the FacePairs on either side, stored as a
+///		flat table of EdgePairs sorted by Edge.  Lookups are performed by
+///		binary search.  Iterators are invalidated by insert().
+///	</summary>
+class EdgeMap {
+
+public:
+	typedef Edge key_type;
+
+	typedef FacePair mapped_type;
+
+	typedef EdgePair value_type;
+
+	typedef EdgeMapVector::iterator iterator;
+
+	typedef EdgeMapVector::const_iterator const_iterator;
+
+public:
+	///	<summary>
+	///		Number of Edges in the map.
+	///	</summary>
+	size_t size() const {
+		return m_vecEdges.size();
+	}
+
+	///	<summary>
+	///		Remove all Edges from the map.
+	///	</summary>
+	void clear() {
+		m_vecEdges.clear();
+	}
+
+	///	<summary>
+	///		Iterators.
+	///	</summary>
+	iterator begin() {
+		return m_vecEdges.begin();
+	}
+
+	iterator end() {
+		return m_vecEdges.end();
+	}
+
+	const_iterator begin() const {
+		return m_vecEdges.begin();
+	}
+
+	const_iterator end() const {
+		return m_vecEdges.end();
+	}
+
+	///	<summary>
+	///		Find the given Edge, or return end() if it is not present.
+	///	</summary>
+	iterator find(const Edge & edge);
+
+	const_iterator find(const Edge & edge) const;
+
+	///	<summary>
+	///		Insert an EdgePair into the map if its Edge is not already
+	///		present.  This is O(size()), so large maps should be built with
+	///		assign() instead.
+	///	</summary>
+	std::pair<iterator, bool> insert(const value_type & value);
+
+	///	<summary>
+	///		Replace the contents of the map with the given EdgePairs, which
+	///		must be sorted by Edge with no duplicates.  The contents of
+	///		vecEdges are swapped into the map.
+	///	</summary>
+	void assign(EdgeMapVector & vecEdges);
+
+private:
+	///	<summary>
+	///		Sorted table of Edges and FacePairs.
+	///	</summary>
+	EdgeMapVector m_vecEdges;
+};
 
 typedef EdgeMap::value_type EdgeMapPair;
 
@@ -641,10 +725,6 @@ typedef std::vector<EdgeMap::iterator> EdgeMapIteratorVector;
 
 typedef std::set<Edge> EdgeSet;
 
-typedef std::pair<Edge, FacePair> EdgePair;
-
-typedef std::vector<EdgePair> EdgeMapVector;
-
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
@@ -719,10 +799,403 @@ typedef std::vector<Face> FaceVector;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		A compact representation of the Faces of a mesh.  The nodes of Face f
+///		are stored in counter-clockwise order in vecFaceNodes at positions
+///		[vecFaceOffsets[f], vecFaceOffsets[f+1]).  Edge k of Face f connects
+///		node k to node k+1 and has type vecEdgeTypes[vecFaceOffsets[f]+k];
+///		if vecEdgeTypes is empty all Edges have type Edge::Type_Default.
+///	</summary>
+class CompactFaceVector {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	CompactFaceVector() {
+		vecFaceOffsets.push_back(0);
+	}
+
+	///	<summary>
+	///		Number of Faces.
+	///	</summary>
+	size_t size() const {
+		return (vecFaceOffsets.size() - 1);
+	}
+
+	///	<summary>
+	///		Remove all Faces.
+	///	</summary>
+	void clear() {
+		vecFaceOffsets.resize(1);
+		vecFaceOffsets[0] = 0;
+		vecFaceNodes.clear();
+		vecEdgeTypes.clear();
+	}
+
+	///	<summary>
+	///		Determine if per-Edge types are stored.
+	///	</summary>
+	bool HasEdgeTypes() const {
+		return (vecEdgeTypes.size() != 0);
+	}
+
+	///	<summary>
+	///		Number of nodes (and Edges) of the given Face.
+	///	</summary>
+	inline int GetNodeCount(size_t f) const {
+		return static_cast<int>(vecFaceOffsets[f+1] - vecFaceOffsets[f]);
+	}
+
+	///	<summary>
+	///		Pointer to the nodes of the given Face.
+	///	</summary>
+	inline const int * GetNodes(size_t f) const {
+		return &(vecFaceNodes[vecFaceOffsets[f]]);
+	}
+
+	///	<summary>
+	///		Get node k of the given Face.
+	///	</summary>
+	inline int GetNode(size_t f, int k) const {
+		return vecFaceNodes[vecFaceOffsets[f] + k];
+	}
+
+	///	<summary>
+	///		Get the type of Edge k of the given Face.
+	///	</summary>
+	inline Edge::Type GetEdgeType(size_t f, int k) const {
+		if (vecEdgeTypes.size() == 0) {
+			return Edge::Type_Default;
+		}
+		return static_cast<Edge::Type>(vecEdgeTypes[vecFaceOffsets[f] + k]);
+	}
+
+	///	<summary>
+	///		Append a Face with the given nodes and Edge types (optional).
+	///	</summary>
+	void AddFace(
+		int nNodes,
+		const int * ixNodes,
+		const int * iEdgeTypes = NULL
+	);
+
+	///	<summary>
+	///		Allocate storage for per-Edge types, initialized to
+	///		Edge::Type_Default.
+	///	</summary>
+	void AllocateEdgeTypes() {
+		if (vecEdgeTypes.size() == 0) {
+			vecEdgeTypes.resize(vecFaceNodes.size(),
+				static_cast<unsigned char>(Edge::Type_Default));
+		}
+	}
+
+	///	<summary>
+	///		Build a Face from the given compact Face.
+	///	</summary>
+	Face GetFace(size_t f) const;
+
+	///	<summary>
+	///		Initialize from a FaceVector.
+	///	</summary>
+	void FromFaces(const FaceVector & faces);
+
+	///	<summary>
+	///		Populate a FaceVector from this CompactFaceVector.
+	///	</summary>
+	void ToFaces(FaceVector & faces) const;
+
+public:
+	///	<summary>
+	///		Offset of the first node of each Face in vecFaceNodes, with
+	///		size() + 1 entries.
+	///	</summary>
+	std::vector<size_t> vecFaceOffsets;
+
+	///	<summary>
+	///		Node indices of all Faces.
+	///	</summary>
+	std::vector<int> vecFaceNodes;
+
+	///	<summary>
+	///		Type of each Edge (optionally initialized).
+	///	</summary>
+	std::vector<unsigned char> vecEdgeTypes;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		A reverse node array stores all faces associated with a given node.
+///		Face indices of all nodes are stored in compressed sparse row format,
+///		with the faces of each node sorted in increasing order.
 ///	</summary>
-typedef std::vector< std::set<int> > ReverseNodeArray;
+class ReverseNodeArray {
+
+public:
+	///	<summary>
+	///		A read-only view of the Face indices associated with a node.
+	///	</summary>
+	class FaceIndexRange {
+	public:
+		typedef const int * const_iterator;
+
+		///	<summary>
+		///		Constructor.
+		///	</summary>
+		FaceIndexRange(
+			const int * pBegin,
+			const int * pEnd
+		) :
+			m_pBegin(pBegin),
+			m_pEnd(pEnd)
+		{ }
+
+		///	<summary>
+		///		Iterators.
+		///	</summary>
+		const_iterator begin() const {
+			return m_pBegin;
+		}
+
+		const_iterator end() const {
+			return m_pEnd;
+		}
+
+		///	<summary>
+		///		Number of Faces.
+		///	</summary>
+		size_t size() const {
+			return static_cast<size_t>(m_pEnd - m_pBegin);
+		}
+
+		///	<summary>
+		///		Accessor.
+		///	</summary>
+		int operator[](size_t i) const {
+			return m_pBegin[i];
+		}
+
+	private:
+		const int * m_pBegin;
+		const int * m_pEnd;
+	};
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	ReverseNodeArray() {
+		m_vecOffsets.push_back(0);
+	}
+
+	///	<summary>
+	///		Number of nodes.
+	///	</summary>
+	size_t size() const {
+		return (m_vecOffsets.size() - 1);
+	}
+
+	///	<summary>
+	///		Remove all nodes.
+	///	</summary>
+	void clear() {
+		m_vecOffsets.resize(1);
+		m_vecOffsets[0] = 0;
+		m_vecFaces.clear();
+	}
+
+	///	<summary>
+	///		Get the Faces associated with the given node.
+	///	</summary>
+	FaceIndexRange operator[](size_t ixNode) const {
+		_ASSERT(ixNode + 1 < m_vecOffsets.size());
+		const int * pFaces = (m_vecFaces.size() == 0)?(NULL):(&(m_vecFaces[0]));
+		return FaceIndexRange(
+			pFaces + m_vecOffsets[ixNode],
+			pFaces + m_vecOffsets[ixNode+1]);
+	}
+
+	///	<summary>
+	///		Construct the ReverseNodeArray from the given Faces.
+	///	</summary>
+	void Construct(
+		size_t sNodes,
+		const FaceVector & faces
+	);
+
+	///	<summary>
+	///		Construct the ReverseNodeArray from the given compact Faces.
+	///	</summary>
+	void Construct(
+		size_t sNodes,
+		const CompactFaceVector & compactfaces
+	);
+
+protected:
+	///	<summary>
+	///		Construct the ReverseNodeArray using a two-pass count over Faces,
+	///		where FaceAccessor provides GetNodeCount(f) and GetNode(f,k).
+	///	</summary>
+	template <class FaceAccessor>
+	void ConstructFromAccessor(
+		size_t sNodes,
+		size_t sFaces,
+		const FaceAccessor & accessor
+	);
+
+private:
+	///	<summary>
+	///		Offset of the Faces of each node in m_vecFaces, with size() + 1
+	///		entries.
+	///	</summary>
+	std::vector<size_t> m_vecOffsets;
+
+	///	<summary>
+	///		Face indices of all nodes.
+	///	</summary>
+	std::vector<int> m_vecFaces;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A bounding volume hierarchy of spherical caps over the Faces of a
+///		mesh on the unit sphere, used for locating the Faces that may contain
+///		a given Node in logarithmic time.
+///	</summary>
+class FaceCapTree {
+
+public:
+	///	<summary>
+	///		Maximum number of Faces stored in each leaf.
+	///	</summary>
+	static const int MaxLeafFaces = 4;
+
+	///	<summary>
+	///		Angular padding added to each cap, so that Nodes on Face edges
+	///		within the containment tolerance are not missed.
+	///	</summary>
+	static const Real CapPadding;
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FaceCapTree() :
+		m_sFaces(0)
+	{ }
+
+	///	<summary>
+	///		Number of Faces in this tree.
+	///	</summary>
+	size_t size() const {
+		return m_sFaces;
+	}
+
+	///	<summary>
+	///		Remove all Faces.
+	///	</summary>
+	void clear() {
+		m_sFaces = 0;
+		m_vecCaps.clear();
+		m_vecFaces.clear();
+	}
+
+	///	<summary>
+	///		Construct the tree over the given Faces.
+	///	</summary>
+	void Construct(
+		const NodeVector & nodes,
+		const FaceVector & faces
+	);
+
+	///	<summary>
+	///		Find all Faces whose bounding cap contains the given Node,
+	///		in increasing order of Face index.  This is a superset of the
+	///		Faces that contain the Node.
+	///	</summary>
+	void FindCandidateFaces(
+		const Node & node,
+		std::vector<int> & vecFaces
+	) const;
+
+protected:
+	///	<summary>
+	///		A spherical cap, which is a leaf if ixLeft is negative.
+	///	</summary>
+	struct Cap {
+		///	<summary>
+		///		Center of the cap (unit vector).
+		///	</summary>
+		Real x;
+		Real y;
+		Real z;
+
+		///	<summary>
+		///		Angular radius of the cap.
+		///	</summary>
+		Real dRadius;
+
+		///	<summary>
+		///		Cosine of the padded angular radius of the cap.
+		///	</summary>
+		Real dCosRadius;
+
+		///	<summary>
+		///		Child caps for interior caps.
+		///	</summary>
+		int ixLeft;
+		int ixRight;
+
+		///	<summary>
+		///		Range of m_vecFaces for leaf caps.
+		///	</summary>
+		int ixBegin;
+		int ixEnd;
+	};
+
+	///	<summary>
+	///		Recursively build the tree over m_vecFaces[ixBegin, ixEnd).
+	///	</summary>
+	int BuildRecursive(
+		const std::vector<Cap> & vecFaceCaps,
+		const std::vector<Real> & vecCenters,
+		int ixBegin,
+		int ixEnd
+	);
+
+	///	<summary>
+	///		Set the padded cosine of the radius of a cap.
+	///	</summary>
+	static void SetCosRadius(Cap & cap);
+
+	///	<summary>
+	///		Calculate the smallest cap containing two caps.
+	///	</summary>
+	static Cap MergeCaps(
+		const Cap & cap1,
+		const Cap & cap2
+	);
+
+private:
+	///	<summary>
+	///		Number of Faces in this tree.
+	///	</summary>
+	size_t m_sFaces;
+
+	///	<summary>
+	///		Caps of the tree, with the root cap at index zero.
+	///	</summary>
+	std::vector<Cap> m_vecCaps;
+
+	///	<summary>
+	///		Face indices, arranged so that each leaf references a
+	///		contiguous range.
+	///	</summary>
+	std::vector<int> m_vecFaces;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -764,6 +1237,15 @@ public:
 	///	<summary>
 	FaceVector faces;
 
+	///	<summary>
+	///		Compact storage of the Faces of this mesh (optionally initialized).
+	///		The Faces are held in only one of faces and compactfaces.  If
+	///		faces is non-empty it is authoritative; any compactfaces left
+	///		alongside it are stale, are ignored and are released by the
+	///		next Mesh operation that builds from or modifies the Faces.
+	///	</summary>
+	CompactFaceVector compactfaces;
+
 	///	<summary>
 	///		Tolerance for removing coincident nodes.
 	///	</summary>
@@ -799,6 +1281,11 @@ public:
 	///	</summary>
 	ReverseNodeArray revnodearray;
 
+	///	<summary>
+	///		FaceCapTree for this mesh (optionally initialized).
+	///	</summary>
+	FaceCapTree facetree;
+
 	///	<summary>
 	///		Indices of the original Faces for this mesh (for use when
 	///		the original mesh has been subdivided).
@@ -835,16 +1322,50 @@ public:
 	///	</summary>
 	void Clear();
 
+	///	<summary>
+	///		Convert the FaceVector into compactfaces, releasing the
+	///		FaceVector.
+	///	</summary>
+	void ConstructCompactFaces();
+
+	///	<summary>
+	///		Expand compactfaces into the FaceVector, releasing compactfaces.
+	///	</summary>
+	void ConstructFacesFromCompact();
+
+	///	<summary>
+	///		Release compactfaces if the FaceVector is populated, in which
+	///		case compactfaces is stale.
+	///	</summary>
+	void DiscardStaleCompactFaces();
+
+	///	<summary>
+	///		Get the number of Faces in the mesh, using compactfaces if
+	///		the FaceVector is empty.
+	///	</summary>
+	size_t GetFaceCount() const {
+		if (faces.size() != 0) {
+			return faces.size();
+		}
+		return compactfaces.size();
+	}
+
 	///	<summary>
 	///		Construct the EdgeMap from the NodeVector and FaceVector.
 	///	</summary>
 	void ConstructEdgeMap();
 
 	///	<summary>
-	///		Construct the ReverseNodeArray from the NodeVector and FaceVector.
+	///		Construct the ReverseNodeArray from the NodeVector and FaceVector
+	///		(or compactfaces if the FaceVector is empty).
 	///	</summary>
 	void ConstructReverseNodeArray();
 
+	///	<summary>
+	///		Construct the FaceCapTree from the NodeVector and FaceVector.
+	///	</summary>
+	void ConstructFaceTree();
+
 	///	<summary>
 	///		Calculate Face areas.
 	///	</summary>
@@ -871,25 +1392,38 @@ public:
 	void RemoveCoincidentNodes();
 
 	///	<summary>
-	///		Write the mesh to a NetCDF file in Exodus format.
+	///		Write the mesh to a NetCDF file in Exodus format.  Arrays are
+	///		gathered and written in chunks of bounded size.  For netCDF-4
+	///		files, variables are chunked and compressed with the shuffle
+	///		filter and the given deflate level (0 disables compression).
 	///	</summary>
 	void Write(
 		const std::string & strFile,
-		NcFile::FileFormat eFileFormat = NcFile::Classic
+		NcFile::FileFormat eFileFormat = NcFile::Classic,
+		int nDeflateLevel = 1
 	) const;
 
 	///	<summary>
-	///		Write the mesh to a NetCDF file in SCRIP format.
+	///		Write the mesh to a NetCDF file in SCRIP format.  Arrays are
+	///		gathered and written in chunks of bounded size.  For netCDF-4
+	///		files, variables are chunked and compressed with the shuffle
+	///		filter and the given deflate level (0 disables compression).
 	///	</summary>
 	void WriteScrip(
 		const std::string & strFile,
-		NcFile::FileFormat eFileFormat = NcFile::Classic
+		NcFile::FileFormat eFileFormat = NcFile::Classic,
+		int nDeflateLevel = 1
 	) const;
 
 	///	<summary>
-	///		Read the mesh from a NetCDF file.
+	///		Read the mesh from a NetCDF file.  Faces are read into
+	///		compactfaces and, if fConstructFaces is true, expanded into the
+	///		FaceVector (releasing compactfaces).
 	///	</summary>
-	void Read(const std::string & strFile);
+	void Read(
+		const std::string & strFile,
+		bool fConstructFaces = true
+	);
 
 	///	<summary>
 	///		Remove zero edges from all Faces.
@@ -0,0 +1,493 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GridRasterizer.cpp
+///	\author  Paul Ullrich
+///	\version October 18, 2026
+///
+///	<remarks>
+///		Copyright 2026 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "GridRasterizer.h"
+#include "SimpleGrid.h"
+#include "ColorMap.h"
+#include "PNGImage.h"
+#include "CoordTransforms.h"
+#include "Exception.h"
+#include "Announce.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Header of a pixel-to-node map cache file, followed by one 32-bit
+///		node index per pixel.
+///	</summary>
+struct GridRasterizerCacheHeader {
+	char szMagic[8];
+	uint32_t uVersion;
+	uint32_t nWidth;
+	uint32_t nHeight;
+	uint32_t uReserved;
+	uint64_t ulGridFingerprint;
+	uint64_t ulGridSize;
+	double dLonBegin;
+	double dLonEnd;
+	double dLatBegin;
+	double dLatEnd;
+	double dMaxDistDeg;
+};
+
+static const char GridRasterizerCacheMagic[8] =
+	{'T','R','A','S','T','M','A','P'};
+
+static const uint32_t GridRasterizerCacheVersion = 1;
+
+///////////////////////////////////////////////////////////////////////////////
+// GridRasterizer
+///////////////////////////////////////////////////////////////////////////////
+
+GridRasterizer::GridRasterizer() :
+	m_nWidth(0),
+	m_nHeight(0),
+	m_dLonBegin(0.0),
+	m_dLonEnd(0.0),
+	m_dLatBegin(0.0),
+	m_dLatEnd(0.0),
+	m_dMaxDistDeg(0.0),
+	m_ulGridFingerprint(0),
+	m_ulGridSize(0)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::Initialize(
+	const SimpleGrid & grid,
+	unsigned int nWidth,
+	unsigned int nHeight,
+	double dLonBegin,
+	double dLonEnd,
+	double dLatBegin,
+	double dLatEnd,
+	double dMaxDistDeg,
+	const std::string & strCacheDir
+) {
+	if ((nWidth == 0) || (nHeight == 0)) {
+		_EXCEPTION2("Invalid image size (%u x %u)", nWidth, nHeight);
+	}
+	if (dLonEnd <= dLonBegin) {
+		_EXCEPTION2("Invalid longitude range [%1.5f, %1.5f]",
+			dLonBegin, dLonEnd);
+	}
+	if ((dLatEnd <= dLatBegin) || (dLatBegin < -90.0) || (dLatEnd > 90.0)) {
+		_EXCEPTION2("Invalid latitude range [%1.5f, %1.5f]",
+			dLatBegin, dLatEnd);
+	}
+	if (dMaxDistDeg < 0.0) {
+		_EXCEPTION1("Invalid maximum distance (%1.5f)", dMaxDistDeg);
+	}
+	if (grid.GetSize() >= static_cast<size_t>(InvalidNode)) {
+		_EXCEPTION1("Grid is too large for rasterization (%lu nodes)",
+			grid.GetSize());
+	}
+
+	m_nWidth = nWidth;
+	m_nHeight = nHeight;
+	m_dLonBegin = dLonBegin;
+	m_dLonEnd = dLonEnd;
+	m_dLatBegin = dLatBegin;
+	m_dLatEnd = dLatEnd;
+	m_dMaxDistDeg = dMaxDistDeg;
+	m_ulGridFingerprint = grid.Fingerprint();
+	m_ulGridSize = grid.GetSize();
+	m_vecPixelNode.clear();
+
+	// Load the map from the cache if possible
+	std::string strCacheFile;
+	if (strCacheDir != "") {
+		strCacheFile = strCacheDir + "/" + CacheFilename();
+		if (ReadCache(strCacheFile)) {
+			return;
+		}
+	}
+
+	Build(grid);
+
+	// A cache that cannot be written only costs a rebuild next time
+	if (strCacheFile != "") {
+		try {
+			WriteCache(strCacheFile);
+		} catch(Exception & e) {
+			Announce("WARNING: Unable to write rasterizer cache: %s",
+				e.ToString().c_str());
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::Build(
+	const SimpleGrid & grid
+) {
+	if (!grid.HasSpatialIndex()) {
+		_EXCEPTIONT("Grid must have a spatial index for rasterization");
+	}
+
+	const size_t sWidth = static_cast<size_t>(m_nWidth);
+	const size_t sPixels = sWidth * static_cast<size_t>(m_nHeight);
+
+	const double dDeltaLon = (m_dLonEnd - m_dLonBegin) / m_nWidth;
+	const double dDeltaLat = (m_dLatEnd - m_dLatBegin) / m_nHeight;
+
+	// Pixel centers, with the first row at the top of the image
+	std::vector<double> dLonRad(sPixels);
+	std::vector<double> dLatRad(sPixels);
+
+#pragma omp parallel for schedule(static)
+	for (long lj = 0; lj < static_cast<long>(m_nHeight); lj++) {
+		const double dLat =
+			DegToRad(m_dLatEnd - (static_cast<double>(lj) + 0.5) * dDeltaLat);
+		const size_t sRow = static_cast<size_t>(lj) * sWidth;
+		for (size_t i = 0; i < sWidth; i++) {
+			dLonRad[sRow + i] =
+				DegToRad(m_dLonBegin + (static_cast<double>(i) + 0.5) * dDeltaLon);
+			dLatRad[sRow + i] = dLat;
+		}
+	}
+
+	std::vector<size_t> vecNodeIxs(sPixels);
+	grid.NearestNodesBatch(
+		&(dLonRad[0]), &(dLatRad[0]), sPixels, &(vecNodeIxs[0]));
+
+	// Pixels further than the maximum chord length from their node are
+	// not associated with any node
+	const double dMaxChord2 =
+		(m_dMaxDistDeg > 0.0)
+		? ChordLengthFromGreatCircleDistance_Deg(m_dMaxDistDeg)
+			* ChordLengthFromGreatCircleDistance_Deg(m_dMaxDistDeg)
+		: 0.0;
+
+	m_vecPixelNode.resize(sPixels);
+
+#pragma omp parallel for schedule(static)
+	for (long lp = 0; lp < static_cast<long>(sPixels); lp++) {
+		const size_t ix = vecNodeIxs[lp];
+
+		if (dMaxChord2 > 0.0) {
+			const double dCosLat0 = cos(dLatRad[lp]);
+			const double dCosLat1 = cos(grid.m_dLat[ix]);
+
+			const double dDX =
+				cos(grid.m_dLon[ix]) * dCosLat1 - cos(dLonRad[lp]) * dCosLat0;
+			const double dDY =
+				sin(grid.m_dLon[ix]) * dCosLat1 - sin(dLonRad[lp]) * dCosLat0;
+			const double dDZ = sin(grid.m_dLat[ix]) - sin(dLatRad[lp]);
+			if (dDX * dDX + dDY * dDY + dDZ * dDZ > dMaxChord2) {
+				m_vecPixelNode[lp] = InvalidNode;
+				continue;
+			}
+		}
+
+		m_vecPixelNode[lp] = static_cast<uint32_t>(ix);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string GridRasterizer::CacheFilename() const {
+
+	// Key on the grid and all map parameters
+	uint64_t hash = SimpleGrid::HashBytes(NULL, 0);
+	hash = SimpleGrid::HashBytes(
+		&m_ulGridFingerprint, sizeof(m_ulGridFingerprint), hash);
+	hash = SimpleGrid::HashBytes(&m_ulGridSize, sizeof(m_ulGridSize), hash);
+	hash = SimpleGrid::HashBytes(&m_nWidth, sizeof(m_nWidth), hash);
+	hash = SimpleGrid::HashBytes(&m_nHeight, sizeof(m_nHeight), hash);
+	hash = SimpleGrid::HashBytes(&m_dLonBegin, sizeof(m_dLonBegin), hash);
+	hash = SimpleGrid::HashBytes(&m_dLonEnd, sizeof(m_dLonEnd), hash);
+	hash = SimpleGrid::HashBytes(&m_dLatBegin, sizeof(m_dLatBegin), hash);
+	hash = SimpleGrid::HashBytes(&m_dLatEnd, sizeof(m_dLatEnd), hash);
+	hash = SimpleGrid::HashBytes(&m_dMaxDistDeg, sizeof(m_dMaxDistDeg), hash);
+
+	char szFilename[64];
+	snprintf(szFilename, sizeof(szFilename), "rastermap_%016llx.dat",
+		static_cast<unsigned long long>(hash));
+
+	return std::string(szFilename);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool GridRasterizer::ReadCache(
+	const std::string & strFilename
+) {
+	FILE * fp = fopen(strFilename.c_str(), "rb");
+	if (fp == NULL) {
+		return false;
+	}
+
+	GridRasterizerCacheHeader header;
+	if (fread(&header, sizeof(header), 1, fp) != 1) {
+		fclose(fp);
+		return false;
+	}
+
+	// Only accept maps generated with exactly the same parameters
+	if ((memcmp(header.szMagic, GridRasterizerCacheMagic, 8) != 0) ||
+	    (header.uVersion != GridRasterizerCacheVersion) ||
+	    (header.nWidth != m_nWidth) ||
+	    (header.nHeight != m_nHeight) ||
+	    (header.ulGridFingerprint != m_ulGridFingerprint) ||
+	    (header.ulGridSize != m_ulGridSize) ||
+	    (header.dLonBegin != m_dLonBegin) ||
+	    (header.dLonEnd != m_dLonEnd) ||
+	    (header.dLatBegin != m_dLatBegin) ||
+	    (header.dLatEnd != m_dLatEnd) ||
+	    (header.dMaxDistDeg != m_dMaxDistDeg)
+	) {
+		fclose(fp);
+		return false;
+	}
+
+	const size_t sPixels =
+		static_cast<size_t>(m_nWidth) * static_cast<size_t>(m_nHeight);
+
+	std::vector<uint32_t> vecPixelNode(sPixels);
+	size_t sRead = fread(&(vecPixelNode[0]), sizeof(uint32_t), sPixels, fp);
+	fclose(fp);
+
+	if (sRead != sPixels) {
+		return false;
+	}
+	for (size_t p = 0; p < sPixels; p++) {
+		if ((vecPixelNode[p] != InvalidNode) &&
+		    (static_cast<uint64_t>(vecPixelNode[p]) >= m_ulGridSize)
+		) {
+			return false;
+		}
+	}
+
+	m_vecPixelNode.swap(vecPixelNode);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::WriteCache(
+	const std::string & strFilename
+) const {
+	const size_t sPixels =
+		static_cast<size_t>(m_nWidth) * static_cast<size_t>(m_nHeight);
+
+	if ((sPixels == 0) || (m_vecPixelNode.size() != sPixels)) {
+		_EXCEPTIONT("GridRasterizer has not been initialized");
+	}
+
+	GridRasterizerCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.szMagic, GridRasterizerCacheMagic, 8);
+	header.uVersion = GridRasterizerCacheVersion;
+	header.nWidth = m_nWidth;
+	header.nHeight = m_nHeight;
+	header.ulGridFingerprint = m_ulGridFingerprint;
+	header.ulGridSize = m_ulGridSize;
+	header.dLonBegin = m_dLonBegin;
+	header.dLonEnd = m_dLonEnd;
+	header.dLatBegin = m_dLatBegin;
+	header.dLatEnd = m_dLatEnd;
+	header.dMaxDistDeg = m_dMaxDistDeg;
+
+	// Unique temporary file in the same directory, so that concurrent
+	// writers do not share it and the rename is atomic
+	std::vector<char> vecTempFilename(strFilename.begin(), strFilename.end());
+	const char szTempSuffix[] = ".XXXXXX";
+	vecTempFilename.insert(
+		vecTempFilename.end(), szTempSuffix, szTempSuffix + sizeof(szTempSuffix));
+
+	int fd = mkstemp(&(vecTempFilename[0]));
+	if (fd == (-1)) {
+		_EXCEPTION1("Unable to create temporary file for cache file \"%s\"",
+			strFilename.c_str());
+	}
+
+	std::string strTempFilename(&(vecTempFilename[0]));
+
+	// mkstemp creates the file readable only by its owner
+	fchmod(fd, 0644);
+
+	FILE * fp = fdopen(fd, "wb");
+	if (fp == NULL) {
+		close(fd);
+		remove(strTempFilename.c_str());
+		_EXCEPTION1("Unable to open cache file \"%s\" for writing",
+			strTempFilename.c_str());
+	}
+
+	bool fSuccess = (fwrite(&header, sizeof(header), 1, fp) == 1);
+	if (fSuccess) {
+		fSuccess = (fwrite(&(m_vecPixelNode[0]),
+			sizeof(uint32_t), sPixels, fp) == sPixels);
+	}
+	if (fclose(fp) != 0) {
+		fSuccess = false;
+	}
+
+	if (!fSuccess) {
+		remove(strTempFilename.c_str());
+		_EXCEPTION1("Error writing cache file \"%s\"",
+			strTempFilename.c_str());
+	}
+	if (rename(strTempFilename.c_str(), strFilename.c_str()) != 0) {
+		remove(strTempFilename.c_str());
+		_EXCEPTION1("Unable to rename cache file to \"%s\"",
+			strFilename.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::CheckField(
+	const float * dData,
+	size_t sCount
+) const {
+	if (m_vecPixelNode.size() == 0) {
+		_EXCEPTIONT("GridRasterizer has not been initialized");
+	}
+	if (static_cast<uint64_t>(sCount) != m_ulGridSize) {
+		_EXCEPTION2("Field size (%lu) does not match grid size (%lu)",
+			sCount, static_cast<size_t>(m_ulGridSize));
+	}
+	_ASSERT(dData != NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::CheckImage(
+	const PNGImage & img
+) const {
+	if ((img.width() != m_nWidth) || (img.height() != m_nHeight)) {
+		_EXCEPTION4("Image size (%u x %u) does not match rasterizer (%u x %u)",
+			img.width(), img.height(), m_nWidth, m_nHeight);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::Gather(
+	const float * dData,
+	size_t sCount,
+	float dFillValue,
+	float * dImage
+) const {
+	CheckField(dData, sCount);
+	_ASSERT(dImage != NULL);
+
+	const size_t sWidth = static_cast<size_t>(m_nWidth);
+
+#pragma omp parallel for schedule(static)
+	for (long lj = 0; lj < static_cast<long>(m_nHeight); lj++) {
+		const size_t sRow = static_cast<size_t>(lj) * sWidth;
+		const uint32_t * pNode = &(m_vecPixelNode[sRow]);
+		float * pImage = dImage + sRow;
+
+		for (size_t i = 0; i < sWidth; i++) {
+			const uint32_t ix = pNode[i];
+			pImage[i] = (ix == InvalidNode) ? dFillValue : dData[ix];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::Render(
+	const float * dData,
+	size_t sCount,
+	const ColorMap & colormap,
+	float dMinValue,
+	float dMaxValue,
+	PNGImage & img
+) const {
+	CheckField(dData, sCount);
+	CheckImage(img);
+
+	if (colormap.size() == 0) {
+		_EXCEPTIONT("Empty colormap");
+	}
+
+	const size_t sWidth = static_cast<size_t>(m_nWidth);
+
+#pragma omp parallel for schedule(static)
+	for (long lj = 0; lj < static_cast<long>(m_nHeight); lj++) {
+		const size_t sRow = static_cast<size_t>(lj) * sWidth;
+		const uint32_t * pNode = &(m_vecPixelNode[sRow]);
+		unsigned char * pPixel = &(img[4 * sRow]);
+
+		for (size_t i = 0; i < sWidth; i++) {
+			const uint32_t ix = pNode[i];
+			if (ix == InvalidNode) {
+				continue;
+			}
+
+			// NaN values are treated as missing
+			const float dValue = dData[ix];
+			if (dValue != dValue) {
+				continue;
+			}
+
+			colormap.Sample(
+				dValue, dMinValue, dMaxValue,
+				pPixel[4*i+0], pPixel[4*i+1], pPixel[4*i+2]);
+			pPixel[4*i+3] = 255;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GridRasterizer::Render(
+	const float * dData,
+	size_t sCount,
+	const ColorMapLUT & lut,
+	PNGImage & img
+) const {
+	CheckField(dData, sCount);
+	CheckImage(img);
+
+	const size_t sWidth = static_cast<size_t>(m_nWidth);
+
+#pragma omp parallel
+	{
+		// Gather each row with NaN for missing pixels and color it in
+		// a single pass
+		std::vector<float> dRow(sWidth);
+
+#pragma omp for schedule(static)
+		for (long lj = 0; lj < static_cast<long>(m_nHeight); lj++) {
+			const size_t sRow = static_cast<size_t>(lj) * sWidth;
+			const uint32_t * pNode = &(m_vecPixelNode[sRow]);
+
+			for (size_t i = 0; i < sWidth; i++) {
+				const uint32_t ix = pNode[i];
+				dRow[i] = (ix == InvalidNode) ? NAN : dData[ix];
+			}
+
+			lut.SampleArray(&(dRow[0]), sWidth, &(img[4 * sRow]));
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
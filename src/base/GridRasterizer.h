@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GridRasterizer.h
+///	\author  Paul Ullrich
+///	\version October 18, 2026
+///
+///	<remarks>
+///		Copyright 2026 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _GRIDRASTERIZER_H_
+#define _GRIDRASTERIZER_H_
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+class SimpleGrid;
+class ColorMap;
+class ColorMapLUT;
+class PNGImage;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A rasterizer for fields on a SimpleGrid.  The nearest grid node to
+///		the center of each pixel of an equirectangular (longitude-latitude)
+///		image is computed once and stored in a pixel-to-node map, which can
+///		be cached to disk.  Each field is then rendered as a simple gather
+///		through the map.
+///	</summary>
+class GridRasterizer {
+
+public:
+	///	<summary>
+	///		Map entry for pixels that are not associated with any node.
+	///	</summary>
+	static const uint32_t InvalidNode = 0xFFFFFFFFu;
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	GridRasterizer();
+
+	///	<summary>
+	///		Initialize the pixel-to-node map for an image of the given size
+	///		spanning the given longitude and latitude range (in degrees).
+	///		Rows are ordered from dLatEnd (top) to dLatBegin (bottom).  If
+	///		dMaxDistDeg is positive, pixels whose nearest node is further
+	///		than dMaxDistDeg (great circle distance in degrees) are not
+	///		associated with any node.  If strCacheDir is not empty the map is
+	///		read from the cache directory if available, and otherwise written
+	///		to the cache directory after it is computed (a warning is issued
+	///		if it cannot be written).  The grid must have a spatial index.
+	///	</summary>
+	void Initialize(
+		const SimpleGrid & grid,
+		unsigned int nWidth,
+		unsigned int nHeight,
+		double dLonBegin,
+		double dLonEnd,
+		double dLatBegin,
+		double dLatEnd,
+		double dMaxDistDeg = 0.0,
+		const std::string & strCacheDir = ""
+	);
+
+	///	<summary>
+	///		Name of the cache file for the current map parameters.
+	///	</summary>
+	std::string CacheFilename() const;
+
+	///	<summary>
+	///		Read the pixel-to-node map from the given cache file.  Returns
+	///		false if the file does not exist or was generated with different
+	///		parameters, in which case the map is unchanged.
+	///	</summary>
+	bool ReadCache(
+		const std::string & strFilename
+	);
+
+	///	<summary>
+	///		Write the pixel-to-node map to the given cache file.  The file is
+	///		written under a unique temporary name in the same directory and
+	///		renamed, so that concurrent readers never observe a partial file
+	///		and concurrent writers do not interfere.
+	///	</summary>
+	void WriteCache(
+		const std::string & strFilename
+	) const;
+
+	///	<summary>
+	///		Gather a field of sCount values on the grid into an image-sized
+	///		array in row-major order.  Pixels not associated with any node
+	///		are set to dFillValue.
+	///	</summary>
+	void Gather(
+		const float * dData,
+		size_t sCount,
+		float dFillValue,
+		float * dImage
+	) const;
+
+	///	<summary>
+	///		Render a field of sCount values on the grid into the image using
+	///		the given colormap and range.  Pixels not associated with any
+	///		node are left unchanged.  The image must have the same size as
+	///		the map.
+	///	</summary>
+	void Render(
+		const float * dData,
+		size_t sCount,
+		const ColorMap & colormap,
+		float dMinValue,
+		float dMaxValue,
+		PNGImage & img
+	) const;
+
+	///	<summary>
+	///		Render a field of sCount values on the grid into the image using
+	///		a compiled colormap.  NaN values, fill values and pixels not
+	///		associated with any node are set to the fill color of the
+	///		colormap.  The image must have the same size as the map.
+	///	</summary>
+	void Render(
+		const float * dData,
+		size_t sCount,
+		const ColorMapLUT & lut,
+		PNGImage & img
+	) const;
+
+	///	<summary>
+	///		Get the image width.
+	///	</summary>
+	unsigned int width() const {
+		return m_nWidth;
+	}
+
+	///	<summary>
+	///		Get the image height.
+	///	</summary>
+	unsigned int height() const {
+		return m_nHeight;
+	}
+
+	///	<summary>
+	///		Get the pixel-to-node map in row-major order.
+	///	</summary>
+	const std::vector<uint32_t> & GetPixelNodes() const {
+		return m_vecPixelNode;
+	}
+
+protected:
+	///	<summary>
+	///		Compute the pixel-to-node map from the grid.
+	///	</summary>
+	void Build(
+		const SimpleGrid & grid
+	);
+
+	///	<summary>
+	///		Verify that a field is compatible with the map.
+	///	</summary>
+	void CheckField(
+		const float * dData,
+		size_t sCount
+	) const;
+
+	///	<summary>
+	///		Verify that an image is compatible with the map.
+	///	</summary>
+	void CheckImage(
+		const PNGImage & img
+	) const;
+
+private:
+	///	<summary>
+	///		Image width.
+	///	</summary>
+	unsigned int m_nWidth;
+
+	///	<summary>
+	///		Image height.
+	///	</summary>
+	unsigned int m_nHeight;
+
+	///	<summary>
+	///		Longitude of the left edge of the image (in degrees).
+	///	</summary>
+	double m_dLonBegin;
+
+	///	<summary>
+	///		Longitude of the right edge of the image (in degrees).
+	///	</summary>
+	double m_dLonEnd;
+
+	///	<summary>
+	///		Latitude of the bottom edge of the image (in degrees).
+	///	</summary>
+	double m_dLatBegin;
+
+	///	<summary>
+	///		Latitude of the top edge of the image (in degrees).
+	///	</summary>
+	double m_dLatEnd;
+
+	///	<summary>
+	///		Maximum distance from a pixel center to its node (in degrees),
+	///		or zero if there is no maximum.
+	///	</summary>
+	double m_dMaxDistDeg;
+
+	///	<summary>
+	///		Fingerprint of the grid used to generate the map.
+	///	</summary>
+	uint64_t m_ulGridFingerprint;
+
+	///	<summary>
+	///		Number of nodes in the grid used to generate the map.
+	///	</summary>
+	uint64_t m_ulGridSize;
+
+	///	<summary>
+	///		Node index associated with each pixel, in row-major order.
+	///	</summary>
+	std::vector<uint32_t> m_vecPixelNode;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _GRIDRASTERIZER_H_
+
@@ -30,9 +30,24 @@ void MeshUtilities::FindFaceFromNode(
 	aFindFaceStruct.vecFaceLocations.clear();
 	aFindFaceStruct.loc = Face::NodeLocation_Undefined;
 
-	// Loop through all faces to find overlaps
-	// Note: This algorithm can likely be dramatically improved
-	for (int l = 0; l < mesh.faces.size(); l++) {
+	// Candidate faces from the FaceCapTree, if it has been constructed,
+	// in increasing order so results match the search over all faces
+	std::vector<int> vecCandidateFaces;
+
+	bool fUseFaceTree =
+		(mesh.facetree.size() != 0) &&
+		(mesh.facetree.size() == mesh.faces.size());
+
+	int nCandidateFaces = static_cast<int>(mesh.faces.size());
+	if (fUseFaceTree) {
+		mesh.facetree.FindCandidateFaces(node, vecCandidateFaces);
+		nCandidateFaces = static_cast<int>(vecCandidateFaces.size());
+	}
+
+	// Loop through candidate faces to find overlaps
+	for (int c = 0; c < nCandidateFaces; c++) {
+		const int l = (fUseFaceTree)?(vecCandidateFaces[c]):(c);
+
 		Face::NodeLocation loc;
 		int ixLocation;
 
@@ -109,7 +124,7 @@ void MeshUtilities::FindFaceFromNode(
 		if (aFindFaceStruct.vecFaceIndices.size() != 2) {
 			printf("n: %1.5e %1.5e %1.5e\n", node.x, node.y, node.z);
 			_EXCEPTION2("Node found on edge with %i neighboring face(s) (%i)",
-				aFindFaceStruct.vecFaceIndices.size(),
+				(int)(aFindFaceStruct.vecFaceIndices.size()),
 				(int)(aFindFaceStruct.vecFaceIndices.size()));
 		}
 	}
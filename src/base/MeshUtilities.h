@@ -37,7 +37,8 @@ public:
 	) const = 0;
 
 	///	<summary>
-	///		Find all Face indices that contain this Node.
+	///		Find all Face indices that contain this Node.  If the FaceCapTree
+	///		of the mesh has been constructed only nearby Faces are tested.
 	///	</summary>
 	void FindFaceFromNode(
 		const Mesh & mesh,
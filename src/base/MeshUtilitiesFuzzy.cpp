@@ -18,6 +18,9 @@
 
 #include "Exception.h"
 
+#include <algorithm>
+#include <cmath>
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool MeshUtilitiesFuzzy::AreNodesEqual(
@@ -1082,7 +1085,7 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 	const Node & nodeBegin = mesh.nodes[ixNode];
 
 	// Get the set of faces adjacent this node
-	const std::set<int> & setNearbyFaces = mesh.revnodearray[ixNode];
+	ReverseNodeArray::FaceIndexRange setNearbyFaces = mesh.revnodearray[ixNode];
 
 	if (setNearbyFaces.size() < 3) {
 		_EXCEPTIONT("Insufficient Faces at Corner; at least three Faces expected");
@@ -1103,7 +1106,7 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 		- ScalarProduct(dDotNeNb, nodeBegin);
 */
 	// Loop through all faces
-	std::set<int>::const_iterator iter = setNearbyFaces.begin();
+	ReverseNodeArray::FaceIndexRange::const_iterator iter = setNearbyFaces.begin();
 	for (; iter != setNearbyFaces.end(); iter++) {
 
 		const Face & face = mesh.faces[*iter];
@@ -1642,3 +1645,218 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+int MeshUtilitiesFuzzy::WalkToFaceContainingNode(
+	const Mesh & mesh,
+	const Node & node,
+	int ixFace,
+	int nMaxSteps,
+	bool & fOnBoundary
+) const {
+	int ixPrevFace = InvalidFace;
+
+	for (int iStep = 0; iStep < nMaxSteps; iStep++) {
+		const Face & face = mesh.faces[ixFace];
+		const int nEdges = static_cast<int>(face.edges.size());
+
+		fOnBoundary = false;
+
+		// Find an edge with the Node on its exterior, preferring edges
+		// that do not lead back to the previous Face
+		int ixNextFace = InvalidFace;
+		bool fExterior = false;
+
+		for (int k = 0; k < nEdges; k++) {
+			const Edge & edge = face.edges[k];
+
+			int iNodeEdgeSide =
+				FindNodeEdgeSide(
+					mesh.nodes[edge[0]],
+					mesh.nodes[edge[1]],
+					edge.type,
+					node);
+
+			if (iNodeEdgeSide == 0) {
+				fOnBoundary = true;
+			}
+			if (iNodeEdgeSide != (-1)) {
+				continue;
+			}
+
+			fExterior = true;
+
+			EdgeMap::const_iterator iter = mesh.edgemap.find(edge);
+			if (iter == mesh.edgemap.end()) {
+				continue;
+			}
+
+			int ixAdjFace =
+				(iter->second[0] == ixFace)?(iter->second[1]):(iter->second[0]);
+
+			if (ixAdjFace == InvalidFace) {
+				continue;
+			}
+			if ((ixNextFace == InvalidFace) || (ixNextFace == ixPrevFace)) {
+				ixNextFace = ixAdjFace;
+			}
+			if (ixNextFace != ixPrevFace) {
+				break;
+			}
+		}
+
+		// Face contains the Node
+		if (!fExterior) {
+			return ixFace;
+		}
+
+		// Walked off the boundary of the mesh
+		if (ixNextFace == InvalidFace) {
+			return InvalidFace;
+		}
+
+		ixPrevFace = ixFace;
+		ixFace = ixNextFace;
+	}
+
+	return InvalidFace;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int MeshUtilitiesFuzzy::FindLowestFaceContainingNode(
+	const Mesh & mesh,
+	const Node & node,
+	std::vector<int> & vecCandidateFaces
+) const {
+	bool fUseFaceTree =
+		(mesh.facetree.size() != 0) &&
+		(mesh.facetree.size() == mesh.faces.size());
+
+	int nCandidateFaces = static_cast<int>(mesh.faces.size());
+	if (fUseFaceTree) {
+		mesh.facetree.FindCandidateFaces(node, vecCandidateFaces);
+		nCandidateFaces = static_cast<int>(vecCandidateFaces.size());
+	}
+
+	for (int c = 0; c < nCandidateFaces; c++) {
+		const int l = (fUseFaceTree)?(vecCandidateFaces[c]):(c);
+		const Face & face = mesh.faces[l];
+
+		bool fExterior = false;
+		for (size_t k = 0; k < face.edges.size(); k++) {
+			const Edge & edge = face.edges[k];
+
+			int iNodeEdgeSide =
+				FindNodeEdgeSide(
+					mesh.nodes[edge[0]],
+					mesh.nodes[edge[1]],
+					edge.type,
+					node);
+
+			if (iNodeEdgeSide == (-1)) {
+				fExterior = true;
+				break;
+			}
+		}
+
+		if (!fExterior) {
+			return l;
+		}
+	}
+
+	return InvalidFace;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshUtilitiesFuzzy::FindFacesFromNodes(
+	const Mesh & mesh,
+	const NodeVector & nodesQuery,
+	std::vector<int> & vecFaceIndices,
+	int nChunkSize
+) const {
+	if (nChunkSize < 1) {
+		_EXCEPTION1("Invalid chunk size (%i)", nChunkSize);
+	}
+
+	vecFaceIndices.resize(nodesQuery.size());
+
+	if (nodesQuery.size() == 0) {
+		return;
+	}
+	if (mesh.faces.size() == 0) {
+		std::fill(vecFaceIndices.begin(), vecFaceIndices.end(), InvalidFace);
+		return;
+	}
+
+	// Walks longer than this are unlikely to succeed; use the global search
+	const bool fWalk = (mesh.edgemap.size() != 0);
+	const int nMaxSteps =
+		static_cast<int>(4.0 * sqrt(static_cast<double>(mesh.faces.size()))) + 16;
+
+	const long lQueries = static_cast<long>(nodesQuery.size());
+	const long lChunks = (lQueries + nChunkSize - 1) / nChunkSize;
+
+	// Exceptions cannot propagate out of the parallel region; record the
+	// exception from the earliest chunk and rethrow it afterwards
+	long lErrorChunk = lChunks;
+	Exception excError(__FILE__, __LINE__);
+
+#pragma omp parallel for schedule(dynamic, 1)
+	for (long lc = 0; lc < lChunks; lc++) {
+		const long lBegin = lc * nChunkSize;
+		const long lEnd = std::min(lBegin + nChunkSize, lQueries);
+
+		std::vector<int> vecCandidateFaces;
+
+		try {
+			int ixPrevFace = InvalidFace;
+
+			for (long l = lBegin; l < lEnd; l++) {
+				const Node & node = nodesQuery[l];
+
+				int ixFace = InvalidFace;
+
+				if (fWalk && (ixPrevFace != InvalidFace)) {
+					bool fOnBoundary = false;
+					ixFace =
+						WalkToFaceContainingNode(
+							mesh, node, ixPrevFace, nMaxSteps, fOnBoundary);
+
+					// Nodes on edges and corners are shared by several
+					// Faces; use the global search for the lowest index
+					if (fOnBoundary) {
+						ixFace = InvalidFace;
+					}
+				}
+
+				if (ixFace == InvalidFace) {
+					ixFace =
+						FindLowestFaceContainingNode(
+							mesh, node, vecCandidateFaces);
+				}
+
+				vecFaceIndices[l] = ixFace;
+
+				if (ixFace != InvalidFace) {
+					ixPrevFace = ixFace;
+				}
+			}
+
+		} catch(Exception & e) {
+#pragma omp critical
+			{
+				if (lc < lErrorChunk) {
+					lErrorChunk = lc;
+					excError = e;
+				}
+			}
+		}
+	}
+
+	if (lErrorChunk != lChunks) {
+		throw excError;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -139,6 +139,49 @@ public:
 		const Edge::Type edgetype,
 		const FindFaceStruct & aFindFaceStruct
 	);
+
+	///	<summary>
+	///		Locate a stream of Nodes on the mesh.  For each Node the lowest
+	///		index Face containing the Node is stored in vecFaceIndices, or
+	///		InvalidFace if no Face contains it.  The stream is processed in
+	///		chunks of nChunkSize Nodes in parallel.  Within each chunk the
+	///		search walks across the EdgeMap starting from the Face of the
+	///		previous Node, which is efficient for spatially coherent streams,
+	///		and falls back to the FaceCapTree (or all Faces if it has not
+	///		been constructed) when the walk fails.
+	///	</summary>
+	void FindFacesFromNodes(
+		const Mesh & mesh,
+		const NodeVector & nodesQuery,
+		std::vector<int> & vecFaceIndices,
+		int nChunkSize = 1024
+	) const;
+
+protected:
+	///	<summary>
+	///		Walk across the EdgeMap from ixFace towards the Face containing
+	///		node, taking at most nMaxSteps steps.  Returns InvalidFace if the
+	///		walk fails.  fOnBoundary is set if the Node lies on an edge or
+	///		corner of the returned Face.
+	///	</summary>
+	int WalkToFaceContainingNode(
+		const Mesh & mesh,
+		const Node & node,
+		int ixFace,
+		int nMaxSteps,
+		bool & fOnBoundary
+	) const;
+
+	///	<summary>
+	///		Find the lowest index Face containing node, using the FaceCapTree
+	///		if it has been constructed.  Returns InvalidFace if no Face
+	///		contains the Node.
+	///	</summary>
+	int FindLowestFaceContainingNode(
+		const Mesh & mesh,
+		const Node & node,
+		std::vector<int> & vecCandidateFaces
+	) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -17,7 +17,257 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
 
+///////////////////////////////////////////////////////////////////////////////
+// PNGEncoderSettings
+///////////////////////////////////////////////////////////////////////////////
+
+PNGEncoderSettings PNGEncoderSettings::Fast() {
+	PNGEncoderSettings settings;
+	settings.m_eFilterStrategy = PNGFilterStrategy_Up;
+	settings.m_nCompressionLevel = 1;
+	return settings;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PNGEncoderSettings::GetCompressSettings(
+	LodePNGCompressSettings & settings
+) const {
+	if ((m_nCompressionLevel < 0) || (m_nCompressionLevel > 9)) {
+		_EXCEPTION1("Invalid PNG compression level (%i)", m_nCompressionLevel);
+	}
+
+	// Window size, nice match length and lazy matching for each level
+	static const unsigned WindowSize[10] =
+		{0, 256, 512, 1024, 2048, 4096, 4096, 8192, 16384, 32768};
+	static const unsigned NiceMatch[10] =
+		{0, 16, 32, 64, 128, 128, 258, 258, 258, 258};
+	static const unsigned LazyMatching[10] =
+		{0, 0, 0, 0, 1, 1, 1, 1, 1, 1};
+
+	lodepng_compress_settings_init(&settings);
+
+	if (m_nCompressionLevel == 0) {
+		settings.btype = 0;
+		return;
+	}
+
+	settings.windowsize = WindowSize[m_nCompressionLevel];
+	settings.nicematch = NiceMatch[m_nCompressionLevel];
+	settings.lazymatching = LazyMatching[m_nCompressionLevel];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PNG encoding utilities
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Paeth predictor from the PNG specification.
+///	</summary>
+static inline unsigned char PNGPaethPredictor(
+	int a,
+	int b,
+	int c
+) {
+	int pa = abs(b - c);
+	int pb = abs(a - c);
+	int pc = abs(a + b - 2 * c);
+
+	if ((pa <= pb) && (pa <= pc)) {
+		return static_cast<unsigned char>(a);
+	} else if (pb <= pc) {
+		return static_cast<unsigned char>(b);
+	}
+	return static_cast<unsigned char>(c);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Apply PNG filter type nFilterType (0 to 4) to a scanline of sBytes
+///		bytes with sBpp bytes per pixel.  The filter type followed by the
+///		filtered bytes is written to cOut.  cPrev is the previous scanline,
+///		or NULL for the first scanline.
+///	</summary>
+static void PNGFilterScanline(
+	int nFilterType,
+	const unsigned char * cCur,
+	const unsigned char * cPrev,
+	size_t sBytes,
+	size_t sBpp,
+	unsigned char * cOut
+) {
+	cOut[0] = static_cast<unsigned char>(nFilterType);
+	cOut++;
+
+	// The scanline above the first scanline is all zero
+	if (cPrev == NULL) {
+		if (nFilterType == 2) {
+			nFilterType = 0;
+		} else if (nFilterType == 3) {
+			for (size_t i = 0; i < sBpp; i++) {
+				cOut[i] = cCur[i];
+			}
+			for (size_t i = sBpp; i < sBytes; i++) {
+				cOut[i] = static_cast<unsigned char>(cCur[i] - (cCur[i-sBpp] >> 1));
+			}
+			return;
+		} else if (nFilterType == 4) {
+			nFilterType = 1;
+		}
+	}
+
+	switch (nFilterType) {
+	case 0:
+		memcpy(cOut, cCur, sBytes);
+		break;
+
+	case 1:
+		for (size_t i = 0; i < sBpp; i++) {
+			cOut[i] = cCur[i];
+		}
+		for (size_t i = sBpp; i < sBytes; i++) {
+			cOut[i] = static_cast<unsigned char>(cCur[i] - cCur[i-sBpp]);
+		}
+		break;
+
+	case 2:
+		for (size_t i = 0; i < sBytes; i++) {
+			cOut[i] = static_cast<unsigned char>(cCur[i] - cPrev[i]);
+		}
+		break;
+
+	case 3:
+		for (size_t i = 0; i < sBpp; i++) {
+			cOut[i] = static_cast<unsigned char>(cCur[i] - (cPrev[i] >> 1));
+		}
+		for (size_t i = sBpp; i < sBytes; i++) {
+			cOut[i] = static_cast<unsigned char>(
+				cCur[i] - ((cCur[i-sBpp] + cPrev[i]) >> 1));
+		}
+		break;
+
+	case 4:
+		for (size_t i = 0; i < sBpp; i++) {
+			cOut[i] = static_cast<unsigned char>(cCur[i] - cPrev[i]);
+		}
+		for (size_t i = sBpp; i < sBytes; i++) {
+			cOut[i] = static_cast<unsigned char>(cCur[i] -
+				PNGPaethPredictor(cCur[i-sBpp], cPrev[i], cPrev[i-sBpp]));
+		}
+		break;
+
+	default:
+		_EXCEPTION1("Invalid PNG filter type (%i)", nFilterType);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sum of absolute values of filtered bytes interpreted as signed, as
+///		used by the minimum sum filter heuristic.
+///	</summary>
+static size_t PNGFilteredSum(
+	const unsigned char * cFiltered,
+	size_t sBytes
+) {
+	size_t sSum = 0;
+	for (size_t i = 0; i < sBytes; i++) {
+		sSum += (cFiltered[i] < 128) ? cFiltered[i] : (256 - cFiltered[i]);
+	}
+	return sSum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Adler-32 checksum of a buffer.
+///	</summary>
+static uint32_t PNGAdler32(
+	const unsigned char * cData,
+	size_t sBytes
+) {
+	static const uint32_t Base = 65521;
+
+	// Largest number of bytes before the sums must be reduced
+	static const size_t MaxBlock = 5552;
+
+	uint32_t s1 = 1;
+	uint32_t s2 = 0;
+	while (sBytes > 0) {
+		size_t sBlock = (sBytes < MaxBlock) ? sBytes : MaxBlock;
+		sBytes -= sBlock;
+		for (size_t i = 0; i < sBlock; i++) {
+			s1 += cData[i];
+			s2 += s1;
+		}
+		cData += sBlock;
+		s1 %= Base;
+		s2 %= Base;
+	}
+	return (s2 << 16) | s1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Adler-32 checksum of the concatenation of two buffers, given the
+///		checksum of each and the length of the second.
+///	</summary>
+static uint32_t PNGAdler32Combine(
+	uint32_t uAdler1,
+	uint32_t uAdler2,
+	size_t sBytes2
+) {
+	static const uint64_t Base = 65521;
+
+	const uint64_t ulRem = static_cast<uint64_t>(sBytes2 % Base);
+	uint64_t s1 = (uAdler1 & 0xFFFF);
+	uint64_t s2 = (ulRem * s1) % Base;
+
+	s1 = (s1 + (uAdler2 & 0xFFFF) + Base - 1) % Base;
+	s2 = (s2 + (uAdler1 >> 16) + (uAdler2 >> 16) + Base - ulRem) % Base;
+
+	return static_cast<uint32_t>((s2 << 16) | s1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append a 32-bit big endian integer to a buffer.
+///	</summary>
+static void PNGAppendUInt32(
+	std::vector<unsigned char> & vec,
+	uint32_t u
+) {
+	vec.push_back(static_cast<unsigned char>(u >> 24));
+	vec.push_back(static_cast<unsigned char>(u >> 16));
+	vec.push_back(static_cast<unsigned char>(u >> 8));
+	vec.push_back(static_cast<unsigned char>(u));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write a 32-bit big endian integer to a buffer.
+///	</summary>
+static void PNGWriteUInt32(
+	unsigned char * c,
+	uint32_t u
+) {
+	c[0] = static_cast<unsigned char>(u >> 24);
+	c[1] = static_cast<unsigned char>(u >> 16);
+	c[2] = static_cast<unsigned char>(u >> 8);
+	c[3] = static_cast<unsigned char>(u);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PNGImage
 ///////////////////////////////////////////////////////////////////////////////
 
 PNGImage::PNGImage(
@@ -59,6 +309,250 @@ bool PNGImage::write(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool PNGImage::write(
+	const std::string & strFilename,
+	const PNGEncoderSettings & settings
+) const {
+	std::vector<unsigned char> vecPNG;
+	encode(vecPNG, settings);
+
+	unsigned error =
+		lodepng_save_file(&(vecPNG[0]), vecPNG.size(), strFilename.c_str());
+	if (error) {
+		std::cout << "PNG encoder error (" << error << "): " << lodepng_error_text(error) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PNGImage::encode(
+	std::vector<unsigned char> & vecPNG,
+	const PNGEncoderSettings & settings
+) const {
+	if ((m_width == 0) || (m_height == 0)) {
+		_EXCEPTIONT("Cannot encode an empty PNGImage");
+	}
+	if (size() != 4 * static_cast<size_t>(m_width) * m_height) {
+		_EXCEPTIONT("PNGImage buffer size does not match its dimensions");
+	}
+	if (settings.m_nStripRows == 0) {
+		_EXCEPTIONT("PNG strip must contain at least one row");
+	}
+	if ((settings.m_eFilterStrategy < PNGFilterStrategy_None) ||
+	    (settings.m_eFilterStrategy > PNGFilterStrategy_MinSum)
+	) {
+		_EXCEPTION1("Invalid PNG filter strategy (%i)",
+			static_cast<int>(settings.m_eFilterStrategy));
+	}
+
+	LodePNGCompressSettings zlibsettings;
+	settings.GetCompressSettings(zlibsettings);
+
+	const size_t sPixels = static_cast<size_t>(m_width) * m_height;
+
+	// Drop the alpha channel if all pixels are opaque
+	bool fOpaque = true;
+
+#pragma omp parallel for schedule(static) reduction(&&:fOpaque)
+	for (long lp = 0; lp < static_cast<long>(sPixels); lp++) {
+		fOpaque = fOpaque && ((*this)[4 * lp + 3] == 255);
+	}
+
+	const size_t Bpp = fOpaque ? 3 : 4;
+
+	std::vector<unsigned char> vecRGB;
+	if (fOpaque) {
+		vecRGB.resize(3 * sPixels);
+
+#pragma omp parallel for schedule(static)
+		for (long lp = 0; lp < static_cast<long>(sPixels); lp++) {
+			vecRGB[3 * lp + 0] = (*this)[4 * lp + 0];
+			vecRGB[3 * lp + 1] = (*this)[4 * lp + 1];
+			vecRGB[3 * lp + 2] = (*this)[4 * lp + 2];
+		}
+	}
+
+	const size_t sRowBytes = Bpp * static_cast<size_t>(m_width);
+	const size_t sFilteredRowBytes = sRowBytes + 1;
+	const unsigned char * cImage = fOpaque ? &(vecRGB[0]) : &((*this)[0]);
+
+	// Filter all rows; each filtered row only depends on the unfiltered
+	// row above it
+	std::vector<unsigned char> vecFiltered(sFilteredRowBytes * m_height);
+
+	const PNGFilterStrategy eStrategy = settings.m_eFilterStrategy;
+
+#pragma omp parallel
+	{
+		std::vector<unsigned char> vecTrial;
+		if (eStrategy == PNGFilterStrategy_MinSum) {
+			vecTrial.resize(sFilteredRowBytes);
+		}
+
+#pragma omp for schedule(static)
+		for (long lj = 0; lj < static_cast<long>(m_height); lj++) {
+			const unsigned char * cCur = cImage + lj * sRowBytes;
+			const unsigned char * cPrev =
+				(lj == 0) ? NULL : (cImage + (lj - 1) * sRowBytes);
+			unsigned char * cOut = &(vecFiltered[lj * sFilteredRowBytes]);
+
+			if (eStrategy != PNGFilterStrategy_MinSum) {
+				PNGFilterScanline(
+					static_cast<int>(eStrategy),
+					cCur, cPrev, sRowBytes, Bpp, cOut);
+				continue;
+			}
+
+			// Choose the filter with minimum sum of absolute differences
+			size_t sBestSum = 0;
+			for (int f = 0; f < 5; f++) {
+				PNGFilterScanline(f, cCur, cPrev, sRowBytes, Bpp, &(vecTrial[0]));
+				size_t sSum = PNGFilteredSum(&(vecTrial[1]), sRowBytes);
+				if ((f == 0) || (sSum < sBestSum)) {
+					sBestSum = sSum;
+					memcpy(cOut, &(vecTrial[0]), sFilteredRowBytes);
+				}
+			}
+		}
+	}
+
+	// Compress strips concurrently; all but the last strip end with a
+	// sync flush so that the deflate streams can be concatenated
+	const size_t sStripRows = static_cast<size_t>(settings.m_nStripRows);
+	const size_t sStrips = (m_height + sStripRows - 1) / sStripRows;
+
+	std::vector<unsigned char *> vecStripData(sStrips, NULL);
+	std::vector<size_t> vecStripSize(sStrips, 0);
+	std::vector<unsigned> vecStripError(sStrips, 0);
+	std::vector<uint32_t> vecStripAdler(sStrips, 0);
+
+#pragma omp parallel for schedule(dynamic, 1)
+	for (long ls = 0; ls < static_cast<long>(sStrips); ls++) {
+		const size_t sBegin = ls * sStripRows * sFilteredRowBytes;
+		size_t sEnd = (ls + 1) * sStripRows * sFilteredRowBytes;
+		if (sEnd > vecFiltered.size()) {
+			sEnd = vecFiltered.size();
+		}
+
+		if (static_cast<size_t>(ls) == sStrips - 1) {
+			vecStripError[ls] = lodepng_deflate(
+				&(vecStripData[ls]), &(vecStripSize[ls]),
+				&(vecFiltered[sBegin]), sEnd - sBegin, &zlibsettings);
+		} else {
+			vecStripError[ls] = lodepng_deflate_sync(
+				&(vecStripData[ls]), &(vecStripSize[ls]),
+				&(vecFiltered[sBegin]), sEnd - sBegin, &zlibsettings);
+		}
+
+		vecStripAdler[ls] = PNGAdler32(&(vecFiltered[sBegin]), sEnd - sBegin);
+	}
+
+	unsigned error = 0;
+	bool fChunkTooLarge = false;
+	for (size_t s = 0; s < sStrips; s++) {
+		if (error == 0) {
+			error = vecStripError[s];
+		}
+		if (vecStripSize[s] > 0x7FFFFFF0u) {
+			fChunkTooLarge = true;
+		}
+	}
+	if (error || fChunkTooLarge) {
+		for (size_t s = 0; s < sStrips; s++) {
+			free(vecStripData[s]);
+		}
+		if (error) {
+			_EXCEPTION2("PNG encoder error %i: %s",
+				error, lodepng_error_text(error));
+		}
+		_EXCEPTIONT("PNG strip too large for a single IDAT chunk");
+	}
+
+	// Adler-32 checksum of the uncompressed data
+	uint32_t uAdler = vecStripAdler[0];
+	for (size_t s = 1; s < sStrips; s++) {
+		size_t sBytes = sStripRows * sFilteredRowBytes;
+		if (s == sStrips - 1) {
+			sBytes = vecFiltered.size() - s * sStripRows * sFilteredRowBytes;
+		}
+		uAdler = PNGAdler32Combine(uAdler, vecStripAdler[s], sBytes);
+	}
+
+	// Zlib header with the compression level hint
+	unsigned char cZlibFlags = 0x9C;
+	if (settings.m_nCompressionLevel <= 1) {
+		cZlibFlags = 0x01;
+	} else if (settings.m_nCompressionLevel >= 7) {
+		cZlibFlags = 0xDA;
+	}
+
+	// Assemble the PNG signature, header and one IDAT chunk per strip
+	static const unsigned char Signature[8] =
+		{137, 80, 78, 71, 13, 10, 26, 10};
+
+	vecPNG.assign(Signature, Signature + 8);
+
+	PNGAppendUInt32(vecPNG, 13);
+	vecPNG.insert(vecPNG.end(), "IHDR", "IHDR" + 4);
+	PNGAppendUInt32(vecPNG, m_width);
+	PNGAppendUInt32(vecPNG, m_height);
+	vecPNG.push_back(8);
+	vecPNG.push_back(fOpaque ? 2 : 6);
+	vecPNG.push_back(0);
+	vecPNG.push_back(0);
+	vecPNG.push_back(0);
+	PNGAppendUInt32(vecPNG, lodepng_crc32(&(vecPNG[12]), 17));
+
+	std::vector<size_t> vecChunkBegin(sStrips);
+	for (size_t s = 0; s < sStrips; s++) {
+		size_t sLength = vecStripSize[s];
+		if (s == 0) {
+			sLength += 2;
+		}
+		if (s == sStrips - 1) {
+			sLength += 4;
+		}
+
+		vecChunkBegin[s] = vecPNG.size();
+		PNGAppendUInt32(vecPNG, static_cast<uint32_t>(sLength));
+		vecPNG.insert(vecPNG.end(), "IDAT", "IDAT" + 4);
+		if (s == 0) {
+			vecPNG.push_back(0x78);
+			vecPNG.push_back(cZlibFlags);
+		}
+		vecPNG.insert(vecPNG.end(),
+			vecStripData[s], vecStripData[s] + vecStripSize[s]);
+		if (s == sStrips - 1) {
+			PNGAppendUInt32(vecPNG, uAdler);
+		}
+		PNGAppendUInt32(vecPNG, 0);
+
+		free(vecStripData[s]);
+	}
+
+	PNGAppendUInt32(vecPNG, 0);
+	vecPNG.insert(vecPNG.end(), "IEND", "IEND" + 4);
+	PNGAppendUInt32(vecPNG, lodepng_crc32(&(vecPNG[vecPNG.size()-4]), 4));
+
+	// Checksum the IDAT chunks concurrently
+#pragma omp parallel for schedule(dynamic, 1)
+	for (long ls = 0; ls < static_cast<long>(sStrips); ls++) {
+		unsigned char * cChunk = &(vecPNG[vecChunkBegin[ls]]);
+		const size_t sLength =
+			(static_cast<size_t>(cChunk[0]) << 24)
+			| (static_cast<size_t>(cChunk[1]) << 16)
+			| (static_cast<size_t>(cChunk[2]) << 8)
+			| static_cast<size_t>(cChunk[3]);
+
+		PNGWriteUInt32(cChunk + 8 + sLength,
+			lodepng_crc32(cChunk + 4, sLength + 4));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void PNGImage::from_subset(
 	const PNGImage & img,
 	int x1,
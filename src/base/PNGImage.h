@@ -25,6 +25,82 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Strategies for choosing the filter applied to each row of a PNG.
+///	</summary>
+enum PNGFilterStrategy {
+	PNGFilterStrategy_None,
+	PNGFilterStrategy_Sub,
+	PNGFilterStrategy_Up,
+	PNGFilterStrategy_Average,
+	PNGFilterStrategy_Paeth,
+	PNGFilterStrategy_MinSum
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Settings for encoding a PNGImage.
+///	</summary>
+class PNGEncoderSettings {
+
+public:
+	///	<summary>
+	///		Default compression level, equivalent to the default LodePNG
+	///		compression settings.
+	///	</summary>
+	static const int DefaultCompressionLevel = 4;
+
+	///	<summary>
+	///		Default number of rows per independently compressed strip.
+	///	</summary>
+	static const unsigned int DefaultStripRows = 64;
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	PNGEncoderSettings() :
+		m_eFilterStrategy(PNGFilterStrategy_MinSum),
+		m_nCompressionLevel(DefaultCompressionLevel),
+		m_nStripRows(DefaultStripRows)
+	{ }
+
+	///	<summary>
+	///		Settings favoring encoding speed over file size.
+	///	</summary>
+	static PNGEncoderSettings Fast();
+
+	///	<summary>
+	///		Get the deflate settings for the compression level.  Level 0
+	///		stores data uncompressed, level 1 is fastest and level 9 gives
+	///		the smallest files.
+	///	</summary>
+	void GetCompressSettings(
+		LodePNGCompressSettings & settings
+	) const;
+
+public:
+	///	<summary>
+	///		Row filter strategy.
+	///	</summary>
+	PNGFilterStrategy m_eFilterStrategy;
+
+	///	<summary>
+	///		Compression level (0 to 9).
+	///	</summary>
+	int m_nCompressionLevel;
+
+	///	<summary>
+	///		Number of rows in each strip.  Strips are filtered and compressed
+	///		concurrently, so the output does not depend on the number of
+	///		threads.
+	///	</summary>
+	unsigned int m_nStripRows;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 class PNGImage : public std::vector<unsigned char> {
 public:
 	///	<summary>
@@ -57,6 +133,25 @@ public:
 		const std::string & strFilename
 	);
 
+	///	<summary>
+	///		Write the PNG to a file with the given encoder settings.
+	///	</summary>
+	bool write(
+		const std::string & strFilename,
+		const PNGEncoderSettings & settings
+	) const;
+
+	///	<summary>
+	///		Encode the image as an 8-bit RGBA PNG, or 8-bit RGB if all
+	///		pixels are opaque.  Rows are filtered in parallel and horizontal
+	///		strips are compressed concurrently, with each strip stored in its
+	///		own IDAT chunk.
+	///	</summary>
+	void encode(
+		std::vector<unsigned char> & vecPNG,
+		const PNGEncoderSettings & settings
+	) const;
+
 	///	<summary>
 	///		Subset the PNG.
 	///	</summary>
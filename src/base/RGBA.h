@@ -18,6 +18,7 @@
 #define _RGBA_H_
 
 #include <cstdio>
+#include <stdint.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
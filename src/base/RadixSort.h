@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    RadixSort.h
+///	\author  Paul Ullrich
+///	\version October 18, 2026
+///
+///	<remarks>
+///		Copyright 2026 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _RADIXSORT_H_
+#define _RADIXSORT_H_
+
+#include "Exception.h"
+
+#include <vector>
+#include <stdint.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of bits needed to represent all values in [0, ulMax].
+///	</summary>
+inline int RadixSortBitCount(
+	uint64_t ulMax
+) {
+	int nBits = 0;
+	while ((nBits < 64) && ((ulMax >> nBits) != 0)) {
+		nBits++;
+	}
+	return nBits;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Stable least-significant-digit radix sort of 64-bit keys with
+///		associated 64-bit values.  Only the lowest nKeyBits of each key are
+///		used for sorting.  Each pass histograms and scatters a contiguous
+///		chunk of the input per thread, so the result is identical for any
+///		number of threads.
+///	</summary>
+inline void RadixSortKeyValue(
+	std::vector<uint64_t> & vecKeys,
+	std::vector<uint64_t> & vecValues,
+	int nKeyBits = 64
+) {
+	static const int DigitBits = 11;
+	static const size_t Buckets = static_cast<size_t>(1) << DigitBits;
+	static const uint64_t DigitMask = static_cast<uint64_t>(Buckets - 1);
+
+	if (vecKeys.size() != vecValues.size()) {
+		_EXCEPTIONT("Key and value arrays must have the same size");
+	}
+	if ((nKeyBits < 0) || (nKeyBits > 64)) {
+		_EXCEPTION1("Invalid number of key bits (%i)", nKeyBits);
+	}
+
+	const size_t sCount = vecKeys.size();
+	if (sCount < 2) {
+		return;
+	}
+
+	int nThreads = 1;
+#ifdef _OPENMP
+	nThreads = omp_get_max_threads();
+#endif
+
+	std::vector<uint64_t> vecKeysTemp(sCount);
+	std::vector<uint64_t> vecValuesTemp(sCount);
+
+	// Per-thread bucket histograms, converted in place into offsets
+	std::vector<size_t> vecHistogram(
+		static_cast<size_t>(nThreads) * Buckets);
+
+	for (int iShift = 0; iShift < nKeyBits; iShift += DigitBits) {
+
+#pragma omp parallel num_threads(nThreads)
+		{
+			int iThread = 0;
+			int nTeam = 1;
+#ifdef _OPENMP
+			iThread = omp_get_thread_num();
+			nTeam = omp_get_num_threads();
+#endif
+			const size_t sBegin = sCount * iThread / nTeam;
+			const size_t sEnd = sCount * (iThread + 1) / nTeam;
+
+			size_t * pHistogram = &(vecHistogram[iThread * Buckets]);
+			for (size_t b = 0; b < Buckets; b++) {
+				pHistogram[b] = 0;
+			}
+			for (size_t s = sBegin; s < sEnd; s++) {
+				pHistogram[(vecKeys[s] >> iShift) & DigitMask]++;
+			}
+
+#pragma omp barrier
+#pragma omp single
+			{
+				size_t sOffset = 0;
+				for (size_t b = 0; b < Buckets; b++) {
+				for (int t = 0; t < nTeam; t++) {
+					size_t sBucketCount = vecHistogram[t * Buckets + b];
+					vecHistogram[t * Buckets + b] = sOffset;
+					sOffset += sBucketCount;
+				}
+				}
+			}
+
+			for (size_t s = sBegin; s < sEnd; s++) {
+				size_t sDest = pHistogram[(vecKeys[s] >> iShift) & DigitMask]++;
+				vecKeysTemp[sDest] = vecKeys[s];
+				vecValuesTemp[sDest] = vecValues[s];
+			}
+		}
+
+		vecKeys.swap(vecKeysTemp);
+		vecValues.swap(vecValuesTemp);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -18,13 +18,23 @@
 #include "Exception.h"
 
 #include <cstring>
+#include <cmath>
+#include <algorithm>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 SchriftText::SchriftText(
 	const std::string & strFontFile,
-	double dFontSize
-) {
+	double dFontSize,
+	size_t sGlyphCacheCapacity
+) :
+	m_ulGlyphTick(0),
+	m_sGlyphCacheCapacity(sGlyphCacheCapacity)
+{
+	if (sGlyphCacheCapacity == 0) {
+		_EXCEPTIONT("Glyph cache capacity must be positive");
+	}
+
 	m_sft.xScale = dFontSize;
 	m_sft.yScale = dFontSize;
 	m_sft.xOffset = 0;
@@ -37,6 +47,150 @@ SchriftText::SchriftText(
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+SchriftText::~SchriftText() {
+	sft_freefont(m_sft.font);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SchriftText::SetGlyphCacheCapacity(
+	size_t sGlyphCacheCapacity
+) {
+	if (sGlyphCacheCapacity == 0) {
+		_EXCEPTIONT("Glyph cache capacity must be positive");
+	}
+
+	m_sGlyphCacheCapacity = sGlyphCacheCapacity;
+
+	EvictGlyphs(m_sGlyphCacheCapacity);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SchriftText::EvictGlyphs(
+	size_t sCount
+) {
+	while (m_mapGlyphs.size() > sCount) {
+		std::map<GlyphKey, std::pair<Glyph, uint64_t> >::iterator iterOldest =
+			m_mapGlyphs.begin();
+
+		std::map<GlyphKey, std::pair<Glyph, uint64_t> >::iterator iter =
+			m_mapGlyphs.begin();
+		for (; iter != m_mapGlyphs.end(); iter++) {
+			if (iter->second.second < iterOldest->second.second) {
+				iterOldest = iter;
+			}
+		}
+
+		m_mapGlyphs.erase(iterOldest);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const SchriftText::Glyph & SchriftText::GetGlyph(
+	SFT_UChar c
+) {
+	m_ulGlyphTick++;
+
+	GlyphKey key(c, m_sft.yScale);
+
+	std::map<GlyphKey, std::pair<Glyph, uint64_t> >::iterator iter =
+		m_mapGlyphs.find(key);
+	if (iter != m_mapGlyphs.end()) {
+		iter->second.second = m_ulGlyphTick;
+		return iter->second.first;
+	}
+
+	// Render the glyph
+	SFT_Glyph gid;
+	if (sft_lookup(&m_sft, c, &gid) < 0) {
+		_EXCEPTION1("schrift error: character \"%c\" missing", c);
+	}
+
+	SFT_GMetrics mtx;
+	if (sft_gmetrics(&m_sft, gid, &mtx) < 0) {
+		_EXCEPTION1("schrift error: character \"%c\" bad glyph metrics", c);
+	}
+
+	Glyph glyph;
+	glyph.dAdvanceWidth = mtx.advanceWidth;
+	glyph.nLeft = static_cast<int>(floor(mtx.leftSideBearing));
+	glyph.nYOffset = mtx.yOffset;
+	glyph.nMinWidth = mtx.minWidth;
+	glyph.nHeight = mtx.minHeight;
+	glyph.nStride = (mtx.minWidth + 3) & ~3;
+	glyph.vecCoverage.resize(
+		static_cast<size_t>(glyph.nStride) * glyph.nHeight, 0);
+
+	if (glyph.vecCoverage.size() != 0) {
+		SFT_Image img;
+		img.width = glyph.nStride;
+		img.height = glyph.nHeight;
+		img.pixels = &(glyph.vecCoverage[0]);
+		if (sft_render(&m_sft, gid, img) < 0) {
+			_EXCEPTION1("schrift error: character \"%c\" not rendered", c);
+		}
+	}
+
+	// Make room for the new glyph
+	EvictGlyphs(m_sGlyphCacheCapacity - 1);
+
+	std::pair<Glyph, uint64_t> & entry = m_mapGlyphs[key];
+	entry.first = glyph;
+	entry.second = m_ulGlyphTick;
+
+	return entry.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SchriftText::BlitGlyph(
+	const Glyph & glyph,
+	int nX,
+	int nY,
+	int nCanvasWidth,
+	int nCanvasHeight,
+	unsigned char * imagedata,
+	RGBA rgba
+) {
+	const int nLeft = nX + glyph.nLeft;
+	const int nTop = nY + glyph.nYOffset;
+
+	// Clip the glyph to the canvas
+	const int nIBegin = std::max(0, -nLeft);
+	const int nIEnd = std::min(glyph.nMinWidth, nCanvasWidth - nLeft);
+	const int nJBegin = std::max(0, -nTop);
+	const int nJEnd = std::min(glyph.nHeight, nCanvasHeight - nTop);
+
+	const unsigned int uR = rgba.r();
+	const unsigned int uG = rgba.g();
+	const unsigned int uB = rgba.b();
+
+	for (int j = nJBegin; j < nJEnd; j++) {
+		const unsigned char * pCoverage =
+			&(glyph.vecCoverage[static_cast<size_t>(j) * glyph.nStride]);
+
+		unsigned char * pPixel =
+			imagedata + NDIM * (static_cast<size_t>(nTop + j) * nCanvasWidth + nLeft);
+
+		for (int i = nIBegin; i < nIEnd; i++) {
+			const unsigned int uAlpha = pCoverage[i];
+			if (uAlpha == 0) {
+				continue;
+			}
+
+			const unsigned int uBeta = 255 - uAlpha;
+			unsigned char * p = pPixel + NDIM * i;
+			p[0] = static_cast<unsigned char>((uR * uAlpha + p[0] * uBeta + 127) / 255);
+			p[1] = static_cast<unsigned char>((uG * uAlpha + p[1] * uBeta + 127) / 255);
+			p[2] = static_cast<unsigned char>((uB * uAlpha + p[2] * uBeta + 127) / 255);
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void SchriftText::CalculateStringMinImageBufferSize(
@@ -50,31 +204,21 @@ void SchriftText::CalculateStringMinImageBufferSize(
 	nBaseline = 0;
 
 	for (int i = 0; i < str.length(); i++) {
-		SFT_Glyph gid;
-		if (sft_lookup(&m_sft, str[i], &gid) < 0) {
-			_EXCEPTION1("schrift error: character \"%c\" missing", str[i]);
-			return;
-		}
-
-		SFT_GMetrics mtx;
-		if (sft_gmetrics(&m_sft, gid, &mtx) < 0) {
-			_EXCEPTION1("schrift error: character \"%c\" bad glyph metrics", str[i]);
-			return;
-		}
+		const Glyph & glyph = GetGlyph(static_cast<unsigned char>(str[i]));
 
-		if (-mtx.yOffset > nBaseline) {
-			nBaseline = -mtx.yOffset;
+		if (-glyph.nYOffset > nBaseline) {
+			nBaseline = -glyph.nYOffset;
 		}
-		if (mtx.minHeight > nMinHeight) {
-			nMinHeight = mtx.minHeight;
+		if (glyph.nHeight > nMinHeight) {
+			nMinHeight = glyph.nHeight;
 		}
-		if (mtx.minHeight + nBaseline > nMinHeight) {
-			nMinHeight = mtx.minHeight + nBaseline;
+		if (glyph.nHeight + nBaseline > nMinHeight) {
+			nMinHeight = glyph.nHeight + nBaseline;
 		}
 		if (i != str.length()-1) {
-			nMinWidth += mtx.advanceWidth;
+			nMinWidth += glyph.dAdvanceWidth;
 		} else {
-			nMinWidth += mtx.minWidth;
+			nMinWidth += glyph.nMinWidth;
 		}
 	}
 }
@@ -92,55 +236,16 @@ void SchriftText::DrawCharacter(
 	int * pwidth,
 	int * pheight
 ) {
-	SFT_Glyph gid;
-	if (sft_lookup(&m_sft, c, &gid) < 0) {
-		_EXCEPTION1("schrift error: character \"%c\" missing", c);
-		return;
-	}
-
-	SFT_GMetrics mtx;
-	if (sft_gmetrics(&m_sft, gid, &mtx) < 0) {
-		_EXCEPTION1("schrift error: character \"%c\" bad glyph metrics", c);
-		return;
-	}
-
-	SFT_Image img;
-	img.width = (mtx.minWidth + 3) & ~3;
-	img.height = mtx.minHeight;
-	unsigned char * pixels = new unsigned char[img.width * img.height];
-	img.pixels = pixels;
-	if (sft_render(&m_sft, gid, img) < 0) {
-		_EXCEPTION1("schrift error: character \"%c\" not rendered", c);
-		return;
-	}
+	const Glyph & glyph = GetGlyph(c);
 
 	if (pwidth != NULL) {
-		(*pwidth) = mtx.advanceWidth;
+		(*pwidth) = static_cast<int>(glyph.dAdvanceWidth);
 	}
 	if (pheight != NULL) {
-		(*pheight) = mtx.minHeight;
+		(*pheight) = glyph.nHeight;
 	}
 
-	int s = 0;
-	for (int j = 0; j < img.height; j++) {
-		int jx = nY + static_cast<size_t>(j) + mtx.yOffset;
-		for (int i = 0; i < img.width; i++) {
-			int ix = nX + static_cast<size_t>(i) + mtx.leftSideBearing;
-			float dShadingFrac = static_cast<float>(255 - pixels[s]) / 255.0;
-
-			imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 0] =
-				rgba.r() * (1.0 - dShadingFrac) + imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 0] * dShadingFrac;
-			imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 1] =
-				rgba.g() * (1.0 - dShadingFrac) + imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 1] * dShadingFrac;
-			imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 2] =
-				rgba.b() * (1.0 - dShadingFrac) + imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 2] * dShadingFrac;
-			s++;
-		}
-	}
-
-	//_EXCEPTION();
-
-	delete[] pixels;
+	BlitGlyph(glyph, nX, nY, nCanvasWidth, nCanvasHeight, imagedata, rgba);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -184,7 +289,8 @@ void SchriftText::DrawString(
 			}
 		}
 
-	// Render right-aligned and center-aligned text using an image buffer
+	// Render right-aligned and center-aligned text by measuring the string
+	// and then drawing glyphs directly from the cache
 	} else if ((eAlign == TextAlignment_Right) || (eAlign == TextAlignment_Center)) {
 		int nMinBufferWidth;
 		int nMinBufferHeight;
@@ -204,57 +310,25 @@ void SchriftText::DrawString(
 
 		cumulative_height = nMinBufferHeight;
 
-		unsigned char * stringbuf = new unsigned char[NDIM * nMinBufferWidth * nMinBufferHeight];
-		memset(stringbuf, 255, NDIM * nMinBufferWidth * nMinBufferHeight * sizeof(unsigned char));
-
-		int nPenX = 0;
-
-		for (int i = 0; i < str.length(); i++) {
-			DrawCharacter(
-				str[i],
-				nPenX,
-				nBaseline,
-				nMinBufferWidth,
-				nMinBufferHeight,
-				stringbuf,
-				RGBA(0,0,0),
-				&width,
-				&height);
-
-			nPenX += width;
-			cumulative_width += width;
+		for (size_t i = 0; i < str.length(); i++) {
+			const Glyph & glyph = GetGlyph(static_cast<unsigned char>(str[i]));
+			cumulative_width += static_cast<int>(glyph.dAdvanceWidth);
 		}
 
-		int nPenBeginX = 0;
+		int nPenX = nX;
 		if (eAlign == TextAlignment_Right) {
-			nPenBeginX = nX - nPenX;
+			nPenX = nX - cumulative_width;
 		} else if (eAlign == TextAlignment_Center) {
-			nPenBeginX = nX - nPenX / 2;
+			nPenX = nX - cumulative_width / 2;
 		}
 
-		for (int i = 0; i < nMinBufferWidth; i++) {
-			int ix = nPenBeginX + i;
-			for (int j = 0; j < nMinBufferHeight; j++) {
-				int jx = nY - nBaseline + j;
-
-				if (nCanvasWidth * jx + ix >= nCanvasWidth * nCanvasHeight) {
-					continue;
-				}
-				if (j * nMinBufferWidth + i >= nMinBufferWidth * nMinBufferHeight) {
-					continue;
-				}
-				float dShadingFrac = static_cast<float>(stringbuf[NDIM * (j * nMinBufferWidth + i) + 0]) / 255.0; 
-
-				imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 0] =
-					rgba.r() * (1.0 - dShadingFrac) + imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 0] * dShadingFrac;
-				imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 1] =
-					rgba.g() * (1.0 - dShadingFrac) + imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 1] * dShadingFrac;
-				imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 2] =
-					rgba.b() * (1.0 - dShadingFrac) + imagedata[NDIM * nCanvasWidth * jx + NDIM * ix + 2] * dShadingFrac;
-			}
-		}
+		for (size_t i = 0; i < str.length(); i++) {
+			const Glyph & glyph = GetGlyph(static_cast<unsigned char>(str[i]));
 
-		delete[] stringbuf;
+			BlitGlyph(glyph, nPenX, nY, nCanvasWidth, nCanvasHeight, imagedata, rgba);
+
+			nPenX += static_cast<int>(glyph.dAdvanceWidth);
+		}
 	}
 
 	if (pwidth != NULL) {
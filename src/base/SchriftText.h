@@ -21,6 +21,10 @@
 #include "RGBA.h"
 
 #include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <stdint.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -32,6 +36,52 @@ public:
 	///	</summary>
 	static const int NDIM = 4;
 
+	///	<summary>
+	///		Default maximum number of glyphs in the glyph cache.
+	///	</summary>
+	static const size_t DefaultGlyphCacheCapacity = 256;
+
+public:
+	///	<summary>
+	///		A rendered glyph and its metrics.
+	///	</summary>
+	struct Glyph {
+		///	<summary>
+		///		Horizontal advance of the pen.
+		///	</summary>
+		double dAdvanceWidth;
+
+		///	<summary>
+		///		Horizontal offset of the bitmap from the pen, rounded down.
+		///	</summary>
+		int nLeft;
+
+		///	<summary>
+		///		Vertical offset of the bitmap from the baseline.
+		///	</summary>
+		int nYOffset;
+
+		///	<summary>
+		///		Minimum width of the glyph.
+		///	</summary>
+		int nMinWidth;
+
+		///	<summary>
+		///		Height of the bitmap.
+		///	</summary>
+		int nHeight;
+
+		///	<summary>
+		///		Width of each row of the bitmap.
+		///	</summary>
+		int nStride;
+
+		///	<summary>
+		///		Coverage of each pixel of the bitmap (0 to 255).
+		///	</summary>
+		std::vector<unsigned char> vecCoverage;
+	};
+
 public:
 	///	<summary>
 	///		Alignment of text.
@@ -48,9 +98,25 @@ public:
 	///	</summary>
 	SchriftText(
 		const std::string & strFontFile,
-		double dFontSize
+		double dFontSize,
+		size_t sGlyphCacheCapacity = DefaultGlyphCacheCapacity
 	);
 
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~SchriftText();
+
+	///	<summary>
+	///		Copy constructor (disabled since the font is owned).
+	///	</summary>
+	SchriftText(const SchriftText &) = delete;
+
+	///	<summary>
+	///		Copy assignment (disabled).
+	///	</summary>
+	SchriftText & operator=(const SchriftText &) = delete;
+
 public:
 	///	<summary>
 	///		Get the font height.
@@ -59,6 +125,41 @@ public:
 		return m_sft.yScale;
 	}
 
+	///	<summary>
+	///		Set the font size.  Glyphs rendered at other sizes remain in the
+	///		glyph cache.
+	///	</summary>
+	void SetFontSize(
+		double dFontSize
+	) {
+		m_sft.xScale = dFontSize;
+		m_sft.yScale = dFontSize;
+	}
+
+	///	<summary>
+	///		Set the maximum number of glyphs in the glyph cache, evicting the
+	///		least recently used glyphs if necessary.
+	///	</summary>
+	void SetGlyphCacheCapacity(
+		size_t sGlyphCacheCapacity
+	);
+
+	///	<summary>
+	///		Get the number of glyphs in the glyph cache.
+	///	</summary>
+	size_t GetGlyphCacheSize() const {
+		return m_mapGlyphs.size();
+	}
+
+	///	<summary>
+	///		Get the rendered glyph for the given character at the current
+	///		font size, rendering it if it is not in the glyph cache.  The
+	///		reference remains valid until the next call to GetGlyph.
+	///	</summary>
+	const Glyph & GetGlyph(
+		SFT_UChar c
+	);
+
 public:
 	///	<summary>
 	///		Calculate the minimum image buffer size for holding the given string.
@@ -103,11 +204,54 @@ public:
 		int * pwidth = NULL,
 		int * pheight = NULL);
 
+protected:
+	///	<summary>
+	///		Blend a glyph into the image with its coverage as alpha.  The
+	///		coordinate (x,y) indicates the pen position on the baseline.
+	///		Pixels outside of the canvas are not drawn.
+	///	</summary>
+	static void BlitGlyph(
+		const Glyph & glyph,
+		int nX,
+		int nY,
+		int nCanvasWidth,
+		int nCanvasHeight,
+		unsigned char * imagedata,
+		RGBA rgba);
+
+	///	<summary>
+	///		Remove least recently used glyphs until the cache holds at most
+	///		sCount glyphs.
+	///	</summary>
+	void EvictGlyphs(
+		size_t sCount
+	);
+
 private:
 	///	<summary>
 	///		Font information.
 	///	</summary>
 	SFT m_sft;
+
+	///	<summary>
+	///		Key of a cached glyph (character and font size).
+	///	</summary>
+	typedef std::pair<SFT_UChar, double> GlyphKey;
+
+	///	<summary>
+	///		Map from key to cached glyph and the tick of its last use.
+	///	</summary>
+	std::map<GlyphKey, std::pair<Glyph, uint64_t> > m_mapGlyphs;
+
+	///	<summary>
+	///		Tick counter for tracking glyph use.
+	///	</summary>
+	uint64_t m_ulGlyphTick;
+
+	///	<summary>
+	///		Maximum number of glyphs in the glyph cache.
+	///	</summary>
+	size_t m_sGlyphCacheCapacity;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
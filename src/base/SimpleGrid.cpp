@@ -26,10 +26,12 @@
 
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <vector>
+#include <algorithm>
 
 #include "netcdfcpp.h"
 
@@ -54,6 +56,8 @@ bool SimpleGrid::IsInitialized() const {
 	    m_dLat.IsAttached() ||
 	    m_dArea.IsAttached() ||
 	    (m_vecConnectivity.size() != 0) ||
+	    (m_vecConnectivityOffsets.size() != 0) ||
+	    m_fImplicitConnectivity ||
 		(m_kdtree != NULL)
 	) {
 		return true;
@@ -63,89 +67,297 @@ bool SimpleGrid::IsInitialized() const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+size_t SimpleGrid::GetNeighborCount(
+	size_t ix
+) const {
+	if (m_fImplicitConnectivity) {
+		int ixNeighbors[8];
+		return GetImplicitNeighbors(ix, ixNeighbors);
+	}
+
+	if (m_vecConnectivityOffsets.size() != 0) {
+		_ASSERT(ix + 1 < m_vecConnectivityOffsets.size());
+		return (m_vecConnectivityOffsets[ix+1] - m_vecConnectivityOffsets[ix]);
+	}
+
+	_ASSERT(ix < m_vecConnectivity.size());
+	return m_vecConnectivity[ix].size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SimpleGrid::GetNeighbors(
+	size_t ix,
+	std::vector<int> & vecNeighbors
+) const {
+	if (m_fImplicitConnectivity) {
+		int ixNeighbors[8];
+		size_t sNeighbors = GetImplicitNeighbors(ix, ixNeighbors);
+		vecNeighbors.assign(ixNeighbors, ixNeighbors + sNeighbors);
+		return;
+	}
+
+	if (m_vecConnectivityOffsets.size() != 0) {
+		_ASSERT(ix + 1 < m_vecConnectivityOffsets.size());
+		vecNeighbors.assign(
+			m_vecConnectivityIndices.begin() + m_vecConnectivityOffsets[ix],
+			m_vecConnectivityIndices.begin() + m_vecConnectivityOffsets[ix+1]);
+		return;
+	}
+
+	_ASSERT(ix < m_vecConnectivity.size());
+	vecNeighbors = m_vecConnectivity[ix];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SimpleGrid::CompressConnectivity() {
+	if (m_fImplicitConnectivity) {
+		return;
+	}
+	if (m_vecConnectivityOffsets.size() != 0) {
+		return;
+	}
+	if (m_vecConnectivity.size() == 0) {
+		return;
+	}
+
+	m_vecConnectivityOffsets.resize(m_vecConnectivity.size() + 1);
+	m_vecConnectivityOffsets[0] = 0;
+	for (size_t i = 0; i < m_vecConnectivity.size(); i++) {
+		m_vecConnectivityOffsets[i+1] =
+			m_vecConnectivityOffsets[i] + m_vecConnectivity[i].size();
+	}
+
+	m_vecConnectivityIndices.resize(m_vecConnectivityOffsets.back());
+	for (size_t i = 0; i < m_vecConnectivity.size(); i++) {
+		std::copy(
+			m_vecConnectivity[i].begin(),
+			m_vecConnectivity[i].end(),
+			m_vecConnectivityIndices.begin() + m_vecConnectivityOffsets[i]);
+	}
+
+	// Release the per-node connectivity vectors
+	std::vector< std::vector<int> >().swap(m_vecConnectivity);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t SimpleGrid::HashBytes(
+	const void * pData,
+	size_t sBytes,
+	uint64_t hash
+) {
+	const unsigned char * pBytes = static_cast<const unsigned char *>(pData);
+	for (size_t s = 0; s < sBytes; s++) {
+		hash ^= static_cast<uint64_t>(pBytes[s]);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t SimpleGrid::Fingerprint() const {
+	uint64_t hash = HashBytes(NULL, 0);
+
+	uint64_t nDims = m_nGridDim.size();
+	hash = HashBytes(&nDims, sizeof(uint64_t), hash);
+	for (size_t d = 0; d < m_nGridDim.size(); d++) {
+		uint64_t nDim = m_nGridDim[d];
+		hash = HashBytes(&nDim, sizeof(uint64_t), hash);
+	}
+
+	if (m_dLon.GetRows() != 0) {
+		hash = HashBytes(&(m_dLon[0]), m_dLon.GetRows() * sizeof(double), hash);
+	}
+	if (m_dLat.GetRows() != 0) {
+		hash = HashBytes(&(m_dLat[0]), m_dLat.GetRows() * sizeof(double), hash);
+	}
+
+	uint64_t nAreas = m_dArea.GetRows();
+	hash = HashBytes(&nAreas, sizeof(uint64_t), hash);
+	if (nAreas != 0) {
+		hash = HashBytes(&(m_dArea[0]), nAreas * sizeof(double), hash);
+	}
+
+	// Implicit connectivity is determined by the dimensions and options,
+	// explicit connectivity is hashed node by node
+	unsigned char cConnectivity[3];
+	cConnectivity[0] = (m_fImplicitConnectivity)?(2):(HasConnectivity()?1:0);
+	cConnectivity[1] = (m_fImplicitConnectivity && m_fImplicitRegional)?(1):(0);
+	cConnectivity[2] = (m_fImplicitConnectivity && m_fImplicitDiagonal)?(1):(0);
+	hash = HashBytes(cConnectivity, 3, hash);
+
+	if (cConnectivity[0] == 1) {
+		std::vector<int> vecNeighbors;
+		for (size_t i = 0; i < m_dLon.GetRows(); i++) {
+			GetNeighbors(i, vecNeighbors);
+			uint64_t nNeighbors = vecNeighbors.size();
+			hash = HashBytes(&nNeighbors, sizeof(uint64_t), hash);
+			if (nNeighbors != 0) {
+				hash = HashBytes(&(vecNeighbors[0]), nNeighbors * sizeof(int), hash);
+			}
+		}
+	}
+
+	return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SimpleGrid::Equals(
+	const SimpleGrid & grid
+) const {
+	if (m_nGridDim != grid.m_nGridDim) {
+		return false;
+	}
+
+	const DataArray1D<double> * pdThis[3] = {&m_dLon, &m_dLat, &m_dArea};
+	const DataArray1D<double> * pdOther[3] = {&grid.m_dLon, &grid.m_dLat, &grid.m_dArea};
+	for (int a = 0; a < 3; a++) {
+		if (pdThis[a]->GetRows() != pdOther[a]->GetRows()) {
+			return false;
+		}
+		if ((pdThis[a]->GetRows() != 0) &&
+		    (memcmp(&((*pdThis[a])[0]), &((*pdOther[a])[0]),
+		        pdThis[a]->GetRows() * sizeof(double)) != 0)
+		) {
+			return false;
+		}
+	}
+
+	if (m_fImplicitConnectivity || grid.m_fImplicitConnectivity) {
+		return (
+			(m_fImplicitConnectivity == grid.m_fImplicitConnectivity) &&
+			(m_fImplicitRegional == grid.m_fImplicitRegional) &&
+			(m_fImplicitDiagonal == grid.m_fImplicitDiagonal));
+	}
+
+	if (HasConnectivity() != grid.HasConnectivity()) {
+		return false;
+	}
+	if (!HasConnectivity()) {
+		return true;
+	}
+
+	std::vector<int> vecNeighbors;
+	std::vector<int> vecNeighborsOther;
+	for (size_t i = 0; i < m_dLon.GetRows(); i++) {
+		GetNeighbors(i, vecNeighbors);
+		grid.GetNeighbors(i, vecNeighborsOther);
+		if (vecNeighbors != vecNeighborsOther) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void SimpleGrid::GenerateRectilinearConnectivity(
 	int nLat,
 	int nLon,
 	bool fRegional,
 	bool fDiagonalConnectivity
 ) {
+	if ((nLat < 1) || (nLon < 1)) {
+		_EXCEPTION2("Invalid rectilinear grid dimensions (%i x %i)",
+			nLat, nLon);
+	}
+
+	const size_t sLat = static_cast<size_t>(nLat);
+	const size_t sLon = static_cast<size_t>(nLon);
+
+	if ((m_dLon.GetRows() != 0) && (m_dLon.GetRows() != sLat * sLon)) {
+		_EXCEPTION3("Rectilinear grid dimensions (%i x %i) do not match "
+			"grid size (%lu)", nLat, nLon, m_dLon.GetRows());
+	}
+
+	// The grid dimensions determine the implicit connectivity
+	m_nGridDim.resize(2);
+	m_nGridDim[0] = sLat;
+	m_nGridDim[1] = sLon;
+
+	// Connectivity is computed on the fly by GetNeighbors()
 	m_vecConnectivity.clear();
-	m_vecConnectivity.resize(nLon * nLat);
+	m_vecConnectivityOffsets.clear();
+	m_vecConnectivityIndices.clear();
 
-	size_t ixs = 0;
-	for (int j = 0; j < nLat; j++) {
-	for (int i = 0; i < nLon; i++) {
+	m_fImplicitConnectivity = true;
+	m_fImplicitRegional = fRegional;
+	m_fImplicitDiagonal = fDiagonalConnectivity;
+}
 
-		// Connectivity in eight directions
-		if (fDiagonalConnectivity) {
-			if (fRegional) {
-				for (int ix = -1; ix <= 1; ix++) {
-				for (int jx = -1; jx <= 1; jx++) {
-					if ((ix == 0) && (jx == 0)) {
-						continue;
-					}
+///////////////////////////////////////////////////////////////////////////////
 
-					int inew = i + ix;
-					int jnew = j + jx;
+size_t SimpleGrid::GetImplicitNeighbors(
+	size_t ix,
+	int ixNeighbors[8]
+) const {
+	_ASSERT(m_fImplicitConnectivity);
+	_ASSERT(m_nGridDim.size() == 2);
 
-					if ((inew < 0) || (inew >= nLon)) {
-						continue;
-					}
-					if ((jnew < 0) || (jnew >= nLat)) {
-						continue;
-					}
+	const int nLat = static_cast<int>(m_nGridDim[0]);
+	const int nLon = static_cast<int>(m_nGridDim[1]);
 
-					m_vecConnectivity[ixs].push_back(jnew * nLon + inew);
-				}
-				}
+	_ASSERT(ix < static_cast<size_t>(nLat) * static_cast<size_t>(nLon));
 
-			} else {
-				for (int ix = -1; ix <= 1; ix++) {
-				for (int jx = -1; jx <= 1; jx++) {
-					if ((ix == 0) && (jx == 0)) {
-						continue;
-					}
+	const int j = static_cast<int>(ix / static_cast<size_t>(nLon));
+	const int i = static_cast<int>(ix % static_cast<size_t>(nLon));
 
-					int inew = i + ix;
-					int jnew = j + jx;
+	size_t sNeighbors = 0;
 
-					if ((jnew < 0) || (jnew >= nLat)) {
-						continue;
-					}
-					if (inew < 0) {
-						inew += nLon;
-					}
-					if (inew >= nLon) {
-						inew -= nLon;
-					}
+	// Connectivity in eight directions
+	if (m_fImplicitDiagonal) {
+		for (int ioff = -1; ioff <= 1; ioff++) {
+		for (int joff = -1; joff <= 1; joff++) {
+			if ((ioff == 0) && (joff == 0)) {
+				continue;
+			}
 
-					m_vecConnectivity[ixs].push_back(jnew * nLon + inew);
+			int inew = i + ioff;
+			int jnew = j + joff;
+
+			if ((jnew < 0) || (jnew >= nLat)) {
+				continue;
+			}
+			if (m_fImplicitRegional) {
+				if ((inew < 0) || (inew >= nLon)) {
+					continue;
 				}
+			} else {
+				if (inew < 0) {
+					inew += nLon;
+				}
+				if (inew >= nLon) {
+					inew -= nLon;
 				}
 			}
 
-		// Connectivity in the four primary directions
-		} else {
-			if (j != 0) {
-				m_vecConnectivity[ixs].push_back((j-1) * nLon + i);
-			}
-			if (j != nLat-1) {
-				m_vecConnectivity[ixs].push_back((j+1) * nLon + i);
-			}
+			ixNeighbors[sNeighbors++] = jnew * nLon + inew;
+		}
+		}
 
-			if ((!fRegional) ||
-			    ((i != 0) && (i != nLon-1))
-			) {
-				m_vecConnectivity[ixs].push_back(
-					j * nLon + ((i + 1) % nLon));
-				m_vecConnectivity[ixs].push_back(
-					j * nLon + ((i + nLon - 1) % nLon));
-			}
+	// Connectivity in the four primary directions
+	} else {
+		if (j != 0) {
+			ixNeighbors[sNeighbors++] = (j-1) * nLon + i;
+		}
+		if (j != nLat-1) {
+			ixNeighbors[sNeighbors++] = (j+1) * nLon + i;
 		}
 
-		ixs++;
-	}
+		if ((!m_fImplicitRegional) ||
+		    ((i != 0) && (i != nLon-1))
+		) {
+			ixNeighbors[sNeighbors++] = j * nLon + ((i + 1) % nLon);
+			ixNeighbors[sNeighbors++] = j * nLon + ((i + nLon - 1) % nLon);
+		}
 	}
+
+	return sNeighbors;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -259,9 +471,12 @@ void SimpleGrid::GenerateLatitudeLongitude(
 		_EXCEPTIONT("At least two longitudes needed to generate grid.");
 	}
 
-	m_dLat.Allocate(nLon * nLat);
-	m_dLon.Allocate(nLon * nLat);
-	m_dArea.Allocate(nLon * nLat);
+	const size_t sLat = static_cast<size_t>(nLat);
+	const size_t sLon = static_cast<size_t>(nLon);
+
+	m_dLat.Allocate(sLon * sLat);
+	m_dLon.Allocate(sLon * sLat);
+	m_dArea.Allocate(sLon * sLat);
 
 	m_nGridDim.resize(2);
 	m_nGridDim[0] = nLat;
@@ -312,20 +527,13 @@ void SimpleGrid::GenerateLatitudeLongitude(
 		}
 	}
 
-	int ixs = 0;
-	for (int j = 0; j < nLat; j++) {
-	for (int i = 0; i < nLon; i++) {
+	// Sine of the latitude bounds of each row
+	DataArray1D<double> dSinLat1(nLat);
+	DataArray1D<double> dSinLat2(nLat);
 
-		// Vectorize coordinates
-		m_dLat[ixs] = vecLat[j];
-		m_dLon[ixs] = vecLon[i];
-
-		// Bounds of each volume and associated area
+	for (int j = 0; j < nLat; j++) {
 		double dLatRad1;
 		double dLatRad2;
-		
-		double dLonRad1;
-		double dLonRad2;
 
 		if (j == 0) {
 			if (fRegional) {
@@ -346,6 +554,17 @@ void SimpleGrid::GenerateLatitudeLongitude(
 			dLatRad2 = 0.5 * (vecLat[j+1] + vecLat[j]);
 		}
 
+		dSinLat1[j] = sin(dLatRad1);
+		dSinLat2[j] = sin(dLatRad2);
+	}
+
+	// Longitudinal extent of each column
+	DataArray1D<double> dDeltaLon(nLon);
+
+	for (int i = 0; i < nLon; i++) {
+		double dLonRad1;
+		double dLonRad2;
+
 		if (i == 0) {
 			if (fRegional) {
 				dLonRad1 = vecLon[0] - 0.5 * (vecLon[1] - vecLon[0]);
@@ -370,34 +589,43 @@ void SimpleGrid::GenerateLatitudeLongitude(
 		if (dLonRad1 > dLonRad2) {
 			dLonRad1 -= 2.0 * M_PI;
 		}
-		double dDeltaLon = dLonRad2 - dLonRad1;
-		if (!fRegional && (dDeltaLon >= M_PI)) {
+		dDeltaLon[i] = dLonRad2 - dLonRad1;
+		if (!fRegional && (dDeltaLon[i] >= M_PI)) {
 			_EXCEPTION1("Grid element longitudinal extent too large (%1.7f deg).  Did you mean to specify \"--regional\"?",
-				dDeltaLon * 180.0 / M_PI);
+				dDeltaLon[i] * 180.0 / M_PI);
 		}
+	}
 
-		if (fCalculateArea) {
-			m_dArea[ixs] = fabs(sin(dLatRad2) - sin(dLatRad1)) * dDeltaLon;
-		} else {
-			m_dArea[ixs] = 1.0;
-		}
+	// Vectorize coordinates and compute areas, one row per iteration
+#pragma omp parallel for schedule(static)
+	for (int j = 0; j < nLat; j++) {
+		const double dSinLatDiff = fabs(dSinLat2[j] - dSinLat1[j]);
 
-		ixs++;
-	}
+		size_t ixs = static_cast<size_t>(j) * sLon;
+		for (int i = 0; i < nLon; i++) {
+			m_dLat[ixs] = vecLat[j];
+			m_dLon[ixs] = vecLon[i];
+
+			if (fCalculateArea) {
+				m_dArea[ixs] = dSinLatDiff * dDeltaLon[i];
+			} else {
+				m_dArea[ixs] = 1.0;
+			}
+
+			ixs++;
+		}
 	}
 
 	// Generate connectivity
 	GenerateRectilinearConnectivity(nLat, nLon, fRegional, fDiagonalConnectivity);
 
 	// Output total area
-	{
+	if (fVerbose) {
 		double dTotalArea = 0.0;
 		for (size_t i = 0; i < m_dArea.GetRows(); i++) {
 			dTotalArea += m_dArea[i];
 		}
-		if (fVerbose) {
-			Announce("Total calculated grid area: %1.15e sr", dTotalArea);
-		}
+		Announce("Total calculated grid area: %1.15e sr", dTotalArea);
 	}
 
 }
@@ -488,18 +716,21 @@ void SimpleGrid::GenerateLatitudeLongitude(
 		varLat->get(m_dLat, lY, lX);
 		varLon->get(m_dLon, lY, lX);
 
-		for (size_t s = 0; s < m_dLon.GetRows(); s++) {
+#pragma omp parallel for schedule(static)
+		for (long s = 0; s < static_cast<long>(m_dLon.GetRows()); s++) {
 			m_dLon[s] = DegToRad(m_dLon[s]);
 			m_dLat[s] = DegToRad(m_dLat[s]);
 		}
 
-		// Approximate cell areas
+		// Approximate cell areas, one row per iteration
 		if ((lX > 1) && (lY > 1)) {
 			m_dArea.Allocate(lX * lY);
 
 			double dTotalArea = 0.0;
-			size_t s = 0;
-			for (size_t j = 0; j < static_cast<size_t>(lY); j++) {
+#pragma omp parallel for schedule(static) reduction(+:dTotalArea)
+			for (long lj = 0; lj < lY; lj++) {
+			const size_t j = static_cast<size_t>(lj);
+			size_t s = j * static_cast<size_t>(lX);
 			for (size_t i = 0; i < static_cast<size_t>(lX); i++) {
 				double dLonRad0;
 				double dLonRad1;
@@ -674,34 +905,60 @@ void SimpleGrid::GenerateRectilinearStereographic(
 		}
 	}
 
-	// Store longitude and latitude of centerpoints
-	int s = 0;
+	// Bounds of each element in the space of the stereographic projection
+	DataArray1D<double> dXsEdge;
+	DataArray1D<double> dYsEdge;
+
+	if (fCalculateArea) {
+		if (0.5 * dDeltaXRad * static_cast<double>(nX) >= M_PI) {
+			_EXCEPTION1("Total angular coverage of rectilinear stereographic "
+				"grid too large to calculate area (%1.5f >= pi)",
+				0.5 * dDeltaXRad * static_cast<double>(nX));
+		}
+
+		dXsEdge.Allocate(nX+1);
+		dYsEdge.Allocate(nX+1);
+
+		for (int i = 0; i <= nX; i++) {
+			double dXgcd = dXgcd0 + dDeltaXRad * (static_cast<double>(i) - 0.5);
+			dXsEdge[i] = 2.0 * tan(0.5 * dXgcd);
+			dYsEdge[i] = dXsEdge[i];
+		}
+
+		if (fFlipSouthernHemisphere && (dLatRad0 < 0.0)) {
+			for (int j = 0; j <= nX; j++) {
+				dYsEdge[j] *= -1.0;
+			}
+		}
+
+		m_dArea.Allocate(nX * nX);
+	}
+
+	// Store longitude and latitude of centerpoints and element areas,
+	// one row per iteration
+#pragma omp parallel for schedule(static)
 	for (int j = 0; j < nX; j++) {
-	for (int i = 0; i < nX; i++) {
-		StereographicProjectionInv(
-			dLonRad0,
-			dLatRad0,
-			dXs[i],
-			dYs[j],
-			m_dLon[s],
-			m_dLat[s]);
-/*
-		// DEBUG: Verify that the great circle distance is correct
-		printf("%i %i %1.5f\n", i, j,
-			180.0 / M_PI
-			* GreatCircleDistance_Rad(
+		size_t s = static_cast<size_t>(j) * static_cast<size_t>(nX);
+		for (int i = 0; i < nX; i++) {
+			StereographicProjectionInv(
 				dLonRad0,
 				dLatRad0,
+				dXs[i],
+				dYs[j],
 				m_dLon[s],
-				m_dLat[s]));
-*/
-		s++;
-	}
-	}
+				m_dLat[s]);
 
-	// Calculate the area
-	if (fCalculateArea) {
-		_EXCEPTIONT("Unable to calculate the area of the RectilinearStereographic grid (not impemented)");
+			if (fCalculateArea) {
+				m_dArea[s] =
+					StereographicRectangleArea(
+						dXsEdge[i],
+						dYsEdge[j],
+						dXsEdge[i+1],
+						dYsEdge[j+1]);
+			}
+
+			s++;
+		}
 	}
 }
 
@@ -757,39 +1014,93 @@ void SimpleGrid::GenerateRadialStereographic(
 		dRs[i] = 2.0 * sqrt((1.0 - cos(dRgcd)) / (1.0 + cos(dRgcd)));
 	}
 
-	// Calculate the lon/lat coordinates
-	int s = 0;
+	// Elements are annular sectors about the center point, so their areas
+	// depend only on the inner and outer great circle radius
+	DataArray1D<double> dAreaRing;
+
+	if (fCalculateArea) {
+		if (static_cast<double>(nR) * dDeltaRRad > M_PI) {
+			_EXCEPTION1("Total angular coverage of radial stereographic "
+				"grid too large to calculate area (%1.5f > pi)",
+				static_cast<double>(nR) * dDeltaRRad);
+		}
+
+		dAreaRing.Allocate(nR);
+		for (int j = 0; j < nR; j++) {
+			dAreaRing[j] =
+				(cos(static_cast<double>(j) * dDeltaRRad)
+				 - cos(static_cast<double>(j+1) * dDeltaRRad))
+				* 2.0 * M_PI / static_cast<double>(nA);
+		}
+
+		m_dArea.Allocate(nA * nR);
+	}
+
+	// Calculate the lon/lat coordinates and element areas, one ring
+	// per iteration
+#pragma omp parallel for schedule(static)
 	for (int j = 0; j < nR; j++) {
-	for (int i = 0; i < nA; i++) {
-		StereographicProjectionInv(
-			dLonRad0,
-			dLatRad0,
-			dXs[i] * dRs[j],
-			dYs[i] * dRs[j],
-			m_dLon[s],
-			m_dLat[s]);
-/*
-		// DEBUG: Verify that the great circle distance is uniform
-		// in the radial direction
-		printf("%i %i %1.5f %1.5f %1.5f\n", i, j,
-			dXs[i] * dRs[j],
-			dYs[i] * dRs[j],
-			180.0 / M_PI
-			* GreatCircleDistance_Rad(
+		size_t s = static_cast<size_t>(j) * static_cast<size_t>(nA);
+		for (int i = 0; i < nA; i++) {
+			StereographicProjectionInv(
 				dLonRad0,
 				dLatRad0,
+				dXs[i] * dRs[j],
+				dYs[i] * dRs[j],
 				m_dLon[s],
-				m_dLat[s]));
-*/
-		s++;
+				m_dLat[s]);
+
+			if (fCalculateArea) {
+				m_dArea[s] = dAreaRing[j];
+			}
+
+			s++;
+		}
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sort and remove duplicates from the neighbor list of each grid
+///		point, stored in vecNeighbors starting at vecUpperOffsets[i] with
+///		vecCount[i] entries, and store the result in compressed sparse row
+///		format.  Each list is processed independently in parallel.
+///	</summary>
+static void CompressNeighborLists(
+	const std::vector<size_t> & vecUpperOffsets,
+	std::vector<size_t> & vecCount,
+	std::vector<int> & vecNeighbors,
+	std::vector<size_t> & vecConnectivityOffsets,
+	std::vector<int> & vecConnectivityIndices
+) {
+	const long lPoints = static_cast<long>(vecCount.size());
+
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (long lf = 0; lf < lPoints; lf++) {
+		std::vector<int>::iterator iterBegin =
+			vecNeighbors.begin() + vecUpperOffsets[lf];
+		std::vector<int>::iterator iterEnd = iterBegin + vecCount[lf];
+
+		std::sort(iterBegin, iterEnd);
+		vecCount[lf] = std::unique(iterBegin, iterEnd) - iterBegin;
 	}
 
-	// Calculate the area
-	if (fCalculateArea) {
-		_EXCEPTIONT("Unable to calculate the area of the RectilinearStereographic grid (not impemented)");
+	vecConnectivityOffsets.resize(lPoints + 1);
+	vecConnectivityOffsets[0] = 0;
+	for (long lf = 0; lf < lPoints; lf++) {
+		vecConnectivityOffsets[lf+1] = vecConnectivityOffsets[lf] + vecCount[lf];
 	}
 
+	vecConnectivityIndices.resize(vecConnectivityOffsets[lPoints]);
+
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < lPoints; lf++) {
+		std::copy(
+			vecNeighbors.begin() + vecUpperOffsets[lf],
+			vecNeighbors.begin() + vecUpperOffsets[lf] + vecCount[lf],
+			vecConnectivityIndices.begin() + vecConnectivityOffsets[lf]);
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -816,41 +1127,89 @@ void SimpleGrid::FromMeshFV(
 	// Copy over areas
 	m_dArea = mesh.vecFaceArea;
 
-	// Generate connectivity from edge map
-	std::vector< std::set<int> > m_vecConnectivitySet;
-	m_vecConnectivitySet.resize(sFaces);
+	// Verify the edge map and count one-sided edges
+	const long lEdges = static_cast<long>(mesh.edgemap.size());
+	const int nFaces = static_cast<int>(sFaces);
 
 	size_t sOneSidedEdges = 0;
-	EdgeMapConstIterator iterEdgeMap = mesh.edgemap.begin();
-	for (; iterEdgeMap != mesh.edgemap.end(); iterEdgeMap++) {
-		const FacePair & facepr = iterEdgeMap->second;
+	long lFirstInvalidEdge = lEdges;
+
+#pragma omp parallel for reduction(+:sOneSidedEdges) reduction(min:lFirstInvalidEdge)
+	for (long lf = 0; lf < lEdges; lf++) {
+		const FacePair & facepr = (mesh.edgemap.begin() + lf)->second;
 		if ((facepr[0] == InvalidFace) || (facepr[1] == InvalidFace)) {
 			sOneSidedEdges++;
 			continue;
 		}
-		if ((facepr[0] < 0) || (facepr[0] >= sFaces)) {
-			_EXCEPTION1("EdgeMap FacePair out of range (%i)", facepr[0]);
-		}
-		if ((facepr[1] < 0) || (facepr[1] >= sFaces)) {
-			_EXCEPTION1("EdgeMap FacePair out of range (%i)", facepr[1]);
+		if ((facepr[0] < 0) || (facepr[0] >= nFaces) ||
+		    (facepr[1] < 0) || (facepr[1] >= nFaces)
+		) {
+			if (lf < lFirstInvalidEdge) {
+				lFirstInvalidEdge = lf;
+			}
 		}
-		m_vecConnectivitySet[facepr[0]].insert(facepr[1]);
-		m_vecConnectivitySet[facepr[1]].insert(facepr[0]);
+	}
+	if (lFirstInvalidEdge != lEdges) {
+		const FacePair & facepr =
+			(mesh.edgemap.begin() + lFirstInvalidEdge)->second;
+		_EXCEPTION2("EdgeMap FacePair out of range (%i, %i)",
+			facepr[0], facepr[1]);
 	}
 
 	if (sOneSidedEdges != 0) {
 		Announce("One-sided edges: %lu", sOneSidedEdges);
 	}
 
-	m_vecConnectivity.resize(sFaces);
-	for (int i = 0; i < sFaces; i++) {
-		std::set<int>::const_iterator iterConnect =
-			m_vecConnectivitySet[i].begin();
-		for (; iterConnect != m_vecConnectivitySet[i].end(); iterConnect++) {
-			m_vecConnectivity[i].push_back(*iterConnect);
+	// Generate connectivity by looking up the edges of each face in the
+	// edge map, with room for one neighbor per edge
+	std::vector<size_t> vecUpperOffsets(sFaces + 1);
+	vecUpperOffsets[0] = 0;
+	for (size_t i = 0; i < sFaces; i++) {
+		vecUpperOffsets[i+1] = vecUpperOffsets[i] + mesh.faces[i].edges.size();
+	}
+
+	std::vector<int> vecNeighbors(vecUpperOffsets[sFaces]);
+	std::vector<size_t> vecNeighborCount(sFaces);
+
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < static_cast<long>(sFaces); lf++) {
+		const Face & face = mesh.faces[lf];
+		const int nEdges = static_cast<int>(face.edges.size());
+
+		size_t sCount = 0;
+		for (int k = 0; k < nEdges; k++) {
+			const Edge edge(face[k], face[(k+1)%nEdges]);
+			if (edge[0] == edge[1]) {
+				continue;
+			}
+
+			EdgeMapConstIterator iter = mesh.edgemap.find(edge);
+			if (iter == mesh.edgemap.end()) {
+				continue;
+			}
+
+			const FacePair & facepr = iter->second;
+			if ((facepr[0] == InvalidFace) || (facepr[1] == InvalidFace)) {
+				continue;
+			}
+			if (facepr[0] == lf) {
+				vecNeighbors[vecUpperOffsets[lf] + sCount] = facepr[1];
+				sCount++;
+			} else if (facepr[1] == lf) {
+				vecNeighbors[vecUpperOffsets[lf] + sCount] = facepr[0];
+				sCount++;
+			}
 		}
+		vecNeighborCount[lf] = sCount;
 	}
 
+	CompressNeighborLists(
+		vecUpperOffsets,
+		vecNeighborCount,
+		vecNeighbors,
+		m_vecConnectivityOffsets,
+		m_vecConnectivityIndices);
+
 	// Generate centerpoints
 	m_dLon.Allocate(sFaces);
 	m_dLat.Allocate(sFaces);
@@ -859,7 +1218,7 @@ void SimpleGrid::FromMeshFV(
 	if (mesh.type == Mesh::MeshType_RLL) {
 		_EXCEPTIONT("How to define nGridDim?");
 
-		for (int i = 0; i < sFaces; i++) {
+		for (size_t i = 0; i < sFaces; i++) {
 
 			const Face & face = mesh.faces[i];
 
@@ -928,7 +1287,8 @@ void SimpleGrid::FromMeshFV(
 		m_nGridDim.resize(1);
 		m_nGridDim[0] = sFaces;
 
-		for (size_t i = 0; i < sFaces; i++) {
+#pragma omp parallel for schedule(static)
+		for (long i = 0; i < static_cast<long>(sFaces); i++) {
 
 			const Face & face = mesh.faces[i];
 
@@ -1027,26 +1387,51 @@ void SimpleGrid::FromMeshFE(
 	m_nGridDim.resize(1);
 	m_nGridDim[0] = sFaces;
 
+	const long lElements = static_cast<long>(nElements);
+	// Unique GLL nodes are numbered in order of first appearance, so a node
+	// first appears in element k if its index exceeds every index used by
+	// elements before k.  Coordinates are taken from that element.
+	std::vector<int> vecMaxIndexBefore(nElements);
+
+#pragma omp parallel for schedule(static)
+	for (long lf = 0; lf < lElements; lf++) {
+		int ixMax = 0;
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			ixMax = std::max(ixMax, dataGLLnodes[j][i][lf]);
+		}
+		}
+		vecMaxIndexBefore[lf] = ixMax;
+	}
+	{
+		int ixMaxSoFar = 0;
+		for (size_t k = 0; k < nElements; k++) {
+			int ixMaxElement = vecMaxIndexBefore[k];
+			vecMaxIndexBefore[k] = ixMaxSoFar;
+			ixMaxSoFar = std::max(ixMaxSoFar, ixMaxElement);
+		}
+	}
+
 	// Generate coordinates
 	{
 		m_dLon.Allocate(sFaces);
 		m_dLat.Allocate(sFaces);
 
 		const NodeVector & nodevec = mesh.nodes;
-		for (int k = 0; k < nElements; k++) {
-			const Face & face = mesh.faces[k];
 
-			if (face.edges.size() != 4) {
-				_EXCEPTIONT("Mesh must only contain quadrilateral elements");
-			}
-
-			double dFaceNumericalArea = 0.0;
+#pragma omp parallel for schedule(static)
+		for (long lf = 0; lf < lElements; lf++) {
+			const Face & face = mesh.faces[lf];
 
 			for (int j = 0; j < nP; j++) {
 			for (int i = 0; i < nP; i++) {
-				int ix = dataGLLnodes[j][i][k]-1;
+				int ix = dataGLLnodes[j][i][lf]-1;
+
+				_ASSERT((ix >= 0) && (static_cast<size_t>(ix) < m_dLon.GetRows()));
 
-				_ASSERT((ix >= 0) && (ix < m_dLon.GetRows()));
+				if (ix < vecMaxIndexBefore[lf]) {
+					continue;
+				}
 
 				Node nodeGLL;
 				Node dDx1G;
@@ -1074,47 +1459,77 @@ void SimpleGrid::FromMeshFE(
 
 	// Generate connectivity
 	{
-		std::vector< std::set<int> > vecConnectivitySet;
-		vecConnectivitySet.resize(sFaces);
-
-		for (size_t f = 0; f < nElements; f++) {
+		// Count connections in all directions from each GLL node, including
+		// duplicates from neighboring elements
+		std::vector<size_t> vecNeighborCount(sFaces, 0);
 
+#pragma omp parallel for schedule(static)
+		for (long lf = 0; lf < lElements; lf++) {
 			for (int q = 0; q < nP; q++) {
 			for (int p = 0; p < nP; p++) {
+				size_t sCount =
+					  ((p != 0)?(1):(0)) + ((p != (nP-1))?(1):(0))
+					+ ((q != 0)?(1):(0)) + ((q != (nP-1))?(1):(0));
+
+				size_t & sNodeCount = vecNeighborCount[dataGLLnodes[q][p][lf]-1];
+#pragma omp atomic
+				sNodeCount += sCount;
+			}
+			}
+		}
+
+		std::vector<size_t> vecUpperOffsets(sFaces + 1);
+		vecUpperOffsets[0] = 0;
+		for (size_t i = 0; i < sFaces; i++) {
+			vecUpperOffsets[i+1] = vecUpperOffsets[i] + vecNeighborCount[i];
+			vecNeighborCount[i] = 0;
+		}
 
-				std::set<int> & setLocalConnectivity =
-					vecConnectivitySet[dataGLLnodes[q][p][f]-1];
+		// Scatter connections; the order within each list is arbitrary
+		// until sorted below
+		// Note that dataGLLnodes is 1-indexed, whereas we need 0-indexing for connectivity
+		std::vector<int> vecNeighbors(vecUpperOffsets[sFaces]);
 
-				// Connect in all directions
-				// Note that dataGLLnodes is 1-indexed, whereas we need 0-indexing for connectivity
+#pragma omp parallel for schedule(static)
+		for (long lf = 0; lf < lElements; lf++) {
+			for (int q = 0; q < nP; q++) {
+			for (int p = 0; p < nP; p++) {
+				int ix = dataGLLnodes[q][p][lf]-1;
+
+				int ixConnect[4];
+				size_t sCount = 0;
 				if (p != 0) {
-					setLocalConnectivity.insert(
-						dataGLLnodes[q][p-1][f]-1);
+					ixConnect[sCount++] = dataGLLnodes[q][p-1][lf]-1;
 				}
 				if (p != (nP-1)) {
-					setLocalConnectivity.insert(
-						dataGLLnodes[q][p+1][f]-1);
+					ixConnect[sCount++] = dataGLLnodes[q][p+1][lf]-1;
 				}
 				if (q != 0) {
-					setLocalConnectivity.insert(
-						dataGLLnodes[q-1][p][f]-1);
+					ixConnect[sCount++] = dataGLLnodes[q-1][p][lf]-1;
 				}
 				if (q != (nP-1)) {
-					setLocalConnectivity.insert(
-						dataGLLnodes[q+1][p][f]-1);
+					ixConnect[sCount++] = dataGLLnodes[q+1][p][lf]-1;
+				}
+
+				size_t sPosition;
+				size_t & sNodeCount = vecNeighborCount[ix];
+#pragma omp atomic capture
+				{ sPosition = sNodeCount; sNodeCount += sCount; }
+
+				for (size_t c = 0; c < sCount; c++) {
+					vecNeighbors[vecUpperOffsets[ix] + sPosition + c] =
+						ixConnect[c];
 				}
 			}
 			}
 		}
 
-		m_vecConnectivity.resize(sFaces);
-		for (size_t i = 0; i < sFaces; i++) {
-			std::set<int>::const_iterator iterConnect =
-				vecConnectivitySet[i].begin();
-			for (; iterConnect != vecConnectivitySet[i].end(); iterConnect++) {
-				m_vecConnectivity[i].push_back(*iterConnect);
-			}
-		}
+		CompressNeighborLists(
+			vecUpperOffsets,
+			vecNeighborCount,
+			vecNeighbors,
+			m_vecConnectivityOffsets,
+			m_vecConnectivityIndices);
 	}
 
 	// Output total area
@@ -1210,11 +1625,13 @@ void SimpleGrid::FromFile(
 					strConnectivityFile.c_str(), f);
 			}
 			m_vecConnectivity[f][n]--;
-			if (m_vecConnectivity[f][n] == f) {
+			if (static_cast<size_t>(m_vecConnectivity[f][n]) == f) {
 				_EXCEPTION2("Self-connected node found in connectivity file \"%s\" for node %lu",
 					strConnectivityFile.c_str(), f);
 			}
-			if (m_vecConnectivity[f][n] >= sFaces) {
+			if ((m_vecConnectivity[f][n] < 0) ||
+			    (static_cast<size_t>(m_vecConnectivity[f][n]) >= sFaces)
+			) {
 				_EXCEPTION2("Out-of-range index found in connectivity file \"%s\" for node %lu",
 					strConnectivityFile.c_str(), f);
 			}
@@ -1260,15 +1677,17 @@ void SimpleGrid::ToFile(
 	if (sFaces != m_dArea.GetRows()) {
 		_EXCEPTIONT("Mangled SimpleGrid structure: m_dLon.size() != m_dArea.size()");
 	}
-	if (sFaces != m_vecConnectivity.size()) {
-		_EXCEPTIONT("Mangled SimpleGrid structure: m_dLon.size() != m_vecConnectivity.size()");
+	if (!HasConnectivity()) {
+		_EXCEPTIONT("Mangled SimpleGrid structure: missing connectivity");
 	}
 
+	std::vector<int> vecNeighbors;
 	for (size_t i = 0; i < sFaces; i++) {
+		GetNeighbors(i, vecNeighbors);
 		fsOutput << m_dLon[i] << "," << m_dLat[i] << ","
-			<< m_dArea[i] << "," << m_vecConnectivity[i].size();
-		for (size_t j = 0; j < m_vecConnectivity[i].size(); j++) {
-			fsOutput << "," << (m_vecConnectivity[i][j]+1);
+			<< m_dArea[i] << "," << vecNeighbors.size();
+		for (size_t j = 0; j < vecNeighbors.size(); j++) {
+			fsOutput << "," << (vecNeighbors[j]+1);
 		}
 		fsOutput << std::endl;
 	}
@@ -1335,24 +1754,24 @@ int SimpleGrid::CoordinateVectorToIndex(
 		_EXCEPTIONT("Invalid coordinate vector");
 	}
 	if (coordvec.size() == 1) {
-		if (coordvec[0] >= m_nGridDim[0]) {
+		if (static_cast<size_t>(coordvec[0]) >= m_nGridDim[0]) {
 			_EXCEPTIONT("Coordinate vector out of range");
 		}
 		return coordvec[0];
 	}
 	if (coordvec.size() == 2) {
-		if (coordvec[0] >= m_nGridDim[0]) {
+		if (static_cast<size_t>(coordvec[0]) >= m_nGridDim[0]) {
 			_EXCEPTIONT("Coordinate vector out of range");
 		}
-		if (coordvec[1] >= m_nGridDim[1]) {
+		if (static_cast<size_t>(coordvec[1]) >= m_nGridDim[1]) {
 			_EXCEPTIONT("Coordinate vector out of range");
 		}
 	}
 
 	int ix = 0;
 	int d = 1;
-	for (int i = 0; i < coordvec.size(); i++) {
-		if (coordvec[i] >= m_nGridDim[i]) {
+	for (size_t i = 0; i < coordvec.size(); i++) {
+		if (static_cast<size_t>(coordvec[i]) >= m_nGridDim[i]) {
 			_EXCEPTIONT("Coordinate vector out of range");
 		}
 		ix = ix + i * d;
@@ -1365,7 +1784,7 @@ int SimpleGrid::CoordinateVectorToIndex(
 ///////////////////////////////////////////////////////////////////////////////
 
 void SimpleGrid::BuildKDTree() {
-	if (m_kdtree != NULL) {
+	if ((m_kdtree != NULL) || m_fRectilinearIndex) {
 		_EXCEPTIONT("kdtree already exists");
 	}
 	if (m_dLon.GetRows() == 0) {
@@ -1374,6 +1793,11 @@ void SimpleGrid::BuildKDTree() {
 
 	_ASSERT(m_dLon.GetRows() == m_dLat.GetRows());
 
+	// Rectilinear grids are queried analytically
+	if (BuildRectilinearIndex()) {
+		return;
+	}
+
 	// Create the kd tree
 	m_kdtree = kd_create(3);
 	if (m_kdtree == NULL) {
@@ -1427,10 +1851,369 @@ void SimpleGrid::BuildMaskedKDTree(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool SimpleGrid::BuildRectilinearIndex() {
+	if (m_fRectilinearIndex) {
+		return true;
+	}
+	if (m_nGridDim.size() != 2) {
+		return false;
+	}
+
+	const size_t nLat = m_nGridDim[0];
+	const size_t nLon = m_nGridDim[1];
+
+	if ((nLat < 2) || (nLon < 2)) {
+		return false;
+	}
+	if ((m_dLat.GetRows() != nLat * nLon) || (m_dLon.GetRows() != nLat * nLon)) {
+		return false;
+	}
+
+	// Coordinates must be separable
+	for (size_t j = 0; j < nLat; j++) {
+		const size_t ixRow = j * nLon;
+		for (size_t i = 0; i < nLon; i++) {
+			if (m_dLat[ixRow + i] != m_dLat[ixRow]) {
+				return false;
+			}
+			if (m_dLon[ixRow + i] != m_dLon[i]) {
+				return false;
+			}
+		}
+	}
+
+	// Latitudes must be strictly monotone
+	double dLatDir = (m_dLat[nLon] > m_dLat[0])?(1.0):(-1.0);
+	for (size_t j = 0; j < nLat; j++) {
+		if (fabs(m_dLat[j * nLon]) > 0.5 * M_PI + HighTolerance) {
+			return false;
+		}
+		if ((j != 0) &&
+		    (dLatDir * (m_dLat[j * nLon] - m_dLat[(j-1) * nLon]) <= 0.0)
+		) {
+			return false;
+		}
+	}
+
+	// Longitudes must be strictly increasing modulo 2pi
+	DataArray1D<double> dLonOffset(nLon);
+	dLonOffset[0] = 0.0;
+	for (size_t i = 1; i < nLon; i++) {
+		dLonOffset[i] = LonRadToStandardRange(m_dLon[i] - m_dLon[0]);
+		if (dLonOffset[i] <= dLonOffset[i-1]) {
+			return false;
+		}
+	}
+
+	// Build the index
+	m_dRectLatDir = dLatDir;
+
+	m_dRectLat.Allocate(nLat);
+	m_dRectSinLat.Allocate(nLat);
+	m_dRectCosLat.Allocate(nLat);
+
+	for (size_t j = 0; j < nLat; j++) {
+		m_dRectLat[j] = m_dLat[j * nLon];
+		m_dRectSinLat[j] = sin(m_dRectLat[j]);
+		m_dRectCosLat[j] = cos(m_dRectLat[j]);
+	}
+
+	m_dRectLonOffset = dLonOffset;
+	m_dRectSinLon.Allocate(nLon);
+	m_dRectCosLon.Allocate(nLon);
+
+	for (size_t i = 0; i < nLon; i++) {
+		m_dRectSinLon[i] = sin(m_dLon[i]);
+		m_dRectCosLon[i] = cos(m_dLon[i]);
+	}
+
+	// Check for uniform longitude spacing
+	m_dRectDeltaLon = dLonOffset[1];
+	for (size_t i = 2; i < nLon; i++) {
+		if (fabs((dLonOffset[i] - dLonOffset[i-1]) - m_dRectDeltaLon) > HighTolerance) {
+			m_dRectDeltaLon = 0.0;
+			break;
+		}
+	}
+
+	m_fRectilinearIndex = true;
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SimpleGrid::RectilinearRowBound(
+	double dLatRad,
+	bool fStrict
+) const {
+	size_t jBegin = 0;
+	size_t jEnd = m_dRectLat.GetRows();
+
+	const double dTarget = m_dRectLatDir * dLatRad;
+
+	while (jBegin < jEnd) {
+		size_t jMid = jBegin + (jEnd - jBegin) / 2;
+		double dMid = m_dRectLatDir * m_dRectLat[jMid];
+		if ((dMid < dTarget) || (fStrict && (dMid == dTarget))) {
+			jBegin = jMid + 1;
+		} else {
+			jEnd = jMid;
+		}
+	}
+	return jBegin;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SimpleGrid::RectilinearColumnBound(
+	double dOffsetRad,
+	bool fStrict
+) const {
+	const size_t nLon = m_dRectLonOffset.GetRows();
+
+	// Uniform spacing: estimate the column directly and correct for
+	// rounding; otherwise use bisection
+	size_t iBegin = 0;
+	size_t iEnd = nLon;
+	if (m_dRectDeltaLon != 0.0) {
+		double dIx = ceil(dOffsetRad / m_dRectDeltaLon);
+		if (dIx <= 0.0) {
+			iBegin = 0;
+		} else if (dIx >= static_cast<double>(nLon)) {
+			iBegin = nLon;
+		} else {
+			iBegin = static_cast<size_t>(dIx);
+		}
+		while ((iBegin > 0) &&
+		       (m_dRectLonOffset[iBegin-1] >= dOffsetRad) &&
+		       (!fStrict || (m_dRectLonOffset[iBegin-1] != dOffsetRad))
+		) {
+			iBegin--;
+		}
+		iEnd = iBegin;
+	}
+
+	while (iBegin < iEnd) {
+		size_t iMid = iBegin + (iEnd - iBegin) / 2;
+		double dMid = m_dRectLonOffset[iMid];
+		if ((dMid < dOffsetRad) || (fStrict && (dMid == dOffsetRad))) {
+			iBegin = iMid + 1;
+		} else {
+			iEnd = iMid;
+		}
+	}
+
+	while ((iBegin < nLon) &&
+	       ((m_dRectLonOffset[iBegin] < dOffsetRad) ||
+	        (fStrict && (m_dRectLonOffset[iBegin] == dOffsetRad)))
+	) {
+		iBegin++;
+	}
+
+	return iBegin;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SimpleGrid::RectilinearNearestNode(
+	double dLonRad,
+	double dLatRad
+) const {
+	_ASSERT(m_fRectilinearIndex);
+
+	const size_t nLat = m_dRectLat.GetRows();
+	const size_t nLon = m_dRectLonOffset.GetRows();
+
+	// The nearest node in every latitude row lies in the column with the
+	// smallest longitude difference, so first find this column.
+	double dOffset = LonRadToStandardRange(dLonRad - m_dLon[0]);
+
+	size_t iNext = RectilinearColumnBound(dOffset, true);
+	_ASSERT(iNext > 0);
+
+	size_t iLon = iNext - 1;
+	double dDeltaLon = dOffset - m_dRectLonOffset[iLon];
+
+	double dDeltaLonNext;
+	if (iNext == nLon) {
+		dDeltaLonNext = 2.0 * M_PI - dOffset;
+	} else {
+		dDeltaLonNext = m_dRectLonOffset[iNext] - dOffset;
+	}
+	if (dDeltaLon > M_PI) {
+		dDeltaLon = 2.0 * M_PI - dDeltaLon;
+	}
+	if (dDeltaLonNext > M_PI) {
+		dDeltaLonNext = 2.0 * M_PI - dDeltaLonNext;
+	}
+	if (dDeltaLonNext < dDeltaLon) {
+		iLon = iNext % nLon;
+		dDeltaLon = dDeltaLonNext;
+	}
+
+	// Along this column the cosine of the great circle distance is
+	// A cos(lat - beta) with beta = atan2(sin(lat0), cos(lat0) cos(dlon)).
+	// When beta is a valid latitude the nearest row is one of the two rows
+	// bracketing beta; otherwise the nearest row is the first or last row.
+	const double dSinLat = sin(dLatRad);
+	const double dCosLatCosDeltaLon = cos(dLatRad) * cos(dDeltaLon);
+	const double dBeta = atan2(dSinLat, dCosLatCosDeltaLon);
+
+	size_t jNext = RectilinearRowBound(dBeta, false);
+
+	size_t jCandidates[4] = {0, nLat-1, nLat-1, nLat-1};
+	if (jNext > 0) {
+		jCandidates[2] = jNext - 1;
+	}
+	if (jNext < nLat) {
+		jCandidates[3] = jNext;
+	}
+
+	size_t jLat = 0;
+	double dMaxCosDist = -2.0;
+	for (int c = 0; c < 4; c++) {
+		const size_t j = jCandidates[c];
+		double dCosDist =
+			dSinLat * m_dRectSinLat[j]
+			+ dCosLatCosDeltaLon * m_dRectCosLat[j];
+
+		if ((dCosDist > dMaxCosDist) ||
+		    ((dCosDist == dMaxCosDist) && (j < jLat))
+		) {
+			dMaxCosDist = dCosDist;
+			jLat = j;
+		}
+	}
+
+	return (jLat * nLon + iLon);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SimpleGrid::RectilinearNearestNodes(
+	double dLonRad,
+	double dLatRad,
+	double dDistDegGCD,
+	std::vector<size_t> & vecNodeIxs,
+	std::vector<double> * pvecChord2
+) const {
+	_ASSERT(m_fRectilinearIndex);
+
+	vecNodeIxs.clear();
+	if (pvecChord2 != NULL) {
+		pvecChord2->clear();
+	}
+
+	if (dDistDegGCD < 0.0) {
+		return;
+	}
+
+	const size_t nLon = m_dRectLonOffset.GetRows();
+
+	// Use the same Cartesian distance criteria as the kdtree
+	const double dDistRad = DegToRad(dDistDegGCD);
+	const double dDistXYZ = 2.0 * sin(dDistRad / 2.0) + ReferenceTolerance;
+	const double dDistXYZ2 = dDistXYZ * dDistXYZ;
+
+	// Padding added to the search bounds; candidates are verified exactly
+	static const double dPad = 1.0e-8;
+
+	const double dSinLat = sin(dLatRad);
+	const double dCosLat = cos(dLatRad);
+	const double dSinLon = sin(dLonRad);
+	const double dCosLon = cos(dLonRad);
+
+	const double dOffset = LonRadToStandardRange(dLonRad - m_dLon[0]);
+
+	// Latitude rows within range
+	const double dLatMin = dLatRad - dDistRad - dPad;
+	const double dLatMax = dLatRad + dDistRad + dPad;
+
+	size_t jBegin;
+	size_t jEnd;
+	if (m_dRectLatDir > 0.0) {
+		jBegin = RectilinearRowBound(dLatMin, false);
+		jEnd = RectilinearRowBound(dLatMax, true);
+	} else {
+		jBegin = RectilinearRowBound(dLatMax, false);
+		jEnd = RectilinearRowBound(dLatMin, true);
+	}
+
+	const double dCosDist = cos(dDistRad);
+
+	for (size_t j = jBegin; j < jEnd; j++) {
+
+		// Longitude half-width of the spherical cap along this row
+		double dHalfWidth = M_PI;
+		double dCosLatCosLatRow = dCosLat * m_dRectCosLat[j];
+		if (dCosLatCosLatRow > ReferenceTolerance) {
+			double dCosHalfWidth =
+				(dCosDist - dSinLat * m_dRectSinLat[j]) / dCosLatCosLatRow;
+
+			if (dCosHalfWidth >= 1.0) {
+				dHalfWidth = 0.0;
+			} else if (dCosHalfWidth > -1.0) {
+				dHalfWidth = acos(dCosHalfWidth);
+			}
+		}
+		dHalfWidth += dPad;
+
+		// Walk the columns that fall within the longitude span
+		size_t iFirst = 0;
+		double dStart = 0.0;
+		if (dHalfWidth < M_PI) {
+			dStart = LonRadToStandardRange(dOffset - dHalfWidth);
+			iFirst = RectilinearColumnBound(dStart, false) % nLon;
+		}
+
+		const double dRowCos = dCosLat * m_dRectCosLat[j];
+		const double dRowSin = dSinLat * m_dRectSinLat[j];
+
+		for (size_t n = 0; n < nLon; n++) {
+			size_t i = (iFirst + n) % nLon;
+
+			if (dHalfWidth < M_PI) {
+				double dSpan = m_dRectLonOffset[i] - dStart;
+				if (dSpan < 0.0) {
+					dSpan += 2.0 * M_PI;
+				}
+				if (dSpan > 2.0 * dHalfWidth) {
+					break;
+				}
+			}
+
+			double dCosLonDiff =
+				dCosLon * m_dRectCosLon[i] + dSinLon * m_dRectSinLon[i];
+
+			double dChord2 =
+				2.0 - 2.0 * (dRowSin + dRowCos * dCosLonDiff);
+			if (dChord2 < 0.0) {
+				dChord2 = 0.0;
+			}
+
+			if (dChord2 <= dDistXYZ2) {
+				vecNodeIxs.push_back(j * nLon + i);
+				if (pvecChord2 != NULL) {
+					pvecChord2->push_back(dChord2);
+				}
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 size_t SimpleGrid::NearestNode(
 	double dLonRad,
 	double dLatRad
 ) const {
+	if ((m_kdtree == NULL) && m_fRectilinearIndex) {
+		if (fabs(dLatRad) > 0.5 * M_PI + HighTolerance) {
+			_EXCEPTION1("Latitude out of range (%2.14f)", dLatRad);
+		}
+		return RectilinearNearestNode(dLonRad, dLatRad);
+	}
 	if (m_kdtree == NULL) {
 		_EXCEPTIONT("BuildKDTree() must be called before NearestNode()");
 	}
@@ -1463,6 +2246,13 @@ void SimpleGrid::NearestNodes(
 	double dDistDegGCD,
 	std::vector<size_t> & vecNodeIxs
 ) const {
+	if ((m_kdtree == NULL) && m_fRectilinearIndex) {
+		if (fabs(dLatRad) > 0.5 * M_PI + HighTolerance) {
+			_EXCEPTION1("Latitude out of range (%2.14f)", dLatRad);
+		}
+		RectilinearNearestNodes(dLonRad, dLatRad, dDistDegGCD, vecNodeIxs);
+		return;
+	}
 	if (m_kdtree == NULL) {
 		_EXCEPTIONT("BuildKDTree() must be called before NearestNode()");
 	}
@@ -1498,3 +2288,293 @@ void SimpleGrid::NearestNodes(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SimpleGrid::NearestNodesWithDistances(
+	double dLonRad,
+	double dLatRad,
+	double dDistDegGCD,
+	std::vector< std::pair<size_t, double> > & vecNodeIxDist,
+	bool fSort,
+	size_t sMaxCount
+) const {
+	if ((m_kdtree == NULL) && !m_fRectilinearIndex) {
+		_EXCEPTIONT("BuildKDTree() must be called before NearestNodesWithDistances()");
+	}
+
+	vecNodeIxDist.clear();
+
+	// Candidates are stored as (squared chord length, index) pairs; since
+	// chord length is monotone in great circle distance, filtering, sorting
+	// and truncation are performed on chord length and the conversion to
+	// great circle distance is only applied to the returned nodes.
+	std::vector< std::pair<double, size_t> > vecChord2Ix;
+
+	if (m_kdtree == NULL) {
+		if (fabs(dLatRad) > 0.5 * M_PI + HighTolerance) {
+			_EXCEPTION1("Latitude out of range (%2.14f)", dLatRad);
+		}
+
+		std::vector<size_t> vecNodeIxs;
+		std::vector<double> vecChord2;
+		RectilinearNearestNodes(
+			dLonRad, dLatRad, dDistDegGCD, vecNodeIxs, &vecChord2);
+
+		vecChord2Ix.resize(vecNodeIxs.size());
+		for (size_t s = 0; s < vecNodeIxs.size(); s++) {
+			vecChord2Ix[s].first = vecChord2[s];
+			vecChord2Ix[s].second = vecNodeIxs[s];
+		}
+
+	} else {
+		double dX, dY, dZ;
+		RLLtoXYZ_Rad(dLonRad, dLatRad, dX, dY, dZ);
+
+		double dDistXYZ = 2.0 * sin(DegToRad(dDistDegGCD) / 2.0) + ReferenceTolerance;
+
+		kdres * kdresNearestRange = kd_nearest_range3(m_kdtree, dX, dY, dZ, dDistXYZ);
+		if (kdresNearestRange == NULL) {
+			_EXCEPTIONT("kd_nearest_range3() failed");
+		}
+
+		vecChord2Ix.reserve(kd_res_size(kdresNearestRange));
+		while (!kd_res_end(kdresNearestRange)) {
+			double dXn, dYn, dZn;
+			size_t i = (size_t)(kd_res_item3(kdresNearestRange, &dXn, &dYn, &dZn));
+
+			double dDX = dXn - dX;
+			double dDY = dYn - dY;
+			double dDZ = dZn - dZ;
+
+			vecChord2Ix.push_back(
+				std::pair<double, size_t>(
+					dDX * dDX + dDY * dDY + dDZ * dDZ, i));
+
+			kd_res_next(kdresNearestRange);
+		}
+
+		kd_res_free(kdresNearestRange);
+	}
+
+	// Sort and truncate
+	if ((sMaxCount != 0) && (sMaxCount < vecChord2Ix.size())) {
+		if (fSort) {
+			std::partial_sort(
+				vecChord2Ix.begin(),
+				vecChord2Ix.begin() + sMaxCount,
+				vecChord2Ix.end());
+		} else {
+			std::nth_element(
+				vecChord2Ix.begin(),
+				vecChord2Ix.begin() + sMaxCount,
+				vecChord2Ix.end());
+		}
+		vecChord2Ix.resize(sMaxCount);
+
+	} else if (fSort) {
+		std::sort(vecChord2Ix.begin(), vecChord2Ix.end());
+	}
+
+	// Convert to great circle distance
+	vecNodeIxDist.resize(vecChord2Ix.size());
+	for (size_t s = 0; s < vecChord2Ix.size(); s++) {
+		vecNodeIxDist[s].first = vecChord2Ix[s].second;
+		vecNodeIxDist[s].second =
+			RadToDeg(GreatCircleDistanceFromChordLength_Rad(
+				sqrt(vecChord2Ix[s].first)));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SimpleGrid::PrepareBatchQuery(
+	const double * dLonRad,
+	const double * dLatRad,
+	size_t sCount,
+	std::vector<double> & dXYZ,
+	std::vector<size_t> & vecOrder
+) const {
+	_ASSERT((sCount == 0) || ((dLonRad != NULL) && (dLatRad != NULL)));
+
+	// Verify latitudes up front so that no exceptions are thrown
+	// from within the parallel region
+	for (size_t s = 0; s < sCount; s++) {
+		if (fabs(dLatRad[s]) > 0.5 * M_PI + HighTolerance) {
+			_EXCEPTION2("Latitude of query %lu out of range (%2.14f)",
+				s, dLatRad[s]);
+		}
+	}
+
+	// Convert to Cartesian coordinates once and compute Morton keys
+	dXYZ.resize(3 * sCount);
+
+	std::vector< std::pair<uint64_t, size_t> > vecKeys(sCount);
+
+#pragma omp parallel for schedule(static)
+	for (size_t s = 0; s < sCount; s++) {
+		double dCosLat = cos(dLatRad[s]);
+		dXYZ[3*s+0] = cos(dLonRad[s]) * dCosLat;
+		dXYZ[3*s+1] = sin(dLonRad[s]) * dCosLat;
+		dXYZ[3*s+2] = sin(dLatRad[s]);
+
+		vecKeys[s].first =
+			MortonKeyXYZ(dXYZ[3*s+0], dXYZ[3*s+1], dXYZ[3*s+2]);
+		vecKeys[s].second = s;
+	}
+
+	// Sort queries along the space-filling curve
+	std::sort(vecKeys.begin(), vecKeys.end());
+
+	vecOrder.resize(sCount);
+	for (size_t s = 0; s < sCount; s++) {
+		vecOrder[s] = vecKeys[s].second;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SimpleGrid::NearestNodesBatch(
+	const double * dLonRad,
+	const double * dLatRad,
+	size_t sCount,
+	size_t * sNodeIxs
+) const {
+	if ((m_kdtree == NULL) && !m_fRectilinearIndex) {
+		_EXCEPTIONT("BuildKDTree() must be called before NearestNodesBatch()");
+	}
+	if (sCount == 0) {
+		return;
+	}
+	_ASSERT(sNodeIxs != NULL);
+
+	// Rectilinear index queries are independent of ordering
+	if (m_kdtree == NULL) {
+		for (size_t s = 0; s < sCount; s++) {
+			if (fabs(dLatRad[s]) > 0.5 * M_PI + HighTolerance) {
+				_EXCEPTION2("Latitude of query %lu out of range (%2.14f)",
+					s, dLatRad[s]);
+			}
+		}
+
+#pragma omp parallel for schedule(static)
+		for (size_t s = 0; s < sCount; s++) {
+			sNodeIxs[s] = RectilinearNearestNode(dLonRad[s], dLatRad[s]);
+		}
+		return;
+	}
+
+	std::vector<double> dXYZ;
+	std::vector<size_t> vecOrder;
+
+	PrepareBatchQuery(dLonRad, dLatRad, sCount, dXYZ, vecOrder);
+
+	// Consecutive chunks of the sorted queries are spatially coherent,
+	// so each thread traverses a similar part of the kd tree
+	static const size_t InvalidIx = static_cast<size_t>(-1);
+
+#pragma omp parallel for schedule(dynamic, 256)
+	for (size_t s = 0; s < sCount; s++) {
+		const size_t q = vecOrder[s];
+
+		kdres * kdresNearest =
+			kd_nearest3(m_kdtree, dXYZ[3*q+0], dXYZ[3*q+1], dXYZ[3*q+2]);
+
+		if (kdresNearest == NULL) {
+			sNodeIxs[q] = InvalidIx;
+			continue;
+		}
+		if (kd_res_size(kdresNearest) != 1) {
+			sNodeIxs[q] = InvalidIx;
+		} else {
+			sNodeIxs[q] = (size_t)(kd_res_item_data(kdresNearest));
+		}
+
+		kd_res_free(kdresNearest);
+	}
+
+	for (size_t s = 0; s < sCount; s++) {
+		if (sNodeIxs[s] == InvalidIx) {
+			_EXCEPTION1("kd_nearest3() failed for query %lu", s);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SimpleGrid::NearestNodesBatch(
+	const double * dLonRad,
+	const double * dLatRad,
+	size_t sCount,
+	double dDistDegGCD,
+	std::vector< std::vector<size_t> > & vecNodeIxs
+) const {
+	if ((m_kdtree == NULL) && !m_fRectilinearIndex) {
+		_EXCEPTIONT("BuildKDTree() must be called before NearestNodesBatch()");
+	}
+
+	vecNodeIxs.clear();
+	vecNodeIxs.resize(sCount);
+
+	if (sCount == 0) {
+		return;
+	}
+
+	// Rectilinear index queries are independent of ordering
+	if (m_kdtree == NULL) {
+		for (size_t s = 0; s < sCount; s++) {
+			if (fabs(dLatRad[s]) > 0.5 * M_PI + HighTolerance) {
+				_EXCEPTION2("Latitude of query %lu out of range (%2.14f)",
+					s, dLatRad[s]);
+			}
+		}
+
+#pragma omp parallel for schedule(dynamic, 64)
+		for (size_t s = 0; s < sCount; s++) {
+			RectilinearNearestNodes(
+				dLonRad[s], dLatRad[s], dDistDegGCD, vecNodeIxs[s]);
+		}
+		return;
+	}
+
+	std::vector<double> dXYZ;
+	std::vector<size_t> vecOrder;
+
+	PrepareBatchQuery(dLonRad, dLatRad, sCount, dXYZ, vecOrder);
+
+	double dDistXYZ = 2.0 * sin(DegToRad(dDistDegGCD) / 2.0) + ReferenceTolerance;
+
+	std::vector<char> fFailed(sCount, 0);
+
+#pragma omp parallel for schedule(dynamic, 64)
+	for (size_t s = 0; s < sCount; s++) {
+		const size_t q = vecOrder[s];
+
+		kdres * kdresNearestRange =
+			kd_nearest_range3(
+				m_kdtree,
+				dXYZ[3*q+0], dXYZ[3*q+1], dXYZ[3*q+2],
+				dDistXYZ);
+
+		if (kdresNearestRange == NULL) {
+			fFailed[q] = 1;
+			continue;
+		}
+
+		std::vector<size_t> & vecQueryIxs = vecNodeIxs[q];
+		vecQueryIxs.reserve(kd_res_size(kdresNearestRange));
+		while (!kd_res_end(kdresNearestRange)) {
+			vecQueryIxs.push_back(
+				(size_t)(kd_res_item_data(kdresNearestRange)));
+			kd_res_next(kdresNearestRange);
+		}
+
+		kd_res_free(kdresNearestRange);
+	}
+
+	for (size_t s = 0; s < sCount; s++) {
+		if (fFailed[s]) {
+			_EXCEPTION1("kd_nearest_range3() failed for query %lu", s);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -24,6 +24,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <stdint.h>
 
 #include "netcdfcpp.h"
 
@@ -51,7 +52,13 @@ public:
 	///		Constructor.
 	///	</summary>
 	SimpleGrid() :
-		m_kdtree(NULL)
+		m_fImplicitConnectivity(false),
+		m_fImplicitRegional(false),
+		m_fImplicitDiagonal(false),
+		m_kdtree(NULL),
+		m_fRectilinearIndex(false),
+		m_dRectLatDir(1.0),
+		m_dRectDeltaLon(0.0)
 	{ }
 
 	///	<summary>
@@ -79,6 +86,13 @@ public:
 	///		Determine if the SimpleGrid has connectivity information.
 	///	</summary>
 	bool HasConnectivity() const {
+		if (m_fImplicitConnectivity) {
+			return true;
+		}
+		if (m_vecConnectivityOffsets.size() != 0) {
+			_ASSERT(m_vecConnectivityOffsets.size() == m_dLon.GetRows() + 1);
+			return true;
+		}
 		if (m_vecConnectivity.size() == 0) {
 			return false;
 		}
@@ -86,9 +100,67 @@ public:
 		return true;
 	}
 
+	///	<summary>
+	///		Get the number of neighbors of the given grid point.
+	///	</summary>
+	size_t GetNeighborCount(
+		size_t ix
+	) const;
+
+	///	<summary>
+	///		Get the neighbors of the given grid point.
+	///	</summary>
+	void GetNeighbors(
+		size_t ix,
+		std::vector<int> & vecNeighbors
+	) const;
+
+	///	<summary>
+	///		Determine if the connectivity of this SimpleGrid is implicit
+	///		(computed on the fly from the rectilinear grid dimensions).
+	///	</summary>
+	bool HasImplicitConnectivity() const {
+		return m_fImplicitConnectivity;
+	}
+
+	///	<summary>
+	///		Convert connectivity to compressed sparse row storage, releasing
+	///		the per-node neighbor lists.  Implicit connectivity is left
+	///		unchanged.
+	///	</summary>
+	void CompressConnectivity();
+
+	///	<summary>
+	///		Compute a 64-bit fingerprint of this SimpleGrid from its
+	///		dimensions, coordinates, areas and connectivity.  The
+	///		fingerprint does not depend on how connectivity is stored.
+	///	</summary>
+	uint64_t Fingerprint() const;
+
+	///	<summary>
+	///		Determine if this SimpleGrid has the same dimensions,
+	///		coordinates, areas and connectivity as another SimpleGrid.
+	///	</summary>
+	bool Equals(
+		const SimpleGrid & grid
+	) const;
+
+	///	<summary>
+	///		Accumulate a block of bytes into a 64-bit FNV-1a hash.
+	///	</summary>
+	static uint64_t HashBytes(
+		const void * pData,
+		size_t sBytes,
+		uint64_t hash = 14695981039346656037ULL
+	);
+
 public:
 	///	<summary>
-	///		Generate connectivity information for a rectilinear grid.
+	///		Generate connectivity information for a rectilinear grid with
+	///		nLat rows of nLon points.  The grid dimensions are set to
+	///		(nLat, nLon) and must match the number of points if coordinates
+	///		have already been generated.  The connectivity is implicit and is
+	///		not materialized; use GetNeighbors() to access it.
 	///	</summary>
 	void GenerateRectilinearConnectivity(
 		int nLat,
@@ -97,6 +169,18 @@ public:
 		bool fDiagonalConnectivity
 	);
 
+protected:
+	///	<summary>
+	///		Compute the implicit rectilinear connectivity of the given grid
+	///		point, storing up to eight neighbors in ixNeighbors and returning
+	///		the number of neighbors.
+	///	</summary>
+	size_t GetImplicitNeighbors(
+		size_t ix,
+		int ixNeighbors[8]
+	) const;
+
+public:
 	///	<summary>
 	///		Get the latitude name, variable and dimension from a NcFile.
 	///	</summary>
@@ -257,10 +341,37 @@ public:
 
 public:
 	///	<summary>
-	///		Build a kdtree using this SimpleGrid.
+	///		Build a kdtree using this SimpleGrid.  If the SimpleGrid is a
+	///		rectilinear latitude-longitude grid the rectilinear index is
+	///		built instead and no kdtree is constructed.
 	///	</summary>
 	void BuildKDTree();
 
+	///	<summary>
+	///		Determine if this SimpleGrid is a latitude-longitude grid with
+	///		separable coordinates and, if so, build an index that answers
+	///		nearest node queries analytically.
+	///	</summary>
+	///	<returns>
+	///		true if the rectilinear index has been built.
+	///	</returns>
+	bool BuildRectilinearIndex();
+
+	///	<summary>
+	///		Determine if a kdtree or rectilinear index is available for
+	///		nearest node queries.
+	///	</summary>
+	bool HasSpatialIndex() const {
+		return ((m_kdtree != NULL) || m_fRectilinearIndex);
+	}
+
+	///	<summary>
+	///		Determine if the rectilinear index has been built.
+	///	</summary>
+	bool HasRectilinearIndex() const {
+		return m_fRectilinearIndex;
+	}
+
 	///	<summary>
 	///		Build a kdtree using this SimpleGrid, only including points
 	///		indicated by the mask.
@@ -288,6 +399,104 @@ public:
 		std::vector<size_t> & vecNodeIxs
 	) const;
 
+	///	<summary>
+	///		Find the nearest node to each of sCount coordinates (in radians).
+	///		Queries are reordered along a space-filling curve for locality
+	///		and executed in parallel; results are stored in query order.
+	///	</summary>
+	void NearestNodesBatch(
+		const double * dLonRad,
+		const double * dLatRad,
+		size_t sCount,
+		size_t * sNodeIxs
+	) const;
+
+	///	<summary>
+	///		Find the set of nodes within the specified distance (degrees great
+	///		circle distance) of each of sCount coordinates (in radians).
+	///	</summary>
+	void NearestNodesBatch(
+		const double * dLonRad,
+		const double * dLatRad,
+		size_t sCount,
+		double dDistDegGCD,
+		std::vector< std::vector<size_t> > & vecNodeIxs
+	) const;
+
+	///	<summary>
+	///		Find the set of nodes within the specified distance (degrees
+	///		great circle distance) of the given coordinate, along with the
+	///		great circle distance (in degrees) to each node.  If fSort is
+	///		true the nodes are sorted by increasing distance.  If sMaxCount
+	///		is nonzero only the sMaxCount nearest nodes are returned.
+	///	</summary>
+	void NearestNodesWithDistances(
+		double dLonRad,
+		double dLatRad,
+		double dDistDegGCD,
+		std::vector< std::pair<size_t, double> > & vecNodeIxDist,
+		bool fSort = true,
+		size_t sMaxCount = 0
+	) const;
+
+protected:
+	///	<summary>
+	///		Find the nearest node to the given coordinate using the
+	///		rectilinear index.
+	///	</summary>
+	size_t RectilinearNearestNode(
+		double dLonRad,
+		double dLatRad
+	) const;
+
+	///	<summary>
+	///		Find the set of nodes within the specified distance (degrees
+	///		great circle distance) of the given coordinate using the
+	///		rectilinear index.  If pvecChord2 is not NULL it is populated
+	///		with the squared chord length to each node.
+	///	</summary>
+	void RectilinearNearestNodes(
+		double dLonRad,
+		double dLatRad,
+		double dDistDegGCD,
+		std::vector<size_t> & vecNodeIxs,
+		std::vector<double> * pvecChord2 = NULL
+	) const;
+
+	///	<summary>
+	///		Get the first latitude row j of the rectilinear index with
+	///		m_dRectLatDir * lat[j] >= m_dRectLatDir * dLatRad (or > if
+	///		fStrict is true).
+	///	</summary>
+	size_t RectilinearRowBound(
+		double dLatRad,
+		bool fStrict
+	) const;
+
+	///	<summary>
+	///		Get the first longitude column of the rectilinear index whose
+	///		offset from the first column is greater than or equal to
+	///		dOffsetRad (or greater than if fStrict is true).  Returns the
+	///		number of columns if no such column exists.
+	///	</summary>
+	size_t RectilinearColumnBound(
+		double dOffsetRad,
+		bool fStrict
+	) const;
+
+	///	<summary>
+	///		Convert a batch of query coordinates to Cartesian coordinates
+	///		and determine an ordering of the queries along a space-filling
+	///		curve.
+	///	</summary>
+	void PrepareBatchQuery(
+		const double * dLonRad,
+		const double * dLatRad,
+		size_t sCount,
+		std::vector<double> & dXYZ,
+		std::vector<size_t> & vecOrder
+	) const;
+
 public:
 	///	<summary>
 	///		Grid dimensions.
@@ -310,16 +519,81 @@ public:
 	///	</summary>
 	DataArray1D<double> m_dArea;
 
+private:
 	///	<summary>
-	///		Connectivity of each grid point (optionally initialized).
+	///		Flag indicating connectivity is implicit and computed from the
+	///		rectilinear grid dimensions m_nGridDim.
+	///	</summary>
+	bool m_fImplicitConnectivity;
+
+	///	<summary>
+	///		Flag indicating the implicit connectivity is regional (not
+	///		periodic in longitude).
+	///	</summary>
+	bool m_fImplicitRegional;
+
+	///	<summary>
+	///		Flag indicating the implicit connectivity includes diagonal
+	///		neighbors.
+	///	</summary>
+	bool m_fImplicitDiagonal;
+
+	///	<summary>
+	///		Connectivity of each grid point (optionally initialized).  Use
+	///		GetNeighbors() to access connectivity in any representation.
 	///	</summary>
 	std::vector< std::vector<int> > m_vecConnectivity;
 
-private:
+	///	<summary>
+	///		Offsets of the connectivity of each grid point into
+	///		m_vecConnectivityIndices when connectivity is stored in compressed
+	///		sparse row format (optionally initialized).
+	///	</summary>
+	std::vector<size_t> m_vecConnectivityOffsets;
+
+	///	<summary>
+	///		Connectivity of all grid points in compressed sparse row format
+	///		(optionally initialized).
+	///	</summary>
+	std::vector<int> m_vecConnectivityIndices;
+
 	///	<summary>
 	///		kd tree used for quick lookup of grid points (optionally initialized).
 	///	</summary>
 	kdtree * m_kdtree;
+
+	///	<summary>
+	///		Flag indicating the rectilinear index has been built.
+	///	</summary>
+	bool m_fRectilinearIndex;
+
+	///	<summary>
+	///		Orientation of the latitude rows of the rectilinear index
+	///		(1 for increasing, -1 for decreasing).
+	///	</summary>
+	double m_dRectLatDir;
+
+	///	<summary>
+	///		Latitude of each row of the rectilinear index (in radians) and
+	///		its sine and cosine.
+	///	</summary>
+	DataArray1D<double> m_dRectLat;
+	DataArray1D<double> m_dRectSinLat;
+	DataArray1D<double> m_dRectCosLat;
+
+	///	<summary>
+	///		Longitude offset of each column of the rectilinear index from the
+	///		first column (in radians, strictly increasing in [0,2pi)) and the
+	///		sine and cosine of the longitude of each column.
+	///	</summary>
+	DataArray1D<double> m_dRectLonOffset;
+	DataArray1D<double> m_dRectSinLon;
+	DataArray1D<double> m_dRectCosLon;
+
+	///	<summary>
+	///		Longitude spacing of the rectilinear index if uniform, or zero.
+	///	</summary>
+	double m_dRectDeltaLon;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
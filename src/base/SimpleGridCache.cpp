@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    SimpleGridCache.cpp
+///	\author  Paul Ullrich
+///	\version October 18, 2026
+///
+///	<remarks>
+///		Copyright 2026 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "SimpleGridCache.h"
+#include "Exception.h"
+
+#include <cstdio>
+#include <sys/stat.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::mutex SimpleGridCache::s_mutex;
+
+std::multimap<uint64_t, SimpleGridCache::SimpleGridPtr> SimpleGridCache::s_mapGrids;
+
+std::map<std::string, SimpleGridCache::SimpleGridPtr> SimpleGridCache::s_mapKeys;
+
+///////////////////////////////////////////////////////////////////////////////
+
+SimpleGridCache::SimpleGridPtr SimpleGridCache::GenerateLatitudeLongitude(
+	const DataArray1D<double> & vecLat,
+	const DataArray1D<double> & vecLon,
+	bool fRegional,
+	bool fDiagonalConnectivity
+) {
+	// Key on the options and the exact bytes of the input coordinate
+	// arrays, so that distinct inputs never share a key
+	uint64_t nLat = vecLat.GetRows();
+	uint64_t nLon = vecLon.GetRows();
+
+	std::string strKey("rll:");
+	strKey += (fRegional)?('1'):('0');
+	strKey += (fDiagonalConnectivity)?('1'):('0');
+	strKey.append(reinterpret_cast<const char *>(&nLat), sizeof(uint64_t));
+	strKey.append(reinterpret_cast<const char *>(&nLon), sizeof(uint64_t));
+	if (nLat != 0) {
+		strKey.append(
+			reinterpret_cast<const char *>(&(vecLat[0])),
+			nLat * sizeof(double));
+	}
+	if (nLon != 0) {
+		strKey.append(
+			reinterpret_cast<const char *>(&(vecLon[0])),
+			nLon * sizeof(double));
+	}
+
+	SimpleGridPtr pgridCached = FindByKey(strKey);
+	if (pgridCached) {
+		return pgridCached;
+	}
+
+	// Generate the grid
+	SimpleGrid * pgrid = new SimpleGrid;
+	try {
+		pgrid->GenerateLatitudeLongitude(
+			vecLat,
+			vecLon,
+			fRegional,
+			fDiagonalConnectivity,
+			false);
+
+	} catch(...) {
+		delete pgrid;
+		throw;
+	}
+
+	return InsertWithKey(strKey, pgrid);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SimpleGridCache::SimpleGridPtr SimpleGridCache::FromFile(
+	const std::string & strConnectivityFile
+) {
+	// Key on the file name, size and modification time
+	struct stat statFile;
+	if (stat(strConnectivityFile.c_str(), &statFile) != 0) {
+		_EXCEPTION1("Unable to open file \"%s\"",
+			strConnectivityFile.c_str());
+	}
+
+	char szStat[64];
+	snprintf(szStat, 64, ":%lld:%lld",
+		static_cast<long long>(statFile.st_size),
+		static_cast<long long>(statFile.st_mtime));
+
+	std::string strKey = std::string("file:") + strConnectivityFile + szStat;
+
+	SimpleGridPtr pgridCached = FindByKey(strKey);
+	if (pgridCached) {
+		return pgridCached;
+	}
+
+	// Load the grid
+	SimpleGrid * pgrid = new SimpleGrid;
+	try {
+		pgrid->FromFile(strConnectivityFile);
+
+	} catch(...) {
+		delete pgrid;
+		throw;
+	}
+
+	return InsertWithKey(strKey, pgrid);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SimpleGridCache::SimpleGridPtr SimpleGridCache::Insert(
+	SimpleGrid * pgrid
+) {
+	if (pgrid == NULL) {
+		_EXCEPTIONT("Attempting to insert NULL SimpleGrid into cache");
+	}
+
+	uint64_t ulFingerprint = pgrid->Fingerprint();
+
+	// Return the existing grid if present
+	SimpleGridPtr pgridCached;
+	{
+		std::lock_guard<std::mutex> lock(s_mutex);
+		pgridCached = FindEqualLocked(ulFingerprint, *pgrid);
+	}
+	if (pgridCached) {
+		delete pgrid;
+		return pgridCached;
+	}
+
+	// Precompute the spatial index and compressed connectivity outside
+	// of the lock, since this may be expensive
+	try {
+		if ((pgrid->GetSize() != 0) && (!pgrid->HasSpatialIndex())) {
+			pgrid->BuildKDTree();
+		}
+		pgrid->CompressConnectivity();
+
+	} catch(...) {
+		delete pgrid;
+		throw;
+	}
+
+	SimpleGridPtr pgridNew(pgrid);
+
+	// Another thread may have inserted the same grid in the meantime
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	pgridCached = FindEqualLocked(ulFingerprint, *pgridNew);
+	if (pgridCached) {
+		return pgridCached;
+	}
+
+	s_mapGrids.insert(
+		std::pair<uint64_t, SimpleGridPtr>(ulFingerprint, pgridNew));
+
+	return pgridNew;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SimpleGridCache::SimpleGridPtr SimpleGridCache::Find(
+	uint64_t ulFingerprint
+) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	std::multimap<uint64_t, SimpleGridPtr>::const_iterator iter =
+		s_mapGrids.find(ulFingerprint);
+	if (iter == s_mapGrids.end()) {
+		return SimpleGridPtr();
+	}
+	return iter->second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SimpleGridCache::SimpleGridPtr SimpleGridCache::FindEqualLocked(
+	uint64_t ulFingerprint,
+	const SimpleGrid & grid
+) {
+	std::pair<
+		std::multimap<uint64_t, SimpleGridPtr>::const_iterator,
+		std::multimap<uint64_t, SimpleGridPtr>::const_iterator> range =
+			s_mapGrids.equal_range(ulFingerprint);
+
+	for (; range.first != range.second; range.first++) {
+		if (range.first->second->Equals(grid)) {
+			return range.first->second;
+		}
+	}
+	return SimpleGridPtr();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t SimpleGridCache::size() {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	return s_mapGrids.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SimpleGridCache::Clear() {
+	std::lock_guard<std::mutex> lock(s_mutex);
+	s_mapGrids.clear();
+	s_mapKeys.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SimpleGridCache::SimpleGridPtr SimpleGridCache::FindByKey(
+	const std::string & strKey
+) {
+	std::lock_guard<std::mutex> lock(s_mutex);
+
+	std::map<std::string, SimpleGridPtr>::const_iterator iter =
+		s_mapKeys.find(strKey);
+	if (iter == s_mapKeys.end()) {
+		return SimpleGridPtr();
+	}
+	return iter->second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SimpleGridCache::SimpleGridPtr SimpleGridCache::InsertWithKey(
+	const std::string & strKey,
+	SimpleGrid * pgrid
+) {
+	SimpleGridPtr pgridCached = Insert(pgrid);
+
+	std::lock_guard<std::mutex> lock(s_mutex);
+	s_mapKeys[strKey] = pgridCached;
+
+	return pgridCached;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    SimpleGridCache.h
+///	\author  Paul Ullrich
+///	\version October 18, 2026
+///
+///	<remarks>
+///		Copyright 2026 Paul Ullrich
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _SIMPLEGRIDCACHE_H_
+#define _SIMPLEGRIDCACHE_H_
+
+#include "SimpleGrid.h"
+#include "DataArray1D.h"
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A process-wide cache of immutable SimpleGrids.  Grids in the cache
+///		are shared between all components of a run and have their spatial
+///		index (kd tree or rectilinear index) and compressed connectivity
+///		precomputed.  Grids generated or loaded through the cache carry
+///		their cell areas.  Repeated requests for the same input return the
+///		cached instance instead of rebuilding the grid.
+///	</summary>
+class SimpleGridCache {
+
+public:
+	///	<summary>
+	///		A shared pointer to an immutable SimpleGrid.
+	///	</summary>
+	typedef std::shared_ptr<const SimpleGrid> SimpleGridPtr;
+
+public:
+	///	<summary>
+	///		Get the longitude-latitude grid with the given coordinates,
+	///		generating it if it does not exist in the cache.
+	///	</summary>
+	static SimpleGridPtr GenerateLatitudeLongitude(
+		const DataArray1D<double> & vecLat,
+		const DataArray1D<double> & vecLon,
+		bool fRegional,
+		bool fDiagonalConnectivity
+	);
+
+	///	<summary>
+	///		Get the grid stored in the given connectivity file, loading it
+	///		if it does not exist in the cache.  The file is identified by
+	///		its name, size and modification time.
+	///	</summary>
+	static SimpleGridPtr FromFile(
+		const std::string & strConnectivityFile
+	);
+
+	///	<summary>
+	///		Insert a SimpleGrid into the cache, taking ownership of it.  If an
+	///		equal grid already exists in the cache the cached grid is
+	///		returned and pgrid is deleted.  Grids are matched by fingerprint
+	///		and then compared in full, so grids with colliding fingerprints
+	///		are cached separately.  Areas are not computed for grids that
+	///		do not have them.
+	///	</summary>
+	static SimpleGridPtr Insert(
+		SimpleGrid * pgrid
+	);
+
+	///	<summary>
+	///		Find a grid in the cache by fingerprint, or return an empty
+	///		pointer if no such grid exists.  If several cached grids share
+	///		the fingerprint the first one inserted is returned.
+	///	</summary>
+	static SimpleGridPtr Find(
+		uint64_t ulFingerprint
+	);
+
+	///	<summary>
+	///		Number of grids in the cache.
+	///	</summary>
+	static size_t size();
+
+	///	<summary>
+	///		Remove all grids from the cache.  Grids remain valid as long as
+	///		they are referenced elsewhere.
+	///	</summary>
+	static void Clear();
+
+protected:
+	///	<summary>
+	///		Find a grid in the cache by input key.
+	///	</summary>
+	static SimpleGridPtr FindByKey(
+		const std::string & strKey
+	);
+
+	///	<summary>
+	///		Find a cached grid equal to the given grid.  The cache mutex
+	///		must be held by the caller.
+	///	</summary>
+	static SimpleGridPtr FindEqualLocked(
+		uint64_t ulFingerprint,
+		const SimpleGrid & grid
+	);
+
+	///	<summary>
+	///		Insert a grid into the cache and associate it with the given
+	///		input key.
+	///	</summary>
+	static SimpleGridPtr InsertWithKey(
+		const std::string & strKey,
+		SimpleGrid * pgrid
+	);
+
+private:
+	///	<summary>
+	///		Mutex guarding the cache.
+	///	</summary>
+	static std::mutex s_mutex;
+
+	///	<summary>
+	///		Map from fingerprint to cached grids.
+	///	</summary>
+	static std::multimap<uint64_t, SimpleGridPtr> s_mapGrids;
+
+	///	<summary>
+	///		Map from input key to cached grid.
+	///	</summary>
+	static std::map<std::string, SimpleGridPtr> s_mapKeys;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
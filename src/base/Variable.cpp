@@ -1120,10 +1120,12 @@ void Variable::LoadGridData(
 		// Calculate mean of field
 		m_data.Zero();
 
-		if (grid.m_vecConnectivity.size() != m_data.GetRows()) {
+		if (!grid.HasConnectivity() || (grid.GetSize() != m_data.GetRows())) {
 			_EXCEPTIONT("Invalid grid connectivity array");
 		}
 
+		std::vector<int> vecNeighbors;
+
 		for (int i = 0; i < m_data.GetRows(); i++) {
 			std::set<int> setNodesVisited;
 			std::set<int> setNodesToVisit;
@@ -1144,8 +1146,9 @@ void Variable::LoadGridData(
 				m_data[i] += varField.m_data[j];
 
 				// Find additional neighbors to explore
-				for (int k = 0; k < grid.m_vecConnectivity[j].size(); k++) {
-					int l = grid.m_vecConnectivity[j][k];
+				grid.GetNeighbors(j, vecNeighbors);
+				for (int k = 0; k < vecNeighbors.size(); k++) {
+					int l = vecNeighbors[k];
 
 					// Check if already visited
 					if (setNodesVisited.find(l) != setNodesVisited.end()) {
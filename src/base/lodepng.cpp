@@ -1605,7 +1605,8 @@ static unsigned encodeLZ77(uivector* out, Hash* hash,
 
 /* /////////////////////////////////////////////////////////////////////////// */
 
-static unsigned deflateNoCompression(ucvector* out, const unsigned char* data, size_t datasize)
+static unsigned deflateNoCompression(ucvector* out, const unsigned char* data, size_t datasize,
+                                     int final_stream)
 {
   /*non compressed deflate block data: 1 bit BFINAL,2 bits BTYPE,(5 bits): it jumps to start of next byte,
   2 bytes LEN, 2 bytes NLEN, LEN bytes literal DATA*/
@@ -1617,7 +1618,7 @@ static unsigned deflateNoCompression(ucvector* out, const unsigned char* data, s
     unsigned BFINAL, BTYPE, LEN, NLEN;
     unsigned char firstbyte;
 
-    BFINAL = (i == numdeflateblocks - 1);
+    BFINAL = final_stream && (i == numdeflateblocks - 1);
     BTYPE = 0;
 
     firstbyte = (unsigned char)(BFINAL + ((BTYPE & 1) << 1) + ((BTYPE & 2) << 1));
@@ -1969,8 +1970,13 @@ static unsigned deflateFixed(ucvector* out, size_t* bp, Hash* hash,
   return error;
 }
 
+/*
+If final_stream is 0 the last block is not marked as final and the output is
+terminated with an empty stored block (a sync flush), so that it ends on a byte
+boundary and further deflate data can be appended to it.
+*/
 static unsigned lodepng_deflatev(ucvector* out, const unsigned char* in, size_t insize,
-                                 const LodePNGCompressSettings* settings)
+                                 const LodePNGCompressSettings* settings, int final_stream)
 {
   unsigned error = 0;
   size_t i, blocksize, numdeflateblocks;
@@ -1978,7 +1984,7 @@ static unsigned lodepng_deflatev(ucvector* out, const unsigned char* in, size_t
   Hash hash;
 
   if(settings->btype > 2) return 61;
-  else if(settings->btype == 0) return deflateNoCompression(out, in, insize);
+  else if(settings->btype == 0) return deflateNoCompression(out, in, insize, final_stream);
   else if(settings->btype == 1) blocksize = insize;
   else /*if(settings->btype == 2)*/
   {
@@ -1994,7 +2000,7 @@ static unsigned lodepng_deflatev(ucvector* out, const unsigned char* in, size_t
 
   for(i = 0; i < numdeflateblocks && !error; i++)
   {
-    int final = i == numdeflateblocks - 1;
+    int final = final_stream && (i == numdeflateblocks - 1);
     size_t start = i * blocksize;
     size_t end = start + blocksize;
     if(end > insize) end = insize;
@@ -2005,6 +2011,16 @@ static unsigned lodepng_deflatev(ucvector* out, const unsigned char* in, size_t
 
   hash_cleanup(&hash);
 
+  if(!error && !final_stream)
+  {
+    /*empty stored block: BFINAL 0, BTYPE 00, jump to next byte, LEN 0, NLEN 65535*/
+    addBitsToStream(&bp, out, 0, 3);
+    ucvector_push_back(out, (unsigned char)0);
+    ucvector_push_back(out, (unsigned char)0);
+    ucvector_push_back(out, (unsigned char)255);
+    ucvector_push_back(out, (unsigned char)255);
+  }
+
   return error;
 }
 
@@ -2015,7 +2031,20 @@ unsigned lodepng_deflate(unsigned char** out, size_t* outsize,
   unsigned error;
   ucvector v;
   ucvector_init_buffer(&v, *out, *outsize);
-  error = lodepng_deflatev(&v, in, insize, settings);
+  error = lodepng_deflatev(&v, in, insize, settings, 1);
+  *out = v.data;
+  *outsize = v.size;
+  return error;
+}
+
+unsigned lodepng_deflate_sync(unsigned char** out, size_t* outsize,
+                              const unsigned char* in, size_t insize,
+                              const LodePNGCompressSettings* settings)
+{
+  unsigned error;
+  ucvector v;
+  ucvector_init_buffer(&v, *out, *outsize);
+  error = lodepng_deflatev(&v, in, insize, settings, 0);
   *out = v.data;
   *outsize = v.size;
   return error;
@@ -2267,24 +2296,33 @@ const LodePNGDecompressSettings lodepng_default_decompress_settings = {0, 0, 0,
 /* / CRC32                                                                  / */
 /* ////////////////////////////////////////////////////////////////////////// */
 
-static unsigned Crc32_crc_table_computed = 0;
-static unsigned Crc32_crc_table[256];
-
-/*Make the table for a fast CRC.*/
-static void Crc32_make_crc_table(void)
+/*Table for a fast CRC.  The table is built by the constructor of a function
+local static, which C++11 guarantees to initialize exactly once even when
+several threads compute checksums concurrently.*/
+struct Crc32_CrcTable
 {
-  unsigned c, k, n;
-  for(n = 0; n < 256; n++)
+  unsigned data[256];
+
+  Crc32_CrcTable()
   {
-    c = n;
-    for(k = 0; k < 8; k++)
+    unsigned c, k, n;
+    for(n = 0; n < 256; n++)
     {
-      if(c & 1) c = 0xedb88320L ^ (c >> 1);
-      else c = c >> 1;
+      c = n;
+      for(k = 0; k < 8; k++)
+      {
+        if(c & 1) c = 0xedb88320L ^ (c >> 1);
+        else c = c >> 1;
+      }
+      data[n] = c;
     }
-    Crc32_crc_table[n] = c;
   }
-  Crc32_crc_table_computed = 1;
+};
+
+static const unsigned* Crc32_get_crc_table(void)
+{
+  static const Crc32_CrcTable table;
+  return table.data;
 }
 
 /*Update a running CRC with the bytes buf[0..len-1]--the CRC should be
@@ -2292,13 +2330,13 @@ initialized to all 1's, and the transmitted value is the 1's complement of the
 final running CRC (see the crc() routine below).*/
 static unsigned Crc32_update_crc(const unsigned char* buf, unsigned crc, size_t len)
 {
+  const unsigned* crc_table = Crc32_get_crc_table();
   unsigned c = crc;
   size_t n;
 
-  if(!Crc32_crc_table_computed) Crc32_make_crc_table();
   for(n = 0; n < len; n++)
   {
-    c = Crc32_crc_table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
+    c = crc_table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
   }
   return c;
 }
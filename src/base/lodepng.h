@@ -771,6 +771,17 @@ unsigned lodepng_deflate(unsigned char** out, size_t* outsize,
                          const unsigned char* in, size_t insize,
                          const LodePNGCompressSettings* settings);
 
+/*
+Like lodepng_deflate, but the last block is not marked as final and the output
+is terminated with an empty stored block (a sync flush). The output ends on a
+byte boundary, so the deflate streams of consecutive pieces of data can be
+concatenated, with the last piece compressed with lodepng_deflate.
+(Added for Tempest; not part of upstream LodePNG.)
+*/
+unsigned lodepng_deflate_sync(unsigned char** out, size_t* outsize,
+                              const unsigned char* in, size_t insize,
+                              const LodePNGCompressSettings* settings);
+
 #endif /*LODEPNG_COMPILE_ENCODER*/
 #endif /*LODEPNG_COMPILE_ZLIB*/
 
@@ -20,13 +20,1947 @@
 
 #include "Exception.h"
 #include "Announce.h"
+#include "Constants.h"
+#include "CoordTransforms.h"
+#include "DataArray1D.h"
+#include "DataArray3D.h"
+#include "GridElements.h"
+#include "MeshUtilitiesFuzzy.h"
+#include "ColorMap.h"
+#include "PNGImage.h"
+#include "lodepng.h"
+#include "FiniteElementTools.h"
+#include "GaussQuadrature.h"
+#include "GaussLobattoQuadrature.h"
+#include "SimpleGrid.h"
+#include "SimpleGridCache.h"
 
 #include "netcdfcpp.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate cell-centered latitude and longitude arrays (in radians)
+///		for a global grid.
+///	</summary>
+void GenerateLatitudeLongitudeArrays(
+	int nLat,
+	int nLon,
+	DataArray1D<double> & vecLat,
+	DataArray1D<double> & vecLon
+) {
+	vecLat.Allocate(nLat);
+	vecLon.Allocate(nLon);
+	for (int j = 0; j < nLat; j++) {
+		vecLat[j] = (-0.5 + (static_cast<double>(j) + 0.5) / nLat) * M_PI;
+	}
+	for (int i = 0; i < nLon; i++) {
+		vecLon[i] = (static_cast<double>(i) + 0.5) / nLon * 2.0 * M_PI;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that the SimpleGridCache returns the cached instance for
+///		repeated requests and keeps grids that differ only in their
+///		connectivity options apart.
+///	</summary>
+void TestSimpleGridCache() {
+	AnnounceStartBlock("Testing SimpleGridCache");
+
+	SimpleGridCache::Clear();
+
+	DataArray1D<double> vecLat;
+	DataArray1D<double> vecLon;
+	GenerateLatitudeLongitudeArrays(18, 36, vecLat, vecLon);
+
+	SimpleGridCache::SimpleGridPtr pgrid =
+		SimpleGridCache::GenerateLatitudeLongitude(vecLat, vecLon, false, false);
+	SimpleGridCache::SimpleGridPtr pgridAgain =
+		SimpleGridCache::GenerateLatitudeLongitude(vecLat, vecLon, false, false);
+	SimpleGridCache::SimpleGridPtr pgridDiagonal =
+		SimpleGridCache::GenerateLatitudeLongitude(vecLat, vecLon, false, true);
+	SimpleGridCache::SimpleGridPtr pgridRegional =
+		SimpleGridCache::GenerateLatitudeLongitude(vecLat, vecLon, true, false);
+
+	if (pgrid != pgridAgain) {
+		_EXCEPTIONT("Repeated request did not return the cached grid");
+	}
+	if ((pgrid == pgridDiagonal) || (pgrid == pgridRegional)) {
+		_EXCEPTIONT("Grids with different connectivity share a cache entry");
+	}
+	if (SimpleGridCache::size() != 3) {
+		_EXCEPTION1("Expected 3 cached grids (found %lu)",
+			SimpleGridCache::size());
+	}
+	if ((pgrid->Fingerprint() == pgridDiagonal->Fingerprint()) ||
+	    (pgrid->Fingerprint() == pgridRegional->Fingerprint())
+	) {
+		_EXCEPTIONT("Grids with different connectivity share a fingerprint");
+	}
+	if (pgrid->GetNeighborCount(0) == pgridDiagonal->GetNeighborCount(0)) {
+		_EXCEPTIONT("Diagonal connectivity not applied");
+	}
+	if (!pgrid->HasAreas() || !pgrid->HasSpatialIndex()) {
+		_EXCEPTIONT("Cached grid missing areas or spatial index");
+	}
+
+	// Inserting an equal grid returns the cached instance
+	SimpleGrid * pgridCopy = new SimpleGrid;
+	pgridCopy->GenerateLatitudeLongitude(vecLat, vecLon, false, true, false);
+	if (SimpleGridCache::Insert(pgridCopy) != pgridDiagonal) {
+		_EXCEPTIONT("Inserting an equal grid did not return the cached grid");
+	}
+
+	SimpleGridCache::Clear();
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate query coordinates (in radians) for nearest node searches:
+///		nRandom random points followed by points at the poles and on either
+///		side of the longitude wrap at 0 and 360 degrees.
+///	</summary>
+void GenerateSphereQueryPoints(
+	int nRandom,
+	std::vector<double> & vecLon,
+	std::vector<double> & vecLat
+) {
+	vecLon.clear();
+	vecLat.clear();
+
+	for (int i = 0; i < nRandom; i++) {
+		vecLon.push_back(
+			(4.0 * static_cast<double>(rand()) / RAND_MAX - 1.0) * M_PI);
+		vecLat.push_back(
+			asin(2.0 * static_cast<double>(rand()) / RAND_MAX - 1.0));
+	}
+
+	const double dWrapLon[8] = {
+		0.0, 1.0e-13, -1.0e-13, 2.0 * M_PI, 2.0 * M_PI - 1.0e-13,
+		2.0 * M_PI + 1.0e-13, -M_PI, 3.0 * M_PI};
+	const double dWrapLat[6] = {
+		-0.5 * M_PI, -1.2, 0.0, 0.7, 0.5 * M_PI - 1.0e-13, 0.5 * M_PI};
+
+	for (int i = 0; i < 8; i++) {
+	for (int j = 0; j < 6; j++) {
+		vecLon.push_back(dWrapLon[i]);
+		vecLat.push_back(dWrapLat[j]);
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Chord length between grid node i and the given coordinate (in
+///		radians).
+///	</summary>
+double GridNodeChordLength(
+	const SimpleGrid & grid,
+	size_t i,
+	double dLonRad,
+	double dLatRad
+) {
+	double dX0, dY0, dZ0;
+	double dX1, dY1, dZ1;
+	RLLtoXYZ_Rad(grid.m_dLon[i], grid.m_dLat[i], dX0, dY0, dZ0);
+	RLLtoXYZ_Rad(dLonRad, dLatRad, dX1, dY1, dZ1);
+	return sqrt(
+		(dX1 - dX0) * (dX1 - dX0)
+		+ (dY1 - dY0) * (dY1 - dY0)
+		+ (dZ1 - dZ0) * (dZ1 - dZ0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that node ix is a nearest node to the given coordinate among
+///		all grid nodes (or those in pfMask) by brute force.  Ties are
+///		accepted to within round-off.
+///	</summary>
+void CheckNearestNode(
+	const SimpleGrid & grid,
+	const DataArray1D<bool> * pfMask,
+	double dLonRad,
+	double dLatRad,
+	size_t ix,
+	const char * szQuery
+) {
+	if ((ix >= grid.GetSize()) || ((pfMask != NULL) && !(*pfMask)[ix])) {
+		_EXCEPTION2("%s returned invalid node %lu", szQuery, ix);
+	}
+
+	double dMinChord = 4.0;
+	for (size_t i = 0; i < grid.GetSize(); i++) {
+		if ((pfMask == NULL) || (*pfMask)[i]) {
+			dMinChord = std::min(dMinChord,
+				GridNodeChordLength(grid, i, dLonRad, dLatRad));
+		}
+	}
+
+	const double dChord = GridNodeChordLength(grid, ix, dLonRad, dLatRad);
+	if (dChord > dMinChord + 1.0e-12) {
+		_EXCEPTION5("%s at (%1.15e, %1.15e) returned node %lu at chord "
+			"length %1.15e", szQuery, dLonRad, dLatRad, ix, dChord);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that vecNodeIxs holds exactly the grid nodes (or those in
+///		pfMask) within dDistDeg great circle degrees of the given coordinate
+///		by brute force.  Nodes within round-off of the radius may be either
+///		included or excluded.
+///	</summary>
+void CheckNodesWithinDistance(
+	const SimpleGrid & grid,
+	const DataArray1D<bool> * pfMask,
+	double dLonRad,
+	double dLatRad,
+	double dDistDeg,
+	const std::vector<size_t> & vecNodeIxs,
+	const char * szQuery
+) {
+	const double dMaxChord = 2.0 * sin(0.5 * DegToRad(dDistDeg));
+
+	std::vector<size_t> vecSorted(vecNodeIxs);
+	std::sort(vecSorted.begin(), vecSorted.end());
+	if (std::adjacent_find(vecSorted.begin(), vecSorted.end()) != vecSorted.end()) {
+		_EXCEPTION1("%s returned duplicate nodes", szQuery);
+	}
+
+	for (size_t i = 0; i < grid.GetSize(); i++) {
+		const bool fFound =
+			std::binary_search(vecSorted.begin(), vecSorted.end(), i);
+		const bool fInMask = ((pfMask == NULL) || (*pfMask)[i]);
+		const double dChord = GridNodeChordLength(grid, i, dLonRad, dLatRad);
+
+		if (fFound && (!fInMask || (dChord > dMaxChord + 1.0e-10))) {
+			_EXCEPTION4("%s at (%1.15e, %1.15e) returned node %lu outside "
+				"the radius", szQuery, dLonRad, dLatRad, i);
+		}
+		if (!fFound && fInMask && (dChord < dMaxChord - 1.0e-10)) {
+			_EXCEPTION4("%s at (%1.15e, %1.15e) missed node %lu within "
+				"the radius", szQuery, dLonRad, dLatRad, i);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that batched nearest node and range queries match brute force
+///		and the single point queries, using the kd tree of a masked grid and
+///		the rectilinear index of a latitude-longitude grid.
+///	</summary>
+void TestNearestNodesBatch() {
+	AnnounceStartBlock("Testing NearestNodesBatch");
+
+	srand(26);
+
+	DataArray1D<double> vecLat;
+	DataArray1D<double> vecLon;
+	GenerateLatitudeLongitudeArrays(24, 48, vecLat, vecLon);
+
+	std::vector<double> vecQueryLon;
+	std::vector<double> vecQueryLat;
+	GenerateSphereQueryPoints(1000, vecQueryLon, vecQueryLat);
+
+	const size_t sQueries = vecQueryLon.size();
+	const double dDistDeg = 12.0;
+
+	for (int g = 0; g < 2; g++) {
+		SimpleGrid grid;
+		grid.GenerateLatitudeLongitude(vecLat, vecLon, false, false, false);
+
+		DataArray1D<bool> fMask(grid.GetSize());
+		const DataArray1D<bool> * pfMask = NULL;
+		if (g == 0) {
+			for (size_t i = 0; i < grid.GetSize(); i++) {
+				fMask[i] = (rand() % 4 != 0);
+			}
+			grid.BuildMaskedKDTree(fMask);
+			pfMask = &fMask;
+		} else {
+			grid.BuildKDTree();
+		}
+
+		std::vector<size_t> vecNearest(sQueries);
+		grid.NearestNodesBatch(
+			&(vecQueryLon[0]), &(vecQueryLat[0]), sQueries, &(vecNearest[0]));
+
+		std::vector< std::vector<size_t> > vecRange;
+		grid.NearestNodesBatch(
+			&(vecQueryLon[0]), &(vecQueryLat[0]), sQueries, dDistDeg, vecRange);
+
+		std::vector<size_t> vecNodeIxs;
+		for (size_t q = 0; q < sQueries; q++) {
+			CheckNearestNode(grid, pfMask,
+				vecQueryLon[q], vecQueryLat[q],
+				vecNearest[q], "NearestNodesBatch");
+			CheckNearestNode(grid, pfMask,
+				vecQueryLon[q], vecQueryLat[q],
+				grid.NearestNode(vecQueryLon[q], vecQueryLat[q]), "NearestNode");
+
+			CheckNodesWithinDistance(grid, pfMask,
+				vecQueryLon[q], vecQueryLat[q], dDistDeg,
+				vecRange[q], "NearestNodesBatch");
+
+			grid.NearestNodes(
+				vecQueryLon[q], vecQueryLat[q], dDistDeg, vecNodeIxs);
+			CheckNodesWithinDistance(grid, pfMask,
+				vecQueryLon[q], vecQueryLat[q], dDistDeg,
+				vecNodeIxs, "NearestNodes");
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that nearest node and range queries answered by the
+///		rectilinear index match brute force and the kd tree, on global grids
+///		with increasing and decreasing latitudes, a grid with nodes at the
+///		poles and a regional grid crossing longitude 0.
+///	</summary>
+void TestRectilinearIndex() {
+	AnnounceStartBlock("Testing rectilinear index");
+
+	srand(27);
+
+	for (int g = 0; g < 4; g++) {
+		SimpleGrid grid;
+		SimpleGrid gridKDTree;
+
+		if (g == 3) {
+			const double dDeg = M_PI / 180.0;
+			grid.GenerateRegionalLatitudeLongitude(
+				-30.0 * dDeg, 40.0 * dDeg, -20.0 * dDeg, 30.0 * dDeg, 14, 25, false);
+			gridKDTree.GenerateRegionalLatitudeLongitude(
+				-30.0 * dDeg, 40.0 * dDeg, -20.0 * dDeg, 30.0 * dDeg, 14, 25, false);
+
+		} else {
+			DataArray1D<double> vecLat;
+			DataArray1D<double> vecLon;
+			if (g == 2) {
+				vecLat.Allocate(13);
+				vecLon.Allocate(24);
+				for (int j = 0; j < 13; j++) {
+					vecLat[j] = (-0.5 + static_cast<double>(j) / 12.0) * M_PI;
+				}
+				for (int i = 0; i < 24; i++) {
+					vecLon[i] = static_cast<double>(i) / 24.0 * 2.0 * M_PI;
+				}
+			} else {
+				GenerateLatitudeLongitudeArrays(24, 48, vecLat, vecLon);
+			}
+			if (g == 1) {
+				for (int j = 0; j < 12; j++) {
+					std::swap(vecLat[j], vecLat[23-j]);
+				}
+			}
+			grid.GenerateLatitudeLongitude(vecLat, vecLon, false, false, false);
+			gridKDTree.GenerateLatitudeLongitude(vecLat, vecLon, false, false, false);
+		}
+
+		grid.BuildKDTree();
+		if (!grid.HasRectilinearIndex()) {
+			_EXCEPTION1("Grid %i: rectilinear index not built", g);
+		}
+
+		DataArray1D<bool> fMask(gridKDTree.GetSize());
+		for (size_t i = 0; i < gridKDTree.GetSize(); i++) {
+			fMask[i] = true;
+		}
+		gridKDTree.BuildMaskedKDTree(fMask);
+
+		// Random and wrap points, grid nodes, and midpoints between
+		// neighboring columns including the pair across the wrap
+		std::vector<double> vecQueryLon;
+		std::vector<double> vecQueryLat;
+		GenerateSphereQueryPoints(500, vecQueryLon, vecQueryLat);
+
+		const size_t sLat = grid.m_nGridDim[0];
+		const size_t sLon = grid.m_nGridDim[1];
+		for (size_t j = 0; j < sLat; j++) {
+		for (size_t i = 0; i < sLon; i++) {
+			const size_t ix = j * sLon + i;
+			const size_t ixNext = j * sLon + (i + 1) % sLon;
+			double dLonNext = grid.m_dLon[ixNext];
+			if (dLonNext < grid.m_dLon[ix]) {
+				dLonNext += 2.0 * M_PI;
+			}
+			vecQueryLon.push_back(grid.m_dLon[ix]);
+			vecQueryLat.push_back(grid.m_dLat[ix]);
+			vecQueryLon.push_back(0.5 * (grid.m_dLon[ix] + dLonNext));
+			vecQueryLat.push_back(grid.m_dLat[ix]);
+		}
+		}
+
+		const double dDistDeg[4] = {0.5, 12.0, 100.0, 200.0};
+
+		std::vector<size_t> vecNodeIxs;
+		for (size_t q = 0; q < vecQueryLon.size(); q++) {
+			const double dLon = vecQueryLon[q];
+			const double dLat = vecQueryLat[q];
+
+			const size_t ix = grid.NearestNode(dLon, dLat);
+			CheckNearestNode(grid, NULL, dLon, dLat, ix, "NearestNode");
+
+			const size_t ixKDTree = gridKDTree.NearestNode(dLon, dLat);
+			if (fabs(GridNodeChordLength(grid, ix, dLon, dLat)
+			    - GridNodeChordLength(grid, ixKDTree, dLon, dLat)) > 1.0e-12
+			) {
+				_EXCEPTION3("Grid %i: rectilinear index and kd tree nearest "
+					"nodes differ at (%1.15e, %1.15e)", g, dLon, dLat);
+			}
+
+			for (int d = 0; d < 4; d++) {
+				grid.NearestNodes(dLon, dLat, dDistDeg[d], vecNodeIxs);
+				CheckNodesWithinDistance(grid, NULL,
+					dLon, dLat, dDistDeg[d], vecNodeIxs, "NearestNodes");
+			}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that NearestNodesWithDistances returns the nodes within the
+///		radius with their great circle distances, sorted when requested and
+///		truncated to the nearest nodes when a maximum count is given, using
+///		the kd tree of a masked grid and the rectilinear index.
+///	</summary>
+void TestNearestNodesWithDistances() {
+	AnnounceStartBlock("Testing NearestNodesWithDistances");
+
+	srand(28);
+
+	DataArray1D<double> vecLat;
+	DataArray1D<double> vecLon;
+	GenerateLatitudeLongitudeArrays(24, 48, vecLat, vecLon);
+
+	std::vector<double> vecQueryLon;
+	std::vector<double> vecQueryLat;
+	GenerateSphereQueryPoints(500, vecQueryLon, vecQueryLat);
+
+	const double dDistDeg[2] = {5.0, 30.0};
+	const size_t sMaxCount = 5;
+
+	for (int g = 0; g < 2; g++) {
+		SimpleGrid grid;
+		grid.GenerateLatitudeLongitude(vecLat, vecLon, false, false, false);
+
+		DataArray1D<bool> fMask(grid.GetSize());
+		const DataArray1D<bool> * pfMask = NULL;
+		if (g == 0) {
+			for (size_t i = 0; i < grid.GetSize(); i++) {
+				fMask[i] = (rand() % 4 != 0);
+			}
+			grid.BuildMaskedKDTree(fMask);
+			pfMask = &fMask;
+		} else {
+			grid.BuildKDTree();
+		}
+
+		std::vector< std::pair<size_t, double> > vecSorted;
+		std::vector< std::pair<size_t, double> > vecUnsorted;
+		std::vector< std::pair<size_t, double> > vecNearest;
+		std::vector<size_t> vecNodeIxs;
+		std::vector<double> vecDist;
+
+		for (size_t q = 0; q < vecQueryLon.size(); q++) {
+		for (int d = 0; d < 2; d++) {
+			const double dLon = vecQueryLon[q];
+			const double dLat = vecQueryLat[q];
+
+			grid.NearestNodesWithDistances(
+				dLon, dLat, dDistDeg[d], vecSorted, true);
+
+			vecNodeIxs.resize(vecSorted.size());
+			for (size_t s = 0; s < vecSorted.size(); s++) {
+				vecNodeIxs[s] = vecSorted[s].first;
+
+				const double dGCD = GreatCircleDistance_Deg(
+					dLon, dLat,
+					grid.m_dLon[vecSorted[s].first],
+					grid.m_dLat[vecSorted[s].first]);
+				if (fabs(vecSorted[s].second - dGCD) > 1.0e-6) {
+					_EXCEPTION4("Grid %i: distance %1.15e to node %lu differs "
+						"from great circle distance %1.15e",
+						g, vecSorted[s].second, vecSorted[s].first, dGCD);
+				}
+				if ((s != 0) && (vecSorted[s].second < vecSorted[s-1].second)) {
+					_EXCEPTION1("Grid %i: nodes not sorted by distance", g);
+				}
+			}
+			CheckNodesWithinDistance(grid, pfMask,
+				dLon, dLat, dDistDeg[d], vecNodeIxs, "NearestNodesWithDistances");
+
+			// Unsorted results are a permutation of the sorted results
+			grid.NearestNodesWithDistances(
+				dLon, dLat, dDistDeg[d], vecUnsorted, false);
+			std::sort(vecUnsorted.begin(), vecUnsorted.end());
+			std::vector< std::pair<size_t, double> > vecSortedByIx(vecSorted);
+			std::sort(vecSortedByIx.begin(), vecSortedByIx.end());
+			if (vecUnsorted != vecSortedByIx) {
+				_EXCEPTION1("Grid %i: unsorted and sorted results differ", g);
+			}
+
+			// Truncated results are the nearest nodes, sorted or not
+			const size_t sCount = std::min(sMaxCount, vecSorted.size());
+			for (int f = 0; f < 2; f++) {
+				grid.NearestNodesWithDistances(
+					dLon, dLat, dDistDeg[d], vecNearest, (f == 0), sMaxCount);
+				if (vecNearest.size() != sCount) {
+					_EXCEPTION3("Grid %i: %lu nearest nodes returned "
+						"(expected %lu)", g, vecNearest.size(), sCount);
+				}
+
+				vecDist.resize(sCount);
+				for (size_t s = 0; s < sCount; s++) {
+					vecDist[s] = vecNearest[s].second;
+					if (!std::binary_search(
+							vecSortedByIx.begin(), vecSortedByIx.end(),
+							vecNearest[s])
+					) {
+						_EXCEPTION2("Grid %i: truncated result contains node "
+							"%lu not in the full result", g, vecNearest[s].first);
+					}
+				}
+				if (f == 1) {
+					std::sort(vecDist.begin(), vecDist.end());
+				}
+				for (size_t s = 0; s < sCount; s++) {
+					if (vecDist[s] != vecSorted[s].second) {
+						_EXCEPTION1("Grid %i: truncated result does not hold "
+							"the nearest nodes", g);
+					}
+				}
+			}
+		}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append a Face to the mesh with its own copy of each node.  Copies
+///		are displaced by a distance well within the coincident node
+///		tolerance so that they are merged by RemoveCoincidentNodes.
+///	</summary>
+void AppendFaceWithDuplicateNodes(
+	Mesh & mesh,
+	const std::vector<Node> & vecFaceNodes
+) {
+	const int nEdges = static_cast<int>(vecFaceNodes.size());
+	const Real dDisplacement =
+		1.0e-3 * ReferenceTolerance * static_cast<Real>(mesh.faces.size() % 3);
+
+	Face face(nEdges);
+	for (int i = 0; i < nEdges; i++) {
+		face.SetNode(i, static_cast<int>(mesh.nodes.size()));
+		mesh.nodes.push_back(
+			Node(
+				vecFaceNodes[i].x + dDisplacement,
+				vecFaceNodes[i].y,
+				vecFaceNodes[i].z));
+	}
+	mesh.faces.push_back(face);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate an equiangular cubed-sphere mesh with nResolution x
+///		nResolution Faces per panel, where every Face has its own nodes.
+///	</summary>
+void GenerateCubedSphereWithDuplicateNodes(
+	int nResolution,
+	Mesh & mesh
+) {
+	mesh.Clear();
+
+	for (int p = 0; p < 6; p++) {
+	for (int a = 0; a < nResolution; a++) {
+	for (int b = 0; b < nResolution; b++) {
+		const int nAlpha[4] = {a, a+1, a+1, a};
+		const int nBeta[4] = {b, b, b+1, b+1};
+
+		std::vector<Node> vecFaceNodes(4);
+		for (int i = 0; i < 4; i++) {
+			Real dX = tan(0.25 * M_PI
+				* (2.0 * static_cast<Real>(nAlpha[i]) / nResolution - 1.0));
+			Real dY = tan(0.25 * M_PI
+				* (2.0 * static_cast<Real>(nBeta[i]) / nResolution - 1.0));
+
+			Node node;
+			switch (p) {
+				case 0: node = Node( 1.0,   dX,   dY); break;
+				case 1: node = Node( -dX,  1.0,   dY); break;
+				case 2: node = Node(-1.0,  -dX,   dY); break;
+				case 3: node = Node(  dX, -1.0,   dY); break;
+				case 4: node = Node( -dY,   dX,  1.0); break;
+				default: node = Node( dY,   dX, -1.0); break;
+			}
+			vecFaceNodes[i] = node.Normalized();
+		}
+		AppendFaceWithDuplicateNodes(mesh, vecFaceNodes);
+	}
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Merge the coincident nodes of a mesh of triangles over the given
+///		nodes and check the result against merging the nodes in index order
+///		with a NodeTree, which keeps the lowest indexed node within the
+///		tolerance.  Returns the number of nodes after merging.
+///	</summary>
+size_t CheckRemoveCoincidentNodes(
+	const NodeVector & nodesIn,
+	double dTolerance
+) {
+	const size_t sNodes = nodesIn.size();
+
+	Mesh mesh;
+	mesh.coincident_node_tolerance = dTolerance;
+	mesh.nodes = nodesIn;
+	for (size_t i = 0; i < sNodes; i++) {
+		Face face(3);
+		for (size_t k = 0; k < 3; k++) {
+			face.SetNode(k, static_cast<int>((i + k) % sNodes));
+		}
+		mesh.faces.push_back(face);
+	}
+
+	NodeTree nt(dTolerance);
+	std::vector<int> vecNodeIndex(sNodes);
+	std::vector<size_t> vecUniques;
+	for (size_t i = 0; i < sNodes; i++) {
+		size_t ix = nt.find_or_insert(nodesIn[i], i);
+		if (ix == i) {
+			vecNodeIndex[i] = static_cast<int>(vecUniques.size());
+			vecUniques.push_back(i);
+		} else {
+			vecNodeIndex[i] = vecNodeIndex[ix];
+		}
+	}
+
+	mesh.RemoveCoincidentNodes();
+
+	if (mesh.nodes.size() != vecUniques.size()) {
+		_EXCEPTION2("RemoveCoincidentNodes kept %lu nodes (NodeTree keeps %lu)",
+			mesh.nodes.size(), vecUniques.size());
+	}
+	for (size_t u = 0; u < vecUniques.size(); u++) {
+		const Node & node = nodesIn[vecUniques[u]];
+		if ((mesh.nodes[u].x != node.x) ||
+		    (mesh.nodes[u].y != node.y) ||
+		    (mesh.nodes[u].z != node.z)
+		) {
+			_EXCEPTION2("Merged node %lu is not original node %lu",
+				u, vecUniques[u]);
+		}
+	}
+	for (size_t f = 0; f < sNodes; f++) {
+		for (size_t k = 0; k < 3; k++) {
+			if (mesh.faces[f][k] != vecNodeIndex[(f + k) % sNodes]) {
+				_EXCEPTION1("Face %lu nodes differ from NodeTree merge", f);
+			}
+		}
+	}
+
+	return mesh.nodes.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that RemoveCoincidentNodes merges duplicated nodes in a
+///		convex global mesh and in a regional mesh with a concave Face, and
+///		that the merged meshes are validated and convexified as expected.
+///		Merges at the tolerance and across spatial hash cells are checked
+///		against a NodeTree.
+///	</summary>
+void TestRemoveCoincidentNodes() {
+	AnnounceStartBlock("Testing RemoveCoincidentNodes");
+
+	// Convex global mesh
+	{
+		const int nResolution = 4;
+
+		Mesh mesh;
+		GenerateCubedSphereWithDuplicateNodes(nResolution, mesh);
+		mesh.RemoveCoincidentNodes();
+
+		const size_t sExpectedNodes = 6 * nResolution * nResolution + 2;
+		if (mesh.nodes.size() != sExpectedNodes) {
+			_EXCEPTION2("Convex mesh has %lu nodes after merge (expected %lu)",
+				mesh.nodes.size(), sExpectedNodes);
+		}
+
+		mesh.Validate();
+
+		FaceVector facesOriginal = mesh.faces;
+		ConvexifyMesh(mesh);
+
+		if (mesh.faces.size() != facesOriginal.size()) {
+			_EXCEPTIONT("ConvexifyMesh modified a convex mesh");
+		}
+		for (size_t f = 0; f < facesOriginal.size(); f++) {
+			if (IsFaceConcave(mesh.faces[f], mesh.nodes)) {
+				_EXCEPTION1("Convex mesh Face %lu detected as concave", f);
+			}
+			for (size_t i = 0; i < facesOriginal[f].edges.size(); i++) {
+				if (mesh.faces[f][i] != facesOriginal[f][i]) {
+					_EXCEPTIONT("ConvexifyMesh modified a convex mesh");
+				}
+			}
+		}
+	}
+
+	// Regional mesh consisting of a concave dart and the convex
+	// quadrilateral that fills its notch, in the plane tangent to (1,0,0)
+	{
+		const Real dDart[4][2] = {{0.0, 0.0}, {2.0, 0.0}, {0.8, 0.8}, {0.0, 2.0}};
+		const Real dFill[4][2] = {{2.0, 0.0}, {2.0, 2.0}, {0.0, 2.0}, {0.8, 0.8}};
+
+		std::vector<Node> vecDart(4);
+		std::vector<Node> vecFill(4);
+		for (int i = 0; i < 4; i++) {
+			vecDart[i] = Node(1.0, 0.1 * dDart[i][0], 0.1 * dDart[i][1]).Normalized();
+			vecFill[i] = Node(1.0, 0.1 * dFill[i][0], 0.1 * dFill[i][1]).Normalized();
+		}
+
+		Mesh mesh;
+		AppendFaceWithDuplicateNodes(mesh, vecDart);
+		AppendFaceWithDuplicateNodes(mesh, vecFill);
+		mesh.RemoveCoincidentNodes();
+
+		if (mesh.nodes.size() != 5) {
+			_EXCEPTION1("Concave mesh has %lu nodes after merge (expected 5)",
+				mesh.nodes.size());
+		}
+		if ((mesh.faces[0][1] != mesh.faces[1][0]) ||
+		    (mesh.faces[0][2] != mesh.faces[1][3]) ||
+		    (mesh.faces[0][3] != mesh.faces[1][2])
+		) {
+			_EXCEPTIONT("Shared nodes of concave mesh not merged");
+		}
+		if (!IsFaceConcave(mesh.faces[0], mesh.nodes)) {
+			_EXCEPTIONT("Concave Face not detected after merge");
+		}
+		if (IsFaceConcave(mesh.faces[1], mesh.nodes)) {
+			_EXCEPTIONT("Convex Face detected as concave after merge");
+		}
+	}
+
+	// Nodes at and just past the tolerance, straddling cell boundaries and
+	// within the tolerance of several unique nodes.  The tolerance and
+	// coordinates are powers of two so that offsets are exact; 0.5, 0.25
+	// and 0.125 lie on boundaries of the spatial hash cells of size 2 dTol.
+	{
+		const double dTol = ldexp(1.0, -20);
+		const Node nodeBase(0.5, 0.25, 0.125);
+
+		NodeVector nodesAt;
+		nodesAt.push_back(nodeBase);
+		nodesAt.push_back(Node(0.5 + dTol, 0.25, 0.125));
+		if (CheckRemoveCoincidentNodes(nodesAt, dTol) != 1) {
+			_EXCEPTIONT("Node at the tolerance not merged");
+		}
+
+		NodeVector nodesPast;
+		nodesPast.push_back(nodeBase);
+		nodesPast.push_back(Node(0.5 + dTol + ldexp(dTol, -20), 0.25, 0.125));
+		if (CheckRemoveCoincidentNodes(nodesPast, dTol) != 2) {
+			_EXCEPTIONT("Node just past the tolerance merged");
+		}
+
+		NodeVector nodesStraddle;
+		nodesStraddle.push_back(
+			Node(0.5 - 0.25 * dTol, 0.25 - 0.25 * dTol, 0.125 - 0.25 * dTol));
+		nodesStraddle.push_back(
+			Node(0.5 + 0.25 * dTol, 0.25 + 0.25 * dTol, 0.125 + 0.25 * dTol));
+		nodesStraddle.push_back(Node(0.5 + 0.5 * dTol, 0.25, 0.125));
+		if (CheckRemoveCoincidentNodes(nodesStraddle, dTol) != 1) {
+			_EXCEPTIONT("Nodes straddling cell boundaries not merged");
+		}
+
+		// Node 2 is within the tolerance of unique nodes 0 and 1 and merges
+		// into node 0; node 4 is only within the tolerance of node 3, which
+		// merges into node 1, and so is unique
+		NodeVector nodesLowest;
+		nodesLowest.push_back(nodeBase);
+		nodesLowest.push_back(Node(0.5 + 1.5 * dTol, 0.25, 0.125));
+		nodesLowest.push_back(Node(0.5 + 0.75 * dTol, 0.25, 0.125));
+		nodesLowest.push_back(Node(0.5 + 2.25 * dTol, 0.25, 0.125));
+		nodesLowest.push_back(Node(0.5 + 3.125 * dTol, 0.25, 0.125));
+		if (CheckRemoveCoincidentNodes(nodesLowest, dTol) != 3) {
+			_EXCEPTIONT("Lowest indexed node not kept");
+		}
+
+		// Dense random clusters, which exceed the neighbor and scan limits
+		// of the spatial hash and are resolved with its NodeTree fallback
+		srand(34);
+		NodeVector nodesCluster;
+		for (int c = 0; c < 4; c++) {
+			const int nClusterNodes = (c % 2 == 0)?(40):(600);
+			for (int i = 0; i < nClusterNodes; i++) {
+				double dOffset[3];
+				for (int d = 0; d < 3; d++) {
+					dOffset[d] = 3.0 * dTol
+						* (static_cast<double>(rand()) / RAND_MAX - 0.5);
+				}
+				nodesCluster.push_back(Node(
+					0.5 + 8.0 * dTol * c + dOffset[0],
+					0.25 + dOffset[1],
+					0.125 + dOffset[2]));
+			}
+		}
+		CheckRemoveCoincidentNodes(nodesCluster, dTol);
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that the neighbor lists of a SimpleGrid generated from a
+///		Mesh match the sorted neighbor sets built directly from the edge map
+///		(finite volume) and from the GLL node numbering (finite element), on
+///		a mesh with holes and so one-sided edges.
+///	</summary>
+void TestSimpleGridFromMesh() {
+	AnnounceStartBlock("Testing SimpleGrid from Mesh");
+
+	Mesh mesh;
+	GenerateCubedSphereWithDuplicateNodes(4, mesh);
+	mesh.RemoveCoincidentNodes();
+
+	// Punch holes in the mesh
+	FaceVector faces;
+	for (size_t f = 0; f < mesh.faces.size(); f++) {
+		if (f % 7 != 3) {
+			faces.push_back(mesh.faces[f]);
+		}
+	}
+	mesh.faces = faces;
+	mesh.CalculateFaceAreas(false);
+	mesh.ConstructEdgeMap();
+
+	const size_t sFaces = mesh.faces.size();
+
+	// Finite volume reference connectivity
+	std::vector< std::set<int> > vecSetFV(sFaces);
+	size_t sOneSidedEdges = 0;
+	EdgeMapConstIterator iterEdgeMap = mesh.edgemap.begin();
+	for (; iterEdgeMap != mesh.edgemap.end(); iterEdgeMap++) {
+		const FacePair & facepr = iterEdgeMap->second;
+		if ((facepr[0] == InvalidFace) || (facepr[1] == InvalidFace)) {
+			sOneSidedEdges++;
+			continue;
+		}
+		vecSetFV[facepr[0]].insert(facepr[1]);
+		vecSetFV[facepr[1]].insert(facepr[0]);
+	}
+	if (sOneSidedEdges == 0) {
+		_EXCEPTIONT("Test mesh has no one-sided edges");
+	}
+
+	SimpleGrid gridFV;
+	gridFV.FromMeshFV(mesh);
+
+	std::vector<int> vecNeighbors;
+	for (size_t i = 0; i < sFaces; i++) {
+		gridFV.GetNeighbors(i, vecNeighbors);
+		if ((gridFV.GetNeighborCount(i) != vecSetFV[i].size()) ||
+		    (vecNeighbors.size() != vecSetFV[i].size()) ||
+		    !std::equal(vecNeighbors.begin(), vecNeighbors.end(),
+		        vecSetFV[i].begin())
+		) {
+			_EXCEPTION1("FromMeshFV neighbors of Face %lu do not match", i);
+		}
+	}
+
+	// Finite element reference connectivity
+	const int nP = 4;
+
+	DataArray3D<int> dataGLLnodes(nP, nP, sFaces);
+	DataArray3D<double> dataGLLJacobian(nP, nP, sFaces);
+	GenerateMetaData(mesh, nP, true, dataGLLnodes, dataGLLJacobian);
+
+	SimpleGrid gridFE;
+	gridFE.FromMeshFE(mesh, true, nP);
+
+	const size_t sNodes = gridFE.m_dLon.GetRows();
+	std::vector< std::set<int> > vecSetFE(sNodes);
+	for (size_t f = 0; f < sFaces; f++) {
+		for (int q = 0; q < nP; q++) {
+		for (int p = 0; p < nP; p++) {
+			std::set<int> & setLocal = vecSetFE[dataGLLnodes[q][p][f]-1];
+			if (p != 0) {
+				setLocal.insert(dataGLLnodes[q][p-1][f]-1);
+			}
+			if (p != nP-1) {
+				setLocal.insert(dataGLLnodes[q][p+1][f]-1);
+			}
+			if (q != 0) {
+				setLocal.insert(dataGLLnodes[q-1][p][f]-1);
+			}
+			if (q != nP-1) {
+				setLocal.insert(dataGLLnodes[q+1][p][f]-1);
+			}
+		}
+		}
+	}
+
+	for (size_t i = 0; i < sNodes; i++) {
+		gridFE.GetNeighbors(i, vecNeighbors);
+		if ((gridFE.GetNeighborCount(i) != vecSetFE[i].size()) ||
+		    (vecNeighbors.size() != vecSetFE[i].size()) ||
+		    !std::equal(vecNeighbors.begin(), vecNeighbors.end(),
+		        vecSetFE[i].begin())
+		) {
+			_EXCEPTION1("FromMeshFE neighbors of node %lu do not match", i);
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate a global latitude-longitude mesh with nLat rows of nLon
+///		Faces.  Rows adjacent to the poles are triangles sharing the pole
+///		node, and edges along lines of latitude are constant latitude edges.
+///	</summary>
+void GenerateLatitudeLongitudeMesh(
+	int nLat,
+	int nLon,
+	Mesh & mesh
+) {
+	mesh.Clear();
+
+	mesh.nodes.push_back(Node(0.0, 0.0, -1.0));
+	for (int j = 1; j < nLat; j++) {
+		const Real dLat = (-0.5 + static_cast<Real>(j) / nLat) * M_PI;
+		for (int i = 0; i < nLon; i++) {
+			const Real dLon = static_cast<Real>(i) / nLon * 2.0 * M_PI;
+			mesh.nodes.push_back(Node(
+				cos(dLat) * cos(dLon), cos(dLat) * sin(dLon), sin(dLat)));
+		}
+	}
+	mesh.nodes.push_back(Node(0.0, 0.0, 1.0));
+
+	const int ixNorthPole = static_cast<int>(mesh.nodes.size()) - 1;
+
+	for (int j = 0; j < nLat; j++) {
+	for (int i = 0; i < nLon; i++) {
+		const int ixLower0 = 1 + (j-1) * nLon + i;
+		const int ixLower1 = 1 + (j-1) * nLon + (i + 1) % nLon;
+		const int ixUpper0 = 1 + j * nLon + i;
+		const int ixUpper1 = 1 + j * nLon + (i + 1) % nLon;
+
+		if (j == 0) {
+			Face face(3);
+			face.SetNode(0, 0);
+			face.SetNode(1, ixUpper1);
+			face.SetNode(2, ixUpper0);
+			face.edges[1].type = Edge::Type_ConstantLatitude;
+			mesh.faces.push_back(face);
+
+		} else if (j == nLat-1) {
+			Face face(3);
+			face.SetNode(0, ixLower0);
+			face.SetNode(1, ixLower1);
+			face.SetNode(2, ixNorthPole);
+			face.edges[0].type = Edge::Type_ConstantLatitude;
+			mesh.faces.push_back(face);
+
+		} else {
+			Face face(4);
+			face.SetNode(0, ixLower0);
+			face.SetNode(1, ixLower1);
+			face.SetNode(2, ixUpper1);
+			face.SetNode(3, ixUpper0);
+			face.edges[0].type = Edge::Type_ConstantLatitude;
+			face.edges[2].type = Edge::Type_ConstantLatitude;
+			mesh.faces.push_back(face);
+		}
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate query nodes for locating on a mesh: nRandom random nodes
+///		followed by every mesh node and the midpoint of every Face edge.
+///	</summary>
+void GenerateMeshQueryNodes(
+	const Mesh & mesh,
+	int nRandom,
+	NodeVector & nodesQuery
+) {
+	nodesQuery.clear();
+
+	while (static_cast<int>(nodesQuery.size()) < nRandom) {
+		Node node(
+			2.0 * static_cast<Real>(rand()) / RAND_MAX - 1.0,
+			2.0 * static_cast<Real>(rand()) / RAND_MAX - 1.0,
+			2.0 * static_cast<Real>(rand()) / RAND_MAX - 1.0);
+		const Real dMag2 = node.x * node.x + node.y * node.y + node.z * node.z;
+		if ((dMag2 > 1.0) || (dMag2 < 1.0e-2)) {
+			continue;
+		}
+		nodesQuery.push_back(node.Normalized());
+	}
+
+	nodesQuery.insert(nodesQuery.end(), mesh.nodes.begin(), mesh.nodes.end());
+
+	for (size_t f = 0; f < mesh.faces.size(); f++) {
+		const Face & face = mesh.faces[f];
+		for (size_t i = 0; i < face.edges.size(); i++) {
+			const Node & node0 = mesh.nodes[face.edges[i][0]];
+			const Node & node1 = mesh.nodes[face.edges[i][1]];
+			if (face.edges[i].type == Edge::Type_ConstantLatitude) {
+				const Real dRadius = sqrt(1.0 - node0.z * node0.z);
+				Node nodeMid(node0.x + node1.x, node0.y + node1.y, 0.0);
+				const Real dMag = sqrt(nodeMid.x * nodeMid.x + nodeMid.y * nodeMid.y);
+				nodesQuery.push_back(Node(
+					dRadius * nodeMid.x / dMag,
+					dRadius * nodeMid.y / dMag,
+					node0.z));
+			} else {
+				nodesQuery.push_back(Node(
+					node0.x + node1.x,
+					node0.y + node1.y,
+					node0.z + node1.z).Normalized());
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Find all Faces containing the given Node by testing every Face.
+///	</summary>
+void FindAllFacesContainingNode(
+	const MeshUtilitiesFuzzy & utils,
+	const Mesh & mesh,
+	const Node & node,
+	std::vector<int> & vecFaces
+) {
+	vecFaces.clear();
+	for (size_t f = 0; f < mesh.faces.size(); f++) {
+		Face::NodeLocation loc;
+		int ixLocation;
+		utils.ContainsNode(mesh.faces[f], mesh.nodes, node, loc, ixLocation);
+		if (loc != Face::NodeLocation_Exterior) {
+			vecFaces.push_back(static_cast<int>(f));
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that FindFaceFromNode with the FaceCapTree finds the same
+///		Faces as testing every Face, on random nodes, mesh nodes and edge
+///		midpoints of a cubed-sphere and a latitude-longitude mesh.
+///	</summary>
+void TestFindFaceFromNode() {
+	AnnounceStartBlock("Testing FindFaceFromNode");
+
+	srand(35);
+
+	for (int m = 0; m < 2; m++) {
+		Mesh mesh;
+		if (m == 0) {
+			GenerateCubedSphereWithDuplicateNodes(6, mesh);
+			mesh.RemoveCoincidentNodes();
+		} else {
+			GenerateLatitudeLongitudeMesh(9, 16, mesh);
+		}
+
+		NodeVector nodesQuery;
+		GenerateMeshQueryNodes(mesh, 2000, nodesQuery);
+
+		MeshUtilitiesFuzzy utils;
+
+		// Reference results from testing every Face
+		std::vector<FindFaceStruct> vecReference(nodesQuery.size());
+		for (size_t i = 0; i < nodesQuery.size(); i++) {
+			utils.FindFaceFromNode(mesh, nodesQuery[i], vecReference[i]);
+		}
+
+		mesh.ConstructFaceTree();
+
+		std::vector<int> vecCandidates;
+		std::vector<int> vecContaining;
+		for (size_t i = 0; i < nodesQuery.size(); i++) {
+			FindAllFacesContainingNode(utils, mesh, nodesQuery[i], vecContaining);
+			if (vecContaining.size() == 0) {
+				_EXCEPTION2("Mesh %i: no Face contains query node %lu", m, i);
+			}
+
+			mesh.facetree.FindCandidateFaces(nodesQuery[i], vecCandidates);
+			if (!std::includes(
+					vecCandidates.begin(), vecCandidates.end(),
+					vecContaining.begin(), vecContaining.end())
+			) {
+				_EXCEPTION2("Mesh %i: FaceCapTree missed a Face containing "
+					"query node %lu", m, i);
+			}
+
+			FindFaceStruct aFindFaceStruct;
+			utils.FindFaceFromNode(mesh, nodesQuery[i], aFindFaceStruct);
+
+			if ((aFindFaceStruct.loc != vecReference[i].loc) ||
+			    (aFindFaceStruct.vecFaceIndices != vecReference[i].vecFaceIndices) ||
+			    (aFindFaceStruct.vecFaceLocations != vecReference[i].vecFaceLocations)
+			) {
+				_EXCEPTION2("Mesh %i: FindFaceFromNode results differ with "
+					"FaceCapTree for query node %lu", m, i);
+			}
+			if ((aFindFaceStruct.vecFaceIndices.size() == 0) ||
+			    (aFindFaceStruct.vecFaceIndices[0] != vecContaining[0])
+			) {
+				_EXCEPTION2("Mesh %i: FindFaceFromNode did not find the lowest "
+					"Face containing query node %lu", m, i);
+			}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that FindFacesFromNodes returns the lowest indexed Face
+///		containing each Node, as found by testing every Face.  Nodes on
+///		shared edges and corners must resolve to the lowest index Face
+///		whichever Face the walk arrives from.
+///	</summary>
+void TestFindFacesFromNodes() {
+	AnnounceStartBlock("Testing FindFacesFromNodes");
+
+	srand(36);
+
+	for (int m = 0; m < 3; m++) {
+		Mesh mesh;
+		if (m == 2) {
+			GenerateLatitudeLongitudeMesh(9, 16, mesh);
+		} else {
+			GenerateCubedSphereWithDuplicateNodes(6, mesh);
+			mesh.RemoveCoincidentNodes();
+		}
+
+		// Punch holes in the second mesh, which stop walks at one-sided
+		// edges and leave some nodes outside every Face
+		if (m == 1) {
+			FaceVector faces;
+			for (size_t f = 0; f < mesh.faces.size(); f++) {
+				if (f % 7 != 3) {
+					faces.push_back(mesh.faces[f]);
+				}
+			}
+			mesh.faces = faces;
+		}
+
+		mesh.ConstructEdgeMap();
+
+		// Random nodes, a spatially coherent track, and then mesh nodes and
+		// edge midpoints, which lie on Faces in the order of the mesh
+		NodeVector nodesQuery;
+		GenerateMeshQueryNodes(mesh, 1000, nodesQuery);
+
+		NodeVector nodesTrack;
+		for (int i = 0; i < 2000; i++) {
+			const Real dT = static_cast<Real>(i) / 2000.0;
+			const Real dLat = (0.49 - 0.98 * dT) * M_PI;
+			const Real dLon = 12.0 * M_PI * dT;
+			nodesTrack.push_back(Node(
+				cos(dLat) * cos(dLon), cos(dLat) * sin(dLon), sin(dLat)));
+		}
+		nodesQuery.insert(nodesQuery.begin() + 1000,
+			nodesTrack.begin(), nodesTrack.end());
+
+		MeshUtilitiesFuzzy utils;
+
+		std::vector<int> vecLowest(nodesQuery.size());
+		std::vector<int> vecContaining;
+		size_t sShared = 0;
+		size_t sOutside = 0;
+		for (size_t i = 0; i < nodesQuery.size(); i++) {
+			FindAllFacesContainingNode(utils, mesh, nodesQuery[i], vecContaining);
+			if (vecContaining.size() == 0) {
+				vecLowest[i] = InvalidFace;
+				sOutside++;
+			} else {
+				vecLowest[i] = vecContaining[0];
+			}
+			if (vecContaining.size() > 1) {
+				sShared++;
+			}
+		}
+		if ((sShared == 0) || ((m == 1) && (sOutside == 0))) {
+			_EXCEPTION1("Mesh %i: query nodes do not cover shared edges "
+				"or holes", m);
+		}
+
+		const int nChunkSizes[3] = {1, 16, 1024};
+
+		for (int t = 0; t < 2; t++) {
+			if (t == 1) {
+				mesh.ConstructFaceTree();
+			}
+			for (int c = 0; c < 3; c++) {
+				std::vector<int> vecFaceIndices;
+				utils.FindFacesFromNodes(
+					mesh, nodesQuery, vecFaceIndices, nChunkSizes[c]);
+
+				for (size_t i = 0; i < nodesQuery.size(); i++) {
+					if (vecFaceIndices[i] != vecLowest[i]) {
+						_EXCEPTION4("Mesh %i: FindFacesFromNodes returned Face "
+							"%i for query node %lu (expected %i)",
+							m, vecFaceIndices[i], i, vecLowest[i]);
+					}
+				}
+			}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Reference edge map with the std::map used by Mesh::EdgeMap before
+///		it was stored as a flat table.
+///	</summary>
+typedef std::map<Edge, FacePair> EdgeMapReference;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that two EdgePairs hold the same Edge, with the same
+///		orientation and type, and the same FacePair.
+///	</summary>
+void CheckEdgePair(
+	const EdgePair & edgepr,
+	const EdgePair & edgeprRef,
+	const char * szContext
+) {
+	if ((edgepr.first.node[0] != edgeprRef.first.node[0]) ||
+	    (edgepr.first.node[1] != edgeprRef.first.node[1]) ||
+	    (edgepr.first.type != edgeprRef.first.type) ||
+	    (edgepr.second[0] != edgeprRef.second[0]) ||
+	    (edgepr.second[1] != edgeprRef.second[1])
+	) {
+		_EXCEPTION6("%s: Edge (%i, %i) of type %i with Faces (%i, %i) "
+			"does not match the reference map",
+			szContext,
+			edgepr.first.node[0], edgepr.first.node[1],
+			static_cast<int>(edgepr.first.type),
+			edgepr.second[0], edgepr.second[1]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that an EdgeMap iterates over the same EdgePairs as a
+///		reference map, in the same order.
+///	</summary>
+void CheckEdgeMap(
+	const EdgeMap & edgemap,
+	const EdgeMapReference & edgemapRef,
+	const char * szContext
+) {
+	if (edgemap.size() != edgemapRef.size()) {
+		_EXCEPTION3("%s: EdgeMap has %lu Edges (expected %lu)",
+			szContext, edgemap.size(), edgemapRef.size());
+	}
+
+	EdgeMapConstIterator iter = edgemap.begin();
+	EdgeMapReference::const_iterator iterRef = edgemapRef.begin();
+	for (; iterRef != edgemapRef.end(); iter++, iterRef++) {
+		CheckEdgePair(*iter, *iterRef, szContext);
+	}
+	if (iter != edgemap.end()) {
+		_EXCEPTION1("%s: EdgeMap iteration does not end", szContext);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that Mesh::ConstructEdgeMap matches the reference map built
+///		by inserting every non-zero Edge of every Face, in Face order.
+///	</summary>
+void CheckConstructEdgeMap(
+	Mesh & mesh,
+	const char * szContext
+) {
+	EdgeMapReference edgemapRef;
+	for (size_t f = 0; f < mesh.faces.size(); f++) {
+		const Face & face = mesh.faces[f];
+		const int nEdges = face.edges.size();
+		for (int k = 0; k < nEdges; k++) {
+			if (face[k] == face[(k+1)%nEdges]) {
+				continue;
+			}
+			Edge edge(face[k], face[(k+1)%nEdges]);
+			edgemapRef.insert(EdgeMapReference::value_type(
+				edge, FacePair())).first->second.AddFace(f);
+		}
+	}
+
+	mesh.ConstructEdgeMap();
+	CheckEdgeMap(mesh.edgemap, edgemapRef, szContext);
+
+	// Construct again from the compact representation of the Faces
+	mesh.ConstructCompactFaces();
+	mesh.ConstructEdgeMap();
+	CheckEdgeMap(mesh.edgemap, edgemapRef, szContext);
+	mesh.ConstructFacesFromCompact();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that EdgeMap find, insert and iteration match a std::map,
+///		including insertion of Edges that are already present in either
+///		orientation, and that Mesh::ConstructEdgeMap matches the map built
+///		one Edge at a time on meshes with one-sided and degenerate Edges.
+///	</summary>
+void TestEdgeMap() {
+	AnnounceStartBlock("Testing EdgeMap");
+
+	srand(32);
+
+	// Random insertions and lookups
+	const int nNodes = 40;
+
+	EdgeMap edgemap;
+	EdgeMapReference edgemapRef;
+
+	for (int n = 0; n < 2000; n++) {
+		int ixNode0 = rand() % nNodes;
+		int ixNode1 = rand() % (nNodes - 1);
+		if (ixNode1 >= ixNode0) {
+			ixNode1++;
+		}
+		const Edge::Type type =
+			(rand() % 2 == 0)?(Edge::Type_Default):(Edge::Type_ConstantLatitude);
+
+		EdgePair edgepr(Edge(ixNode0, ixNode1, type), FacePair());
+		edgepr.second.AddFace(n);
+
+		std::pair<EdgeMapIterator, bool> prInsert = edgemap.insert(edgepr);
+		std::pair<EdgeMapReference::iterator, bool> prInsertRef =
+			edgemapRef.insert(edgepr);
+
+		if (prInsert.second != prInsertRef.second) {
+			_EXCEPTION3("insert of Edge (%i, %i) returned %i",
+				ixNode0, ixNode1, static_cast<int>(prInsert.second));
+		}
+		CheckEdgePair(*(prInsert.first), *(prInsertRef.first), "insert");
+
+		// Add a second Face to Edges that are inserted twice
+		if ((!prInsert.second) && (!prInsert.first->second.IsComplete())) {
+			prInsert.first->second.AddFace(n);
+			prInsertRef.first->second.AddFace(n);
+		}
+
+		// Look up a random Edge, in either orientation
+		const Edge edgeFind(rand() % nNodes, rand() % nNodes);
+
+		EdgeMapIterator iterFind = edgemap.find(edgeFind);
+		EdgeMapConstIterator iterFindConst =
+			static_cast<const EdgeMap &>(edgemap).find(edgeFind);
+		EdgeMapReference::iterator iterFindRef = edgemapRef.find(edgeFind);
+
+		if (iterFind != iterFindConst) {
+			_EXCEPTIONT("find and const find differ");
+		}
+		if (iterFindRef == edgemapRef.end()) {
+			if (iterFind != edgemap.end()) {
+				_EXCEPTION2("find of absent Edge (%i, %i) did not return end()",
+					edgeFind[0], edgeFind[1]);
+			}
+		} else {
+			if (iterFind == edgemap.end()) {
+				_EXCEPTION2("find of Edge (%i, %i) returned end()",
+					edgeFind[0], edgeFind[1]);
+			}
+			CheckEdgePair(*iterFind, *iterFindRef, "find");
+		}
+
+		if (n % 100 == 0) {
+			CheckEdgeMap(edgemap, edgemapRef, "insert");
+		}
+	}
+	CheckEdgeMap(edgemap, edgemapRef, "insert");
+
+	// Replacing the contents from a sorted table
+	EdgeMapVector vecEdges(edgemapRef.begin(), edgemapRef.end());
+	edgemap.clear();
+	if (edgemap.size() != 0) {
+		_EXCEPTIONT("clear did not empty the EdgeMap");
+	}
+	edgemap.assign(vecEdges);
+	CheckEdgeMap(edgemap, edgemapRef, "assign");
+
+	// Global latitude-longitude mesh with holes, where every fifth
+	// quadrilateral is split into two degenerate quadrilaterals
+	Mesh meshBase;
+	GenerateLatitudeLongitudeMesh(12, 24, meshBase);
+
+	Mesh mesh;
+	mesh.nodes = meshBase.nodes;
+	for (size_t f = 0; f < meshBase.faces.size(); f++) {
+		const Face & face = meshBase.faces[f];
+		if (f % 7 == 3) {
+			continue;
+		}
+		if ((f % 5 == 0) && (face.edges.size() == 4)) {
+			const int ixFirst[4] = {face[0], face[1], face[2], face[2]};
+			const int ixSecond[4] = {face[2], face[3], face[0], face[0]};
+
+			Face faceFirst(4);
+			Face faceSecond(4);
+			for (int i = 0; i < 4; i++) {
+				faceFirst.SetNode(i, ixFirst[i]);
+				faceSecond.SetNode(i, ixSecond[i]);
+			}
+			mesh.faces.push_back(faceFirst);
+			mesh.faces.push_back(faceSecond);
+
+		} else {
+			mesh.faces.push_back(face);
+		}
+	}
+	CheckConstructEdgeMap(mesh, "ConstructEdgeMap (latitude-longitude)");
+
+	// Cubed sphere
+	Mesh meshCS;
+	GenerateCubedSphereWithDuplicateNodes(6, meshCS);
+	meshCS.RemoveCoincidentNodes();
+	CheckConstructEdgeMap(meshCS, "ConstructEdgeMap (cubed sphere)");
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that a quadrature rule on [-1,1] integrates all monomials up
+///		to the given degree to within the given tolerance.
+///	</summary>
+void CheckQuadratureExactness(
+	const char * szRule,
+	int nCount,
+	int nDegree,
+	const double * dG,
+	const double * dW,
+	double dTolerance
+) {
+	for (int p = 0; p <= nDegree; p++) {
+		double dSum = 0.0;
+		for (int k = 0; k < nCount; k++) {
+			dSum += dW[k] * pow(dG[k], p);
+		}
+
+		double dExact = (p % 2 == 0)?(2.0 / static_cast<double>(p + 1)):(0.0);
+
+		if (fabs(dSum - dExact) > dTolerance) {
+			_EXCEPTION5("%s quadrature with %i points not exact for x^%i "
+				"(%1.5e, expected %1.5e)",
+				szRule, nCount, p, dSum, dExact);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that Gauss and Gauss-Lobatto quadrature are exact for
+///		monomials of degree 2n-1 and 2n-3, respectively, both for
+///		tabulated and computed numbers of points.
+///	</summary>
+void TestQuadratureExactness() {
+	AnnounceStartBlock("Testing quadrature exactness");
+
+	// Tabulated rules are correctly rounded; computed rules are accurate
+	// to a few units in the last place
+	const int nTabulatedMaxCount = 16;
+	const int nMaxCount = 24;
+	const double dTabulatedTolerance = 5.0e-16;
+	const double dComputedTolerance = 5.0e-15;
+
+	for (int n = 1; n <= nMaxCount; n++) {
+		const double * dG;
+		const double * dW;
+
+		const double dTolerance =
+			(n <= nTabulatedMaxCount)
+				?(dTabulatedTolerance):(dComputedTolerance);
+
+		GaussQuadrature::GetCachedPoints(n, dG, dW);
+		CheckQuadratureExactness("Gauss", n, 2 * n - 1, dG, dW, dTolerance);
+
+		if (n >= 2) {
+			GaussLobattoQuadrature::GetCachedPoints(n, dG, dW);
+			CheckQuadratureExactness(
+				"Gauss-Lobatto", n, 2 * n - 3, dG, dW, dTolerance);
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that GenerateMetaData assigns the same index to GLL nodes
+///		at the same location, and distinct indices otherwise, on a mesh
+///		where neighboring Faces start at different corners (so shared
+///		edges are traversed in both directions) and some quadrilaterals
+///		are degenerate.
+///	</summary>
+void TestGLLNumbering() {
+	AnnounceStartBlock("Testing GLL numbering");
+
+	Mesh meshBase;
+	GenerateCubedSphereWithDuplicateNodes(3, meshBase);
+	meshBase.RemoveCoincidentNodes();
+
+	// Rotate the starting corner of each Face and split every fifth Face
+	// into two degenerate quadrilaterals along a diagonal
+	Mesh mesh;
+	mesh.nodes = meshBase.nodes;
+
+	for (size_t f = 0; f < meshBase.faces.size(); f++) {
+		const Face & face = meshBase.faces[f];
+
+		int ix[4];
+		for (int i = 0; i < 4; i++) {
+			ix[i] = face[(i + f) % 4];
+		}
+
+		if (f % 5 == 0) {
+			const int ixFirst[4] = {ix[0], ix[1], ix[2], ix[2]};
+			const int ixSecond[4] = {ix[2], ix[3], ix[0], ix[0]};
+
+			Face faceFirst(4);
+			Face faceSecond(4);
+			for (int i = 0; i < 4; i++) {
+				faceFirst.SetNode(i, ixFirst[i]);
+				faceSecond.SetNode(i, ixSecond[i]);
+			}
+			mesh.faces.push_back(faceFirst);
+			mesh.faces.push_back(faceSecond);
+
+		} else {
+			Face faceRotated(4);
+			for (int i = 0; i < 4; i++) {
+				faceRotated.SetNode(i, ix[i]);
+			}
+			mesh.faces.push_back(faceRotated);
+		}
+	}
+
+	mesh.ConstructEdgeMap();
+
+	const int nP = 4;
+
+	DataArray3D<int> dataGLLnodes;
+	DataArray3D<double> dataGLLJacobian;
+	double dArea =
+		GenerateMetaData(mesh, nP, false, dataGLLnodes, dataGLLJacobian);
+
+	if (fabs(dArea - 4.0 * M_PI) > 1.0e-3) {
+		_EXCEPTION1("Incorrect total area (%1.15e)", dArea);
+	}
+
+	// Location of each GLL node, which must agree between all Faces
+	// referencing the same index
+	DataArray1D<double> dG;
+	DataArray1D<double> dW;
+	GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
+
+	std::vector<Node> vecGLLNodes;
+	std::vector<bool> vecAssigned;
+
+	for (size_t k = 0; k < mesh.faces.size(); k++) {
+	for (int j = 0; j < nP; j++) {
+	for (int i = 0; i < nP; i++) {
+		Node node;
+		ApplyLocalMap(mesh.faces[k], mesh.nodes, dG[i], dG[j], node);
+
+		const int ix = dataGLLnodes[j][i][k];
+		if (ix < 1) {
+			_EXCEPTION1("Invalid GLL node index (%i)", ix);
+		}
+		if (static_cast<size_t>(ix) > vecGLLNodes.size()) {
+			vecGLLNodes.resize(ix);
+			vecAssigned.resize(ix, false);
+		}
+
+		if (!vecAssigned[ix-1]) {
+			vecGLLNodes[ix-1] = node;
+			vecAssigned[ix-1] = true;
+
+		} else if ((vecGLLNodes[ix-1] - node).Magnitude() > 1.0e-12) {
+			_EXCEPTION1("GLL node %i assigned to distinct locations", ix);
+		}
+	}
+	}
+	}
+
+	for (size_t n = 0; n < vecAssigned.size(); n++) {
+		if (!vecAssigned[n]) {
+			_EXCEPTION1("GLL node %lu not referenced", n+1);
+		}
+	}
+
+	// Distinct indices must have distinct locations
+	std::vector< std::pair<double, int> > vecSortedX(vecGLLNodes.size());
+	for (size_t n = 0; n < vecGLLNodes.size(); n++) {
+		vecSortedX[n] = std::pair<double, int>(vecGLLNodes[n].x, n);
+	}
+	std::sort(vecSortedX.begin(), vecSortedX.end());
+
+	for (size_t n = 0; n < vecSortedX.size(); n++) {
+		for (size_t m = n + 1; m < vecSortedX.size(); m++) {
+			if (vecSortedX[m].first - vecSortedX[n].first > 1.0e-8) {
+				break;
+			}
+			const Node & node0 = vecGLLNodes[vecSortedX[n].second];
+			const Node & node1 = vecGLLNodes[vecSortedX[m].second];
+			if ((node0 - node1).Magnitude() < 1.0e-8) {
+				_EXCEPTION2("GLL nodes %i and %i have the same location",
+					vecSortedX[n].second + 1, vecSortedX[m].second + 1);
+			}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that the batched ApplyInverseMap agrees with the single-point
+///		version to round-off and recovers the local coordinates of points
+///		mapped from random locations and from near the corners of each Face,
+///		with points of different Faces interleaved within each block.
+///	</summary>
+void TestInverseMapBatch() {
+	AnnounceStartBlock("Testing batched ApplyInverseMap");
+
+	srand(43);
+
+	// Local coordinates near the Face edges
+	const double dEdgeCoord[6] =
+		{0.0, 1.0e-12, 1.0e-6, 1.0 - 1.0e-6, 1.0 - 1.0e-12, 1.0};
+
+	for (int m = 0; m < 2; m++) {
+		Mesh mesh;
+		if (m == 0) {
+			GenerateCubedSphereWithDuplicateNodes(4, mesh);
+			mesh.RemoveCoincidentNodes();
+
+		} else {
+			// Quadrilaterals of a latitude-longitude mesh, including those
+			// adjacent to the polar triangles
+			Mesh meshLatLon;
+			GenerateLatitudeLongitudeMesh(9, 16, meshLatLon);
+			mesh.nodes = meshLatLon.nodes;
+			for (size_t f = 0; f < meshLatLon.faces.size(); f++) {
+				if (meshLatLon.faces[f].edges.size() == 4) {
+					mesh.faces.push_back(meshLatLon.faces[f]);
+				}
+			}
+		}
+
+		// Points on every Face, with random Faces and local coordinates
+		// followed by every combination of near-edge coordinates on each
+		// Face, in random Face order
+		std::vector<int> vecFace;
+		std::vector<double> vecAlphaExact;
+		std::vector<double> vecBetaExact;
+
+		const int nFaces = static_cast<int>(mesh.faces.size());
+		for (int n = 0; n < 20 * nFaces + 7; n++) {
+			vecFace.push_back(rand() % nFaces);
+			vecAlphaExact.push_back(
+				static_cast<double>(rand()) / static_cast<double>(RAND_MAX));
+			vecBetaExact.push_back(
+				static_cast<double>(rand()) / static_cast<double>(RAND_MAX));
+		}
+
+		std::vector<int> vecFaceOrder(nFaces);
+		for (int f = 0; f < nFaces; f++) {
+			vecFaceOrder[f] = f;
+		}
+		for (int f = nFaces - 1; f > 0; f--) {
+			std::swap(vecFaceOrder[f], vecFaceOrder[rand() % (f + 1)]);
+		}
+		for (int i = 0; i < 6; i++) {
+		for (int j = 0; j < 6; j++) {
+			for (int f = 0; f < nFaces; f++) {
+				vecFace.push_back(vecFaceOrder[f]);
+				vecAlphaExact.push_back(dEdgeCoord[i]);
+				vecBetaExact.push_back(dEdgeCoord[j]);
+			}
+		}
+		}
+
+		const size_t sCount = vecFace.size();
+
+		std::vector<double> vecX(sCount);
+		std::vector<double> vecY(sCount);
+		std::vector<double> vecZ(sCount);
+		for (size_t s = 0; s < sCount; s++) {
+			Node node;
+			ApplyLocalMap(
+				mesh.faces[vecFace[s]], mesh.nodes,
+				vecAlphaExact[s], vecBetaExact[s], node);
+			vecX[s] = node.x;
+			vecY[s] = node.y;
+			vecZ[s] = node.z;
+		}
+
+		std::vector<double> vecAlpha(sCount);
+		std::vector<double> vecBeta(sCount);
+		ApplyInverseMap(
+			mesh.faces, mesh.nodes, sCount, &(vecFace[0]),
+			&(vecX[0]), &(vecY[0]), &(vecZ[0]),
+			&(vecAlpha[0]), &(vecBeta[0]));
+
+		for (size_t s = 0; s < sCount; s++) {
+			double dAlpha;
+			double dBeta;
+			ApplyInverseMap(
+				mesh.faces[vecFace[s]], mesh.nodes,
+				Node(vecX[s], vecY[s], vecZ[s]), dAlpha, dBeta);
+
+			if ((fabs(vecAlpha[s] - dAlpha) > 1.0e-14) ||
+			    (fabs(vecBeta[s] - dBeta) > 1.0e-14)
+			) {
+				_EXCEPTION6("Mesh %i point %lu: batched (%1.15e, %1.15e) "
+					"differs from single-point (%1.15e, %1.15e)",
+					m, s, vecAlpha[s], vecBeta[s], dAlpha, dBeta);
+			}
+			if ((fabs(vecAlpha[s] - vecAlphaExact[s]) > 1.0e-10) ||
+			    (fabs(vecBeta[s] - vecBetaExact[s]) > 1.0e-10)
+			) {
+				_EXCEPTION6("Mesh %i point %lu: batched (%1.15e, %1.15e) "
+					"differs from exact (%1.15e, %1.15e)",
+					m, s, vecAlpha[s], vecBeta[s],
+					vecAlphaExact[s], vecBetaExact[s]);
+			}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that images encoded by PNGImage decode to the original
+///		pixels for all filter strategies and a range of compression
+///		levels and strip sizes, for both opaque and translucent images.
+///	</summary>
+void TestPNGRoundTrip() {
+	AnnounceStartBlock("Testing PNG encode and decode");
+
+	const unsigned int nWidth = 301;
+	const unsigned int nHeight = 203;
+
+	const PNGFilterStrategy eStrategies[6] = {
+		PNGFilterStrategy_None,
+		PNGFilterStrategy_Sub,
+		PNGFilterStrategy_Up,
+		PNGFilterStrategy_Average,
+		PNGFilterStrategy_Paeth,
+		PNGFilterStrategy_MinSum
+	};
+	const int nCompressionLevels[4] = {0, 1, 4, 9};
+	const unsigned int nStripRows[3] = {1, 64, 1024};
+
+	for (int iOpaque = 0; iOpaque < 2; iOpaque++) {
+
+		// Smooth gradients with noise, so that all filters are exercised
+		PNGImage img(nWidth, nHeight);
+		for (unsigned int j = 0; j < nHeight; j++) {
+		for (unsigned int i = 0; i < nWidth; i++) {
+			unsigned char * c = &(img[4 * (j * nWidth + i)]);
+			unsigned int uHash = (i * 2654435761u) ^ (j * 40503u);
+			c[0] = static_cast<unsigned char>(i + (uHash >> 29));
+			c[1] = static_cast<unsigned char>(j * 3);
+			c[2] = static_cast<unsigned char>((i * j) >> 4);
+			c[3] = (iOpaque)?(255):(static_cast<unsigned char>(uHash >> 24));
+		}
+		}
+
+		for (int s = 0; s < 6; s++) {
+		for (int l = 0; l < 4; l++) {
+		for (int r = 0; r < 3; r++) {
+			PNGEncoderSettings settings;
+			settings.m_eFilterStrategy = eStrategies[s];
+			settings.m_nCompressionLevel = nCompressionLevels[l];
+			settings.m_nStripRows = nStripRows[r];
+
+			std::vector<unsigned char> vecPNG;
+			img.encode(vecPNG, settings);
+
+			// The decoder verifies chunk checksums
+			std::vector<unsigned char> vecDecoded;
+			unsigned int nDecodedWidth;
+			unsigned int nDecodedHeight;
+			unsigned int uError =
+				lodepng::decode(
+					vecDecoded, nDecodedWidth, nDecodedHeight, vecPNG);
+
+			if (uError != 0) {
+				_EXCEPTION4("Decoding failed (strategy %i, level %i, "
+					"strip rows %u): %s",
+					s, nCompressionLevels[l], nStripRows[r],
+					lodepng_error_text(uError));
+			}
+			if ((nDecodedWidth != nWidth) || (nDecodedHeight != nHeight)) {
+				_EXCEPTION2("Decoded image has incorrect size (%u x %u)",
+					nDecodedWidth, nDecodedHeight);
+			}
+			if ((vecDecoded.size() != img.size()) ||
+			    !std::equal(vecDecoded.begin(), vecDecoded.end(), img.begin())
+			) {
+				_EXCEPTION3("Decoded pixels differ (strategy %i, level %i, "
+					"strip rows %u)",
+					s, nCompressionLevels[l], nStripRows[r]);
+			}
+		}
+		}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Verify that ColorMapLUT matches ColorMap::Sample for colormaps of
+///		several sizes and ranges, on values at and one ulp either side of
+///		every color boundary, values outside the range and random values.
+///	</summary>
+void TestColorMapLUT() {
+	AnnounceStartBlock("Testing ColorMapLUT");
+
+	const size_t nColors[3] = {256, 7, 5000};
+	const float dRanges[3][2] = {{-3.7f, 12.9f}, {0.0f, 1.0f}, {250.0f, -40.0f}};
+
+	srand(47);
+
+	for (int c = 0; c < 3; c++) {
+		ColorMap colormap;
+		colormap.resize(nColors[c], std::vector<unsigned char>(3));
+		for (size_t i = 0; i < nColors[c]; i++) {
+			colormap[i][0] = static_cast<unsigned char>(i % 256);
+			colormap[i][1] = static_cast<unsigned char>((i / 256) % 256);
+			colormap[i][2] = static_cast<unsigned char>((7 * i) % 256);
+		}
+
+		for (int r = 0; r < 3; r++) {
+			const float dMin = dRanges[r][0];
+			const float dMax = dRanges[r][1];
+
+			ColorMapLUT lut;
+			lut.Initialize(colormap, dMin, dMax);
+
+			std::vector<float> vecValues;
+			vecValues.push_back(0.190624967f);
+			vecValues.push_back(dMin - 1.0f);
+			vecValues.push_back(dMax + 1.0f);
+			for (size_t i = 0; i <= nColors[c]; i++) {
+				const float dEdge = dMin + (dMax - dMin)
+					* static_cast<float>(i) / static_cast<float>(nColors[c]);
+				vecValues.push_back(std::nextafter(dEdge, -HUGE_VALF));
+				vecValues.push_back(dEdge);
+				vecValues.push_back(std::nextafter(dEdge, HUGE_VALF));
+			}
+			for (int i = 0; i < 10000; i++) {
+				vecValues.push_back(dMin + (dMax - dMin)
+					* static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
+			}
+
+			std::vector<RGBA> vecColors(vecValues.size());
+			lut.SampleArray(&(vecValues[0]), vecValues.size(), &(vecColors[0]));
+
+			for (size_t i = 0; i < vecValues.size(); i++) {
+				unsigned char cR;
+				unsigned char cG;
+				unsigned char cB;
+				colormap.Sample(vecValues[i], dMin, dMax, cR, cG, cB);
+
+				const RGBA rgba = lut.Sample(vecValues[i]);
+				if ((rgba.r() != cR) || (rgba.g() != cG) || (rgba.b() != cB) ||
+				    (vecColors[i].r() != cR) ||
+				    (vecColors[i].g() != cG) ||
+				    (vecColors[i].b() != cB)
+				) {
+					_EXCEPTION4("ColorMapLUT differs from ColorMap::Sample "
+						"for value %1.9e on [%1.9e, %1.9e] with %lu colors",
+						vecValues[i], dMin, dMax, nColors[c]);
+				}
+			}
+		}
+	}
+
+	AnnounceEndBlock("Done");
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
 
+	int iResult = 0;
+
 #if defined(TEMPEST_MPIOMP)
 	// Initialize MPI
 	MPI_Init(&argc, &argv);
@@ -39,11 +1973,43 @@ try {
 
 	AnnounceBanner();
 
+	TestSimpleGridCache();
+
+	TestNearestNodesBatch();
+
+	TestRectilinearIndex();
+
+	TestNearestNodesWithDistances();
+
+	TestRemoveCoincidentNodes();
+
+	TestSimpleGridFromMesh();
+
+	TestFindFaceFromNode();
+
+	TestFindFacesFromNodes();
+
+	TestEdgeMap();
+
+	TestGLLNumbering();
+
+	TestInverseMapBatch();
+
+	TestQuadratureExactness();
+
+	TestPNGRoundTrip();
+
+	TestColorMapLUT();
+
+	AnnounceBanner();
+
 } catch(Exception & e) {
 	AnnounceOutputOnAllRanks();
 	AnnounceSetOutputBuffer(stdout);
 	Announce(e.ToString().c_str());
 
+	iResult = (-1);
+
 #if defined(TEMPEST_MPIOMP)
 	MPI_Abort(MPI_COMM_WORLD, -1);
 #endif
@@ -54,6 +2020,7 @@ try {
 	MPI_Finalize();
 #endif
 
+	return iResult;
 }
 
 ///////////////////////////////////////////////////////////////////////////////